@@ -36,12 +36,18 @@ class BloomFilter {
   explicit BloomFilter() : bits_{Allocator()} {}
   explicit BloomFilter(const Allocator& allocator) : bits_{allocator} {}
 
+  // Largest expected number of entries. The serialized form stores the
+  // number of words as int32_t.
+  static constexpr uint64_t kMaxCapacity = 1ULL << 31;
+
   // Prepares 'this' for use with an expected 'capacity'
   // entries. Drops any prior content.
-  void reset(int32_t capacity) {
+  void reset(uint64_t capacity) {
+    VELOX_CHECK_LE(
+        capacity, kMaxCapacity, "Too many entries for a Bloom filter");
     bits_.clear();
     // 2 bytes per value.
-    bits_.resize(std::max<int32_t>(4, bits::nextPowerOfTwo(capacity) / 4));
+    bits_.resize(std::max<uint64_t>(4, bits::nextPowerOfTwo(capacity) / 4));
   }
 
   bool isSet() {
@@ -15,6 +15,7 @@
  */
 
 #include "velox/common/base/BloomFilter.h"
+#include "velox/common/base/tests/GTestUtils.h"
 
 #include <folly/Hash.h>
 #include <folly/Random.h>
@@ -42,6 +43,16 @@ TEST_F(BloomFilterTest, basic) {
   EXPECT_GT(2, 100 * numFalsePositives / kSize);
 }
 
+TEST_F(BloomFilterTest, maxCapacity) {
+  BloomFilter bloom;
+  // A capacity that does not fit in 32 bits is rejected instead of being
+  // truncated to a small filter.
+  VELOX_ASSERT_THROW(
+      bloom.reset((1ULL << 32) + 1024), "Too many entries for a Bloom filter");
+  bloom.reset(1ULL << 20);
+  EXPECT_EQ(bloom.serializedSize(), 1 + 4 + (1 << 18) * sizeof(uint64_t));
+}
+
 TEST_F(BloomFilterTest, serialize) {
   constexpr int32_t kSize = 1024;
   BloomFilter bloom;
@@ -37,6 +37,14 @@ AsyncDataCacheEntry::~AsyncDataCacheEntry() {
 
 void AsyncDataCacheEntry::setExclusiveToShared() {
   VELOX_CHECK(isExclusive());
+  shard_->cache()->incrementAdmission(!isLowPriority_, size_);
+  if (isLowPriority_ && !isPrefetch_) {
+    // Evictable as soon as the pins of the first use are released. A
+    // prefetched entry is made evictable at its first use instead, see
+    // CacheShard::findOrCreate(), so that it is not evicted before it
+    // is read.
+    makeEvictable();
+  }
   numPins_ = 1;
   std::unique_ptr<folly::SharedPromise<bool>> promise;
   {
@@ -138,6 +146,12 @@ std::string AsyncDataCacheEntry::toString() const {
       numPins_);
 }
 
+CacheShard::CacheShard(AsyncDataCache* cache)
+    : cache_(cache),
+      // One counter per 256KB of capacity in each shard, i.e. in the
+      // order of the number of 64KB entries in the whole cache.
+      sketch_(cache->maxBytes() / (256 << 10)) {}
+
 std::unique_ptr<AsyncDataCacheEntry> CacheShard::getFreeEntryWithSize(
     uint64_t /*sizeHint*/) {
   std::unique_ptr<AsyncDataCacheEntry> newEntry;
@@ -155,6 +169,7 @@ CachePin CacheShard::findOrCreate(
     uint64_t size,
     folly::SemiFuture<bool>* wait) {
   AsyncDataCacheEntry* entryToInit = nullptr;
+  const auto hash = std::hash<RawFileCacheKey>()(key);
   {
     std::lock_guard<std::mutex> l(mutex_);
     ++eventCounter_;
@@ -170,13 +185,23 @@ CachePin CacheShard::findOrCreate(
         return CachePin();
       }
       if (found->size() >= size) {
-        found->touch();
         // The entry is in a readable state. Add a pin.
         if (found->isPrefetch_) {
+          // The first use of prefetched data is not a reuse. It was
+          // counted in 'sketch_' when the entry was made. A low priority
+          // entry becomes evictable once this use releases its pin.
           found->isFirstUse_ = true;
           found->setPrefetch(false);
+          if (found->isLowPriority_) {
+            found->makeEvictable();
+          } else {
+            found->touch();
+          }
         } else {
           ++numHit_;
+          sketch_.increment(hash);
+          found->isLowPriority_ = false;
+          found->touch();
         }
         ++found->numPins_;
         CachePin pin;
@@ -192,10 +217,16 @@ CachePin CacheShard::findOrCreate(
       // entry still retain a valid read pin.
       found->key_.fileNum.clear();
     }
+    sketch_.increment(hash);
     auto newEntry = getFreeEntryWithSize(size);
     // Initialize the members that must be set inside 'mutex_'.
     newEntry->numPins_ = AsyncDataCacheEntry::kExclusive;
     newEntry->promise_ = nullptr;
+    // A key that has not been seen recently is not retained after use
+    // unless there is room for it. This keeps a large scan that reads
+    // its data once from displacing data that is used repeatedly.
+    newEntry->isLowPriority_ = !cache_->hasFreeSpace(size) &&
+        sketch_.frequency(hash) < kMinAdmitFrequency;
     entryToInit = newEntry.get();
     entryMap_[key] = newEntry.get();
     if (emptySlots_.empty()) {
@@ -686,6 +717,8 @@ CacheStats AsyncDataCache::refreshStats() const {
   for (auto& shard : shards_) {
     shard->updateStats(stats);
   }
+  stats.admittedBytes = admittedBytes_;
+  stats.rejectedBytes = rejectedBytes_;
   return stats;
 }
 
@@ -703,7 +736,8 @@ std::string AsyncDataCache::toString() const {
           stats.largePadding
       << " / " << maxBytes_ << " bytes\n"
       << "Miss: " << stats.numNew << " Hit " << stats.numHit << " evict "
-      << stats.numEvict << "\n"
+      << stats.numEvict << " admitted bytes " << stats.admittedBytes
+      << " rejected bytes " << stats.rejectedBytes << "\n"
       << " read pins " << stats.numShared << " write pins "
       << stats.numExclusive << " unused prefetch " << stats.numPrefetch
       << " Alloc Megaclocks " << (stats.allocClocks >> 20)
@@ -26,6 +26,7 @@
 #include "velox/common/base/Portability.h"
 #include "velox/common/base/SelectivityInfo.h"
 #include "velox/common/caching/FileGroupStats.h"
+#include "velox/common/caching/FrequencySketch.h"
 #include "velox/common/caching/ScanTracker.h"
 #include "velox/common/caching/StringIdMap.h"
 #include "velox/common/file/File.h"
@@ -204,6 +205,19 @@ class AsyncDataCacheEntry {
     return isPrefetch_;
   }
 
+  // Marks 'this' as not worth retaining after its first use. Set by
+  // the cache's admission policy or by a loader for data of a scan
+  // that does not reuse cached data. Must be called while 'this' is
+  // exclusive.
+  void setLowPriority() {
+    VELOX_CHECK(isExclusive());
+    isLowPriority_ = true;
+  }
+
+  bool isLowPriority() const {
+    return isLowPriority_;
+  }
+
   // Distinguishes between a reuse of a cached entry from first
   // retrieval of a prefetched entry. If this is false, we have an
   // actual reuse of cached data.
@@ -287,6 +301,11 @@ class AsyncDataCacheEntry {
   // evicted before they are hit.
   bool isPrefetch_{false};
 
+  // True if 'this' was not admitted for retention. 'this' is then
+  // immediately evictable after its first use. Reset if 'this' is hit
+  // again.
+  bool isLowPriority_{false};
+
   // Set after first use of a prefetched entry. Cleared by
   // getAndClearFirstUseFlag(). Does not require synchronization since used for
   // statistics only.
@@ -497,6 +516,11 @@ struct CacheStats {
   // Sum of scores of evicted entries. This serves to infer an average
   // lifetime for entries in cache.
   int64_t sumEvictScore{};
+  // Bytes of new entries admitted for retention.
+  int64_t admittedBytes{};
+  // Bytes of new entries that were not admitted, i.e. that were
+  // evictable right after their first use.
+  int64_t rejectedBytes{};
 };
 // Collection of cache entries whose key hashes to the same shard of
 // the hash number space.  The cache population is divided into shards
@@ -504,7 +528,12 @@ struct CacheStats {
 // and other housekeeping.
 class CacheShard {
  public:
-  explicit CacheShard(AsyncDataCache* FOLLY_NONNULL cache) : cache_(cache) {}
+  // A new entry is retained if its key has been accessed at least this
+  // many times, counting the access that creates the entry, or if the
+  // cache has free space.
+  static constexpr int32_t kMinAdmitFrequency = 2;
+
+  explicit CacheShard(AsyncDataCache* FOLLY_NONNULL cache);
 
   // See AsyncDataCache::findOrCreate.
   CachePin findOrCreate(
@@ -597,6 +626,9 @@ class CacheShard {
   // Tracker of time spent in allocating/freeing MemoryAllocator space
   // for backing cached data.
   std::atomic<uint64_t> allocClocks_;
+  // Access frequency of recently seen keys. Used for deciding whether
+  // a new entry is worth retaining.
+  FrequencySketch sketch_;
 };
 
 class AsyncDataCache : public memory::MemoryAllocator {
@@ -703,6 +735,21 @@ class AsyncDataCache : public memory::MemoryAllocator {
   // triggers a background write of eligible entries to SSD.
   void possibleSsdSave(uint64_t bytes);
 
+  // True if 'bytes' more can be allocated without evicting anything.
+  bool hasFreeSpace(uint64_t bytes) const {
+    return (allocator_->numAllocated() +
+            bits::roundUp(bytes, memory::AllocationTraits::kPageSize) /
+                memory::AllocationTraits::kPageSize) *
+        memory::AllocationTraits::kPageSize <
+        maxBytes_;
+  }
+
+  // Updates the admission statistics for a new entry of 'bytes' that
+  // is admitted for retention or not.
+  void incrementAdmission(bool admitted, uint64_t bytes) {
+    (admitted ? admittedBytes_ : rejectedBytes_) += bytes;
+  }
+
   // Sets a callback applied to new entries at the point where
   //  they are set to shared mode. Used for testing and can be used for
   // e.g. checking checksums.
@@ -785,6 +832,10 @@ class AsyncDataCache : public memory::MemoryAllocator {
   // Approximate counter tracking new entries that could be saved to SSD.
   tsan_atomic<uint64_t> ssdSaveable_{0};
 
+  // Bytes of new entries that were and were not admitted for retention.
+  std::atomic<uint64_t> admittedBytes_{0};
+  std::atomic<uint64_t> rejectedBytes_{0};
+
   CacheStats stats_;
 
   std::function<void(const AsyncDataCacheEntry&)> verifyHook_;
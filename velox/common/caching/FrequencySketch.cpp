@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/FrequencySketch.h"
+
+#include <algorithm>
+
+#include "velox/common/base/BitUtil.h"
+
+namespace facebook::velox::cache {
+namespace {
+// Seeds for deriving an independent counter index per row from one hash.
+constexpr uint64_t kRowSeeds[] = {
+    0x9ae16a3b2f90404fULL,
+    0xc3a5c85c97cb3127ULL,
+    0xb492b66fbe98f273ULL,
+    0x9e3779b97f4a7c15ULL};
+} // namespace
+
+FrequencySketch::FrequencySketch(uint64_t numCounters)
+    : mask_(bits::nextPowerOfTwo(std::max<uint64_t>(numCounters, 64)) - 1),
+      counters_(kNumRows * (mask_ + 1), 0) {}
+
+uint64_t FrequencySketch::index(uint64_t hash, int32_t row) const {
+  return row * (mask_ + 1) + (bits::hashMix(hash, kRowSeeds[row]) & mask_);
+}
+
+void FrequencySketch::increment(uint64_t hash) {
+  uint64_t indices[kNumRows];
+  uint8_t min = kMaxFrequency;
+  for (auto row = 0; row < kNumRows; ++row) {
+    indices[row] = index(hash, row);
+    min = std::min(min, counters_[indices[row]]);
+  }
+  if (min == kMaxFrequency) {
+    return;
+  }
+  for (auto row = 0; row < kNumRows; ++row) {
+    if (counters_[indices[row]] == min) {
+      ++counters_[indices[row]];
+    }
+  }
+  if (++numIncrements_ >= kAgingFactor * (mask_ + 1)) {
+    age();
+  }
+}
+
+int32_t FrequencySketch::frequency(uint64_t hash) const {
+  uint8_t min = kMaxFrequency;
+  for (auto row = 0; row < kNumRows; ++row) {
+    min = std::min(min, counters_[index(hash, row)]);
+  }
+  return min;
+}
+
+void FrequencySketch::age() {
+  for (auto& counter : counters_) {
+    counter >>= 1;
+  }
+  numIncrements_ /= 2;
+  ++numAgings_;
+}
+
+} // namespace facebook::velox::cache
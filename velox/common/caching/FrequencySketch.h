@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace facebook::velox::cache {
+
+// Approximate access counter for cache admission in the style of
+// TinyLFU. This is a count-min sketch of 4 rows of saturating 4 bit
+// counters. A key increments one counter in each row and its
+// frequency is the minimum of these. Only the counters at the minimum
+// are incremented, which reduces the overestimate from collisions.
+// All counters are halved after 10x the number of counters worth of
+// increments so that the sketch reflects recent history. Not
+// thread-safe. Used inside the mutex of a CacheShard.
+class FrequencySketch {
+ public:
+  static constexpr int32_t kMaxFrequency = 15;
+
+  // Constructs a sketch with 'numCounters' rounded up to a power of 2
+  // counters per row. This should be in the order of the number of
+  // distinct keys to track.
+  explicit FrequencySketch(uint64_t numCounters);
+
+  // Records an access to the key with 'hash'.
+  void increment(uint64_t hash);
+
+  // Returns the approximate number of recorded accesses to the key with
+  // 'hash', up to kMaxFrequency.
+  int32_t frequency(uint64_t hash) const;
+
+  // Number of times the counters have been halved.
+  uint64_t numAgings() const {
+    return numAgings_;
+  }
+
+ private:
+  static constexpr int32_t kNumRows = 4;
+  static constexpr int32_t kAgingFactor = 10;
+
+  // Returns the index of the counter of 'hash' in 'row'.
+  uint64_t index(uint64_t hash, int32_t row) const;
+
+  // Halves all counters.
+  void age();
+
+  const uint64_t mask_;
+  // 'kNumRows' rows of 'mask_ + 1' counters.
+  std::vector<uint8_t> counters_;
+  uint64_t numIncrements_{0};
+  uint64_t numAgings_{0};
+};
+
+} // namespace facebook::velox::cache
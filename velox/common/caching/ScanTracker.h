@@ -17,6 +17,7 @@
 #pragma once
 
 #include <folly/container/F14Map.h>
+#include <atomic>
 #include <cstdint>
 #include <mutex>
 
@@ -168,6 +169,23 @@ class ScanTracker {
     return data_[id];
   }
 
+  // Records a lookup of data of this scan in AsyncDataCache. 'hit' is
+  // true if the data was brought to cache by an earlier use, i.e. not
+  // loaded or prefetched for this lookup.
+  void recordCacheLookup(bool hit) {
+    ++(hit ? numCacheHits_ : numCacheMisses_);
+  }
+
+  // True if this scan rarely finds its data in cache, e.g. a scan
+  // over a large table that is read once. Data prefetched for such a
+  // scan is admitted to cache with low priority.
+  bool isLowReuse() const {
+    const int64_t hits = numCacheHits_;
+    const int64_t lookups = hits + numCacheMisses_;
+    return lookups >= kMinLookupsForReuse &&
+        100 * hits < kLowReuseHitPct * lookups;
+  }
+
   std::string_view id() const {
     return id_;
   }
@@ -179,6 +197,11 @@ class ScanTracker {
   std::string toString() const;
 
  private:
+  // Number of cache lookups before isLowReuse() can be true.
+  static constexpr int64_t kMinLookupsForReuse = 100;
+  // Hit percentage below which isLowReuse() is true.
+  static constexpr int64_t kLowReuseHitPct = 10;
+
   std::mutex mutex_;
   // Id of query + scan operator to track.
   const std::string id_;
@@ -191,6 +214,10 @@ class ScanTracker {
   // size is unlimited.
   const int32_t loadQuantum_;
   FileGroupStats* FOLLY_NULLABLE fileGroupStats_;
+  // Counts of cache lookups that found data cached by an earlier use
+  // and of those that did not.
+  std::atomic<int64_t> numCacheHits_{0};
+  std::atomic<int64_t> numCacheMisses_{0};
 };
 
 } // namespace facebook::velox::cache
@@ -589,6 +589,71 @@ TEST_F(AsyncDataCacheTest, outOfCapacity) {
   clearAllocations(allocations);
 }
 
+TEST_F(AsyncDataCacheTest, admission) {
+  constexpr int64_t kMaxBytes = 16 << 20;
+  // Tiny entries do not allocate from the cache's capacity.
+  constexpr int32_t kSize = 1000;
+  constexpr int32_t kAllocationPages = 1;
+  std::deque<memory::Allocation> allocations;
+  initializeCache(kMaxBytes);
+
+  // Creates an entry for 'offset' and returns true if it was not admitted.
+  auto isRejected = [&](uint64_t offset) {
+    auto pin = cache_->findOrCreate({filenames_[0].id(), offset}, kSize);
+    EXPECT_TRUE(pin.checkedEntry()->isExclusive());
+    const bool lowPriority = pin.checkedEntry()->isLowPriority();
+    pin.checkedEntry()->setExclusiveToShared();
+    return lowPriority;
+  };
+
+  // Fill the capacity so that new entries must displace old ones.
+  for (;;) {
+    memory::Allocation allocation;
+    if (!cache_->allocateNonContiguous(kAllocationPages, allocation)) {
+      break;
+    }
+    allocations.push_back(std::move(allocation));
+  }
+  ASSERT_FALSE(cache_->hasFreeSpace(kSize));
+
+  // A key that has not been seen before is not retained.
+  ASSERT_TRUE(isRejected(0));
+  auto stats = cache_->refreshStats();
+  ASSERT_EQ(0, stats.admittedBytes);
+  ASSERT_EQ(kSize, stats.rejectedBytes);
+
+  // A second use of the entry retains it.
+  {
+    auto pin = cache_->findOrCreate({filenames_[0].id(), 0}, kSize);
+    ASSERT_TRUE(pin.checkedEntry()->isShared());
+    ASSERT_FALSE(pin.checkedEntry()->isLowPriority());
+  }
+
+  // A key that has been seen before is admitted when its entry is made
+  // again.
+  cache_->clear();
+  ASSERT_FALSE(isRejected(0));
+  stats = cache_->refreshStats();
+  ASSERT_EQ(kSize, stats.admittedBytes);
+  ASSERT_EQ(kSize, stats.rejectedBytes);
+
+  // Any new entry is admitted if there is free space.
+  clearAllocations(allocations);
+  ASSERT_TRUE(cache_->hasFreeSpace(kSize));
+  ASSERT_FALSE(isRejected(1 << 20));
+
+  // A scan that seldom finds its data in cache is low reuse.
+  ScanTracker tracker;
+  for (auto i = 0; i < 100; ++i) {
+    tracker.recordCacheLookup(i % 20 == 0);
+  }
+  ASSERT_TRUE(tracker.isLowReuse());
+  for (auto i = 0; i < 100; ++i) {
+    tracker.recordCacheLookup(true);
+  }
+  ASSERT_FALSE(tracker.isLowReuse());
+}
+
 namespace {
 // Cuts off the last 1/10th of file at 'path'.
 void corruptFile(const std::string& path) {
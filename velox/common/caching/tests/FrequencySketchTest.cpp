@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/caching/FrequencySketch.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox::cache;
+
+TEST(FrequencySketchTest, basic) {
+  FrequencySketch sketch(1024);
+  EXPECT_EQ(0, sketch.frequency(1));
+  for (auto i = 0; i < 3; ++i) {
+    sketch.increment(1);
+  }
+  EXPECT_EQ(3, sketch.frequency(1));
+
+  // Counters saturate.
+  for (auto i = 0; i < 20; ++i) {
+    sketch.increment(2);
+  }
+  EXPECT_EQ(FrequencySketch::kMaxFrequency, sketch.frequency(2));
+
+  // Keys that were not incremented seldom collide with the ones that were.
+  for (uint64_t key = 100; key < 200; ++key) {
+    sketch.increment(key);
+  }
+  int32_t numFalsePositives = 0;
+  for (uint64_t key = 1000; key < 1100; ++key) {
+    numFalsePositives += sketch.frequency(key) > 0;
+  }
+  EXPECT_GT(10, numFalsePositives);
+}
+
+TEST(FrequencySketchTest, aging) {
+  // 64 counters per row are halved after 640 increments.
+  FrequencySketch sketch(64);
+  for (auto i = 0; i < 10; ++i) {
+    sketch.increment(1);
+  }
+  EXPECT_LE(10, sketch.frequency(1));
+  for (uint64_t key = 1000; key < 100'000 && sketch.numAgings() == 0;
+       ++key) {
+    sketch.increment(key);
+  }
+  EXPECT_EQ(1, sketch.numAgings());
+  EXPECT_GE(FrequencySketch::kMaxFrequency / 2, sketch.frequency(1));
+}
@@ -15,6 +15,7 @@
  */
 
 #include "velox/common/file/File.h"
+#include "velox/common/file/IoUringReader.h"
 
 #include <fmt/format.h>
 #include <glog/logging.h>
@@ -121,12 +122,22 @@ LocalReadFile::pread(uint64_t offset, uint64_t length, void* buf) const {
   return {static_cast<char*>(buf), length};
 }
 
-uint64_t LocalReadFile::preadv(
-    uint64_t offset,
-    const std::vector<folly::Range<char*>>& buffers) const {
-  // Dropped bytes sized so that a typical dropped range of 50K is not
-  // too many iovecs.
-  static thread_local std::vector<char> droppedBytes(16 * 1024);
+namespace {
+// Returns the number of bytes requested by 'buffers', including dropped
+// ranges.
+uint64_t requestedBytes(const std::vector<folly::Range<char*>>& buffers) {
+  uint64_t bytes = 0;
+  for (auto& range : buffers) {
+    bytes += range.size();
+  }
+  return bytes;
+}
+
+// Makes iovecs for 'buffers'. Ranges with nullptr data are read into
+// 'droppedBytes'.
+std::vector<struct iovec> makeIovecs(
+    const std::vector<folly::Range<char*>>& buffers,
+    std::vector<char>& droppedBytes) {
   std::vector<struct iovec> iovecs;
   iovecs.reserve(buffers.size());
   for (auto& range : buffers) {
@@ -141,9 +152,41 @@ uint64_t LocalReadFile::preadv(
       iovecs.push_back({range.data(), range.size()});
     }
   }
+  return iovecs;
+}
+} // namespace
+
+uint64_t LocalReadFile::preadv(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  // Dropped bytes sized so that a typical dropped range of 50K is not
+  // too many iovecs.
+  static thread_local std::vector<char> droppedBytes(16 * 1024);
+  auto iovecs = makeIovecs(buffers, droppedBytes);
+  bytesRead_ += requestedBytes(buffers);
   return folly::preadv(fd_, iovecs.data(), iovecs.size(), offset);
 }
 
+folly::SemiFuture<uint64_t> LocalReadFile::preadvAsync(
+    uint64_t offset,
+    const std::vector<folly::Range<char*>>& buffers) const {
+  auto* reader = IoUringReader::instance();
+  if (!reader) {
+    return ReadFile::preadvAsync(offset, buffers);
+  }
+  // The read completes on another thread, so dropped ranges cannot go to a
+  // thread local buffer. The contents are never looked at, so concurrent
+  // reads may share the same buffer.
+  static std::vector<char> droppedBytes(16 * 1024);
+  auto iovecs = makeIovecs(buffers, droppedBytes);
+  bytesRead_ += requestedBytes(buffers);
+  return reader->readv(fd_, offset, std::move(iovecs));
+}
+
+bool LocalReadFile::hasPreadvAsync() const {
+  return IoUringReader::instance() != nullptr;
+}
+
 uint64_t LocalReadFile::size() const {
   return size_;
 }
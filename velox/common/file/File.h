@@ -218,6 +218,14 @@ class LocalReadFile final : public ReadFile {
       uint64_t offset,
       const std::vector<folly::Range<char*>>& buffers) const final;
 
+  // Submits the read to IoUringReader::instance() if io_uring is available,
+  // else reads synchronously.
+  folly::SemiFuture<uint64_t> preadvAsync(
+      uint64_t offset,
+      const std::vector<folly::Range<char*>>& buffers) const override;
+
+  bool hasPreadvAsync() const override;
+
   uint64_t memoryUsage() const final;
 
   bool shouldCoalesce() const final {
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/common/file/IoUringReader.h"
+
+#include <fmt/format.h>
+#include <folly/String.h>
+#include <glog/logging.h>
+
+#ifdef VELOX_ENABLE_IO_URING
+#include <liburing.h>
+#endif
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox {
+
+struct IoUringReader::Request {
+  folly::Promise<uint64_t> promise;
+  int32_t fd;
+  uint64_t offset;
+  std::vector<struct iovec> iovecs;
+  // Index of the first iovec that is not completely filled.
+  size_t firstIovec{0};
+  uint64_t size{0};
+  uint64_t bytesRead{0};
+
+  // Advances the iovecs past 'bytes' that were just read.
+  void advance(uint64_t bytes) {
+    bytesRead += bytes;
+    offset += bytes;
+    while (bytes > 0 && firstIovec < iovecs.size()) {
+      auto& iov = iovecs[firstIovec];
+      if (bytes < iov.iov_len) {
+        iov.iov_base = static_cast<char*>(iov.iov_base) + bytes;
+        iov.iov_len -= bytes;
+        return;
+      }
+      bytes -= iov.iov_len;
+      ++firstIovec;
+    }
+  }
+};
+
+#ifdef VELOX_ENABLE_IO_URING
+
+struct IoUringReader::Ring {
+  struct io_uring ring;
+
+  ~Ring() {
+    io_uring_queue_exit(&ring);
+  }
+};
+
+// static
+std::unique_ptr<IoUringReader> IoUringReader::create(int32_t queueDepth) {
+  VELOX_CHECK_GT(queueDepth, 0);
+  auto ring = std::make_unique<Ring>();
+  // The completion queue is twice the submission queue by default, so
+  // bounding submissions by 'queueDepth' cannot overflow it.
+  const auto rc = io_uring_queue_init(queueDepth, &ring->ring, 0);
+  if (rc < 0) {
+    LOG(WARNING) << "io_uring_queue_init failed, falling back to synchronous "
+                 << "reads: " << folly::errnoStr(-rc);
+    return nullptr;
+  }
+  return std::unique_ptr<IoUringReader>(
+      new IoUringReader(queueDepth, std::move(ring)));
+}
+
+IoUringReader::~IoUringReader() {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    shutdown_ = true;
+    // A nop with no request wakes up the reaper.
+    struct io_uring_sqe* sqe;
+    while (!(sqe = io_uring_get_sqe(&ring_->ring))) {
+      io_uring_submit(&ring_->ring);
+    }
+    io_uring_prep_nop(sqe);
+    io_uring_sqe_set_data(sqe, nullptr);
+    io_uring_submit(&ring_->ring);
+  }
+  reaper_.join();
+  VELOX_CHECK(pending_.empty());
+}
+
+void IoUringReader::submitLocked(Request* request) {
+  if (numInFlight_ >= queueDepth_) {
+    pending_.push_back(request);
+    return;
+  }
+  auto* sqe = io_uring_get_sqe(&ring_->ring);
+  VELOX_CHECK_NOT_NULL(sqe, "io_uring submission queue full");
+  io_uring_prep_readv(
+      sqe,
+      request->fd,
+      request->iovecs.data() + request->firstIovec,
+      request->iovecs.size() - request->firstIovec,
+      request->offset);
+  io_uring_sqe_set_data(sqe, request);
+  const auto rc = io_uring_submit(&ring_->ring);
+  if (rc < 0) {
+    // The sqe stays in the submission queue and goes to the kernel with
+    // the next successful submit. Turn it into a nop without a request so
+    // that the reaper does not see 'request' after it is freed.
+    io_uring_prep_nop(sqe);
+    io_uring_sqe_set_data(sqe, nullptr);
+    request->promise.setException(std::runtime_error(
+        fmt::format("io_uring_submit failed: {}", folly::errnoStr(-rc))));
+    delete request;
+    return;
+  }
+  ++numInFlight_;
+}
+
+void IoUringReader::reap() {
+  for (;;) {
+    struct io_uring_cqe* cqe;
+    const auto rc = io_uring_wait_cqe(&ring_->ring, &cqe);
+    if (rc == -EINTR) {
+      continue;
+    }
+    VELOX_CHECK_EQ(
+        rc, 0, "io_uring_wait_cqe failed: {}", folly::errnoStr(-rc));
+    auto* request = static_cast<Request*>(io_uring_cqe_get_data(cqe));
+    const auto result = cqe->res;
+    io_uring_cqe_seen(&ring_->ring, cqe);
+
+    std::unique_lock<std::mutex> l(mutex_);
+    if (!request) {
+      if (shutdown_ && numInFlight_ == 0 && pending_.empty()) {
+        return;
+      }
+      continue;
+    }
+    --numInFlight_;
+    if (result == -EINTR || result == -EAGAIN) {
+      submitLocked(request);
+    } else if (result < 0) {
+      request->promise.setException(std::runtime_error(fmt::format(
+          "io_uring read of fd {} failed: {}",
+          request->fd,
+          folly::errnoStr(-result))));
+      delete request;
+    } else {
+      request->advance(result);
+      if (result > 0 && request->bytesRead < request->size) {
+        // Short read, the kernel may stop at page cache or device
+        // boundaries. Continue from where it left off.
+        submitLocked(request);
+      } else {
+        // A 0 byte read means end of file.
+        request->promise.setValue(request->bytesRead);
+        delete request;
+      }
+    }
+    while (!pending_.empty() && numInFlight_ < queueDepth_) {
+      auto* next = pending_.front();
+      pending_.pop_front();
+      submitLocked(next);
+    }
+    if (shutdown_ && numInFlight_ == 0 && pending_.empty()) {
+      // Drain the wakeup nop if it has not been seen yet.
+      if (io_uring_peek_cqe(&ring_->ring, &cqe) == 0) {
+        io_uring_cqe_seen(&ring_->ring, cqe);
+      }
+      return;
+    }
+  }
+}
+
+#else
+
+struct IoUringReader::Ring {};
+
+// static
+std::unique_ptr<IoUringReader> IoUringReader::create(int32_t /*queueDepth*/) {
+  return nullptr;
+}
+
+IoUringReader::~IoUringReader() = default;
+
+void IoUringReader::submitLocked(Request* /*request*/) {
+  VELOX_UNREACHABLE();
+}
+
+void IoUringReader::reap() {
+  VELOX_UNREACHABLE();
+}
+
+#endif
+
+IoUringReader::IoUringReader(int32_t queueDepth, std::unique_ptr<Ring> ring)
+    : queueDepth_(queueDepth), ring_(std::move(ring)) {
+  reaper_ = std::thread([this]() { reap(); });
+}
+
+// static
+IoUringReader* IoUringReader::instance() {
+  static std::unique_ptr<IoUringReader> reader = create();
+  return reader.get();
+}
+
+folly::SemiFuture<uint64_t> IoUringReader::readv(
+    int32_t fd,
+    uint64_t offset,
+    std::vector<struct iovec> iovecs) {
+  auto request = std::make_unique<Request>();
+  request->fd = fd;
+  request->offset = offset;
+  for (const auto& iov : iovecs) {
+    request->size += iov.iov_len;
+  }
+  request->iovecs = std::move(iovecs);
+  auto future = request->promise.getSemiFuture();
+  if (request->size == 0) {
+    request->promise.setValue(0);
+    return future;
+  }
+  std::lock_guard<std::mutex> l(mutex_);
+  VELOX_CHECK(!shutdown_);
+  submitLocked(request.release());
+  return future;
+}
+
+} // namespace facebook::velox
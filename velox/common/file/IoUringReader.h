@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <folly/futures/Future.h>
+
+namespace facebook::velox {
+
+// Submits vectored reads of local files through a Linux io_uring and
+// completes them from a single reaper thread. A small number of threads can
+// thus keep many reads in flight without blocking an IO executor thread per
+// read. At most 'queueDepth' reads are submitted to the kernel at a time, the
+// rest wait in a queue and are submitted as earlier reads complete.
+//
+// Available only if Velox is built with VELOX_ENABLE_IO_URING and the kernel
+// supports io_uring. Otherwise create() and instance() return nullptr and
+// callers fall back to synchronous reads.
+class IoUringReader {
+ public:
+  static constexpr int32_t kDefaultQueueDepth = 256;
+
+  ~IoUringReader();
+
+  // Returns a new reader with a ring of 'queueDepth' entries or nullptr if
+  // io_uring is not available.
+  static std::unique_ptr<IoUringReader> create(
+      int32_t queueDepth = kDefaultQueueDepth);
+
+  // Returns the process-wide reader used by LocalReadFile::preadvAsync or
+  // nullptr if io_uring is not available.
+  static IoUringReader* FOLLY_NULLABLE instance();
+
+  // Reads from 'fd' starting at 'offset' into 'iovecs'. The memory referenced
+  // by 'iovecs' must stay live until the returned future is realized. The
+  // future has the number of bytes read, which is less than the total size
+  // of 'iovecs' only at end of file.
+  folly::SemiFuture<uint64_t>
+  readv(int32_t fd, uint64_t offset, std::vector<struct iovec> iovecs);
+
+  int32_t queueDepth() const {
+    return queueDepth_;
+  }
+
+  // Number of reads submitted to the kernel and not yet completed.
+  int32_t numInFlight() const {
+    std::lock_guard<std::mutex> l(mutex_);
+    return numInFlight_;
+  }
+
+ private:
+  struct Request;
+  struct Ring;
+
+  IoUringReader(int32_t queueDepth, std::unique_ptr<Ring> ring);
+
+  // Submits 'request' if there is room in the ring, else queues it. Must be
+  // called with 'mutex_' held.
+  void submitLocked(Request* FOLLY_NONNULL request);
+
+  // Loop of 'reaper_'. Completes requests and resubmits short reads.
+  void reap();
+
+  const int32_t queueDepth_;
+  std::unique_ptr<Ring> ring_;
+
+  // Serializes access to the submission queue and 'pending_'.
+  mutable std::mutex mutex_;
+  int32_t numInFlight_{0};
+  std::deque<Request*> pending_;
+  bool shutdown_{false};
+  std::thread reaper_;
+};
+
+} // namespace facebook::velox
@@ -37,6 +37,11 @@ DEFINE_int32(
     num_in_run,
     10,
     "Number of consecutive reads of --bytes separated by --gap bytes");
+DEFINE_int32(
+    max_queue_depth,
+    0,
+    "If non-0, compares thread pool and io_uring submission of reads at "
+    "queue depths up to this");
 DEFINE_int32(
     measurement_size,
     100 << 20,
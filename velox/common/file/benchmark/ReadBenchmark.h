@@ -31,6 +31,7 @@
 
 #include "velox/common/file/File.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/file/IoUringReader.h"
 #include "velox/common/time/Timer.h"
 
 DECLARE_string(path);
@@ -41,6 +42,7 @@ DECLARE_bool(odirect);
 DECLARE_int32(bytes);
 DECLARE_int32(gap);
 DECLARE_int32(num_in_run);
+DECLARE_int32(max_queue_depth);
 
 DECLARE_int32(measurement_size);
 
@@ -87,6 +89,10 @@ class ReadBenchmark {
       filesystems::registerLocalFileSystem();
       auto lfs = filesystems::getFileSystem(FLAGS_path, nullptr);
       readFile_ = lfs->openFileForRead(FLAGS_path);
+      if (FLAGS_max_queue_depth) {
+        // The io_uring comparison reads the file through its own fd.
+        fd_ = open(FLAGS_path.c_str(), O_RDONLY);
+      }
     }
     fileSize_ = readFile_->size();
     if (FLAGS_file_size_gb) {
@@ -273,6 +279,105 @@ class ReadBenchmark {
               << std::endl;
   }
 
+  // Measures the throughput of keeping 'queueDepth' preadv's of 'count'
+  // ranges in flight. With 'useRing' the reads are submitted through an
+  // IoUringReader with a ring of 'queueDepth' entries from the calling thread,
+  // else each read runs on a thread of 'executor_'.
+  void queueDepthReads(
+      int32_t size,
+      int32_t gap,
+      int32_t count,
+      int32_t repeats,
+      int32_t queueDepth,
+      bool useRing) {
+    std::unique_ptr<IoUringReader> ring;
+    if (useRing) {
+      ring = IoUringReader::create(queueDepth);
+      if (!ring) {
+        std::cout << "io_uring not available" << std::endl;
+        return;
+      }
+    }
+    clearCache();
+    const int32_t rangeSize = size * count + gap * (count - 1);
+    // One buffer and one pending read per slot. A slot is reused after its
+    // previous read completes, so that at most 'queueDepth' reads are pending.
+    std::vector<std::string> buffers(queueDepth);
+    std::vector<folly::SemiFuture<uint64_t>> futures;
+    futures.reserve(queueDepth);
+    for (auto i = 0; i < queueDepth; ++i) {
+      buffers[i].resize(rangeSize);
+      futures.push_back(folly::makeSemiFuture<uint64_t>(0));
+    }
+    auto& exec = folly::QueuedImmediateExecutor::instance();
+    uint64_t usec = 0;
+    {
+      MicrosecondTimer timer(&usec);
+      for (auto repeat = 0; repeat < repeats; ++repeat) {
+        const auto slot = repeat % queueDepth;
+        std::move(futures[slot]).via(&exec).wait();
+        const int64_t offset =
+            folly::Random::rand64(rng_) % (fileSize_ - rangeSize);
+        auto* buffer = buffers[slot].data();
+        if (useRing) {
+          std::vector<struct iovec> iovecs;
+          for (auto start = 0; start < rangeSize; start += size + gap) {
+            iovecs.push_back({buffer + start, static_cast<size_t>(size)});
+            if (gap && start + size < rangeSize) {
+              // Gaps are read over by the next range.
+              iovecs.push_back(
+                  {buffer + start + size, static_cast<size_t>(gap)});
+            }
+          }
+          futures[slot] = ring->readv(fd_, offset, std::move(iovecs));
+        } else {
+          auto [promise, future] = folly::makePromiseContract<uint64_t>();
+          futures[slot] = std::move(future);
+          executor_->add([offset,
+                          gap,
+                          size,
+                          rangeSize,
+                          buffer,
+                          this,
+                          capturedPromise = std::move(promise)]() mutable {
+            std::vector<folly::Range<char*>> ranges;
+            for (auto start = 0; start < rangeSize; start += size + gap) {
+              ranges.push_back(folly::Range<char*>(buffer + start, size));
+              if (gap && start + size < rangeSize) {
+                ranges.push_back(folly::Range<char*>(nullptr, gap));
+              }
+            }
+            capturedPromise.setValue(readFile_->preadv(offset, ranges));
+          });
+        }
+      }
+      for (auto& future : futures) {
+        std::move(future).via(&exec).wait();
+      }
+    }
+    std::cout << fmt::format(
+                     "{} MB/s qd {} {}",
+                     (static_cast<float>(count) * size * repeats) / usec,
+                     queueDepth,
+                     useRing ? "io_uring" : "thread pool")
+              << std::endl;
+  }
+
+  // Compares thread pool and io_uring submission of preadv's at increasing
+  // queue depths.
+  void queueDepths(int32_t size, int32_t gap, int32_t count) {
+    if (fd_ < 0) {
+      return;
+    }
+    int repeats =
+        std::max<int32_t>(3, (FLAGS_measurement_size) / (size * count));
+    for (auto queueDepth = 1; queueDepth <= FLAGS_max_queue_depth;
+         queueDepth *= 4) {
+      queueDepthReads(size, gap, count, repeats, queueDepth, false);
+      queueDepthReads(size, gap, count, repeats, queueDepth, true);
+    }
+  }
+
   void modes(int32_t size, int32_t gap, int32_t count) {
     int repeats =
         std::max<int32_t>(3, (FLAGS_measurement_size) / (size * count));
@@ -289,6 +394,7 @@ class ReadBenchmark {
     randomReads(size, gap, count, repeats, Mode::Pread, true);
     randomReads(size, gap, count, repeats, Mode::Preadv, true);
     randomReads(size, gap, count, repeats, Mode::Multiple, true);
+    queueDepths(size, gap, count);
   }
 
   void run();
@@ -298,7 +404,7 @@ class ReadBenchmark {
   static constexpr int32_t kWrite = -10000;
   // 0 means no op, kWrite means being written, other numbers are reader counts.
   std::string writeBatch_;
-  int32_t fd_;
+  int32_t fd_{-1};
   std::unique_ptr<folly::IOThreadPoolExecutor> executor_;
   std::unique_ptr<ReadFile> readFile_;
   folly::Random::DefaultGenerator rng_;
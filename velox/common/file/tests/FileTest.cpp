@@ -18,6 +18,7 @@
 
 #include "velox/common/file/File.h"
 #include "velox/common/file/FileSystems.h"
+#include "velox/common/file/IoUringReader.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 #include "velox/exec/tests/utils/TempFilePath.h"
 
@@ -216,6 +217,45 @@ TEST(LocalFile, readFileDestructor) {
   }
 }
 
+TEST(LocalFile, preadvAsync) {
+  auto tempFile = ::exec::test::TempFilePath::create();
+  const auto& filename = tempFile->path.c_str();
+  remove(filename);
+  {
+    LocalWriteFile writeFile(filename);
+    writeData(&writeFile);
+  }
+  LocalReadFile readFile(filename);
+  // Without io_uring the reads are synchronous and the results must be the
+  // same.
+  ASSERT_EQ(readFile.hasPreadvAsync(), IoUringReader::instance() != nullptr);
+  char head[12];
+  char middle[4];
+  std::string tail(kOneMB, 0);
+  std::vector<folly::Range<char*>> buffers = {
+      folly::Range<char*>(head, sizeof(head)),
+      folly::Range<char*>(nullptr, (char*)(uint64_t)100000),
+      folly::Range<char*>(middle, sizeof(middle))};
+  std::vector<folly::Range<char*>> tailBuffers = {
+      folly::Range<char*>(tail.data(), tail.size())};
+  readFile.resetBytesRead();
+  auto future = readFile.preadvAsync(0, buffers);
+  // Reading past the end returns the bytes up to the end of the file.
+  auto tailFuture = readFile.preadvAsync(100, tailBuffers);
+  const uint64_t expectedBytes = sizeof(head) + 100000 + sizeof(middle);
+  ASSERT_EQ(expectedBytes, std::move(future).get());
+  ASSERT_EQ(kOneMB - 85, std::move(tailFuture).get());
+  ASSERT_EQ(std::string_view(head, sizeof(head)), "aaaaabbbbbcc");
+  ASSERT_EQ(std::string_view(middle, sizeof(middle)), "cccc");
+  ASSERT_EQ(tail.substr(kOneMB - 90, 5), "ddddd");
+  // The asynchronous and synchronous reads count the same requested bytes.
+  ASSERT_EQ(expectedBytes + kOneMB, readFile.bytesRead());
+  readFile.resetBytesRead();
+  ASSERT_EQ(expectedBytes, readFile.preadv(0, buffers));
+  ASSERT_EQ(kOneMB - 85, readFile.preadv(100, tailBuffers));
+  ASSERT_EQ(expectedBytes + kOneMB, readFile.bytesRead());
+}
+
 TEST(LocalFile, mkdir) {
   filesystems::registerLocalFileSystem();
   auto tempFolder = ::exec::test::TempDirectoryPath::create();
@@ -183,7 +183,7 @@ class MemoryUsageTracker
   }
 
   int64_t maxMemory() const {
-    return parent_ != nullptr ? parent_->maxMemory() : maxMemory_;
+    return parent_ != nullptr ? parent_->maxMemory() : maxMemory_.load();
   }
 
   std::shared_ptr<MemoryUsageTracker> addChild() {
@@ -197,6 +197,14 @@ class MemoryUsageTracker
     growCallback_ = func;
   }
 
+  /// Sets the memory limit of a root tracker. A limit below the current usage
+  /// fails the next allocation that reaches the limit unless the GrowCallback
+  /// raises the limit again.
+  void setMaxMemory(int64_t maxMemory) {
+    VELOX_CHECK_NULL(parent_, "Only root tracker allows to set memory limit");
+    maxMemory_ = maxMemory;
+  }
+
   void setMakeMemoryCapExceededMessage(MakeMemoryCapExceededMessage func) {
     makeMemoryCapExceededMessage_ = func;
   }
@@ -280,8 +288,9 @@ class MemoryUsageTracker
   std::mutex mutex_;
   std::shared_ptr<MemoryUsageTracker> parent_;
 
-  // The memory limit in bytes to enforce.
-  int64_t maxMemory_;
+  // The memory limit in bytes to enforce. Atomic since the GrowCallback of
+  // another tracker can change it while this tracker checks it.
+  std::atomic<int64_t> maxMemory_;
 
   std::atomic<int64_t> peakBytes_{0};
   std::atomic<int64_t> cumulativeBytes_{0};
@@ -34,6 +34,8 @@ std::string groupName(const std::string& filename) {
   return slash ? std::string(filename.data(), slash - filename.data())
                : filename;
 }
+
+std::atomic<uint64_t> nextFileHandleVersion{1};
 } // namespace
 
 std::unique_ptr<FileHandle> FileHandleGenerator::operator()(
@@ -42,6 +44,7 @@ std::unique_ptr<FileHandle> FileHandleGenerator::operator()(
   fileHandle->file = filesystems::getFileSystem(filename, properties_)
                          ->openFileForRead(filename);
   fileHandle->uuid = StringIdLease(fileIds(), filename);
+  fileHandle->version = nextFileHandleVersion++;
   fileHandle->groupId = StringIdLease(fileIds(), groupName(filename));
   VLOG(1) << "Generating file handle for: " << filename
           << " uuid: " << fileHandle->uuid.id();
@@ -46,6 +46,11 @@ struct FileHandle {
   // memory compared to using the filename as the identifier.
   StringIdLease uuid;
 
+  // Process-wide sequence number of this FileHandle. A file rewritten under
+  // the same path is only read through a new FileHandle, so caches of parsed
+  // file contents key by 'uuid' and 'version' to not serve the old content.
+  uint64_t version{0};
+
   // Id for the group of files this belongs to, e.g. its
   // directory. Used for coarse granularity access tracking, for
   // example to decide placing on SSD.
@@ -52,4 +52,19 @@ uint32_t HiveConfig::maxPartitionsPerWriters(const Config* config) {
   return config->get<uint32_t>(kMaxPartitionsPerWriters, 100);
 }
 
+// static
+uint32_t HiveConfig::maxOpenWriters(const Config* config) {
+  return config->get<uint32_t>(kMaxOpenWriters, 1'000);
+}
+
+// static
+std::string HiveConfig::sortedWriteSpillDirectory(const Config* config) {
+  return config->get<std::string>(kSortedWriteSpillDirectory, "");
+}
+
+// static
+uint64_t HiveConfig::sortedWriteMaxBufferBytes(const Config* config) {
+  return config->get<uint64_t>(kSortedWriteMaxBufferBytes, 256UL << 20);
+}
+
 } // namespace facebook::velox::connector::hive
@@ -35,10 +35,31 @@ class HiveConfig {
   static constexpr const char* kMaxPartitionsPerWriters =
       "max_partitions_per_writers";
 
+  /// Maximum number of files a single table writer instance writes at a
+  /// time, i.e. of distinct partitions and buckets.
+  static constexpr const char* kMaxOpenWriters = "max_open_writers";
+
+  /// Directory for spilling the buffered rows of sorted writes. Sorted writes
+  /// do not spill if empty.
+  static constexpr const char* kSortedWriteSpillDirectory =
+      "sorted_write_spill_directory";
+
+  /// Max bytes of rows buffered by all the sorted file writers of a table
+  /// writer instance. The largest buffers are spilled when the total
+  /// exceeds this. The write fails instead if spilling is disabled.
+  static constexpr const char* kSortedWriteMaxBufferBytes =
+      "sorted_write_max_buffer_bytes";
+
   static InsertExistingPartitionsBehavior insertExistingPartitionsBehavior(
       const Config* config);
 
   static uint32_t maxPartitionsPerWriters(const Config* config);
+
+  static uint32_t maxOpenWriters(const Config* config);
+
+  static std::string sortedWriteSpillDirectory(const Config* config);
+
+  static uint64_t sortedWriteMaxBufferBytes(const Config* config);
 };
 
 } // namespace facebook::velox::connector::hive
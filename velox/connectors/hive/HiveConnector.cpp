@@ -19,6 +19,11 @@
 #include "velox/common/base/Fs.h"
 #include "velox/dwio/common/InputStream.h"
 #include "velox/dwio/common/ReaderFactory.h"
+#include "velox/dwio/common/WriterFactory.h"
+#include "velox/dwio/dwrf/writer/Writer.h"
+#ifdef VELOX_ENABLE_PARQUET
+#include "velox/dwio/parquet/writer/NativeWriter.h"
+#endif
 #include "velox/expression/FieldReference.h"
 #include "velox/type/Conversions.h"
 #include "velox/type/Type.h"
@@ -36,6 +41,12 @@ DEFINE_int32(
     1024,
     "Amount of space for the file handle cache in mb.");
 
+DEFINE_int32(
+    file_metadata_cache_mb,
+    256,
+    "Amount of space for the cache of parsed DWRF and Parquet footers in "
+    "mb. 0 disables the cache.");
+
 namespace facebook::velox::connector::hive {
 namespace {
 static const char* kPath = "$path";
@@ -114,6 +125,7 @@ HiveDataSource::HiveDataSource(
         std::string,
         std::shared_ptr<connector::ColumnHandle>>& columnHandles,
     FileHandleFactory* fileHandleFactory,
+    dwio::common::FileMetadataCache* fileMetadataCache,
     velox::memory::MemoryPool* pool,
     ExpressionEvaluator* expressionEvaluator,
     memory::MemoryAllocator* allocator,
@@ -121,6 +133,7 @@ HiveDataSource::HiveDataSource(
     folly::Executor* executor)
     : outputType_(outputType),
       fileHandleFactory_(fileHandleFactory),
+      fileMetadataCache_(fileMetadataCache),
       pool_(pool),
       readerOpts_(pool),
       expressionEvaluator_(expressionEvaluator),
@@ -311,6 +324,8 @@ void HiveDataSource::addSplit(std::shared_ptr<ConnectorSplit> split) {
   } else {
     readerOpts_.setFileFormat(split_->fileFormat);
   }
+  readerOpts_.setFileMetadataCache(
+      fileMetadataCache_, fileHandle_->uuid.id(), fileHandle_->version);
 
   reader_ = dwio::common::getReaderFactory(readerOpts_.getFileFormat())
                 ->createReader(std::move(input), readerOpts_);
@@ -583,7 +598,24 @@ HiveConnector::HiveConnector(
           std::make_unique<SimpleLRUCache<std::string, FileHandle>>(
               FLAGS_file_handle_cache_mb << 20),
           std::make_unique<FileHandleGenerator>(std::move(properties))),
-      executor_(executor) {}
+      fileMetadataCache_(
+          FLAGS_file_metadata_cache_mb > 0
+              ? std::make_unique<dwio::common::FileMetadataCache>(
+                    static_cast<int64_t>(FLAGS_file_metadata_cache_mb) << 20)
+              : nullptr),
+      executor_(executor) {
+  // HiveDataSink creates its file writers from the registered writer
+  // factories. Registers the writers of the formats built into Velox unless
+  // the application has registered its own.
+  if (!dwio::common::hasWriterFactory(dwio::common::FileFormat::DWRF)) {
+    dwrf::registerDwrfWriterFactory();
+  }
+#ifdef VELOX_ENABLE_PARQUET
+  if (!dwio::common::hasWriterFactory(dwio::common::FileFormat::PARQUET)) {
+    parquet::registerParquetWriterFactory();
+  }
+#endif
+}
 
 VELOX_REGISTER_CONNECTOR_FACTORY(std::make_shared<HiveConnectorFactory>())
 VELOX_REGISTER_CONNECTOR_FACTORY(
@@ -19,6 +19,7 @@
 #include "velox/connectors/hive/HiveConnectorSplit.h"
 #include "velox/connectors/hive/HiveDataSink.h"
 #include "velox/dwio/common/CachedBufferedInput.h"
+#include "velox/dwio/common/FileMetadataCache.h"
 #include "velox/dwio/common/IoStatistics.h"
 #include "velox/dwio/common/Reader.h"
 #include "velox/dwio/common/ScanSpec.h"
@@ -108,6 +109,7 @@ class HiveDataSource : public DataSource {
           std::string,
           std::shared_ptr<connector::ColumnHandle>>& columnHandles,
       FileHandleFactory* FOLLY_NONNULL fileHandleFactory,
+      dwio::common::FileMetadataCache* FOLLY_NULLABLE fileMetadataCache,
       velox::memory::MemoryPool* FOLLY_NONNULL pool,
       ExpressionEvaluator* FOLLY_NONNULL expressionEvaluator,
       memory::MemoryAllocator* FOLLY_NONNULL allocator,
@@ -171,6 +173,8 @@ class HiveDataSource : public DataSource {
   std::unordered_map<std::string, std::shared_ptr<HiveColumnHandle>>
       partitionKeys_;
   FileHandleFactory* FOLLY_NONNULL fileHandleFactory_;
+  // Parsed file footers shared with the other data sources of the connector.
+  dwio::common::FileMetadataCache* FOLLY_NULLABLE fileMetadataCache_;
   velox::memory::MemoryPool* FOLLY_NONNULL pool_;
   std::shared_ptr<dwio::common::IoStatistics> ioStats_;
   std::shared_ptr<common::ScanSpec> scanSpec_;
@@ -224,6 +228,7 @@ class HiveConnector final : public Connector {
         tableHandle,
         columnHandles,
         &fileHandleFactory_,
+        fileMetadataCache_.get(),
         connectorQueryCtx->memoryPool(),
         connectorQueryCtx->expressionEvaluator(),
         connectorQueryCtx->allocator(),
@@ -254,6 +259,8 @@ class HiveConnector final : public Connector {
 
  private:
   FileHandleFactory fileHandleFactory_;
+  // Null if the cache is disabled with --file_metadata_cache_mb=0.
+  std::unique_ptr<dwio::common::FileMetadataCache> fileMetadataCache_;
   folly::Executor* FOLLY_NULLABLE executor_;
 };
 
@@ -17,17 +17,18 @@
 #include "velox/connectors/hive/HiveDataSink.h"
 
 #include "velox/common/base/Fs.h"
+#include "velox/common/base/SuccinctPrinter.h"
 #include "velox/connectors/hive/HiveConfig.h"
 #include "velox/connectors/hive/HiveConnector.h"
+#include "velox/connectors/hive/HivePartitionFunction.h"
 #include "velox/connectors/hive/HivePartitionUtil.h"
-#include "velox/dwio/dwrf/writer/Writer.h"
+#include "velox/connectors/hive/SortingWriter.h"
 
 #include <boost/lexical_cast.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
-using namespace facebook::velox::dwrf;
-using WriterConfig = facebook::velox::dwrf::Config;
+#include <numeric>
 
 namespace facebook::velox::connector::hive {
 
@@ -48,6 +49,72 @@ std::vector<column_index_t> getPartitionChannels(
   return channels;
 }
 
+// Returns the channels of 'names' in 'inputType'.
+std::vector<column_index_t> getChannels(
+    const RowTypePtr& inputType,
+    const std::vector<std::string>& names) {
+  std::vector<column_index_t> channels;
+  channels.reserve(names.size());
+  for (const auto& name : names) {
+    channels.push_back(inputType->getChildIdx(name));
+  }
+  return channels;
+}
+
+std::unique_ptr<core::PartitionFunction> makeBucketFunction(
+    const RowTypePtr& inputType,
+    const std::shared_ptr<const HiveInsertTableHandle>& insertTableHandle) {
+  if (!insertTableHandle->isBucketed()) {
+    return nullptr;
+  }
+  const auto& bucketProperty = insertTableHandle->bucketProperty();
+  const auto bucketCount = bucketProperty->bucketCount();
+  // Each bucket is its own partition.
+  std::vector<int> bucketToPartition(bucketCount);
+  std::iota(bucketToPartition.begin(), bucketToPartition.end(), 0);
+  return std::make_unique<HivePartitionFunction>(
+      bucketCount,
+      std::move(bucketToPartition),
+      getChannels(inputType, bucketProperty->bucketedBy()));
+}
+
+std::vector<column_index_t> getSortChannels(
+    const RowTypePtr& inputType,
+    const std::shared_ptr<const HiveInsertTableHandle>& insertTableHandle) {
+  if (!insertTableHandle->isBucketed()) {
+    return {};
+  }
+  std::vector<std::string> names;
+  for (const auto& column : insertTableHandle->bucketProperty()->sortedBy()) {
+    names.push_back(column->sortColumn());
+  }
+  return getChannels(inputType, names);
+}
+
+std::vector<CompareFlags> getSortCompareFlags(
+    const std::shared_ptr<const HiveInsertTableHandle>& insertTableHandle) {
+  if (!insertTableHandle->isBucketed()) {
+    return {};
+  }
+  std::vector<CompareFlags> compareFlags;
+  for (const auto& column : insertTableHandle->bucketProperty()->sortedBy()) {
+    const auto& sortOrder = column->sortOrder();
+    compareFlags.push_back(
+        {sortOrder.isNullsFirst(), sortOrder.isAscending(), false, false});
+  }
+  return compareFlags;
+}
+
+// Hive identifies the bucket of a file by the leading number of its name.
+std::string makeBucketFileName(
+    std::optional<uint32_t> bucketId,
+    const std::string& fileName) {
+  if (!bucketId.has_value()) {
+    return fileName;
+  }
+  return fmt::format("{:06}_{}", bucketId.value(), fileName);
+}
+
 std::string makePartitionDirectory(
     const std::string& tableDirectory,
     const std::optional<std::string>& partitionSubdirectory) {
@@ -80,11 +147,21 @@ HiveDataSink::HiveDataSink(
                                             HiveConfig::maxPartitionsPerWriters(
                                                 connectorQueryCtx_->config()),
                                             connectorQueryCtx_->memoryPool())
-                                      : nullptr) {}
+                                      : nullptr),
+      bucketFunction_(makeBucketFunction(inputType_, insertTableHandle_)),
+      sortChannels_(getSortChannels(inputType_, insertTableHandle_)),
+      sortCompareFlags_(getSortCompareFlags(insertTableHandle_)),
+      maxOpenWriters_(
+          HiveConfig::maxOpenWriters(connectorQueryCtx_->config())),
+      sortedWriteMaxBufferBytes_(
+          HiveConfig::sortedWriteMaxBufferBytes(connectorQueryCtx_->config())) {
+}
 
 void HiveDataSink::appendData(RowVectorPtr input) {
-  // Write to unpartitioned table.
-  if (partitionChannels_.empty()) {
+  spillSortingWriters();
+
+  // Write to unpartitioned and unbucketed table.
+  if (partitionChannels_.empty() && bucketFunction_ == nullptr) {
     ensureSingleWriter();
 
     writers_[0]->write(input);
@@ -92,40 +169,79 @@ void HiveDataSink::appendData(RowVectorPtr input) {
     return;
   }
 
-  // Write to partitioned table.
-  partitionIdGenerator_->run(input, partitionIds_);
+  // Write to partitioned or bucketed table.
+  computeRowWriters(input);
 
-  ensurePartitionWriters();
-
-  for (column_index_t i = 0; i < input->childrenSize(); i++) {
-    input->childAt(i)->loadedVector();
-  }
-
-  const auto numPartitions = partitionIdGenerator_->numPartitions();
-
-  // All inputs belong to a single partition.
-  if (numPartitions == 1) {
+  // All inputs belong to a single partition and bucket.
+  if (writers_.size() == 1) {
     writers_[0]->write(input);
     writerInfo_[0]->numWrittenRows += input->size();
     return;
   }
 
-  computePartitionRowCountsAndIndices();
+  computeWriterRowCountsAndIndices();
 
-  for (auto id = 0; id < numPartitions; id++) {
-    vector_size_t partitionSize = partitionSizes_[id];
-    if (partitionSize == 0) {
+  for (auto index = 0; index < writers_.size(); index++) {
+    vector_size_t writerSize = writerSizes_[index];
+    if (writerSize == 0) {
       continue;
     }
 
-    RowVectorPtr writerInput = partitionSize == input->size()
+    RowVectorPtr writerInput = writerSize == input->size()
         ? input
-        : exec::wrap(partitionSize, partitionRows_[id], input);
-    writers_[id]->write(writerInput);
-    writerInfo_[id]->numWrittenRows += partitionSize;
+        : exec::wrap(writerSize, writerRows_[index], input);
+    writers_[index]->write(writerInput);
+    writerInfo_[index]->numWrittenRows += writerSize;
   }
 }
 
+void HiveDataSink::computeRowWriters(const RowVectorPtr& input) {
+  const auto numRows = input->size();
+  if (partitionIdGenerator_ != nullptr) {
+    partitionIdGenerator_->run(input, partitionIds_);
+  }
+
+  for (column_index_t i = 0; i < input->childrenSize(); i++) {
+    input->childAt(i)->loadedVector();
+  }
+
+  if (bucketFunction_ != nullptr) {
+    bucketFunction_->partition(*input, bucketIds_);
+  }
+
+  rowWriters_.resize(numRows);
+  for (auto row = 0; row < numRows; row++) {
+    rowWriters_[row] = ensureWriter(
+        partitionIdGenerator_ != nullptr ? partitionIds_[row] : 0,
+        bucketFunction_ != nullptr ? bucketIds_[row] : 0);
+  }
+}
+
+uint32_t HiveDataSink::ensureWriter(uint64_t partitionId, uint32_t bucketId) {
+  const auto key = (partitionId << 32) | bucketId;
+  auto it = writerIndices_.find(key);
+  if (it != writerIndices_.end()) {
+    return it->second;
+  }
+  std::optional<std::string> partitionName;
+  if (partitionIdGenerator_ != nullptr) {
+    partitionName = partitionIdGenerator_->partitionName(partitionId);
+  }
+  std::optional<uint32_t> bucket;
+  if (bucketFunction_ != nullptr) {
+    bucket = bucketId;
+  }
+  const uint32_t index = writers_.size();
+  VELOX_USER_CHECK_LT(
+      index,
+      maxOpenWriters_,
+      "Exceeded limit of {} open writers.",
+      maxOpenWriters_);
+  appendWriter(partitionName, bucket);
+  writerIndices_.emplace(key, index);
+  return index;
+}
+
 std::vector<std::string> HiveDataSink::finish() const {
   std::vector<std::string> partitionUpdates;
   partitionUpdates.reserve(writerInfo_.size());
@@ -165,78 +281,109 @@ void HiveDataSink::close() {
   }
 }
 
-void HiveDataSink::ensureSingleWriter() {
-  if (writers_.empty()) {
-    appendWriter(std::nullopt);
+void HiveDataSink::spillSortingWriters() {
+  uint64_t totalBytes = 0;
+  for (const auto* writer : sortingWriters_) {
+    totalBytes += writer->bufferedBytes();
+  }
+  if (totalBytes <= sortedWriteMaxBufferBytes_) {
+    return;
+  }
+  VELOX_USER_CHECK(
+      sortingWriters_[0]->canSpill(),
+      "Sorted write buffers of {} exceed {} of {}. Set {} to spill them.",
+      succinctBytes(totalBytes),
+      HiveConfig::kSortedWriteMaxBufferBytes,
+      succinctBytes(sortedWriteMaxBufferBytes_),
+      HiveConfig::kSortedWriteSpillDirectory);
+  // Spill the largest buffers until the total is at half of the budget, so
+  // that every input does not spill a small run.
+  auto writers = sortingWriters_;
+  std::sort(writers.begin(), writers.end(), [](auto* left, auto* right) {
+    return left->bufferedBytes() > right->bufferedBytes();
+  });
+  for (auto* writer : writers) {
+    if (totalBytes <= sortedWriteMaxBufferBytes_ / 2) {
+      break;
+    }
+    totalBytes -= writer->bufferedBytes();
+    writer->spill();
   }
 }
 
-void HiveDataSink::ensurePartitionWriters() {
-  const auto numPartitions = partitionIdGenerator_->numPartitions();
-  const auto numWriters = writers_.size();
-
-  VELOX_CHECK_LE(numWriters, numPartitions);
-
-  if (numWriters < numPartitions) {
-    writers_.reserve(numPartitions);
-    writerInfo_.reserve(numPartitions);
-    for (auto id = numWriters; id < numPartitions; id++) {
-      appendWriter(partitionIdGenerator_->partitionName(id));
-    }
+void HiveDataSink::ensureSingleWriter() {
+  if (writers_.empty()) {
+    appendWriter(std::nullopt, std::nullopt);
   }
 }
 
 void HiveDataSink::appendWriter(
-    const std::optional<std::string>& partitionName) {
-  auto config = std::make_shared<WriterConfig>();
+    const std::optional<std::string>& partitionName,
+    std::optional<uint32_t> bucketId) {
   // TODO: Wire up serde properties to writer configs.
-
-  facebook::velox::dwrf::WriterOptions options;
-  options.config = config;
+  dwio::common::FileWriterOptions options;
   options.schema = inputType_;
-  // Without explicitly setting flush policy, the default memory based flush
-  // policy is used.
-  auto writerParameters = getWriterParameters(partitionName);
+  options.memoryPool = connectorQueryCtx_->memoryPool();
+  auto writerParameters = getWriterParameters(partitionName, bucketId);
   auto writePath = fs::path(writerParameters->writeDirectory()) /
       writerParameters->writeFileName();
 
   auto sink = dwio::common::DataSink::create(writePath);
-  writers_.push_back(std::make_unique<Writer>(
-      options, std::move(sink), *connectorQueryCtx_->memoryPool()));
-  writerInfo_.push_back(std::make_shared<HiveWriterInfo>(*writerParameters));
+  auto writer =
+      dwio::common::getWriterFactory(insertTableHandle_->storageFormat())
+          ->createWriter(std::move(sink), options);
+  if (!sortChannels_.empty()) {
+    const auto spillDirectory =
+        HiveConfig::sortedWriteSpillDirectory(connectorQueryCtx_->config());
+    auto sortingWriter = std::make_unique<SortingWriter>(
+        std::move(writer),
+        inputType_,
+        sortChannels_,
+        sortCompareFlags_,
+        connectorQueryCtx_->memoryPool(),
+        spillDirectory.empty()
+            ? ""
+            : (fs::path(spillDirectory) / makeUuid()).string());
+    sortingWriters_.push_back(sortingWriter.get());
+    writer = std::move(sortingWriter);
+  }
+  writers_.push_back(std::move(writer));
+  writerInfo_.push_back(
+      std::make_shared<HiveWriterInfo>(*writerParameters, bucketId));
 }
 
-void HiveDataSink::computePartitionRowCountsAndIndices() {
-  const auto numPartitions = partitionIdGenerator_->numPartitions();
-  const auto numRows = partitionIds_.size();
+void HiveDataSink::computeWriterRowCountsAndIndices() {
+  const auto numWriters = writers_.size();
+  const auto numRows = rowWriters_.size();
 
-  partitionSizes_.resize(numPartitions);
-  std::fill(partitionSizes_.begin(), partitionSizes_.end(), 0);
+  writerSizes_.resize(numWriters);
+  std::fill(writerSizes_.begin(), writerSizes_.end(), 0);
 
-  partitionRows_.resize(numPartitions, nullptr);
-  rawPartitionRows_.resize(numPartitions);
-  for (auto id = 0; id < numPartitions; id++) {
-    if (partitionRows_[id] == nullptr ||
-        partitionRows_[id]->capacity() < numRows * sizeof(vector_size_t)) {
-      partitionRows_[id] =
+  writerRows_.resize(numWriters, nullptr);
+  rawWriterRows_.resize(numWriters);
+  for (auto index = 0; index < numWriters; index++) {
+    if (writerRows_[index] == nullptr ||
+        writerRows_[index]->capacity() < numRows * sizeof(vector_size_t)) {
+      writerRows_[index] =
           allocateIndices(numRows, connectorQueryCtx_->memoryPool());
-      rawPartitionRows_[id] = partitionRows_[id]->asMutable<vector_size_t>();
+      rawWriterRows_[index] = writerRows_[index]->asMutable<vector_size_t>();
     }
   }
 
   for (auto row = 0; row < numRows; row++) {
-    uint64_t id = partitionIds_[row];
-    rawPartitionRows_[id][partitionSizes_[id]] = row;
-    partitionSizes_[id]++;
+    const auto index = rowWriters_[row];
+    rawWriterRows_[index][writerSizes_[index]] = row;
+    writerSizes_[index]++;
   }
 
-  for (auto id = 0; id < numPartitions; id++) {
-    partitionRows_[id]->setSize(partitionSizes_[id] * sizeof(vector_size_t));
+  for (auto index = 0; index < numWriters; index++) {
+    writerRows_[index]->setSize(writerSizes_[index] * sizeof(vector_size_t));
   }
 }
 
 std::shared_ptr<const HiveWriterParameters> HiveDataSink::getWriterParameters(
-    const std::optional<std::string>& partition) const {
+    const std::optional<std::string>& partition,
+    std::optional<uint32_t> bucketId) const {
   auto updateMode = getUpdateMode();
 
   std::string targetFileName;
@@ -248,6 +395,7 @@ std::shared_ptr<const HiveWriterParameters> HiveDataSink::getWriterParameters(
           connectorQueryCtx_->taskId(),
           connectorQueryCtx_->driverId(),
           makeUuid());
+      targetFileName = makeBucketFileName(bucketId, targetFileName);
       writeFileName = targetFileName;
       break;
     }
@@ -257,6 +405,7 @@ std::shared_ptr<const HiveWriterParameters> HiveDataSink::getWriterParameters(
           connectorQueryCtx_->taskId(),
           connectorQueryCtx_->driverId(),
           0);
+      targetFileName = makeBucketFileName(bucketId, targetFileName);
       writeFileName =
           fmt::format(".tmp.velox.{}_{}", targetFileName, makeUuid());
       break;
@@ -17,13 +17,12 @@
 
 #include "velox/connectors/Connector.h"
 #include "velox/connectors/hive/PartitionIdGenerator.h"
-
-namespace facebook::velox::dwrf {
-class Writer;
-}
+#include "velox/core/PlanNode.h"
+#include "velox/dwio/common/WriterFactory.h"
 
 namespace facebook::velox::connector::hive {
 class HiveColumnHandle;
+class SortingWriter;
 
 /// Location related properties of the Hive table to be written.
 class LocationHandle {
@@ -62,6 +61,62 @@ class LocationHandle {
   const TableType tableType_;
 };
 
+/// A column the rows of each written file are sorted on.
+class HiveSortingColumn {
+ public:
+  HiveSortingColumn(std::string sortColumn, core::SortOrder sortOrder)
+      : sortColumn_(std::move(sortColumn)), sortOrder_(std::move(sortOrder)) {}
+
+  const std::string& sortColumn() const {
+    return sortColumn_;
+  }
+
+  const core::SortOrder& sortOrder() const {
+    return sortOrder_;
+  }
+
+ private:
+  const std::string sortColumn_;
+  const core::SortOrder sortOrder_;
+};
+
+/// Bucketing of the Hive table to be written. The rows are assigned to
+/// 'bucketCount' buckets by the Hive hash of the 'bucketedBy' columns, as in
+/// HivePartitionFunction, and each bucket of each partition is written to its
+/// own file. If 'sortedBy' is not empty, the rows of each file are sorted on
+/// these columns.
+class HiveBucketProperty {
+ public:
+  HiveBucketProperty(
+      int32_t bucketCount,
+      std::vector<std::string> bucketedBy,
+      std::vector<std::shared_ptr<const HiveSortingColumn>> sortedBy = {})
+      : bucketCount_(bucketCount),
+        bucketedBy_(std::move(bucketedBy)),
+        sortedBy_(std::move(sortedBy)) {
+    VELOX_USER_CHECK_GT(bucketCount_, 0, "Bucket count must be positive");
+    VELOX_USER_CHECK(!bucketedBy_.empty(), "Bucketed by columns are missing");
+  }
+
+  int32_t bucketCount() const {
+    return bucketCount_;
+  }
+
+  const std::vector<std::string>& bucketedBy() const {
+    return bucketedBy_;
+  }
+
+  const std::vector<std::shared_ptr<const HiveSortingColumn>>& sortedBy()
+      const {
+    return sortedBy_;
+  }
+
+ private:
+  const int32_t bucketCount_;
+  const std::vector<std::string> bucketedBy_;
+  const std::vector<std::shared_ptr<const HiveSortingColumn>> sortedBy_;
+};
+
 /**
  * Represents a request for Hive write.
  */
@@ -69,9 +124,13 @@ class HiveInsertTableHandle : public ConnectorInsertTableHandle {
  public:
   HiveInsertTableHandle(
       std::vector<std::shared_ptr<const HiveColumnHandle>> inputColumns,
-      std::shared_ptr<const LocationHandle> locationHandle)
+      std::shared_ptr<const LocationHandle> locationHandle,
+      dwio::common::FileFormat storageFormat = dwio::common::FileFormat::DWRF,
+      std::shared_ptr<const HiveBucketProperty> bucketProperty = nullptr)
       : inputColumns_(std::move(inputColumns)),
-        locationHandle_(std::move(locationHandle)) {}
+        locationHandle_(std::move(locationHandle)),
+        storageFormat_(storageFormat),
+        bucketProperty_(std::move(bucketProperty)) {}
 
   virtual ~HiveInsertTableHandle() = default;
 
@@ -84,13 +143,31 @@ class HiveInsertTableHandle : public ConnectorInsertTableHandle {
     return locationHandle_;
   }
 
+  /// Returns the file format of the written files. The writers are created by
+  /// the WriterFactory registered for the format.
+  dwio::common::FileFormat storageFormat() const {
+    return storageFormat_;
+  }
+
+  /// Returns the bucketing of the table or nullptr if the table is not
+  /// bucketed.
+  const std::shared_ptr<const HiveBucketProperty>& bucketProperty() const {
+    return bucketProperty_;
+  }
+
   bool isPartitioned() const;
 
+  bool isBucketed() const {
+    return bucketProperty_ != nullptr;
+  }
+
   bool isInsertTable() const;
 
  private:
   const std::vector<std::shared_ptr<const HiveColumnHandle>> inputColumns_;
   const std::shared_ptr<const LocationHandle> locationHandle_;
+  const dwio::common::FileFormat storageFormat_;
+  const std::shared_ptr<const HiveBucketProperty> bucketProperty_;
 };
 
 /// Parameters for Hive writers.
@@ -173,10 +250,14 @@ class HiveWriterParameters {
 };
 
 struct HiveWriterInfo {
-  explicit HiveWriterInfo(HiveWriterParameters parameters)
-      : writerParameters(std::move(parameters)) {}
+  HiveWriterInfo(
+      HiveWriterParameters parameters,
+      std::optional<uint32_t> bucketId = std::nullopt)
+      : writerParameters(std::move(parameters)), bucketId(bucketId) {}
 
   const HiveWriterParameters writerParameters;
+  // Bucket of the rows in the file if the table is bucketed.
+  const std::optional<uint32_t> bucketId;
   vector_size_t numWrittenRows = 0;
 };
 
@@ -195,22 +276,34 @@ class HiveDataSink : public DataSink {
   void close() override;
 
  private:
-  // Pass 0 as partitionId when creating the single writer for an
-  // unpartitioned table.
-  void appendWriter(const std::optional<std::string>& partitionName);
+  // Creates the writer for the rows of 'partitionName' and 'bucketId'. Pass
+  // std::nullopt for an unpartitioned or unbucketed table.
+  void appendWriter(
+      const std::optional<std::string>& partitionName,
+      std::optional<uint32_t> bucketId);
 
   // Make sure to create the one writer for unpartitioned table.
   void ensureSingleWriter();
 
-  // Make sure every partition has one writer created for it.
-  void ensurePartitionWriters();
+  // Spills the largest buffers of 'sortingWriters_' if their total exceeds
+  // 'sortedWriteMaxBufferBytes_'. Called before each input.
+  void spillSortingWriters();
+
+  // Returns the index in 'writers_' of the writer for 'partitionId' and
+  // 'bucketId'. Creates the writer if it does not exist yet.
+  uint32_t ensureWriter(uint64_t partitionId, uint32_t bucketId);
+
+  // Computes the writer index of every row of 'input' into 'rowWriters_'
+  // from the partition and bucket of the row.
+  void computeRowWriters(const RowVectorPtr& input);
 
   // Compute the number of rows as well as the actual row indices corresponding
-  // to every partition ID, based on the ID labeling of partitionIds_.
-  void computePartitionRowCountsAndIndices();
+  // to every writer, based on the labeling of rowWriters_.
+  void computeWriterRowCountsAndIndices();
 
   std::shared_ptr<const HiveWriterParameters> getWriterParameters(
-      const std::optional<std::string>& partition) const;
+      const std::optional<std::string>& partition,
+      std::optional<uint32_t> bucketId) const;
 
   HiveWriterParameters::UpdateMode getUpdateMode() const;
 
@@ -220,19 +313,37 @@ class HiveDataSink : public DataSink {
   const CommitStrategy commitStrategy_;
   const std::vector<column_index_t> partitionChannels_;
   const std::unique_ptr<PartitionIdGenerator> partitionIdGenerator_;
-
-  // Below are structures for partitions from all inputs. writerInfo_ and
-  // writers_ are both indexed by partitionId.
+  // Assigns the rows to buckets. nullptr if the table is not bucketed.
+  const std::unique_ptr<core::PartitionFunction> bucketFunction_;
+  // Channels and sort orders of the columns the files are sorted on. Empty
+  // if the files are not sorted.
+  const std::vector<column_index_t> sortChannels_;
+  const std::vector<CompareFlags> sortCompareFlags_;
+  // Max number of entries in 'writers_'.
+  const uint32_t maxOpenWriters_;
+  // Max bytes buffered by all of 'sortingWriters_'.
+  const uint64_t sortedWriteMaxBufferBytes_;
+
+  // Below are structures for partitions and buckets from all inputs.
+  // writerInfo_ and writers_ are both indexed by the writer index.
+  // writerIndices_ maps the partition id and bucket id of a writer to its
+  // index.
   std::vector<std::shared_ptr<HiveWriterInfo>> writerInfo_;
-  std::vector<std::unique_ptr<dwrf::Writer>> writers_;
-
-  // Below are structures updated when processing current input. partitionIds_
-  // are indexed by the row of input_. partitionRows_, rawPartitionRows_ and
-  // partitionSizes_ are indexed by partitionId.
+  std::vector<std::unique_ptr<dwio::common::FileWriter>> writers_;
+  folly::F14FastMap<uint64_t, uint32_t> writerIndices_;
+  // The writers in 'writers_' that sort their files.
+  std::vector<SortingWriter*> sortingWriters_;
+
+  // Below are structures updated when processing current input.
+  // partitionIds_, bucketIds_ and rowWriters_ are indexed by the row of
+  // input_. writerRows_, rawWriterRows_ and writerSizes_ are indexed by the
+  // writer index.
   raw_vector<uint64_t> partitionIds_;
-  std::vector<BufferPtr> partitionRows_;
-  std::vector<vector_size_t*> rawPartitionRows_;
-  std::vector<vector_size_t> partitionSizes_;
+  std::vector<uint32_t> bucketIds_;
+  raw_vector<uint32_t> rowWriters_;
+  std::vector<BufferPtr> writerRows_;
+  std::vector<vector_size_t*> rawWriterRows_;
+  std::vector<vector_size_t> writerSizes_;
 };
 
 } // namespace facebook::velox::connector::hive
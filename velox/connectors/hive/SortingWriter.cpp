@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/connectors/hive/SortingWriter.h"
+#include "velox/common/file/FileSystems.h"
+#include "velox/exec/PrefixSort.h"
+
+namespace facebook::velox::connector::hive {
+
+SortingWriter::SortingWriter(
+    std::unique_ptr<dwio::common::FileWriter> writer,
+    const RowTypePtr& inputType,
+    const std::vector<column_index_t>& sortColumns,
+    std::vector<CompareFlags> sortCompareFlags,
+    memory::MemoryPool* pool,
+    std::string spillDirectory)
+    : writer_(std::move(writer)),
+      inputType_(inputType),
+      sortCompareFlags_(std::move(sortCompareFlags)),
+      pool_(pool),
+      spillDirectory_(std::move(spillDirectory)) {
+  VELOX_CHECK(!sortColumns.empty());
+  VELOX_CHECK_EQ(sortColumns.size(), sortCompareFlags_.size());
+  std::vector<TypePtr> keyTypes;
+  std::vector<TypePtr> dependentTypes;
+  std::vector<TypePtr> types;
+  std::vector<std::string> names;
+  // Store the sort columns first in the row container as in OrderBy.
+  std::vector<bool> isSortColumn(inputType_->size(), false);
+  for (auto i = 0; i < sortColumns.size(); ++i) {
+    const auto channel = sortColumns[i];
+    VELOX_CHECK(!isSortColumn[channel], "Duplicate sort column");
+    isSortColumn[channel] = true;
+    columnMap_.emplace_back(i, channel);
+    keyTypes.push_back(inputType_->childAt(channel));
+    types.push_back(keyTypes.back());
+    names.push_back(inputType_->nameOf(channel));
+  }
+  for (column_index_t channel = 0, nextChannel = sortColumns.size();
+       channel < inputType_->size();
+       ++channel) {
+    if (isSortColumn[channel]) {
+      continue;
+    }
+    columnMap_.emplace_back(nextChannel++, channel);
+    dependentTypes.push_back(inputType_->childAt(channel));
+    types.push_back(dependentTypes.back());
+    names.push_back(inputType_->nameOf(channel));
+  }
+  data_ = std::make_unique<exec::RowContainer>(keyTypes, dependentTypes, pool_);
+  internalStoreType_ = ROW(std::move(names), std::move(types));
+  outputBatchSize_ = data_->estimatedNumRowsPerBatch(kBatchSizeInBytes);
+}
+
+SortingWriter::~SortingWriter() {
+  // Frees the spill files of an aborted write.
+  spiller_.reset();
+  removeSpillDirectory();
+}
+
+void SortingWriter::write(const VectorPtr& data) {
+  auto* input = data->as<RowVector>();
+  VELOX_CHECK_NOT_NULL(input, "SortingWriter expects a RowVector");
+
+  SelectivityVector allRows(input->size());
+  std::vector<char*> rows(input->size());
+  for (auto row = 0; row < input->size(); ++row) {
+    rows[row] = data_->newRow();
+  }
+  for (const auto& projection : columnMap_) {
+    DecodedVector decoded(*input->childAt(projection.outputChannel), allRows);
+    for (auto i = 0; i < input->size(); ++i) {
+      data_->store(decoded, i, rows[i], projection.inputChannel);
+    }
+  }
+  numRows_ += input->size();
+}
+
+void SortingWriter::spill() {
+  VELOX_CHECK(canSpill());
+  if (data_->numRows() == 0) {
+    return;
+  }
+  if (spiller_ == nullptr) {
+    filesystems::getFileSystem(spillDirectory_, nullptr)
+        ->mkdir(spillDirectory_);
+    spillDirectoryCreated_ = true;
+    spiller_ = std::make_unique<exec::Spiller>(
+        exec::Spiller::Type::kOrderBy,
+        data_.get(),
+        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
+        internalStoreType_,
+        data_->keyTypes().size(),
+        sortCompareFlags_,
+        fmt::format("{}/spill", spillDirectory_),
+        std::numeric_limits<int64_t>::max(),
+        0,
+        exec::Spiller::spillPool(),
+        nullptr);
+    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+  }
+  // Spill all the rows and free the memory of 'data_'.
+  spiller_->spill(0, 0);
+}
+
+void SortingWriter::close() {
+  if (numRows_ > 0) {
+    if (spiller_ == nullptr) {
+      writeSorted();
+    } else {
+      writeSpilled();
+    }
+  }
+  VELOX_CHECK_EQ(numRowsWritten_, numRows_);
+  data_.reset();
+  spiller_.reset();
+  removeSpillDirectory();
+  writer_->close();
+}
+
+void SortingWriter::writeSorted() {
+  VELOX_CHECK_EQ(numRows_, data_->numRows());
+  std::vector<char*> rows(numRows_);
+  exec::RowContainerIterator iter;
+  data_->listRows(&iter, numRows_, rows.data());
+  exec::PrefixSort::sort(
+      data_.get(),
+      sortCompareFlags_,
+      folly::Range<char**>(rows.data(), rows.size()));
+
+  while (numRowsWritten_ < numRows_) {
+    auto output = prepareOutput();
+    for (const auto& projection : columnMap_) {
+      data_->extractColumn(
+          rows.data() + numRowsWritten_,
+          output->size(),
+          projection.inputChannel,
+          output->childAt(projection.outputChannel));
+    }
+    numRowsWritten_ += output->size();
+    writer_->write(output);
+  }
+}
+
+void SortingWriter::writeSpilled() {
+  // There is one partition, so all the rows are spilled or merged from
+  // 'data_' as in OrderBy.
+  auto nonSpilledRows = spiller_->finishSpill();
+  VELOX_CHECK(nonSpilledRows.empty());
+  auto merge = spiller_->startMerge(0);
+
+  std::vector<const RowVector*> sources(outputBatchSize_);
+  std::vector<vector_size_t> sourceRows(outputBatchSize_);
+  while (numRowsWritten_ < numRows_) {
+    auto output = prepareOutput();
+    int32_t outputRow = 0;
+    int32_t outputSize = 0;
+    bool isEndOfBatch = false;
+    while (outputRow + outputSize < output->size()) {
+      auto* stream = merge->next();
+      VELOX_CHECK_NOT_NULL(stream);
+      sources[outputSize] = &stream->current();
+      sourceRows[outputSize] = stream->currentIndex(&isEndOfBatch);
+      ++outputSize;
+      if (FOLLY_UNLIKELY(isEndOfBatch)) {
+        // Copy out the rows before the stream reads its next batch in pop().
+        exec::gatherCopy(
+            output.get(),
+            outputRow,
+            outputSize,
+            sources,
+            sourceRows,
+            columnMap_);
+        outputRow += outputSize;
+        outputSize = 0;
+      }
+      stream->pop();
+    }
+    if (outputSize != 0) {
+      exec::gatherCopy(
+          output.get(), outputRow, outputSize, sources, sourceRows, columnMap_);
+    }
+    numRowsWritten_ += output->size();
+    writer_->write(output);
+  }
+}
+
+void SortingWriter::removeSpillDirectory() {
+  if (!spillDirectoryCreated_) {
+    return;
+  }
+  spillDirectoryCreated_ = false;
+  try {
+    filesystems::getFileSystem(spillDirectory_, nullptr)
+        ->rmdir(spillDirectory_);
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Failed to remove sorted write spill directory '"
+               << spillDirectory_ << "': " << e.what();
+  }
+}
+
+RowVectorPtr SortingWriter::prepareOutput() {
+  const auto batchSize =
+      std::min<int64_t>(numRows_ - numRowsWritten_, outputBatchSize_);
+  return std::static_pointer_cast<RowVector>(
+      BaseVector::create(inputType_, batchSize, pool_));
+}
+
+} // namespace facebook::velox::connector::hive
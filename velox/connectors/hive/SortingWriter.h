@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/dwio/common/FileWriter.h"
+#include "velox/exec/OperatorUtils.h"
+
+namespace facebook::velox::connector::hive {
+
+/// FileWriter that writes the rows of a file sorted on a set of columns.
+/// Buffers the rows in a RowContainer and writes them in sorted order to the
+/// wrapped writer on close(). If a spill directory is given, the owner can
+/// spill the buffered rows in sorted runs with spill(). The runs are merged on
+/// close(). The spill directory is created on the first spill and removed with
+/// its files on close() or, if the write is aborted, on destruction.
+class SortingWriter : public dwio::common::FileWriter {
+ public:
+  /// @param writer The writer of the file.
+  /// @param inputType Type of the written vectors.
+  /// @param sortColumns Channels of the sort columns in 'inputType'.
+  /// @param sortCompareFlags Sort order of each of 'sortColumns'.
+  /// @param spillDirectory Directory of the spill files of this writer only.
+  /// Empty to disable spilling.
+  SortingWriter(
+      std::unique_ptr<dwio::common::FileWriter> writer,
+      const RowTypePtr& inputType,
+      const std::vector<column_index_t>& sortColumns,
+      std::vector<CompareFlags> sortCompareFlags,
+      memory::MemoryPool* FOLLY_NONNULL pool,
+      std::string spillDirectory);
+
+  ~SortingWriter() override;
+
+  void write(const VectorPtr& data) override;
+
+  /// No-op. The rows are written once all of them are known in close().
+  void flush() override {}
+
+  void close() override;
+
+  /// Returns the memory held by the buffered rows.
+  uint64_t bufferedBytes() const {
+    return data_ != nullptr ? data_->allocatedBytes() : 0;
+  }
+
+  /// True if the buffered rows can be spilled.
+  bool canSpill() const {
+    return !spillDirectory_.empty();
+  }
+
+  /// Spills all the buffered rows as a sorted run. canSpill() must be true.
+  void spill();
+
+ private:
+  // Max bytes of a batch written to 'writer_'.
+  static constexpr int32_t kBatchSizeInBytes{2 * 1024 * 1024};
+
+  // Sorts the buffered rows and writes them to 'writer_'.
+  void writeSorted();
+
+  // Merges the spilled runs and writes them to 'writer_'.
+  void writeSpilled();
+
+  // Returns a vector of 'inputType_' for the next at most 'outputBatchSize_'
+  // rows.
+  RowVectorPtr prepareOutput();
+
+  // Removes 'spillDirectory_' and the spill files in it if created by spill().
+  void removeSpillDirectory();
+
+  const std::unique_ptr<dwio::common::FileWriter> writer_;
+  const RowTypePtr inputType_;
+  const std::vector<CompareFlags> sortCompareFlags_;
+  memory::MemoryPool* const pool_;
+  const std::string spillDirectory_;
+
+  // Maps the columns of 'data_' to the columns of the input. The sort columns
+  // come first in 'data_'.
+  std::vector<exec::IdentityProjection> columnMap_;
+
+  // Type of the rows in 'data_' and in the spill files.
+  RowTypePtr internalStoreType_;
+
+  std::unique_ptr<exec::RowContainer> data_;
+
+  std::unique_ptr<exec::Spiller> spiller_;
+
+  // True if spill() created 'spillDirectory_'.
+  bool spillDirectoryCreated_{false};
+
+  // Maximum number of rows of a batch written to 'writer_'.
+  vector_size_t outputBatchSize_;
+
+  // Number of rows written to 'this'.
+  int64_t numRows_{0};
+
+  // Number of rows written to 'writer_'.
+  int64_t numRowsWritten_{0};
+};
+
+} // namespace facebook::velox::connector::hive
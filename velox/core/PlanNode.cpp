@@ -541,12 +541,14 @@ WindowNode::WindowNode(
     std::vector<SortOrder> sortingOrders,
     std::vector<std::string> windowColumnNames,
     std::vector<Function> windowFunctions,
-    PlanNodePtr source)
+    PlanNodePtr source,
+    bool inputsSorted)
     : PlanNode(std::move(id)),
       partitionKeys_(std::move(partitionKeys)),
       sortingKeys_(std::move(sortingKeys)),
       sortingOrders_(std::move(sortingOrders)),
       windowFunctions_(std::move(windowFunctions)),
+      inputsSorted_(inputsSorted),
       sources_{std::move(source)},
       outputType_(getWindowOutputType(
           sources_[0]->outputType(),
@@ -562,6 +564,68 @@ WindowNode::WindowNode(
       "Number of sorting keys must be equal to the number of sorting orders");
 }
 
+namespace {
+RowTypePtr getRowNumberOutputType(
+    const RowTypePtr& inputType,
+    const std::optional<std::string>& rowNumberColumnName) {
+  if (!rowNumberColumnName.has_value()) {
+    return inputType;
+  }
+  auto names = inputType->names();
+  auto types = inputType->children();
+  names.push_back(rowNumberColumnName.value());
+  types.push_back(BIGINT());
+  return ROW(std::move(names), std::move(types));
+}
+} // namespace
+
+RowNumberNode::RowNumberNode(
+    PlanNodeId id,
+    std::vector<FieldAccessTypedExprPtr> partitionKeys,
+    const std::optional<std::string>& rowNumberColumnName,
+    std::optional<int32_t> limit,
+    PlanNodePtr source)
+    : PlanNode(std::move(id)),
+      partitionKeys_(std::move(partitionKeys)),
+      limit_(limit),
+      sources_{std::move(source)},
+      outputType_(getRowNumberOutputType(
+          sources_[0]->outputType(),
+          rowNumberColumnName)) {
+  VELOX_CHECK(
+      !limit_.has_value() || limit_.value() > 0,
+      "RowNumber limit must be greater than zero");
+  VELOX_CHECK(
+      rowNumberColumnName.has_value() || limit_.has_value(),
+      "RowNumber must generate a row number or have a limit");
+}
+
+TopNRowNumberNode::TopNRowNumberNode(
+    PlanNodeId id,
+    std::vector<FieldAccessTypedExprPtr> partitionKeys,
+    std::vector<FieldAccessTypedExprPtr> sortingKeys,
+    std::vector<SortOrder> sortingOrders,
+    const std::optional<std::string>& rowNumberColumnName,
+    int32_t limit,
+    PlanNodePtr source)
+    : PlanNode(std::move(id)),
+      partitionKeys_(std::move(partitionKeys)),
+      sortingKeys_(std::move(sortingKeys)),
+      sortingOrders_(std::move(sortingOrders)),
+      limit_(limit),
+      sources_{std::move(source)},
+      outputType_(getRowNumberOutputType(
+          sources_[0]->outputType(),
+          rowNumberColumnName)) {
+  VELOX_CHECK(
+      !sortingKeys_.empty(), "TopNRowNumber must specify sorting keys");
+  VELOX_CHECK_EQ(
+      sortingKeys_.size(),
+      sortingOrders_.size(),
+      "Number of sorting keys must be equal to the number of sorting orders");
+  VELOX_CHECK_GT(limit_, 0, "TopNRowNumber limit must be greater than zero");
+}
+
 namespace {
 void addSortingKeys(
     std::stringstream& stream,
@@ -647,6 +711,10 @@ void OrderByNode::addDetails(std::stringstream& stream) const {
 }
 
 void WindowNode::addDetails(std::stringstream& stream) const {
+  if (inputsSorted_) {
+    stream << "STREAMING ";
+  }
+
   stream << "partition by [";
   if (!partitionKeys_.empty()) {
     addFields(stream, partitionKeys_);
@@ -668,6 +736,40 @@ void WindowNode::addDetails(std::stringstream& stream) const {
   }
 }
 
+void RowNumberNode::addDetails(std::stringstream& stream) const {
+  stream << "partition by [";
+  if (!partitionKeys_.empty()) {
+    addFields(stream, partitionKeys_);
+  }
+  stream << "]";
+
+  if (limit_.has_value()) {
+    stream << " limit " << limit_.value();
+  }
+
+  if (generateRowNumber()) {
+    stream << " " << outputType_->names().back();
+  }
+}
+
+void TopNRowNumberNode::addDetails(std::stringstream& stream) const {
+  stream << "partition by [";
+  if (!partitionKeys_.empty()) {
+    addFields(stream, partitionKeys_);
+  }
+  stream << "] ";
+
+  stream << "order by [";
+  addSortingKeys(stream, sortingKeys_, sortingOrders_);
+  stream << "] ";
+
+  stream << "limit " << limit_;
+
+  if (generateRowNumber()) {
+    stream << " " << outputType_->names().back();
+  }
+}
+
 void PlanNode::toString(
     std::stringstream& stream,
     bool detailed,
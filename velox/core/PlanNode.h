@@ -1728,6 +1728,10 @@ class WindowNode : public PlanNode {
   /// @param windowColumnNames specifies the output column
   /// names for each window function column. So
   /// windowColumnNames.length() = windowFunctions.length().
+  /// @param inputsSorted specifies that the input is already clustered by the
+  /// partition keys and sorted by the sorting keys within each partition. The
+  /// window functions are then evaluated in a streaming fashion, one
+  /// partition at a time, without sorting the input.
   WindowNode(
       PlanNodeId id,
       std::vector<FieldAccessTypedExprPtr> partitionKeys,
@@ -1735,7 +1739,8 @@ class WindowNode : public PlanNode {
       std::vector<SortOrder> sortingOrders,
       std::vector<std::string> windowColumnNames,
       std::vector<Function> windowFunctions,
-      PlanNodePtr source);
+      PlanNodePtr source,
+      bool inputsSorted = false);
 
   const std::vector<PlanNodePtr>& sources() const override {
     return sources_;
@@ -1747,6 +1752,11 @@ class WindowNode : public PlanNode {
     return outputType_;
   }
 
+  bool canSpill(const QueryConfig& queryConfig) const override {
+    // A streaming window holds only one partition in memory at a time.
+    return !inputsSorted_ && queryConfig.windowSpillEnabled();
+  }
+
   const std::vector<FieldAccessTypedExprPtr>& partitionKeys() const {
     return partitionKeys_;
   }
@@ -1763,6 +1773,10 @@ class WindowNode : public PlanNode {
     return windowFunctions_;
   }
 
+  bool inputsSorted() const {
+    return inputsSorted_;
+  }
+
   std::string_view name() const override {
     return "Window";
   }
@@ -1777,6 +1791,126 @@ class WindowNode : public PlanNode {
 
   const std::vector<Function> windowFunctions_;
 
+  const bool inputsSorted_;
+
+  const std::vector<PlanNodePtr> sources_;
+
+  const RowTypePtr outputType_;
+};
+
+/// Computes row_number() OVER (PARTITION BY partitionKeys) for each input row,
+/// i.e. numbers the rows of each partition in the order of arrival. Runs in a
+/// streaming fashion, keeping only a counter per partition. If 'limit' is set,
+/// drops the rows with a row number greater than 'limit'. The output has the
+/// input columns followed by a BIGINT row number column named
+/// 'rowNumberColumnName' if that is set. If there are no partition keys, all
+/// rows are in one partition.
+class RowNumberNode : public PlanNode {
+ public:
+  RowNumberNode(
+      PlanNodeId id,
+      std::vector<FieldAccessTypedExprPtr> partitionKeys,
+      const std::optional<std::string>& rowNumberColumnName,
+      std::optional<int32_t> limit,
+      PlanNodePtr source);
+
+  const std::vector<PlanNodePtr>& sources() const override {
+    return sources_;
+  }
+
+  const RowTypePtr& outputType() const override {
+    return outputType_;
+  }
+
+  const std::vector<FieldAccessTypedExprPtr>& partitionKeys() const {
+    return partitionKeys_;
+  }
+
+  std::optional<int32_t> limit() const {
+    return limit_;
+  }
+
+  bool generateRowNumber() const {
+    return outputType_->size() > sources_[0]->outputType()->size();
+  }
+
+  std::string_view name() const override {
+    return "RowNumber";
+  }
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const std::vector<FieldAccessTypedExprPtr> partitionKeys_;
+
+  const std::optional<int32_t> limit_;
+
+  const std::vector<PlanNodePtr> sources_;
+
+  const RowTypePtr outputType_;
+};
+
+/// Computes row_number() OVER (PARTITION BY partitionKeys ORDER BY
+/// sortingKeys) and keeps only the rows with a row number up to 'limit'. This
+/// is the plan for 'row_number() OVER (...) <= limit'. Keeps at most 'limit'
+/// rows per partition in memory instead of all the input. The output has the
+/// input columns followed by a BIGINT row number column named
+/// 'rowNumberColumnName' if that is set. The output is grouped by partition
+/// and sorted by the sorting keys within each partition. If there are no
+/// partition keys, all rows are in one partition.
+class TopNRowNumberNode : public PlanNode {
+ public:
+  TopNRowNumberNode(
+      PlanNodeId id,
+      std::vector<FieldAccessTypedExprPtr> partitionKeys,
+      std::vector<FieldAccessTypedExprPtr> sortingKeys,
+      std::vector<SortOrder> sortingOrders,
+      const std::optional<std::string>& rowNumberColumnName,
+      int32_t limit,
+      PlanNodePtr source);
+
+  const std::vector<PlanNodePtr>& sources() const override {
+    return sources_;
+  }
+
+  const RowTypePtr& outputType() const override {
+    return outputType_;
+  }
+
+  const std::vector<FieldAccessTypedExprPtr>& partitionKeys() const {
+    return partitionKeys_;
+  }
+
+  const std::vector<FieldAccessTypedExprPtr>& sortingKeys() const {
+    return sortingKeys_;
+  }
+
+  const std::vector<SortOrder>& sortingOrders() const {
+    return sortingOrders_;
+  }
+
+  int32_t limit() const {
+    return limit_;
+  }
+
+  bool generateRowNumber() const {
+    return outputType_->size() > sources_[0]->outputType()->size();
+  }
+
+  std::string_view name() const override {
+    return "TopNRowNumber";
+  }
+
+ private:
+  void addDetails(std::stringstream& stream) const override;
+
+  const std::vector<FieldAccessTypedExprPtr> partitionKeys_;
+
+  const std::vector<FieldAccessTypedExprPtr> sortingKeys_;
+  const std::vector<SortOrder> sortingOrders_;
+
+  const int32_t limit_;
+
   const std::vector<PlanNodePtr> sources_;
 
   const RowTypePtr outputType_;
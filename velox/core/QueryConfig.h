@@ -66,6 +66,36 @@ class QueryConfig {
   static constexpr const char* kOperatorTrackCpuUsage =
       "driver.track_operator_cpu_usage";
 
+  /// Max wall time in milliseconds a Driver runs on a thread before it yields
+  /// to let other Drivers run. The Driver is queued again on the executor of
+  /// the query. 0 means no limit.
+  static constexpr const char* kDriverTimeSliceLimitMs =
+      "driver_time_slice_limit_ms";
+
+  /// Max number of Drivers of a pipeline that reads splits from a table scan.
+  /// If greater than the number of Drivers the pipeline starts with, the Task
+  /// adds Drivers while the Drivers are CPU bound and there are queued splits,
+  /// and retires Drivers down to the starting number while they are not. 0
+  /// disables adding and retiring Drivers.
+  static constexpr const char* kMaxElasticDriversPerPipeline =
+      "max_elastic_drivers_per_pipeline";
+
+  /// Interval in milliseconds over which the CPU utilization of the Drivers of
+  /// an elastic pipeline is measured before a Driver is added or retired.
+  static constexpr const char* kElasticDriverIntervalMs =
+      "elastic_driver_interval_ms";
+
+  /// A Driver is added to an elastic pipeline if its Drivers spent at least
+  /// this share of their wall time on CPU in the last interval.
+  static constexpr const char* kElasticDriverScaleUpUtilization =
+      "elastic_driver_scale_up_utilization";
+
+  /// A Driver of an elastic pipeline is retired if the Drivers spent less than
+  /// this share of their wall time on CPU in the last interval, e.g. because
+  /// they wait for IO or for a thread.
+  static constexpr const char* kElasticDriverScaleDownUtilization =
+      "elastic_driver_scale_down_utilization";
+
   // Flags used to configure the CAST operator:
 
   // This flag makes the Row conversion to by applied
@@ -94,6 +124,17 @@ class QueryConfig {
   static constexpr const char* kPartialAggregationGoodPct =
       "partial_aggregation_reduction_ratio_threshold";
 
+  /// Number of input rows a partial aggregation must receive before it
+  /// considers abandoning the aggregation.
+  static constexpr const char* kAbandonPartialAggregationMinRows =
+      "abandon_partial_aggregation_min_rows";
+
+  /// Number of groups as percentage of the input rows at or above which a
+  /// partial aggregation is abandoned, i.e. it stops grouping and passes
+  /// its input on in intermediate form.
+  static constexpr const char* kAbandonPartialAggregationMinPct =
+      "abandon_partial_aggregation_min_pct";
+
   static constexpr const char* kMaxPartitionedOutputBufferSize =
       "driver.max-page-partitioning-buffer-size";
 
@@ -110,6 +151,13 @@ class QueryConfig {
 
   static constexpr const char* kCreateEmptyFiles = "driver.create_empty_files";
 
+  /// The max number of distinct build side keys for which a hash join pushes
+  /// down a Bloom filter on a join key to the probe side table scan when the
+  /// keys do not allow an exact range or IN-list filter. 0 disables Bloom
+  /// filter pushdown.
+  static constexpr const char* kHashProbeBloomFilterPushdownMaxSize =
+      "hash_probe_bloom_filter_pushdown_max_size";
+
   /// Global enable spilling flag.
   static constexpr const char* kSpillEnabled = "spill_enabled";
 
@@ -126,6 +174,9 @@ class QueryConfig {
   /// OrderBy spilling flag, only applies if "spill_enabled" flag is set.
   static constexpr const char* kOrderBySpillEnabled = "order_by_spill_enabled";
 
+  /// Window spilling flag, only applies if "spill_enabled" flag is set.
+  static constexpr const char* kWindowSpillEnabled = "window_spill_enabled";
+
   /// The max memory that a final aggregation can use before spilling. If it 0,
   /// then there is no limit.
   static constexpr const char* kAggregationSpillMemoryThreshold =
@@ -141,6 +192,11 @@ class QueryConfig {
   static constexpr const char* kOrderBySpillMemoryThreshold =
       "order_by_spill_memory_threshold";
 
+  /// The max memory that a window can use before spilling. If it 0, then
+  /// there is no limit.
+  static constexpr const char* kWindowSpillMemoryThreshold =
+      "window_spill_memory_threshold";
+
   static constexpr const char* kTestingSpillPct = "testing.spill-pct";
 
   /// The max allowed spilling level with zero being the initial spilling level.
@@ -172,6 +228,10 @@ class QueryConfig {
   static constexpr const char* kSpillableReservationGrowthPct =
       "spillable-reservation-growth-pct";
 
+  /// The compression codec of spill files, one of "none", "zlib", "snappy",
+  /// "lz4" or "zstd".
+  static constexpr const char* kSpillCompressionKind = "spill_compression_kind";
+
   uint64_t maxPartialAggregationMemoryUsage() const {
     static constexpr uint64_t kDefault = 1L << 24;
     return get<uint64_t>(kMaxPartialAggregationMemory, kDefault);
@@ -192,6 +252,16 @@ class QueryConfig {
     return get<double>(kPartialAggregationGoodPct, kDefault);
   }
 
+  int32_t abandonPartialAggregationMinRows() const {
+    static constexpr int32_t kDefault = 100'000;
+    return get<int32_t>(kAbandonPartialAggregationMinRows, kDefault);
+  }
+
+  int32_t abandonPartialAggregationMinPct() const {
+    static constexpr int32_t kDefault = 80;
+    return get<int32_t>(kAbandonPartialAggregationMinPct, kDefault);
+  }
+
   uint64_t joinSpillMemoryThreshold() const {
     static constexpr uint64_t kDefault = 0;
     return get<uint64_t>(kJoinSpillMemoryThreshold, kDefault);
@@ -202,6 +272,11 @@ class QueryConfig {
     return get<uint64_t>(kOrderBySpillMemoryThreshold, kDefault);
   }
 
+  uint64_t windowSpillMemoryThreshold() const {
+    static constexpr uint64_t kDefault = 0;
+    return get<uint64_t>(kWindowSpillMemoryThreshold, kDefault);
+  }
+
   // Returns the target size for a Task's buffered output. The
   // producer Drivers are blocked when the buffered size exceeds
   // this. The Drivers are resumed when the buffered size goes below
@@ -234,6 +309,11 @@ class QueryConfig {
     return kDefault;
   }
 
+  uint64_t hashProbeBloomFilterPushdownMaxSize() const {
+    static constexpr uint64_t kDefault = 0;
+    return get<uint64_t>(kHashProbeBloomFilterPushdownMaxSize, kDefault);
+  }
+
   bool adaptiveFilterReorderingEnabled() const {
     return get<bool>(kAdaptiveFilterReorderingEnabled, true);
   }
@@ -308,6 +388,12 @@ class QueryConfig {
     return get<bool>(kOrderBySpillEnabled, true);
   }
 
+  /// Returns 'is window spilling enabled' flag. Must also check the
+  /// spillEnabled()!
+  bool windowSpillEnabled() const {
+    return get<bool>(kWindowSpillEnabled, true);
+  }
+
   // Returns a percentage of aggregation or join input batches that
   // will be forced to spill for testing. 0 means no extra spilling.
   int32_t testingSpillPct() const {
@@ -354,6 +440,10 @@ class QueryConfig {
     return get<double>(kSpillableReservationGrowthPct, kDefaultPct);
   }
 
+  std::string spillCompressionKind() const {
+    return get<std::string>(kSpillCompressionKind, "none");
+  }
+
   bool exprTrackCpuUsage() const {
     return get<bool>(kExprTrackCpuUsage, false);
   }
@@ -362,6 +452,26 @@ class QueryConfig {
     return get<bool>(kOperatorTrackCpuUsage, true);
   }
 
+  uint32_t driverTimeSliceLimitMs() const {
+    return get<uint32_t>(kDriverTimeSliceLimitMs, 0);
+  }
+
+  uint32_t maxElasticDriversPerPipeline() const {
+    return get<uint32_t>(kMaxElasticDriversPerPipeline, 0);
+  }
+
+  uint32_t elasticDriverIntervalMs() const {
+    return get<uint32_t>(kElasticDriverIntervalMs, 100);
+  }
+
+  double elasticDriverScaleUpUtilization() const {
+    return get<double>(kElasticDriverScaleUpUtilization, 0.8);
+  }
+
+  double elasticDriverScaleDownUtilization() const {
+    return get<double>(kElasticDriverScaleDownUtilization, 0.3);
+  }
+
   template <typename T>
   T get(const std::string& key, const T& defaultValue) const {
     return configManager_->get<T>(key, defaultValue);
@@ -191,6 +191,9 @@ void CacheInputStream::loadSync(Region region) {
     }
     auto entry = pin_.checkedEntry();
     if (entry->isExclusive()) {
+      if (tracker_) {
+        tracker_->recordCacheLookup(false);
+      }
       // Missed memory cache. Trying to load from ssd cache, and if again
       // missed, fall back to remote fetching.
       entry->setGroupId(groupId_);
@@ -209,9 +212,13 @@ void CacheInputStream::loadSync(Region region) {
       entry->setExclusiveToShared();
     } else {
       // Hit memory cache.
-      if (!entry->getAndClearFirstUseFlag()) {
+      const bool isReuse = !entry->getAndClearFirstUseFlag();
+      if (isReuse) {
         ioStats_->ramHit().increment(entry->size());
       }
+      if (tracker_) {
+        tracker_->recordCacheLookup(isReuse);
+      }
       return;
     }
   } while (pin_.empty());
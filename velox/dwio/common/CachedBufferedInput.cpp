@@ -285,11 +285,13 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
       cache::AsyncDataCache& cache,
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
-      std::vector<CacheRequest*> requests)
+      std::vector<CacheRequest*> requests,
+      bool lowPriority)
       : CoalescedLoad(makeKeys(requests), makeSizes(requests)),
         cache_(cache),
         ioStats_(std::move(ioStats)),
-        groupId_(groupId) {
+        groupId_(groupId),
+        lowPriority_(lowPriority) {
     for (auto& request : requests) {
       requests_.push_back(std::move(*request));
     }
@@ -315,6 +317,17 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
   }
 
  protected:
+  // Sets up a new entry made by loadData().
+  void initializePin(CachePin& pin, bool isPrefetch) {
+    auto entry = pin.checkedEntry();
+    if (isPrefetch) {
+      entry->setPrefetch(true);
+    }
+    if (lowPriority_) {
+      entry->setLowPriority();
+    }
+  }
+
   void updateStats(const CoalesceIoStats& stats, bool isPrefetch, bool isSsd) {
     if (ioStats_) {
       ioStats_->incRawOverreadBytes(stats.extraBytes);
@@ -352,6 +365,8 @@ class DwioCoalescedLoadBase : public cache::CoalescedLoad {
   std::vector<CacheRequest> requests_;
   std::shared_ptr<IoStatistics> ioStats_;
   const uint64_t groupId_;
+  // True if the loaded entries are not retained after first use.
+  const bool lowPriority_;
 };
 
 // Represents a CoalescedLoad from ReadFile, e.g. disagg disk.
@@ -363,8 +378,14 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
       std::vector<CacheRequest*> requests,
-      int32_t maxCoalesceDistance)
-      : DwioCoalescedLoadBase(cache, ioStats, groupId, std::move(requests)),
+      int32_t maxCoalesceDistance,
+      bool lowPriority)
+      : DwioCoalescedLoadBase(
+            cache,
+            ioStats,
+            groupId,
+            std::move(requests),
+            lowPriority),
         input_(std::move(input)),
         maxCoalesceDistance_(maxCoalesceDistance) {}
 
@@ -375,9 +396,7 @@ class DwioCoalescedLoad : public DwioCoalescedLoadBase {
         keys_,
         [&](int32_t index) { return sizes_[index]; },
         [&](int32_t /*index*/, CachePin pin) {
-          if (isPrefetch) {
-            pin.checkedEntry()->setPrefetch(true);
-          }
+          initializePin(pin, isPrefetch);
           pins.push_back(std::move(pin));
         });
     if (pins.empty()) {
@@ -410,8 +429,14 @@ class SsdLoad : public DwioCoalescedLoadBase {
       cache::AsyncDataCache& cache,
       std::shared_ptr<IoStatistics> ioStats,
       uint64_t groupId,
-      std::vector<CacheRequest*> requests)
-      : DwioCoalescedLoadBase(cache, ioStats, groupId, std::move(requests)) {}
+      std::vector<CacheRequest*> requests,
+      bool lowPriority)
+      : DwioCoalescedLoadBase(
+            cache,
+            ioStats,
+            groupId,
+            std::move(requests),
+            lowPriority) {}
 
   std::vector<CachePin> loadData(bool isPrefetch) override {
     std::vector<SsdPin> ssdPins;
@@ -420,9 +445,7 @@ class SsdLoad : public DwioCoalescedLoadBase {
         keys_,
         [&](int32_t index) { return sizes_[index]; },
         [&](int32_t index, CachePin pin) {
-          if (isPrefetch) {
-            pin.checkedEntry()->setPrefetch(true);
-          }
+          initializePin(pin, isPrefetch);
           pins.push_back(std::move(pin));
           ssdPins.push_back(std::move(requests_[index].ssdPin));
         });
@@ -444,12 +467,22 @@ void CachedBufferedInput::readRegion(
   if (requests.empty() || (requests.size() == 1 && !prefetch)) {
     return;
   }
+  // Data prefetched for a scan that seldom reuses cached data is
+  // expected to be read once.
+  const bool lowPriority = prefetch && tracker_ && tracker_->isLowReuse();
   std::shared_ptr<cache::CoalescedLoad> load;
   if (!requests[0]->ssdPin.empty()) {
-    load = std::make_shared<SsdLoad>(*cache_, ioStats_, groupId_, requests);
+    load = std::make_shared<SsdLoad>(
+        *cache_, ioStats_, groupId_, requests, lowPriority);
   } else {
     load = std::make_shared<DwioCoalescedLoad>(
-        *cache_, input_, ioStats_, groupId_, requests, maxCoalesceDistance_);
+        *cache_,
+        input_,
+        ioStats_,
+        groupId_,
+        requests,
+        maxCoalesceDistance_,
+        lowPriority);
   }
   allCoalescedLoads_.push_back(load);
   coalescedLoads_.withWLock([&](auto& loads) {
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/common/FileMetadataCache.h"
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::dwio::common {
+
+std::shared_ptr<const FileMetadata> FileMetadataCache::get(
+    const FileMetadataKey& key) {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto* entry = cache_.get(key);
+  if (entry == nullptr) {
+    ++stats_.numMisses;
+    return nullptr;
+  }
+  // Copy out the shared_ptr and unpin right away. The caller keeps the
+  // metadata alive independently of the cache.
+  auto metadata = *entry;
+  cache_.release(key);
+  ++stats_.numHits;
+  return metadata;
+}
+
+void FileMetadataCache::put(
+    const FileMetadataKey& key,
+    std::shared_ptr<const FileMetadata> metadata) {
+  VELOX_CHECK_NOT_NULL(metadata);
+  const auto size = static_cast<int64_t>(metadata->size());
+  auto entry = std::make_unique<MetadataPtr>(std::move(metadata));
+  std::lock_guard<std::mutex> l(mutex_);
+  if (cache_.add(key, entry.get(), size)) {
+    entry.release();
+  } else {
+    ++stats_.numRejected;
+  }
+}
+
+FileMetadataCache::Stats FileMetadataCache::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto stats = stats_;
+  stats.cachedBytes = cache_.currentSize();
+  return stats;
+}
+
+} // namespace facebook::velox::dwio::common
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/hash/Hash.h>
+
+#include <memory>
+#include <mutex>
+
+#include "velox/common/caching/SimpleLRUCache.h"
+
+namespace facebook::velox::dwio::common {
+
+/// Parsed file metadata, e.g. the footer of a DWRF or Parquet file. Produced
+/// by the format specific reader on the first open of a file and shared by
+/// all later readers of the same file. Must be immutable once cached.
+class FileMetadata {
+ public:
+  virtual ~FileMetadata() = default;
+
+  /// Approximate memory held by 'this'. Counted against the capacity of
+  /// FileMetadataCache.
+  virtual uint64_t size() const = 0;
+};
+
+/// Identifies a version of a file. 'fileId' is the process-wide id of the
+/// file path. 'fileVersion' changes each time the file is opened anew, e.g.
+/// when its file handle is recreated, so that a file rewritten under the
+/// same path does not hit the entry of its previous content. 'fileLength'
+/// also tells apart versions opened with the same 'fileVersion'.
+struct FileMetadataKey {
+  uint64_t fileId;
+  uint64_t fileVersion;
+  uint64_t fileLength;
+
+  bool operator==(const FileMetadataKey& other) const {
+    return fileId == other.fileId && fileVersion == other.fileVersion &&
+        fileLength == other.fileLength;
+  }
+};
+
+struct FileMetadataKeyHasher {
+  size_t operator()(const FileMetadataKey& key) const {
+    return folly::hash::hash_combine(
+        key.fileId, key.fileVersion, key.fileLength);
+  }
+};
+
+/// Size-bounded cache of parsed file metadata. Shared by the readers of all
+/// splits and queries of a connector so that the footer of a file is read
+/// and deserialized once instead of once per split. Thread-safe.
+class FileMetadataCache {
+ public:
+  struct Stats {
+    uint64_t numHits{0};
+    uint64_t numMisses{0};
+    /// Number of put() calls that did not add an entry, because the key was
+    /// already present or the entry did not fit.
+    uint64_t numRejected{0};
+    /// Sum of FileMetadata::size() of the cached entries.
+    int64_t cachedBytes{0};
+  };
+
+  explicit FileMetadataCache(int64_t capacity) : cache_(capacity) {}
+
+  /// Returns the metadata for 'key' or nullptr if not cached. The returned
+  /// metadata stays valid after it is evicted from the cache.
+  std::shared_ptr<const FileMetadata> get(const FileMetadataKey& key);
+
+  /// Adds 'metadata' for 'key', evicting older entries if needed. Does
+  /// nothing if 'key' is already present or 'metadata' is larger than the
+  /// capacity.
+  void put(
+      const FileMetadataKey& key,
+      std::shared_ptr<const FileMetadata> metadata);
+
+  Stats stats() const;
+
+ private:
+  using MetadataPtr = std::shared_ptr<const FileMetadata>;
+
+  mutable std::mutex mutex_;
+  SimpleLRUCache<
+      FileMetadataKey,
+      MetadataPtr,
+      std::equal_to<FileMetadataKey>,
+      FileMetadataKeyHasher>
+      cache_;
+  Stats stats_;
+};
+
+} // namespace facebook::velox::dwio::common
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/vector/BaseVector.h"
+
+namespace facebook::velox::dwio::common {
+
+/// Abstract writer of a file format. Writes vectors of the file schema to a
+/// DataSink given to the implementation.
+class FileWriter {
+ public:
+  virtual ~FileWriter() = default;
+
+  /// Appends 'data' to the file.
+  virtual void write(const VectorPtr& data) = 0;
+
+  /// Forces the data written so far to the DataSink. Does not close the
+  /// writer.
+  virtual void flush() = 0;
+
+  /// Writes the remaining data and the file footer and closes the DataSink.
+  /// No data can be written after close().
+  virtual void close() = 0;
+};
+
+} // namespace facebook::velox::dwio::common
@@ -23,6 +23,7 @@
 #include "velox/common/memory/Memory.h"
 #include "velox/dwio/common/ColumnSelector.h"
 #include "velox/dwio/common/ErrorTolerance.h"
+#include "velox/dwio/common/FileMetadataCache.h"
 #include "velox/dwio/common/InputStream.h"
 #include "velox/dwio/common/ScanSpec.h"
 #include "velox/dwio/common/encryption/Encryption.h"
@@ -348,6 +349,9 @@ class ReaderOptions {
   std::shared_ptr<encryption::DecrypterFactory> decrypterFactory_;
   uint64_t directorySizeGuess{kDefaultDirectorySizeGuess};
   uint64_t filePreloadThreshold{kDefaultFilePreloadThreshold};
+  FileMetadataCache* fileMetadataCache_{nullptr};
+  uint64_t fileId_{0};
+  uint64_t fileVersion_{0};
 
  public:
   static constexpr int32_t kDefaultLoadQuantum = 8 << 20; // 8MB
@@ -381,6 +385,9 @@ class ReaderOptions {
     decrypterFactory_ = other.decrypterFactory_;
     directorySizeGuess = other.directorySizeGuess;
     filePreloadThreshold = other.filePreloadThreshold;
+    fileMetadataCache_ = other.fileMetadataCache_;
+    fileId_ = other.fileId_;
+    fileVersion_ = other.fileVersion_;
     return *this;
   }
 
@@ -484,6 +491,24 @@ class ReaderOptions {
     return *this;
   }
 
+  /**
+   * Set the cache of parsed file metadata and the id of the file to read.
+   * The reader looks up the footer in 'cache' before reading and parsing it
+   * and adds it to 'cache' after a miss. 'fileId' must be unique per file
+   * path in the process, e.g. the id of the file handle. 'fileVersion' must
+   * change whenever the file is opened anew, e.g. the version of the file
+   * handle.
+   */
+  ReaderOptions& setFileMetadataCache(
+      FileMetadataCache* cache,
+      uint64_t fileId,
+      uint64_t fileVersion) {
+    fileMetadataCache_ = cache;
+    fileId_ = fileId;
+    fileVersion_ = fileVersion;
+    return *this;
+  }
+
   /**
    * Get the desired tail location.
    * @return if not set, return the maximum long.
@@ -549,6 +574,18 @@ class ReaderOptions {
   uint64_t getFilePreloadThreshold() const {
     return filePreloadThreshold;
   }
+
+  FileMetadataCache* getFileMetadataCache() const {
+    return fileMetadataCache_;
+  }
+
+  uint64_t getFileId() const {
+    return fileId_;
+  }
+
+  uint64_t getFileVersion() const {
+    return fileVersion_;
+  }
 };
 
 } // namespace common
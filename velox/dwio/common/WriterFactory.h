@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "velox/dwio/common/DataSink.h"
+#include "velox/dwio/common/FileWriter.h"
+#include "velox/dwio/common/Options.h"
+
+namespace facebook::velox::dwio::common {
+
+/// Options for creating a FileWriter with a WriterFactory.
+struct FileWriterOptions {
+  /// Type of the vectors to write.
+  TypePtr schema;
+
+  /// Pool of the writer's memory.
+  memory::MemoryPool* FOLLY_NULLABLE memoryPool{nullptr};
+};
+
+/// Writer factory interface.
+///
+/// Implement this interface to provide a factory of writers for a particular
+/// file format. Factory objects should be registered using
+/// registerWriterFactory() to become available for connectors. Only a single
+/// writer factory per file format is allowed.
+class WriterFactory {
+ public:
+  /// Constructs a factory for writers of 'format'.
+  explicit WriterFactory(FileFormat format) : format_(format) {}
+
+  virtual ~WriterFactory() = default;
+
+  /// Returns the file format this factory is designated to.
+  FileFormat fileFormat() const {
+    return format_;
+  }
+
+  /// Creates a writer to 'sink'.
+  virtual std::unique_ptr<FileWriter> createWriter(
+      std::unique_ptr<DataSink> sink,
+      const FileWriterOptions& options) = 0;
+
+ private:
+  const FileFormat format_;
+};
+
+/// Registers a writer factory. Only a single factory can be registered for
+/// each file format. An attempt to register multiple factories for a single
+/// file format causes a failure.
+bool registerWriterFactory(std::shared_ptr<WriterFactory> factory);
+
+/// Unregisters the writer factory for 'format'. Returns false if there is no
+/// factory for 'format'.
+bool unregisterWriterFactory(FileFormat format);
+
+/// Returns true if a writer factory is registered for 'format'.
+bool hasWriterFactory(FileFormat format);
+
+/// Returns the writer factory for 'format'. Results in a failure if there is
+/// no registered factory for 'format'.
+std::shared_ptr<WriterFactory> getWriterFactory(FileFormat format);
+
+} // namespace facebook::velox::dwio::common
@@ -490,7 +490,10 @@ DwrfReader::DwrfReader(
           options.getDirectorySizeGuess(),
           options.getFilePreloadThreshold(),
           options.getFileFormat() == FileFormat::ORC ? FileFormat::ORC
-                                                     : FileFormat::DWRF)),
+                                                     : FileFormat::DWRF,
+          options.getFileMetadataCache(),
+          options.getFileId(),
+          options.getFileVersion())),
       options_(options) {}
 
 std::unique_ptr<StripeInformation> DwrfReader::getStripe(
@@ -92,7 +92,10 @@ ReaderBase::ReaderBase(
     std::shared_ptr<DecrypterFactory> decryptorFactory,
     uint64_t directorySizeGuess,
     uint64_t filePreloadThreshold,
-    FileFormat fileFormat)
+    FileFormat fileFormat,
+    dwio::common::FileMetadataCache* metadataCache,
+    uint64_t fileId,
+    uint64_t fileVersion)
     : pool_{pool},
       arena_(std::make_unique<google::protobuf::Arena>()),
       decryptorFactory_(decryptorFactory),
@@ -110,8 +113,87 @@ ReaderBase::ReaderBase(
       preloadFile ? fileLength_ : std::min(fileLength_, directorySizeGuess_);
   DWIO_ENSURE_GE(readSize, 4, "File size too small");
 
+  const dwio::common::FileMetadataKey metadataKey{
+      fileId, fileVersion, fileLength_};
+  if (metadataCache != nullptr) {
+    cachedMetadata_ = std::dynamic_pointer_cast<const DwrfFileMetadata>(
+        metadataCache->get(metadataKey));
+    if (cachedMetadata_ && cachedMetadata_->fileFormat != fileFormat) {
+      cachedMetadata_.reset();
+    }
+  }
+
+  if (cachedMetadata_) {
+    // The tail does not need to be read. A small file is still loaded as a
+    // whole since its data is read next.
+    if (preloadFile) {
+      input_->enqueue({0, fileLength_});
+      input_->load(LogType::FILE);
+    }
+    postScript_ = cachedMetadata_->postScript;
+    psLength_ = cachedMetadata_->psLength;
+    footer_ = std::make_unique<FooterWrapper>(cachedMetadata_->footer);
+  } else if (metadataCache != nullptr) {
+    // Parse the footer into an arena of its own so that it can outlive
+    // 'this' in the cache.
+    auto footerArena = std::make_shared<google::protobuf::Arena>();
+    readPostScriptAndFooter(fileFormat, readSize, footerArena.get());
+    cachedMetadata_ = std::make_shared<DwrfFileMetadata>(
+        fileFormat, std::move(footerArena), postScript_, *footer_, psLength_);
+    metadataCache->put(metadataKey, cachedMetadata_);
+  } else {
+    readPostScriptAndFooter(fileFormat, readSize, arena_.get());
+  }
+
+  uint64_t footerSize = postScript_->footerLength();
+  uint64_t cacheSize =
+      postScript_->hasCacheSize() ? postScript_->cacheSize() : 0;
+  uint64_t tailSize = 1 + psLength_ + footerSize + cacheSize;
+
+  schema_ = std::dynamic_pointer_cast<const RowType>(convertType(*footer_));
+  DWIO_ENSURE_NOT_NULL(schema_, "invalid schema");
+
+  // load stripe index/footer cache
+  if (cacheSize > 0) {
+    DWIO_ENSURE_EQ(format(), DwrfFormat::kDwrf);
+    if (input_->shouldPrefetchStripes()) {
+      cache_ = std::make_unique<StripeMetadataCache>(
+          postScript_->cacheMode(),
+          *footer_,
+          input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER));
+      input_->load(LogType::FOOTER);
+    } else {
+      auto cacheBuffer =
+          std::make_shared<dwio::common::DataBuffer<char>>(pool, cacheSize);
+      input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER)
+          ->readFully(cacheBuffer->data(), cacheSize);
+      cache_ = std::make_unique<StripeMetadataCache>(
+          postScript_->cacheMode(), *footer_, std::move(cacheBuffer));
+    }
+  }
+  if (!cache_ && input_->shouldPrefetchStripes()) {
+    auto numStripes = getFooter().stripesSize();
+    for (auto i = 0; i < numStripes; i++) {
+      const auto stripe = getFooter().stripes(i);
+      input_->enqueue(
+          {stripe.offset() + stripe.indexLength() + stripe.dataLength(),
+           stripe.footerLength()});
+    }
+    if (numStripes) {
+      input_->load(LogType::FOOTER);
+    }
+  }
+  // initialize file decrypter
+  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
+}
+
+void ReaderBase::readPostScriptAndFooter(
+    FileFormat fileFormat,
+    uint64_t readSize,
+    google::protobuf::Arena* arena) {
   input_->enqueue({fileLength_ - readSize, readSize});
-  input_->load(preloadFile ? LogType::FILE : LogType::FOOTER);
+  input_->load(
+      fileLength_ <= filePreloadThreshold_ ? LogType::FILE : LogType::FOOTER);
 
   // TODO: read footer from spectrum
   {
@@ -167,55 +249,19 @@ ReaderBase::ReaderBase(
       fileLength_ - psLength_ - footerSize - 1, footerSize, LogType::FOOTER);
   if (fileFormat == FileFormat::DWRF) {
     auto footer =
-        google::protobuf::Arena::CreateMessage<proto::Footer>(arena_.get());
+        google::protobuf::Arena::CreateMessage<proto::Footer>(arena);
     ProtoUtils::readProtoInto<proto::Footer>(
         createDecompressedStream(std::move(footerStream), "File Footer"),
         footer);
     footer_ = std::make_unique<FooterWrapper>(footer);
   } else {
-    auto footer = google::protobuf::Arena::CreateMessage<proto::orc::Footer>(
-        arena_.get());
+    auto footer =
+        google::protobuf::Arena::CreateMessage<proto::orc::Footer>(arena);
     ProtoUtils::readProtoInto<proto::orc::Footer>(
         createDecompressedStream(std::move(footerStream), "File Footer"),
         footer);
     footer_ = std::make_unique<FooterWrapper>(footer);
   }
-
-  schema_ = std::dynamic_pointer_cast<const RowType>(convertType(*footer_));
-  DWIO_ENSURE_NOT_NULL(schema_, "invalid schema");
-
-  // load stripe index/footer cache
-  if (cacheSize > 0) {
-    DWIO_ENSURE_EQ(format(), DwrfFormat::kDwrf);
-    if (input_->shouldPrefetchStripes()) {
-      cache_ = std::make_unique<StripeMetadataCache>(
-          postScript_->cacheMode(),
-          *footer_,
-          input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER));
-      input_->load(LogType::FOOTER);
-    } else {
-      auto cacheBuffer =
-          std::make_shared<dwio::common::DataBuffer<char>>(pool, cacheSize);
-      input_->read(fileLength_ - tailSize, cacheSize, LogType::FOOTER)
-          ->readFully(cacheBuffer->data(), cacheSize);
-      cache_ = std::make_unique<StripeMetadataCache>(
-          postScript_->cacheMode(), *footer_, std::move(cacheBuffer));
-    }
-  }
-  if (!cache_ && input_->shouldPrefetchStripes()) {
-    auto numStripes = getFooter().stripesSize();
-    for (auto i = 0; i < numStripes; i++) {
-      const auto stripe = getFooter().stripes(i);
-      input_->enqueue(
-          {stripe.offset() + stripe.indexLength() + stripe.dataLength(),
-           stripe.footerLength()});
-    }
-    if (numStripes) {
-      input_->load(LogType::FOOTER);
-    }
-  }
-  // initialize file decrypter
-  handler_ = DecryptionHandler::create(*footer_, decryptorFactory_.get());
 }
 
 std::vector<uint64_t> ReaderBase::getRowsPerStripe() const {
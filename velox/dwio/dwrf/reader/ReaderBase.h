@@ -56,6 +56,33 @@ class FooterStatisticsImpl : public dwio::common::Statistics {
   }
 };
 
+/// Parsed post script and footer of a DWRF or ORC file. Cached in a
+/// dwio::common::FileMetadataCache and shared by all readers of the file.
+struct DwrfFileMetadata : public dwio::common::FileMetadata {
+  DwrfFileMetadata(
+      dwio::common::FileFormat _fileFormat,
+      std::shared_ptr<google::protobuf::Arena> _arena,
+      std::shared_ptr<const PostScript> _postScript,
+      const FooterWrapper& _footer,
+      uint64_t _psLength)
+      : fileFormat(_fileFormat),
+        arena(std::move(_arena)),
+        postScript(std::move(_postScript)),
+        footer(_footer),
+        psLength(_psLength) {}
+
+  uint64_t size() const override {
+    return sizeof(*this) + arena->SpaceUsed() + psLength;
+  }
+
+  const dwio::common::FileFormat fileFormat;
+  // Owns the footer.
+  const std::shared_ptr<google::protobuf::Arena> arena;
+  const std::shared_ptr<const PostScript> postScript;
+  const FooterWrapper footer;
+  const uint64_t psLength;
+};
+
 class ReaderBase {
  public:
   // create reader base from buffered input
@@ -68,7 +95,10 @@ class ReaderBase {
           dwio::common::ReaderOptions::kDefaultDirectorySizeGuess,
       uint64_t filePreloadThreshold =
           dwio::common::ReaderOptions::kDefaultFilePreloadThreshold,
-      dwio::common::FileFormat fileFormat = dwio::common::FileFormat::DWRF);
+      dwio::common::FileFormat fileFormat = dwio::common::FileFormat::DWRF,
+      dwio::common::FileMetadataCache* metadataCache = nullptr,
+      uint64_t fileId = 0,
+      uint64_t fileVersion = 0);
 
   ReaderBase(
       memory::MemoryPool& pool,
@@ -226,14 +256,25 @@ class ReaderBase {
   }
 
  private:
+  // Reads the post script and the footer from 'input_' and parses them into
+  // 'postScript_' and 'footer_'. The footer is allocated from 'arena'.
+  // 'readSize' bytes at the end of the file have been loaded into 'input_'.
+  void readPostScriptAndFooter(
+      dwio::common::FileFormat fileFormat,
+      uint64_t readSize,
+      google::protobuf::Arena* arena);
+
   static std::shared_ptr<const Type> convertType(
       const FooterWrapper& footer,
       uint32_t index = 0);
 
   memory::MemoryPool& pool_;
   std::unique_ptr<google::protobuf::Arena> arena_;
-  std::unique_ptr<PostScript> postScript_;
+  std::shared_ptr<const PostScript> postScript_;
   std::unique_ptr<FooterWrapper> footer_ = nullptr;
+  // Set if reading with a FileMetadataCache. Keeps the arena of 'footer_'
+  // alive, which is then shared with other readers of the file.
+  std::shared_ptr<const DwrfFileMetadata> cachedMetadata_;
   std::unique_ptr<StripeMetadataCache> cache_;
   // Keeps factory alive for possibly async prefetch.
   std::shared_ptr<dwio::common::encryption::DecrypterFactory> decryptorFactory_;
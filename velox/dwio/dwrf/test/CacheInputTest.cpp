@@ -513,6 +513,84 @@ TEST_F(CacheTest, bufferedInput) {
   readLoop("testfile2", 30, 70, 70, 20, 4, ioStats_);
 }
 
+TEST_F(CacheTest, lowReusePrefetch) {
+  initializeCache(64 << 20);
+  // Counts the prefetched entries of low priority when their load completes
+  // and how many of them are evictable before their first use.
+  std::atomic<int32_t> numLowPriority{0};
+  std::atomic<int32_t> numEvictable{0};
+  cache_->setVerifyHook([&](const AsyncDataCacheEntry& entry) {
+    checkEntry(entry);
+    if (entry.isPrefetch() && entry.isLowPriority()) {
+      ++numLowPriority;
+      if (entry.score(accessTime()) == std::numeric_limits<int32_t>::max()) {
+        ++numEvictable;
+      }
+    }
+  });
+
+  // A scan that has not found its data in cache is low reuse.
+  auto tracker = std::make_shared<ScanTracker>(
+      "testTracker",
+      nullptr,
+      dwio::common::ReaderOptions::kDefaultLoadQuantum,
+      groupStats_);
+  for (auto i = 0; i < 100; ++i) {
+    tracker->recordCacheLookup(false);
+  }
+  ASSERT_TRUE(tracker->isLowReuse());
+
+  uint64_t fileId;
+  uint64_t groupId;
+  auto file = inputByPath("test_for_low_reuse", fileId, groupId);
+  auto input = std::make_unique<CachedBufferedInput>(
+      file,
+      *pool_,
+      MetricsLog::voidLog(),
+      fileId,
+      cache_.get(),
+      tracker,
+      groupId,
+      ioStats_,
+      executor_.get(),
+      dwio::common::ReaderOptions::kDefaultLoadQuantum,
+      512 << 10);
+  // Regions without a tracking id are prefetched on 'executor_'.
+  const std::vector<Region> regions = {{0, 100'000}, {300'000, 100'000}};
+  const int32_t numRegions = regions.size();
+  std::vector<std::unique_ptr<SeekableInputStream>> streams;
+  for (const auto& region : regions) {
+    streams.push_back(input->enqueue(region, nullptr));
+  }
+  input->load(LogType::TEST);
+  while (numLowPriority < numRegions) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10)); // NOLINT
+  }
+  // The prefetched entries are kept until they are read.
+  EXPECT_EQ(0, numEvictable.load());
+  auto stats = cache_->refreshStats();
+  EXPECT_EQ(numRegions, stats.numPrefetch);
+  EXPECT_EQ(200'000, stats.rejectedBytes);
+
+  for (auto i = 0; i < numRegions; ++i) {
+    const void* data;
+    int32_t size;
+    int64_t numRead = 0;
+    while (streams[i]->Next(&data, &size)) {
+      file->checkData(data, regions[i].offset + numRead, size);
+      numRead += size;
+    }
+    EXPECT_EQ(regions[i].length, numRead);
+  }
+  // The first use is not a hit and leaves the entries low priority.
+  stats = cache_->refreshStats();
+  EXPECT_EQ(0, stats.numPrefetch);
+  EXPECT_EQ(0, stats.numHit);
+  streams.clear();
+  input.reset();
+  cache_->setVerifyHook(checkEntry);
+}
+
 // Calibrates the data read for a densely and sparsely read stripe of
 // test data. Fills the SSD cache with test data. Reads 2x cache size
 // worth of data and checks that the cache population settles to a
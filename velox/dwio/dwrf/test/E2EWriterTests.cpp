@@ -15,6 +15,7 @@
  */
 
 #include <folly/Random.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <random>
 #include "velox/dwio/common/Options.h"
 #include "velox/dwio/common/Statistics.h"
@@ -787,6 +788,64 @@ TEST(E2EWriterTests, PartialStride) {
   ASSERT_EQ(true, reader->columnStatistics(1)->hasNull().value());
 }
 
+TEST(E2EWriterTests, parallelEncoding) {
+  HiveTypeParser parser;
+  auto type = parser.parse(
+      "struct<"
+      "bool_val:boolean,"
+      "byte_val:tinyint,"
+      "short_val:smallint,"
+      "int_val:int,"
+      "long_val:bigint,"
+      "float_val:float,"
+      "double_val:double,"
+      "string_val:string,"
+      "binary_val:binary,"
+      "timestamp_val:timestamp,"
+      "array_val:array<float>,"
+      "map_val:map<int,double>,"
+      "map_val:map<bigint,double>," /* this is column 12 */
+      "struct_val:struct<a:float,b:double>"
+      ">");
+  auto pool = memory::getDefaultMemoryPool();
+  std::vector<VectorPtr> batches;
+  for (size_t i = 0; i < 4; ++i) {
+    batches.push_back(BatchMaker::createBatch(type, 1'100, *pool, nullptr, i));
+  }
+
+  // Writes 'batches' in two stripes and returns the file.
+  auto writeFile = [&](folly::Executor* executor) {
+    auto config = std::make_shared<Config>();
+    config->set(Config::COMPRESSION, CompressionKind::CompressionKind_ZSTD);
+    config->set(Config::FLATTEN_MAP, true);
+    config->set(Config::MAP_FLAT_COLS, {12});
+    // Small batches so that a stripe is written in several rounds.
+    config->set(Config::RAW_DATA_SIZE_PER_BATCH, 10UL * 1024);
+    auto sink = std::make_unique<MemorySink>(*pool, 16 * kSizeMB);
+    auto* sinkPtr = sink.get();
+    WriterOptions options;
+    options.config = config;
+    options.schema = type;
+    options.encodingExecutor = executor;
+    Writer writer{options, std::move(sink), *pool};
+    for (size_t i = 0; i < batches.size(); ++i) {
+      writer.write(batches[i]);
+      if (i == 1) {
+        writer.flush();
+      }
+    }
+    writer.close();
+    return std::string(sinkPtr->getData(), sinkPtr->size());
+  };
+
+  auto expected = writeFile(nullptr);
+  folly::CPUThreadPoolExecutor executor(4);
+  for (auto i = 0; i < 3; ++i) {
+    // The layout of the file does not depend on the executor.
+    ASSERT_EQ(expected, writeFile(&executor));
+  }
+}
+
 TEST(E2EWriterTests, OversizeRows) {
   auto pool = facebook::velox::memory::getDefaultMemoryPool();
 
@@ -212,3 +212,97 @@ TEST(ReaderBaseTest, InvalidPostScriptThrows) {
   EXPECT_THROW(
       { createCorruptedFileReader(0, 1'000'000); }, exception::LoggedException);
 }
+
+namespace {
+// Returns the content of a file with no stripes and 'numRows' in the footer.
+std::string createEmptyFile(MemoryPool& pool, uint64_t numRows) {
+  MemorySink sink{pool, 1024};
+  DataBufferHolder holder{pool, 1024, 0, DEFAULT_PAGE_GROW_RATIO, &sink};
+  BufferedOutputStream output{holder};
+
+  DataBuffer<char> header{pool, 3};
+  std::memcpy(header.data(), "ORC", 3);
+  sink.write(std::move(header));
+
+  proto::Footer footer;
+  footer.set_numberofrows(numRows);
+  auto type = footer.add_types();
+  type->set_kind(proto::Type_Kind::Type_Kind_STRUCT);
+
+  footer.SerializeToZeroCopyStream(&output);
+  output.flush();
+  auto footerLen = sink.size() - 3;
+
+  proto::PostScript ps;
+  ps.set_footerlength(footerLen);
+  ps.set_compression(proto::CompressionKind::NONE);
+
+  ps.SerializeToZeroCopyStream(&output);
+  output.flush();
+  auto psLen = static_cast<uint8_t>(sink.size() - 3 - footerLen);
+
+  DataBuffer<char> buf{pool, 1};
+  buf.data()[0] = psLen;
+  sink.write(std::move(buf));
+  return std::string(sink.getData(), sink.size());
+}
+} // namespace
+
+TEST(ReaderBaseTest, fileMetadataCache) {
+  auto pool = facebook::velox::memory::getDefaultMemoryPool();
+  FileMetadataCache cache(1 << 20);
+  auto createReader = [&](const std::string& content,
+                          uint64_t fileId,
+                          uint64_t fileVersion = 1) {
+    return std::make_unique<ReaderBase>(
+        *pool,
+        std::make_unique<BufferedInput>(
+            std::make_shared<facebook::velox::InMemoryReadFile>(content),
+            *pool),
+        nullptr,
+        ReaderOptions::kDefaultDirectorySizeGuess,
+        ReaderOptions::kDefaultFilePreloadThreshold,
+        FileFormat::DWRF,
+        &cache,
+        fileId,
+        fileVersion);
+  };
+
+  const auto file = createEmptyFile(*pool, 10);
+  auto first = createReader(file, 1);
+  ASSERT_EQ(cache.stats().numMisses, 1);
+  ASSERT_EQ(cache.stats().numHits, 0);
+  ASSERT_GT(cache.stats().cachedBytes, 0);
+
+  // The second reader of the same file shares the parsed footer.
+  auto second = createReader(file, 1);
+  ASSERT_EQ(cache.stats().numHits, 1);
+  ASSERT_EQ(
+      first->getFooter().getDwrfPtr(), second->getFooter().getDwrfPtr());
+  ASSERT_EQ(second->getPostScriptLength(), first->getPostScriptLength());
+  first.reset();
+  ASSERT_EQ(second->getFooter().numberOfRows(), 10);
+  ASSERT_EQ(second->getSchema()->size(), 0);
+
+  // A different file with the same content is parsed again.
+  auto other = createReader(file, 2);
+  ASSERT_EQ(cache.stats().numMisses, 2);
+  ASSERT_NE(
+      other->getFooter().getDwrfPtr(), second->getFooter().getDwrfPtr());
+
+  // A rewrite of file 1 with a different length does not hit the entry of
+  // the previous version.
+  const auto rewritten = createEmptyFile(*pool, 1'000'000);
+  ASSERT_NE(rewritten.size(), file.size());
+  auto newVersion = createReader(rewritten, 1);
+  ASSERT_EQ(cache.stats().numMisses, 3);
+  ASSERT_EQ(newVersion->getFooter().numberOfRows(), 1'000'000);
+
+  // A rewrite of file 1 with the same length is parsed again when opened by
+  // a new file handle.
+  const auto sameLength = createEmptyFile(*pool, 20);
+  ASSERT_EQ(sameLength.size(), file.size());
+  auto reopened = createReader(sameLength, 1, 2);
+  ASSERT_EQ(cache.stats().numMisses, 4);
+  ASSERT_EQ(reopened->getFooter().numberOfRows(), 20);
+}
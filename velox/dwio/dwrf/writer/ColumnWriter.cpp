@@ -15,7 +15,10 @@
  */
 
 #include "velox/dwio/dwrf/writer/ColumnWriter.h"
+#include <folly/ScopeGuard.h>
 #include <velox/dwio/common/exception/Exception.h>
+#include <deque>
+#include "velox/common/base/AsyncSource.h"
 #include "velox/dwio/common/ChainedBuffer.h"
 #include "velox/dwio/dwrf/common/EncoderUtil.h"
 #include "velox/dwio/dwrf/writer/DictionaryEncodingUtils.h"
@@ -35,7 +38,8 @@ namespace facebook::velox::dwrf {
 WriterContext::LocalDecodedVector BaseColumnWriter::decode(
     const VectorPtr& slice,
     const common::Ranges& ranges) {
-  auto& selected = context_.getSharedSelectivityVector(slice->size());
+  auto localSelected = context_.getLocalSelectivityVector(slice->size());
+  auto& selected = localSelected.get();
   // initialize
   selected.clearAll();
   for (auto& range : ranges.getRanges()) {
@@ -1588,26 +1592,105 @@ class StructColumnWriter : public BaseColumnWriter {
       std::function<proto::ColumnEncoding&(uint32_t)> encodingFactory,
       std::function<void(proto::ColumnEncoding&)> encodingOverride) override {
     BaseColumnWriter::flush(encodingFactory, encodingOverride);
-    for (auto& c : children_) {
-      c->flush(encodingFactory);
+    if (!isParallel()) {
+      for (auto& c : children_) {
+        c->flush(encodingFactory);
+      }
+      return;
+    }
+    // The children add their encodings to per child lists which are added to
+    // the footer in the order of the children, as in the serial case.
+    std::vector<std::deque<std::pair<uint32_t, proto::ColumnEncoding>>>
+        encodings(children_.size());
+    forEachChild([&](size_t i) {
+      children_[i]->flush(
+          [&encodings, i](uint32_t nodeId) -> proto::ColumnEncoding& {
+            encodings[i].emplace_back(nodeId, proto::ColumnEncoding{});
+            return encodings[i].back().second;
+          });
+    });
+    for (auto& childEncodings : encodings) {
+      for (auto& [nodeId, encoding] : childEncodings) {
+        encodingFactory(nodeId).Swap(&encoding);
+      }
     }
   }
 
  private:
+  // True if the children are written and flushed in parallel on the encoding
+  // executor. Only the top level columns are parallelized.
+  bool isParallel() const {
+    return isRoot() && context_.encodingExecutor() && children_.size() > 1;
+  }
+
+  // Calls 'func' with the index of each child. Runs the calls on the encoding
+  // executor if isParallel(). Returns after all calls have finished and
+  // rethrows the first error, if any.
+  void forEachChild(const std::function<void(size_t)>& func);
+
   uint64_t writeChildrenAndStats(
       const RowVector* rowSlice,
       const common::Ranges& ranges,
       uint64_t nullCount);
 };
 
+void StructColumnWriter::forEachChild(
+    const std::function<void(size_t)>& func) {
+  if (!isParallel()) {
+    for (size_t i = 0; i < children_.size(); ++i) {
+      func(i);
+    }
+    return;
+  }
+  std::vector<std::shared_ptr<AsyncSource<bool>>> steps;
+  auto sync = folly::makeGuard([&]() {
+    // This is executed on returning path, possibly in unwinding, so must not
+    // throw. The steps reference 'func' and the column writers.
+    for (auto& step : steps) {
+      try {
+        step->move();
+      } catch (const std::exception& e) {
+        LOG(ERROR) << "Error in parallel column write: " << e.what();
+      }
+    }
+  });
+  auto* executor = context_.encodingExecutor();
+  for (size_t i = 0; i < children_.size(); ++i) {
+    steps.push_back(std::make_shared<AsyncSource<bool>>([i, &func]() {
+      func(i);
+      return std::make_unique<bool>(true);
+    }));
+    executor->add([step = steps.back()]() { step->prepare(); });
+  }
+  // The calling thread runs the steps that have not started on the executor.
+  std::exception_ptr error;
+  for (auto& step : steps) {
+    try {
+      step->move();
+    } catch (const std::exception&) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  sync.dismiss();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
 uint64_t StructColumnWriter::writeChildrenAndStats(
     const RowVector* rowSlice,
     const common::Ranges& ranges,
     uint64_t nullCount) {
   uint64_t rawSize = 0;
   if (ranges.size() > 0) {
-    for (size_t i = 0; i < children_.size(); ++i) {
-      rawSize += children_.at(i)->write(rowSlice->childAt(i), ranges);
+    std::vector<uint64_t> childRawSizes(children_.size());
+    forEachChild([&](size_t i) {
+      childRawSizes[i] = children_.at(i)->write(rowSlice->childAt(i), ranges);
+    });
+    for (auto childRawSize : childRawSizes) {
+      rawSize += childRawSize;
     }
   }
   if (nullCount) {
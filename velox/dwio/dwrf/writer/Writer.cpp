@@ -653,4 +653,23 @@ void Writer::close() {
   WriterBase::close();
 }
 
+std::unique_ptr<dwio::common::FileWriter> DwrfWriterFactory::createWriter(
+    std::unique_ptr<dwio::common::DataSink> sink,
+    const dwio::common::FileWriterOptions& options) {
+  VELOX_CHECK_NOT_NULL(options.memoryPool);
+  WriterOptions dwrfOptions;
+  dwrfOptions.config = std::make_shared<Config>();
+  dwrfOptions.schema = options.schema;
+  return std::make_unique<Writer>(
+      dwrfOptions, std::move(sink), *options.memoryPool);
+}
+
+void registerDwrfWriterFactory() {
+  dwio::common::registerWriterFactory(std::make_shared<DwrfWriterFactory>());
+}
+
+void unregisterDwrfWriterFactory() {
+  dwio::common::unregisterWriterFactory(dwio::common::FileFormat::DWRF);
+}
+
 } // namespace facebook::velox::dwrf
@@ -20,6 +20,7 @@
 #include <limits>
 
 #include "velox/common/base/GTestMacros.h"
+#include "velox/dwio/common/WriterFactory.h"
 #include "velox/dwio/dwrf/common/Encryption.h"
 #include "velox/dwio/dwrf/common/wrap/dwrf-proto-wrapper.h"
 #include "velox/dwio/dwrf/writer/ColumnWriter.h"
@@ -124,9 +125,15 @@ struct WriterOptions {
       WriterContext& context,
       const velox::dwio::common::TypeWithId& type)>
       columnWriterFactory;
+  // If set, the top level columns are encoded, compressed and flushed in
+  // parallel on this executor. Each batch of at most RAW_DATA_SIZE_PER_BATCH
+  // bytes is written by all columns before the next batch starts, so the
+  // buffered data is bounded as in the serial case. The output is the same
+  // as without the executor. Not owned.
+  folly::Executor* FOLLY_NULLABLE encodingExecutor{nullptr};
 };
 
-class Writer : public WriterBase {
+class Writer : public WriterBase, public dwio::common::FileWriter {
  public:
   Writer(
       const WriterOptions& options,
@@ -144,6 +151,7 @@ class Writer : public WriterBase {
     initContext(options.config, std::move(pool), std::move(handler));
     auto& context = getContext();
     context.buildPhysicalSizeAggregators(*schema_);
+    context.setEncodingExecutor(options.encodingExecutor);
     if (!options.flushPolicyFactory) {
       flushPolicy_ = std::make_unique<DefaultFlushPolicy>(
           context.stripeSizeFlushThreshold,
@@ -179,10 +187,10 @@ class Writer : public WriterBase {
 
   ~Writer() override = default;
 
-  void write(const VectorPtr& slice);
+  void write(const VectorPtr& slice) override;
 
   // Forces the writer to flush, does not close the writer.
-  void flush();
+  void flush() override;
 
   void close() override;
 
@@ -238,4 +246,17 @@ class Writer : public WriterBase {
   friend class WriterTestHelper;
 };
 
+class DwrfWriterFactory : public dwio::common::WriterFactory {
+ public:
+  DwrfWriterFactory() : WriterFactory(dwio::common::FileFormat::DWRF) {}
+
+  std::unique_ptr<dwio::common::FileWriter> createWriter(
+      std::unique_ptr<dwio::common::DataSink> sink,
+      const dwio::common::FileWriterOptions& options) override;
+};
+
+void registerDwrfWriterFactory();
+
+void unregisterDwrfWriterFactory();
+
 } // namespace facebook::velox::dwrf
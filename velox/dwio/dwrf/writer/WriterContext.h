@@ -17,6 +17,10 @@
 #pragma once
 
 #include <limits>
+#include <mutex>
+
+#include <folly/Executor.h>
+
 #include "velox/common/base/GTestMacros.h"
 #include "velox/common/time/CpuWallTimer.h"
 #include "velox/dwio/dwrf/common/Common.h"
@@ -77,12 +81,12 @@ class WriterContext : public CompressionBufferPool {
       outputStreamPool_->setMemoryUsageTracker(tracker->addChild());
       generalPool_->setMemoryUsageTracker(tracker->addChild());
     }
-    compressionBuffer_ = std::make_unique<dwio::common::DataBuffer<char>>(
-        *generalPool_, compressionBlockSize + PAGE_HEADER_SIZE);
+    compressionBuffers_.push_back(newCompressionBuffer());
   }
 
   bool hasStream(const DwrfStreamIdentifier& stream) const {
-    return streams_.find(stream) != streams_.end();
+    std::lock_guard<std::mutex> l(streamsMutex_);
+    return hasStreamLocked(stream);
   }
 
   const DataBufferHolder& getStream(const DwrfStreamIdentifier& stream) const {
@@ -105,22 +109,32 @@ class WriterContext : public CompressionBufferPool {
   // flush policy evaluation and would be more accurate after flush.
   std::unique_ptr<BufferedOutputStream> newStream(
       const DwrfStreamIdentifier& stream) {
-    DWIO_ENSURE(
-        !hasStream(stream), "Stream already exists ", stream.toString());
-    streams_.emplace(
-        std::piecewise_construct,
-        std::forward_as_tuple(stream),
-        std::forward_as_tuple(
-            getMemoryPool(MemoryUsageCategory::OUTPUT_STREAM),
-            compressionBlockSize,
-            getConfig(Config::COMPRESSION_BLOCK_SIZE_MIN),
-            getConfig(Config::COMPRESSION_BLOCK_SIZE_EXTEND_RATIO)));
-    auto& holder = streams_.at(stream);
+    DataBufferHolder* holder;
+    {
+      // Column writers of different top level columns may create streams
+      // concurrently when writing on the encoding executor.
+      std::lock_guard<std::mutex> l(streamsMutex_);
+      DWIO_ENSURE(
+          !hasStreamLocked(stream),
+          "Stream already exists ",
+          stream.toString());
+      holder = &streams_
+                    .emplace(
+                        std::piecewise_construct,
+                        std::forward_as_tuple(stream),
+                        std::forward_as_tuple(
+                            getMemoryPool(MemoryUsageCategory::OUTPUT_STREAM),
+                            compressionBlockSize,
+                            getConfig(Config::COMPRESSION_BLOCK_SIZE_MIN),
+                            getConfig(
+                                Config::COMPRESSION_BLOCK_SIZE_EXTEND_RATIO)))
+                    .first->second;
+    }
     auto encrypter = handler_->isEncrypted(stream.encodingKey().node)
         ? std::addressof(
               handler_->getEncryptionProvider(stream.encodingKey().node))
         : nullptr;
-    return newStream(compression, holder, encrypter);
+    return newStream(compression, *holder, encrypter);
   }
 
   std::unique_ptr<DataBufferHolder> newDataBufferHolder(
@@ -145,6 +159,8 @@ class WriterContext : public CompressionBufferPool {
       const EncodingKey& ek,
       velox::memory::MemoryPool& dictionaryPool,
       velox::memory::MemoryPool& generalPool) {
+    // Taken before 'streamsMutex_' in newStream().
+    std::lock_guard<std::mutex> l(dictEncodersMutex_);
     auto result = dictEncoders_.find(ek);
     if (result == dictEncoders_.end()) {
       auto emplaceResult = dictEncoders_.emplace(
@@ -176,7 +192,8 @@ class WriterContext : public CompressionBufferPool {
   }
 
   void suppressStream(const DwrfStreamIdentifier& stream) {
-    DWIO_ENSURE(hasStream(stream));
+    std::lock_guard<std::mutex> l(streamsMutex_);
+    DWIO_ENSURE(hasStreamLocked(stream));
     auto& collector = streams_.at(stream);
     collector.suppress();
   }
@@ -304,18 +321,41 @@ class WriterContext : public CompressionBufferPool {
     }
   }
 
+  // Returns a compression buffer. There is one buffer per stream being
+  // compressed at the same time, i.e. one unless columns are written on the
+  // encoding executor.
   std::unique_ptr<dwio::common::DataBuffer<char>> getBuffer(
       uint64_t size) override {
-    DWIO_ENSURE_NOT_NULL(compressionBuffer_);
-    DWIO_ENSURE_GE(compressionBuffer_->size(), size);
-    return std::move(compressionBuffer_);
+    std::unique_ptr<dwio::common::DataBuffer<char>> buffer;
+    {
+      std::lock_guard<std::mutex> l(poolMutex_);
+      if (!compressionBuffers_.empty()) {
+        buffer = std::move(compressionBuffers_.back());
+        compressionBuffers_.pop_back();
+      }
+    }
+    if (!buffer) {
+      buffer = newCompressionBuffer();
+    }
+    DWIO_ENSURE_GE(buffer->size(), size);
+    return buffer;
   }
 
   void returnBuffer(
       std::unique_ptr<dwio::common::DataBuffer<char>> buffer) override {
     DWIO_ENSURE_NOT_NULL(buffer);
-    DWIO_ENSURE(!compressionBuffer_);
-    compressionBuffer_ = std::move(buffer);
+    std::lock_guard<std::mutex> l(poolMutex_);
+    compressionBuffers_.push_back(std::move(buffer));
+  }
+
+  // Sets the executor for writing the top level columns in parallel. Must be
+  // set before the column writers are created.
+  void setEncodingExecutor(folly::Executor* FOLLY_NULLABLE executor) {
+    encodingExecutor_ = executor;
+  }
+
+  folly::Executor* FOLLY_NULLABLE encodingExecutor() const {
+    return encodingExecutor_;
   }
 
   void incrementNodeSize(uint32_t node, uint64_t size) {
@@ -492,19 +532,52 @@ class WriterContext : public CompressionBufferPool {
     return LocalDecodedVector{*this};
   }
 
-  SelectivityVector& getSharedSelectivityVector(velox::vector_size_t size) {
-    if (UNLIKELY(!selectivityVector_)) {
-      selectivityVector_ = std::make_unique<velox::SelectivityVector>(size);
-    } else {
-      selectivityVector_->resize(size);
+  class LocalSelectivityVector {
+   public:
+    LocalSelectivityVector(WriterContext& context, velox::vector_size_t size)
+        : context_(context), vector_(context_.getSelectivityVector()) {
+      vector_->resize(size);
+    }
+
+    LocalSelectivityVector(LocalSelectivityVector&& other) noexcept
+        : context_{other.context_}, vector_{std::move(other.vector_)} {}
+
+    LocalSelectivityVector& operator=(LocalSelectivityVector&& other) =
+        delete;
+
+    ~LocalSelectivityVector() {
+      if (vector_) {
+        context_.releaseSelectivityVector(std::move(vector_));
+      }
     }
-    return *selectivityVector_;
+
+    SelectivityVector& get() {
+      return *vector_;
+    }
+
+   private:
+    WriterContext& context_;
+    std::unique_ptr<velox::SelectivityVector> vector_;
+  };
+
+  LocalSelectivityVector getLocalSelectivityVector(velox::vector_size_t size) {
+    return LocalSelectivityVector{*this, size};
   }
 
  private:
   void validateConfigs() const;
 
+  bool hasStreamLocked(const DwrfStreamIdentifier& stream) const {
+    return streams_.find(stream) != streams_.end();
+  }
+
+  std::unique_ptr<dwio::common::DataBuffer<char>> newCompressionBuffer() {
+    return std::make_unique<dwio::common::DataBuffer<char>>(
+        *generalPool_, compressionBlockSize + PAGE_HEADER_SIZE);
+  }
+
   std::unique_ptr<velox::DecodedVector> getDecodedVector() {
+    std::lock_guard<std::mutex> l(poolMutex_);
     if (decodedVectorPool_.empty()) {
       return std::make_unique<velox::DecodedVector>();
     }
@@ -514,9 +587,26 @@ class WriterContext : public CompressionBufferPool {
   }
 
   void releaseDecodedVector(std::unique_ptr<velox::DecodedVector>&& vector) {
+    std::lock_guard<std::mutex> l(poolMutex_);
     decodedVectorPool_.push_back(std::move(vector));
   }
 
+  std::unique_ptr<velox::SelectivityVector> getSelectivityVector() {
+    std::lock_guard<std::mutex> l(poolMutex_);
+    if (selectivityVectorPool_.empty()) {
+      return std::make_unique<velox::SelectivityVector>();
+    }
+    auto vector = std::move(selectivityVectorPool_.back());
+    selectivityVectorPool_.pop_back();
+    return vector;
+  }
+
+  void releaseSelectivityVector(
+      std::unique_ptr<velox::SelectivityVector>&& vector) {
+    std::lock_guard<std::mutex> l(poolMutex_);
+    selectivityVectorPool_.push_back(std::move(vector));
+  }
+
   std::shared_ptr<const Config> config_;
   std::shared_ptr<memory::MemoryPool> pool_;
   std::shared_ptr<memory::MemoryPool> dictionaryPool_;
@@ -539,11 +629,21 @@ class WriterContext : public CompressionBufferPool {
   std::function<std::unique_ptr<IndexBuilder>(
       std::unique_ptr<BufferedOutputStream>)>
       indexBuilderFactory_;
-  std::unique_ptr<dwio::common::DataBuffer<char>> compressionBuffer_;
+  // Serializes creation and suppression of streams in 'streams_'.
+  mutable std::mutex streamsMutex_;
+  // Serializes creation of dictionary encoders in 'dictEncoders_'.
+  std::mutex dictEncodersMutex_;
+  // Serializes access to the pools of reusable buffers and vectors below.
+  std::mutex poolMutex_;
+  // A pool of reusable compression buffers.
+  std::vector<std::unique_ptr<dwio::common::DataBuffer<char>>>
+      compressionBuffers_;
   // A pool of reusable DecodedVectors.
   std::vector<std::unique_ptr<velox::DecodedVector>> decodedVectorPool_;
-  // Reusable SelectivityVector
-  std::unique_ptr<velox::SelectivityVector> selectivityVector_;
+  // A pool of reusable SelectivityVectors.
+  std::vector<std::unique_ptr<velox::SelectivityVector>> selectivityVectorPool_;
+  // Executor for writing the top level columns in parallel. Not owned.
+  folly::Executor* FOLLY_NULLABLE encodingExecutor_{nullptr};
 
   std::unique_ptr<encryption::EncryptionHandler> handler_;
   folly::F14FastMap<uint32_t, uint64_t> nodeSize;
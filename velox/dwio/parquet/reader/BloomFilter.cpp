@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/BloomFilter.h"
+
+#define XXH_INLINE_ALL
+#include <xxhash.h>
+
+#include <cstring>
+
+#include <thrift/protocol/TCompactProtocol.h> //@manual
+#include "velox/dwio/common/StreamUtil.h"
+#include "velox/dwio/parquet/thrift/ThriftTransport.h"
+
+namespace facebook::velox::parquet {
+
+namespace {
+// Salts for setting the bits of a block, from the Parquet specification.
+constexpr uint32_t kSalts[8] = {
+    0x47b6137bU,
+    0x44974d91U,
+    0x8824ad5bU,
+    0xa2b7289dU,
+    0x705495c7U,
+    0x2df1424bU,
+    0x9efc4947U,
+    0x5c6bfb31U};
+
+// Bytes read at the start of each filter in the first step. Covers the
+// header and the bitset of small filters.
+constexpr uint64_t kInitialReadSize = 4096;
+
+// Returns the mask of the bit to set in the 'i'th word of a block for 'key'.
+inline uint32_t bitMask(uint32_t key, int32_t i) {
+  return 1U << ((key * kSalts[i]) >> 27);
+}
+
+bool isSupported(const thrift::BloomFilterHeader& header) {
+  return header.numBytes > 0 &&
+      header.numBytes % BloomFilter::kBytesPerBlock == 0 &&
+      header.algorithm.__isset.BLOCK && header.hash.__isset.XXHASH &&
+      header.compression.__isset.UNCOMPRESSED;
+}
+
+bool mayContainInteger(
+    const BloomFilter& bloomFilter,
+    int64_t value,
+    thrift::Type::type physicalType) {
+  switch (physicalType) {
+    case thrift::Type::INT32:
+      return value >= std::numeric_limits<int32_t>::min() &&
+          value <= std::numeric_limits<int32_t>::max() &&
+          bloomFilter.mayContain(BloomFilter::hashInt32(value));
+    case thrift::Type::INT64:
+      return bloomFilter.mayContain(BloomFilter::hashInt64(value));
+    default:
+      return true;
+  }
+}
+
+template <typename Values>
+bool mayContainAnyInteger(
+    const BloomFilter& bloomFilter,
+    const Values& values,
+    thrift::Type::type physicalType) {
+  for (auto value : values) {
+    if (mayContainInteger(bloomFilter, value, physicalType)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool mayContainBytes(
+    const BloomFilter& bloomFilter,
+    std::string_view value,
+    thrift::Type::type physicalType) {
+  return physicalType != thrift::Type::BYTE_ARRAY ||
+      bloomFilter.mayContain(BloomFilter::hashBytes(value));
+}
+} // namespace
+
+BloomFilter::BloomFilter(int32_t numBytes)
+    : bitset_(bits::roundUp(std::max(numBytes, 1), kBytesPerBlock)) {}
+
+BloomFilter::BloomFilter(std::vector<char> bitset)
+    : bitset_(std::move(bitset)) {
+  VELOX_CHECK(!bitset_.empty());
+  VELOX_CHECK_EQ(bitset_.size() % kBytesPerBlock, 0);
+}
+
+uint32_t* BloomFilter::blockFor(uint64_t hash) const {
+  const uint64_t numBlocks = bitset_.size() / kBytesPerBlock;
+  const auto block = ((hash >> 32) * numBlocks) >> 32;
+  return reinterpret_cast<uint32_t*>(
+      const_cast<char*>(bitset_.data()) + block * kBytesPerBlock);
+}
+
+bool BloomFilter::mayContain(uint64_t hash) const {
+  const auto* block = blockFor(hash);
+  const auto key = static_cast<uint32_t>(hash);
+  for (auto i = 0; i < 8; ++i) {
+    if (!(block[i] & bitMask(key, i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BloomFilter::insert(uint64_t hash) {
+  auto* block = blockFor(hash);
+  const auto key = static_cast<uint32_t>(hash);
+  for (auto i = 0; i < 8; ++i) {
+    block[i] |= bitMask(key, i);
+  }
+}
+
+// static
+uint64_t BloomFilter::hashInt32(int32_t value) {
+  return XXH64(&value, sizeof(value), 0);
+}
+
+// static
+uint64_t BloomFilter::hashInt64(int64_t value) {
+  return XXH64(&value, sizeof(value), 0);
+}
+
+// static
+uint64_t BloomFilter::hashBytes(std::string_view value) {
+  return XXH64(value.data(), value.size(), 0);
+}
+
+std::vector<std::unique_ptr<BloomFilter>> readBloomFilters(
+    const std::vector<int64_t>& offsets,
+    const dwio::common::BufferedInput& input) {
+  const uint64_t fileLength = input.getReadFile()->size();
+  std::vector<std::unique_ptr<dwio::common::SeekableInputStream>> streams;
+  std::vector<uint64_t> sizes;
+  auto headerInput = input.clone();
+  for (auto offset : offsets) {
+    VELOX_CHECK_GE(offset, 0);
+    VELOX_CHECK_LT(offset, fileLength);
+    sizes.push_back(std::min(kInitialReadSize, fileLength - offset));
+    streams.push_back(headerInput->enqueue(
+        {static_cast<uint64_t>(offset), sizes.back()}));
+  }
+  headerInput->load(dwio::common::LogType::STRIPE_INDEX);
+
+  struct PendingBitset {
+    int32_t index;
+    std::vector<char> bitset;
+    int32_t numRead;
+    std::unique_ptr<dwio::common::SeekableInputStream> stream;
+  };
+  std::vector<PendingBitset> pending;
+  std::vector<std::unique_ptr<BloomFilter>> result(offsets.size());
+  auto bitsetInput = input.clone();
+  const char* bufferStart = nullptr;
+  const char* bufferEnd = nullptr;
+  for (auto i = 0; i < offsets.size(); ++i) {
+    std::vector<char> data(sizes[i]);
+    dwio::common::readBytes(
+        data.size(), streams[i].get(), data.data(), bufferStart, bufferEnd);
+    auto transport = std::make_shared<thrift::ThriftBufferedTransport>(
+        data.data(), data.size());
+    auto protocol =
+        std::make_unique<apache::thrift::protocol::TCompactProtocolT<
+            thrift::ThriftBufferedTransport>>(transport);
+    thrift::BloomFilterHeader header;
+    const uint64_t headerSize = header.read(protocol.get());
+    if (!isSupported(header)) {
+      continue;
+    }
+    std::vector<char> bitset(header.numBytes);
+    const int32_t numRead =
+        std::min<uint64_t>(header.numBytes, data.size() - headerSize);
+    std::memcpy(bitset.data(), data.data() + headerSize, numRead);
+    if (numRead == header.numBytes) {
+      result[i] = std::make_unique<BloomFilter>(std::move(bitset));
+      continue;
+    }
+    auto stream = bitsetInput->enqueue(
+        {offsets[i] + headerSize + numRead,
+         static_cast<uint64_t>(header.numBytes - numRead)});
+    pending.push_back({i, std::move(bitset), numRead, std::move(stream)});
+  }
+  if (pending.empty()) {
+    return result;
+  }
+  bitsetInput->load(dwio::common::LogType::STRIPE_INDEX);
+  for (auto& bitset : pending) {
+    dwio::common::readBytes(
+        bitset.bitset.size() - bitset.numRead,
+        bitset.stream.get(),
+        bitset.bitset.data() + bitset.numRead,
+        bufferStart,
+        bufferEnd);
+    result[bitset.index] =
+        std::make_unique<BloomFilter>(std::move(bitset.bitset));
+  }
+  return result;
+}
+
+bool canUseBloomFilter(const common::Filter& filter) {
+  // A null passes the filter and is not in the Bloom filter.
+  if (filter.testNull()) {
+    return false;
+  }
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange:
+      return static_cast<const common::BigintRange&>(filter).isSingleValue();
+    case common::FilterKind::kBigintValuesUsingHashTable:
+    case common::FilterKind::kBigintValuesUsingBitmask:
+    case common::FilterKind::kBytesValues:
+      return true;
+    case common::FilterKind::kBytesRange:
+      return static_cast<const common::BytesRange&>(filter).isSingleValue();
+    default:
+      return false;
+  }
+}
+
+bool testBloomFilter(
+    const common::Filter& filter,
+    const BloomFilter& bloomFilter,
+    thrift::Type::type physicalType) {
+  if (!canUseBloomFilter(filter)) {
+    return true;
+  }
+  switch (filter.kind()) {
+    case common::FilterKind::kBigintRange:
+      return mayContainInteger(
+          bloomFilter,
+          static_cast<const common::BigintRange&>(filter).lower(),
+          physicalType);
+    case common::FilterKind::kBigintValuesUsingHashTable:
+      return mayContainAnyInteger(
+          bloomFilter,
+          static_cast<const common::BigintValuesUsingHashTable&>(filter)
+              .values(),
+          physicalType);
+    case common::FilterKind::kBigintValuesUsingBitmask:
+      return mayContainAnyInteger(
+          bloomFilter,
+          static_cast<const common::BigintValuesUsingBitmask&>(filter)
+              .values(),
+          physicalType);
+    case common::FilterKind::kBytesValues:
+      for (const auto& value :
+           static_cast<const common::BytesValues&>(filter).values()) {
+        if (mayContainBytes(bloomFilter, value, physicalType)) {
+          return true;
+        }
+      }
+      return false;
+    case common::FilterKind::kBytesRange:
+      return mayContainBytes(
+          bloomFilter,
+          static_cast<const common::BytesRange&>(filter).lower(),
+          physicalType);
+    default:
+      return true;
+  }
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+#include "velox/type/Filter.h"
+
+namespace facebook::velox::parquet {
+
+/// Split block Bloom filter of a column chunk as defined by the Parquet
+/// format. The bitset is a sequence of 32 byte blocks of 8 32-bit words. A
+/// value is hashed with XXH64 over its plain encoding. The upper 32 bits of
+/// the hash select a block and the lower 32 bits set one bit in each word of
+/// the block.
+class BloomFilter {
+ public:
+  static constexpr int32_t kBytesPerBlock = 32;
+
+  /// Creates a filter with no values for a bitset of 'numBytes', which is
+  /// rounded up to a multiple of kBytesPerBlock.
+  explicit BloomFilter(int32_t numBytes);
+
+  /// Creates a filter with the serialized bitset 'bitset'.
+  explicit BloomFilter(std::vector<char> bitset);
+
+  /// Returns false if no value with 'hash' was inserted.
+  bool mayContain(uint64_t hash) const;
+
+  void insert(uint64_t hash);
+
+  const std::vector<char>& bitset() const {
+    return bitset_;
+  }
+
+  static uint64_t hashInt32(int32_t value);
+
+  static uint64_t hashInt64(int64_t value);
+
+  static uint64_t hashBytes(std::string_view value);
+
+ private:
+  // Returns the first word of the block for 'hash'.
+  uint32_t* blockFor(uint64_t hash) const;
+
+  std::vector<char> bitset_;
+};
+
+/// Reads the Bloom filters at file offsets 'offsets' from 'input'. The size
+/// of a filter is known only from its header, so the headers are read first
+/// and then the bitsets that did not fit in the first read. The reads of
+/// each step are coalesced in a single load of a clone of 'input'. The
+/// result has an element per offset, which is nullptr if the filter uses
+/// an algorithm, hash or compression that is not supported.
+std::vector<std::unique_ptr<BloomFilter>> readBloomFilters(
+    const std::vector<int64_t>& offsets,
+    const dwio::common::BufferedInput& input);
+
+/// True if 'filter' can be tested against a Bloom filter, i.e. it passes a
+/// finite set of integer or string values.
+bool canUseBloomFilter(const common::Filter& filter);
+
+/// Returns false if no value passing 'filter' is in 'bloomFilter'.
+/// 'physicalType' is the Parquet type of the column, which determines the
+/// hashed representation of the values. Filters for which
+/// canUseBloomFilter() is false always return true.
+bool testBloomFilter(
+    const common::Filter& filter,
+    const BloomFilter& bloomFilter,
+    thrift::Type::type physicalType);
+
+} // namespace facebook::velox::parquet
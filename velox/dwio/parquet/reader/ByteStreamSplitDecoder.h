@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/common/base/Exceptions.h"
+
+namespace facebook::velox::parquet {
+
+namespace detail {
+template <int32_t kByteWidth>
+void decodeByteStreamSplit(
+    const char* FOLLY_NONNULL data,
+    int32_t numValues,
+    char* FOLLY_NONNULL values) {
+  for (auto i = 0; i < numValues; ++i) {
+    for (auto byte = 0; byte < kByteWidth; ++byte) {
+      values[i * kByteWidth + byte] = data[byte * numValues + i];
+    }
+  }
+}
+} // namespace detail
+
+/// Decodes 'numValues' BYTE_STREAM_SPLIT encoded values of 'byteWidth' bytes
+/// from 'data' into 'values'. The encoding has one stream of 'numValues'
+/// bytes per byte of the value, where stream k has byte k of each value. The
+/// result is the PLAIN encoding of the same values.
+inline void decodeByteStreamSplit(
+    const char* FOLLY_NONNULL data,
+    int32_t numValues,
+    int32_t byteWidth,
+    char* FOLLY_NONNULL values) {
+  switch (byteWidth) {
+    case 4:
+      detail::decodeByteStreamSplit<4>(data, numValues, values);
+      break;
+    case 8:
+      detail::decodeByteStreamSplit<8>(data, numValues, values);
+      break;
+    default:
+      VELOX_UNSUPPORTED(
+          "BYTE_STREAM_SPLIT not supported for width {}", byteWidth);
+  }
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/common/base/Nulls.h"
+#include "velox/dwio/common/BitPackDecoder.h"
+
+#include <folly/Varint.h>
+
+namespace facebook::velox::parquet {
+
+/// Decoder for DELTA_BINARY_PACKED encoded INT32 and INT64 values. The
+/// encoding has a header with the block size, the number of miniblocks per
+/// block, the total number of values and the first value. Each block has the
+/// minimum delta, the bit width of each miniblock and the miniblocks of
+/// bit-packed deltas from the minimum delta. Values are decoded one miniblock
+/// at a time.
+class DeltaBpDecoder {
+ public:
+  DeltaBpDecoder(const char* FOLLY_NONNULL start, const char* FOLLY_NONNULL end)
+      : bufferStart_(start), bufferEnd_(end) {
+    readHeader();
+  }
+
+  void skip(uint64_t numValues) {
+    skip<false>(numValues, 0, nullptr);
+  }
+
+  template <bool hasNulls>
+  inline void skip(
+      int32_t numValues,
+      int32_t current,
+      const uint64_t* FOLLY_NULLABLE nulls) {
+    if (hasNulls) {
+      numValues = bits::countNonNulls(nulls, current, current + numValues);
+    }
+    // The values depend on all previous deltas, so skipped miniblocks are
+    // decoded too.
+    while (numValues > 0) {
+      if (valueIndex_ == static_cast<int32_t>(values_.size())) {
+        readMiniBlock();
+      }
+      const auto numSkipped =
+          std::min<int32_t>(numValues, values_.size() - valueIndex_);
+      valueIndex_ += numSkipped;
+      numValues -= numSkipped;
+    }
+  }
+
+  template <bool hasNulls, typename Visitor>
+  void readWithVisitor(const uint64_t* FOLLY_NULLABLE nulls, Visitor visitor) {
+    int32_t current = visitor.start();
+    skip<hasNulls>(current, 0, nulls);
+    int32_t toSkip;
+    bool atEnd = false;
+    const bool allowNulls = hasNulls && visitor.allowNulls();
+    for (;;) {
+      if (hasNulls && allowNulls && bits::isBitNull(nulls, current)) {
+        toSkip = visitor.processNull(atEnd);
+      } else {
+        if (hasNulls && !allowNulls) {
+          toSkip = visitor.checkAndSkipNulls(nulls, current, atEnd);
+          if (!Visitor::dense) {
+            skip<false>(toSkip, current, nullptr);
+          }
+          if (atEnd) {
+            return;
+          }
+        }
+
+        // We are at a non-null value on a row to visit.
+        toSkip = visitor.process(
+            static_cast<typename Visitor::DataType>(readLong()), atEnd);
+      }
+      ++current;
+      if (toSkip) {
+        skip<hasNulls>(toSkip, current, nulls);
+        current += toSkip;
+      }
+      if (atEnd) {
+        return;
+      }
+    }
+  }
+
+  /// Returns the next value. INT32 values are returned sign extended.
+  int64_t readLong() {
+    if (valueIndex_ == static_cast<int32_t>(values_.size())) {
+      readMiniBlock();
+    }
+    return values_[valueIndex_++];
+  }
+
+  /// Returns the total number of values in the encoding.
+  int64_t numValues() const {
+    return totalValues_;
+  }
+
+  /// Returns the first byte after the miniblocks read so far. After reading
+  /// all values, this is the end of the encoded data.
+  const char* FOLLY_NONNULL bufferStart() const {
+    return bufferStart_;
+  }
+
+ private:
+  uint64_t readVarint() {
+    folly::ByteRange range(
+        reinterpret_cast<const unsigned char*>(bufferStart_),
+        reinterpret_cast<const unsigned char*>(std::min(
+            bufferStart_ + folly::kMaxVarintLength64, bufferEnd_)));
+    auto value = folly::decodeVarint(range);
+    bufferStart_ = reinterpret_cast<const char*>(range.begin());
+    return value;
+  }
+
+  void readHeader() {
+    const auto blockSize = readVarint();
+    numMiniBlocks_ = readVarint();
+    totalValues_ = readVarint();
+    lastValue_ = folly::decodeZigZag(readVarint());
+    VELOX_CHECK_GT(numMiniBlocks_, 0, "Invalid DELTA_BINARY_PACKED header");
+    valuesPerMiniBlock_ = blockSize / numMiniBlocks_;
+    VELOX_CHECK_EQ(
+        valuesPerMiniBlock_ % 32, 0, "Invalid DELTA_BINARY_PACKED header");
+    if (totalValues_ > 0) {
+      values_.push_back(lastValue_);
+      numUnreadDeltas_ = totalValues_ - 1;
+    }
+    miniBlockIndex_ = numMiniBlocks_;
+  }
+
+  // Decodes the next miniblock into 'values_'.
+  void readMiniBlock() {
+    VELOX_CHECK_GT(
+        numUnreadDeltas_, 0, "Reading past end of DELTA_BINARY_PACKED data");
+    if (miniBlockIndex_ == numMiniBlocks_) {
+      minDelta_ = folly::decodeZigZag(readVarint());
+      VELOX_CHECK_LE(bufferStart_ + numMiniBlocks_, bufferEnd_);
+      bitWidths_ = reinterpret_cast<const uint8_t*>(bufferStart_);
+      bufferStart_ += numMiniBlocks_;
+      miniBlockIndex_ = 0;
+    }
+    const auto bitWidth = bitWidths_[miniBlockIndex_++];
+    VELOX_CHECK_LE(bitWidth, 64, "Invalid DELTA_BINARY_PACKED bit width");
+    // A miniblock is padded to 'valuesPerMiniBlock_' values, a multiple of 32,
+    // so that it always ends at a byte boundary.
+    const auto numBytes = valuesPerMiniBlock_ / 8 * bitWidth;
+    VELOX_CHECK_LE(bufferStart_ + numBytes, bufferEnd_);
+    deltas_.resize(valuesPerMiniBlock_);
+    if (bitWidth == 0) {
+      std::fill(deltas_.begin(), deltas_.end(), 0);
+    } else if (bitWidth <= 32) {
+      unpacked_.resize(valuesPerMiniBlock_);
+      auto* input = reinterpret_cast<const uint8_t*>(bufferStart_);
+      auto* output = unpacked_.data();
+      dwio::common::unpack<uint32_t>(
+          input, numBytes, valuesPerMiniBlock_, bitWidth, output);
+      std::copy(unpacked_.begin(), unpacked_.end(), deltas_.begin());
+    } else {
+      unpackWide(bitWidth);
+    }
+    bufferStart_ += numBytes;
+
+    const auto numDeltas =
+        std::min<int64_t>(numUnreadDeltas_, valuesPerMiniBlock_);
+    values_.resize(numDeltas);
+    // The arithmetic wraps around as in the encoder.
+    uint64_t value = lastValue_;
+    for (auto i = 0; i < numDeltas; ++i) {
+      value += static_cast<uint64_t>(minDelta_) + deltas_[i];
+      values_[i] = value;
+    }
+    lastValue_ = value;
+    valueIndex_ = 0;
+    numUnreadDeltas_ -= numDeltas;
+  }
+
+  // Unpacks a miniblock with deltas wider than 32 bits.
+  void unpackWide(uint8_t bitWidth) {
+    auto* input = reinterpret_cast<const uint8_t*>(bufferStart_);
+    uint64_t bitOffset = 0;
+    for (auto i = 0; i < valuesPerMiniBlock_; ++i) {
+      uint64_t delta = 0;
+      for (auto bit = 0; bit < bitWidth;) {
+        const auto byteOffset = (bitOffset + bit) / 8;
+        const auto shift = (bitOffset + bit) % 8;
+        const auto numBits = std::min<int32_t>(8 - shift, bitWidth - bit);
+        const uint64_t field =
+            (input[byteOffset] >> shift) & ((1 << numBits) - 1);
+        delta |= field << bit;
+        bit += numBits;
+      }
+      deltas_[i] = delta;
+      bitOffset += bitWidth;
+    }
+  }
+
+  const char* FOLLY_NONNULL bufferStart_;
+  const char* FOLLY_NONNULL bufferEnd_;
+
+  uint64_t numMiniBlocks_;
+  uint64_t valuesPerMiniBlock_;
+  int64_t totalValues_;
+
+  // Number of deltas not yet decoded into 'values_'.
+  int64_t numUnreadDeltas_{0};
+
+  // The last decoded value.
+  int64_t lastValue_;
+
+  // Minimum delta and miniblock bit widths of the current block.
+  int64_t minDelta_{0};
+  const uint8_t* FOLLY_NULLABLE bitWidths_{nullptr};
+
+  // Index of the next miniblock in the current block.
+  uint64_t miniBlockIndex_;
+
+  // Unpacked deltas of the current miniblock.
+  std::vector<uint64_t> deltas_;
+  std::vector<uint32_t> unpacked_;
+
+  // Decoded values of the current miniblock and the index of the next value to
+  // return.
+  std::vector<int64_t> values_;
+  int32_t valueIndex_{0};
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
+
+namespace facebook::velox::parquet {
+
+/// Decoder for DELTA_LENGTH_BYTE_ARRAY and DELTA_BYTE_ARRAY encoded strings.
+/// DELTA_LENGTH_BYTE_ARRAY is the DELTA_BINARY_PACKED lengths of all values
+/// followed by the concatenated values. DELTA_BYTE_ARRAY is the
+/// DELTA_BINARY_PACKED lengths of the prefixes shared with the previous value
+/// followed by the suffixes in DELTA_LENGTH_BYTE_ARRAY. The lengths are
+/// decoded for the whole page up front.
+class DeltaByteArrayDecoder {
+ public:
+  /// 'hasPrefixes' is true for DELTA_BYTE_ARRAY.
+  DeltaByteArrayDecoder(
+      const char* FOLLY_NONNULL start,
+      const char* FOLLY_NONNULL end,
+      bool hasPrefixes)
+      : hasPrefixes_(hasPrefixes) {
+    if (hasPrefixes_) {
+      start = readLengths(start, end, prefixLengths_);
+    }
+    data_ = readLengths(start, end, lengths_);
+    VELOX_CHECK(
+        !hasPrefixes_ || prefixLengths_.size() == lengths_.size(),
+        "Mismatched prefix and suffix counts in DELTA_BYTE_ARRAY");
+    dataEnd_ = end;
+  }
+
+  void skip(uint64_t numValues) {
+    skip<false>(numValues, 0, nullptr);
+  }
+
+  template <bool hasNulls>
+  inline void skip(
+      int32_t numValues,
+      int32_t current,
+      const uint64_t* FOLLY_NULLABLE nulls) {
+    if (hasNulls) {
+      numValues = bits::countNonNulls(nulls, current, current + numValues);
+    }
+    if (hasPrefixes_) {
+      // Each value depends on the previous one.
+      for (auto i = 0; i < numValues; ++i) {
+        readString();
+      }
+      return;
+    }
+    VELOX_CHECK_LE(valueIndex_ + numValues, lengths_.size());
+    for (auto i = 0; i < numValues; ++i) {
+      data_ += lengths_[valueIndex_++];
+    }
+  }
+
+  template <bool hasNulls, typename Visitor>
+  void readWithVisitor(const uint64_t* FOLLY_NULLABLE nulls, Visitor visitor) {
+    int32_t current = visitor.start();
+    skip<hasNulls>(current, 0, nulls);
+    int32_t toSkip;
+    bool atEnd = false;
+    const bool allowNulls = hasNulls && visitor.allowNulls();
+    for (;;) {
+      if (hasNulls && allowNulls && bits::isBitNull(nulls, current)) {
+        toSkip = visitor.processNull(atEnd);
+      } else {
+        if (hasNulls && !allowNulls) {
+          toSkip = visitor.checkAndSkipNulls(nulls, current, atEnd);
+          if (!Visitor::dense) {
+            skip<false>(toSkip, current, nullptr);
+          }
+          if (atEnd) {
+            return;
+          }
+        }
+
+        // We are at a non-null value on a row to visit.
+        toSkip = visitor.process(readString(), atEnd);
+      }
+      ++current;
+      if (toSkip) {
+        skip<hasNulls>(toSkip, current, nulls);
+        current += toSkip;
+      }
+      if (atEnd) {
+        return;
+      }
+    }
+  }
+
+  /// Returns the next value. For DELTA_BYTE_ARRAY, the result is valid until
+  /// the next call.
+  folly::StringPiece readString() {
+    VELOX_CHECK_LT(valueIndex_, lengths_.size());
+    const auto length = lengths_[valueIndex_];
+    VELOX_CHECK_LE(data_ + length, dataEnd_);
+    folly::StringPiece suffix(data_, length);
+    data_ += length;
+    if (!hasPrefixes_) {
+      ++valueIndex_;
+      return suffix;
+    }
+    const auto prefixLength = prefixLengths_[valueIndex_++];
+    VELOX_CHECK_LE(prefixLength, lastValue_.size());
+    lastValue_.resize(prefixLength);
+    lastValue_.append(suffix.data(), suffix.size());
+    return folly::StringPiece(lastValue_);
+  }
+
+ private:
+  // Decodes DELTA_BINARY_PACKED lengths from 'start' into 'lengths'. Returns
+  // the first byte after the lengths.
+  static const char* FOLLY_NONNULL readLengths(
+      const char* FOLLY_NONNULL start,
+      const char* FOLLY_NONNULL end,
+      std::vector<int32_t>& lengths) {
+    DeltaBpDecoder decoder(start, end);
+    lengths.resize(decoder.numValues());
+    for (auto& length : lengths) {
+      length = decoder.readLong();
+      VELOX_CHECK_GE(length, 0, "Negative length in delta encoded strings");
+    }
+    return decoder.bufferStart();
+  }
+
+  const bool hasPrefixes_;
+  std::vector<int32_t> prefixLengths_;
+  std::vector<int32_t> lengths_;
+
+  // Index of the next value in 'lengths_'.
+  int32_t valueIndex_{0};
+
+  // The next suffix or value.
+  const char* FOLLY_NONNULL data_;
+  const char* FOLLY_NONNULL dataEnd_;
+
+  // The last value of DELTA_BYTE_ARRAY, which the next value shares a prefix
+  // with.
+  std::string lastValue_;
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/PageIndex.h"
+
+#include <thrift/protocol/TCompactProtocol.h> //@manual
+#include "velox/dwio/common/ScanSpec.h"
+#include "velox/dwio/common/StreamUtil.h"
+#include "velox/dwio/parquet/reader/Statistics.h"
+#include "velox/dwio/parquet/thrift/ThriftTransport.h"
+
+namespace facebook::velox::parquet {
+
+// static
+std::unique_ptr<PageIndex> PageIndex::read(
+    const thrift::RowGroup& rowGroup,
+    const dwio::common::BufferedInput& input) {
+  int64_t begin = std::numeric_limits<int64_t>::max();
+  int64_t end = 0;
+  for (const auto& column : rowGroup.columns) {
+    if (column.__isset.offset_index_offset) {
+      begin = std::min(begin, column.offset_index_offset);
+      end = std::max(
+          end, column.offset_index_offset + column.offset_index_length);
+    }
+    if (column.__isset.column_index_offset) {
+      begin = std::min(begin, column.column_index_offset);
+      end = std::max(
+          end, column.column_index_offset + column.column_index_length);
+    }
+  }
+  if (end <= begin) {
+    return nullptr;
+  }
+  auto stream =
+      input.read(begin, end - begin, dwio::common::LogType::STRIPE_INDEX);
+  std::vector<char> data(end - begin);
+  const char* bufferStart = nullptr;
+  const char* bufferEnd = nullptr;
+  dwio::common::readBytes(
+      data.size(), stream.get(), data.data(), bufferStart, bufferEnd);
+  return std::unique_ptr<PageIndex>(
+      new PageIndex(rowGroup, begin, std::move(data)));
+}
+
+template <typename T>
+T PageIndex::readStruct(int64_t offset, int32_t length) const {
+  VELOX_CHECK_GE(offset, offset_);
+  VELOX_CHECK_LE(offset - offset_ + length, data_.size());
+  auto transport = std::make_shared<thrift::ThriftBufferedTransport>(
+      data_.data() + offset - offset_, length);
+  auto protocol = std::make_unique<apache::thrift::protocol::TCompactProtocolT<
+      thrift::ThriftBufferedTransport>>(transport);
+  T result;
+  result.read(protocol.get());
+  return result;
+}
+
+std::optional<thrift::ColumnIndex> PageIndex::columnIndex(
+    uint32_t column) const {
+  const auto& chunk = rowGroup_.columns[column];
+  if (!chunk.__isset.column_index_offset) {
+    return std::nullopt;
+  }
+  return readStruct<thrift::ColumnIndex>(
+      chunk.column_index_offset, chunk.column_index_length);
+}
+
+std::optional<thrift::OffsetIndex> PageIndex::offsetIndex(
+    uint32_t column) const {
+  const auto& chunk = rowGroup_.columns[column];
+  if (!chunk.__isset.offset_index_offset) {
+    return std::nullopt;
+  }
+  return readStruct<thrift::OffsetIndex>(
+      chunk.offset_index_offset, chunk.offset_index_length);
+}
+
+RowRanges filterPages(
+    const thrift::ColumnIndex& columnIndex,
+    const thrift::OffsetIndex& offsetIndex,
+    int64_t numRows,
+    const TypePtr& type,
+    common::Filter* filter) {
+  const auto& locations = offsetIndex.page_locations;
+  const auto numPages = locations.size();
+  VELOX_CHECK_EQ(numPages, columnIndex.null_pages.size());
+  RowRanges ranges;
+  for (auto i = 0; i < numPages; ++i) {
+    const auto begin = locations[i].first_row_index;
+    const auto end =
+        i + 1 < numPages ? locations[i + 1].first_row_index : numRows;
+    // The page statistics have the same format as the column chunk
+    // statistics.
+    thrift::Statistics pageStats;
+    if (columnIndex.null_pages[i]) {
+      pageStats.__set_null_count(end - begin);
+    } else {
+      pageStats.__set_min_value(columnIndex.min_values[i]);
+      pageStats.__set_max_value(columnIndex.max_values[i]);
+      if (columnIndex.__isset.null_counts) {
+        pageStats.__set_null_count(columnIndex.null_counts[i]);
+      }
+    }
+    auto stats = buildColumnStatisticsFromThrift(pageStats, *type, end - begin);
+    if (!common::testFilter(filter, stats.get(), end - begin, type)) {
+      continue;
+    }
+    if (!ranges.empty() && ranges.back().end == begin) {
+      ranges.back().end = end;
+    } else {
+      ranges.push_back({begin, end});
+    }
+  }
+  return ranges;
+}
+
+RowRanges intersectRowRanges(const RowRanges& left, const RowRanges& right) {
+  RowRanges result;
+  auto i = 0;
+  auto j = 0;
+  while (i < left.size() && j < right.size()) {
+    const auto begin = std::max(left[i].begin, right[j].begin);
+    const auto end = std::min(left[i].end, right[j].end);
+    if (begin < end) {
+      result.push_back({begin, end});
+    }
+    if (left[i].end < right[j].end) {
+      ++i;
+    } else {
+      ++j;
+    }
+  }
+  return result;
+}
+
+} // namespace facebook::velox::parquet
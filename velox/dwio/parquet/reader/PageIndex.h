@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/BufferedInput.h"
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+#include "velox/type/Filter.h"
+
+namespace facebook::velox::parquet {
+
+/// Range of rows [begin, end) of a row group.
+struct RowRange {
+  int64_t begin;
+  int64_t end;
+
+  bool operator==(const RowRange& other) const {
+    return begin == other.begin && end == other.end;
+  }
+};
+
+/// Sorted, non-overlapping ranges of rows of a row group.
+using RowRanges = std::vector<RowRange>;
+
+/// The ColumnIndex and OffsetIndex structures of the column chunks of a row
+/// group. Writers store these for all columns of a row group together
+/// between the row groups and the footer, so they are read with a single IO.
+class PageIndex {
+ public:
+  /// Reads the page index of 'rowGroup' from 'input'. Returns nullptr if no
+  /// column of 'rowGroup' has an OffsetIndex.
+  static std::unique_ptr<PageIndex> read(
+      const thrift::RowGroup& rowGroup,
+      const dwio::common::BufferedInput& input);
+
+  /// Returns the ColumnIndex of the column chunk of leaf 'column' or
+  /// std::nullopt if the chunk has none.
+  std::optional<thrift::ColumnIndex> columnIndex(uint32_t column) const;
+
+  /// Returns the OffsetIndex of the column chunk of leaf 'column' or
+  /// std::nullopt if the chunk has none.
+  std::optional<thrift::OffsetIndex> offsetIndex(uint32_t column) const;
+
+ private:
+  PageIndex(
+      const thrift::RowGroup& rowGroup,
+      uint64_t offset,
+      std::vector<char> data)
+      : rowGroup_(rowGroup), offset_(offset), data_(std::move(data)) {}
+
+  // Deserializes a T from 'length' bytes at file offset 'offset'.
+  template <typename T>
+  T readStruct(int64_t offset, int32_t length) const;
+
+  const thrift::RowGroup& rowGroup_;
+
+  // File offset of the first byte of 'data_'.
+  const uint64_t offset_;
+
+  // The serialized indices of all columns of 'rowGroup_'.
+  const std::vector<char> data_;
+};
+
+/// Returns the ranges of rows on the pages in 'offsetIndex' that may have
+/// values passing 'filter' according to the min/max values and null counts
+/// in 'columnIndex'. 'numRows' is the number of rows in the row group and
+/// 'type' is the type of the column.
+RowRanges filterPages(
+    const thrift::ColumnIndex& columnIndex,
+    const thrift::OffsetIndex& offsetIndex,
+    int64_t numRows,
+    const TypePtr& type,
+    common::Filter* FOLLY_NONNULL filter);
+
+/// Returns the rows that are in both 'left' and 'right'.
+RowRanges intersectRowRanges(const RowRanges& left, const RowRanges& right);
+
+} // namespace facebook::velox::parquet
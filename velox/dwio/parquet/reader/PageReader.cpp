@@ -17,6 +17,7 @@
 #include "velox/dwio/parquet/reader/PageReader.h"
 #include "velox/dwio/common/BufferUtil.h"
 #include "velox/dwio/common/ColumnVisitors.h"
+#include "velox/dwio/parquet/reader/ByteStreamSplitDecoder.h"
 #include "velox/dwio/parquet/reader/NestedStructureDecoder.h"
 #include "velox/dwio/parquet/thrift/ThriftTransport.h"
 #include "velox/vector/FlatVector.h"
@@ -44,7 +45,19 @@ void PageReader::seekToPage(int64_t row) {
       numRowsInPage_ = 0;
       break;
     }
-    PageHeader pageHeader = readPageHeader(chunkSize_ - pageStart_);
+    if (!pageLocations_.empty() && row != kRepDefOnly &&
+        !seekToPageLocation(row)) {
+      // The page of 'row' is not read. Leaves 'this' at an empty page that
+      // ends at 'row'.
+      rowOfPage_ = row;
+      numRepDefsInPage_ = 0;
+      numRowsInPage_ = 0;
+      break;
+    }
+    const int64_t end = regions_.empty()
+        ? chunkSize_
+        : regions_[currentRegion_].offset + regions_[currentRegion_].size;
+    PageHeader pageHeader = readPageHeader(end - pageStart_);
     pageStart_ = pageDataStart_ + pageHeader.compressed_page_size;
 
     switch (pageHeader.type) {
@@ -75,6 +88,77 @@ void PageReader::seekToPage(int64_t row) {
   }
 }
 
+void PageReader::setChunkRegions(
+    std::vector<thrift::PageLocation> pageLocations,
+    std::vector<ChunkRegion> regions) {
+  VELOX_CHECK(isTopLevel_);
+  pageLocations_ = std::move(pageLocations);
+  regions_ = std::move(regions);
+  currentRegion_ = 0;
+  bufferStart_ = bufferEnd_ = nullptr;
+  if (regions_.empty()) {
+    inputStream_.reset();
+    return;
+  }
+  inputStream_ = std::move(regions_[0].stream);
+  streamStart_ = regions_[0].offset;
+  pageStart_ = regions_[0].offset;
+}
+
+bool PageReader::seekToPageLocation(int64_t row) {
+  if (pageStart_ < pageLocations_[0].offset) {
+    // The dictionary page is before the first data page.
+    return true;
+  }
+  auto it = std::upper_bound(
+      pageLocations_.begin(),
+      pageLocations_.end(),
+      row,
+      [](int64_t row, const thrift::PageLocation& location) {
+        return row < location.first_row_index;
+      });
+  VELOX_CHECK(it != pageLocations_.begin());
+  --it;
+  const uint64_t offset = it->offset;
+  if (offset < pageStart_) {
+    // The page with 'row' has been read, so 'row' is past the end.
+    return false;
+  }
+  auto region = std::upper_bound(
+      regions_.begin(),
+      regions_.end(),
+      offset,
+      [](uint64_t offset, const ChunkRegion& region) {
+        return offset < region.offset;
+      });
+  if (region == regions_.begin() ||
+      offset >= (region - 1)->offset + (region - 1)->size) {
+    // The page is not in the ranges to read. This happens when a read ends at
+    // the end of a page and the next page has no rows to read.
+    return false;
+  }
+  --region;
+  rowOfPage_ = it->first_row_index;
+  if (offset == pageStart_) {
+    return true;
+  }
+  const int32_t regionIndex = region - regions_.begin();
+  VELOX_CHECK_GE(regionIndex, currentRegion_);
+  if (regionIndex == currentRegion_) {
+    dwio::common::skipBytes(
+        offset - pageStart_, inputStream_.get(), bufferStart_, bufferEnd_);
+  } else {
+    inputStream_ = std::move(region->stream);
+    streamStart_ = region->offset;
+    currentRegion_ = regionIndex;
+    bufferStart_ = bufferEnd_ = nullptr;
+    dwio::common::skipBytes(
+        offset - streamStart_, inputStream_.get(), bufferStart_, bufferEnd_);
+  }
+  pageStart_ = offset;
+  return true;
+}
+
 PageHeader PageReader::readPageHeader(int64_t remainingSize) {
   // Note that sizeof(PageHeader) may be longer than actually read
   std::shared_ptr<thrift::ThriftBufferedTransport> transport;
@@ -116,7 +200,7 @@ PageHeader PageReader::readPageHeader(int64_t remainingSize) {
   if (wasInBuffer) {
     bufferStart_ += readBytes;
   } else {
-    std::vector<uint64_t> start = {pageDataStart_};
+    std::vector<uint64_t> start = {pageDataStart_ - streamStart_};
     dwio::common::PositionProvider position(start);
     inputStream_->seekToPosition(position);
     bufferStart_ = bufferEnd_ = nullptr;
@@ -678,6 +762,13 @@ int32_t PageReader::getLengthsAndNulls(
 
 void PageReader::makeDecoder() {
   auto parquetType = type_->parquetType_.value();
+  // Pages of a column chunk may have different encodings, e.g. when a writer
+  // falls back from dictionary encoding.
+  directDecoder_.reset();
+  stringDecoder_.reset();
+  booleanDecoder_.reset();
+  deltaBpDecoder_.reset();
+  deltaByteArrayDecoder_.reset();
   switch (encoding_) {
     case Encoding::RLE_DICTIONARY:
     case Encoding::PLAIN_DICTIONARY:
@@ -712,11 +803,54 @@ void PageReader::makeDecoder() {
       }
       break;
     case Encoding::DELTA_BINARY_PACKED:
+      switch (parquetType) {
+        case thrift::Type::INT32:
+        case thrift::Type::INT64:
+          deltaBpDecoder_ = std::make_unique<DeltaBpDecoder>(
+              pageData_, pageData_ + encodedDataSize_);
+          break;
+        default:
+          VELOX_UNSUPPORTED(
+              "DELTA_BINARY_PACKED not supported for Parquet type {}",
+              parquetType);
+      }
+      break;
+    case Encoding::DELTA_LENGTH_BYTE_ARRAY:
+    case Encoding::DELTA_BYTE_ARRAY:
+      VELOX_CHECK_EQ(
+          parquetType,
+          thrift::Type::BYTE_ARRAY,
+          "Delta encoded strings are only supported for BYTE_ARRAY");
+      deltaByteArrayDecoder_ = std::make_unique<DeltaByteArrayDecoder>(
+          pageData_,
+          pageData_ + encodedDataSize_,
+          encoding_ == Encoding::DELTA_BYTE_ARRAY);
+      break;
+    case Encoding::BYTE_STREAM_SPLIT:
+      makeByteStreamSplitDecoder();
+      break;
     default:
       VELOX_UNSUPPORTED("Encoding not supported yet");
   }
 }
 
+void PageReader::makeByteStreamSplitDecoder() {
+  const auto byteWidth = parquetTypeBytes(type_->parquetType_.value());
+  const auto numValues = encodedDataSize_ / byteWidth;
+  dwio::common::ensureCapacity<char>(
+      byteStreamSplitValues_, encodedDataSize_, &pool_);
+  decodeByteStreamSplit(
+      pageData_,
+      numValues,
+      byteWidth,
+      byteStreamSplitValues_->asMutable<char>());
+  directDecoder_ = std::make_unique<dwio::common::DirectDecoder<true>>(
+      std::make_unique<dwio::common::SeekableArrayInputStream>(
+          byteStreamSplitValues_->as<char>(), numValues * byteWidth),
+      false,
+      byteWidth);
+}
+
 void PageReader::skip(int64_t numRows) {
   if (!numRows && firstUnvisited_ != rowOfPage_ + numRowsInPage_) {
     // Return if no skip and position not at end of page or before first page.
@@ -744,6 +878,10 @@ void PageReader::skip(int64_t numRows) {
     stringDecoder_->skip(toSkip);
   } else if (booleanDecoder_) {
     booleanDecoder_->skip(toSkip);
+  } else if (deltaBpDecoder_) {
+    deltaBpDecoder_->skip(toSkip);
+  } else if (deltaByteArrayDecoder_) {
+    deltaByteArrayDecoder_->skip(toSkip);
   } else {
     VELOX_FAIL("No decoder to skip");
   }
@@ -21,6 +21,8 @@
 #include "velox/dwio/common/DirectDecoder.h"
 #include "velox/dwio/common/SelectiveColumnReader.h"
 #include "velox/dwio/parquet/reader/BooleanDecoder.h"
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
+#include "velox/dwio/parquet/reader/DeltaByteArrayDecoder.h"
 #include "velox/dwio/parquet/reader/ParquetTypeWithId.h"
 #include "velox/dwio/parquet/reader/RleBpDataDecoder.h"
 #include "velox/dwio/parquet/reader/StringDecoder.h"
@@ -28,6 +30,14 @@
 
 namespace facebook::velox::parquet {
 
+/// A range of bytes of a column chunk and the stream that reads it.
+struct ChunkRegion {
+  // Offset of the range from the start of the column chunk.
+  uint64_t offset;
+  uint64_t size;
+  std::unique_ptr<dwio::common::SeekableInputStream> stream;
+};
+
 /// Manages access to pages inside a ColumnChunk. Interprets page headers and
 /// encodings and presents the combination of pages and encoded values as a
 /// continuous stream accessible via readWithVisitor().
@@ -51,6 +61,18 @@ class PageReader {
     type_->makeLevelInfo(leafInfo_);
   }
 
+  /// Restricts reading to the ranges of the column chunk in 'regions', which
+  /// are sorted by offset. 'pageLocations' are the locations of all data
+  /// pages of the column chunk from the OffsetIndex, with offsets relative to
+  /// the start of the chunk. Seeking to a row goes directly to the page that
+  /// contains the row. All rows read must be on pages inside 'regions' and
+  /// the first region must contain the dictionary page if there is one. Used
+  /// for top level columns only. 'stream' given to the constructor is not
+  /// used.
+  void setChunkRegions(
+      std::vector<thrift::PageLocation> pageLocations,
+      std::vector<ChunkRegion> regions);
+
   /// Advances 'numRows' top level rows.
   void skip(int64_t numRows);
 
@@ -145,6 +167,12 @@ class PageReader {
   // allowed for non-top level columns.
   void seekToPage(int64_t row);
 
+  // If the dictionary page, if any, has been read, positions the input at
+  // the header of the data page in 'pageLocations_' that contains 'row' and
+  // sets 'rowOfPage_' to the first row of the page. Returns false if 'row' is
+  // after the last data page or its page is not in 'regions_'.
+  bool seekToPageLocation(int64_t row);
+
   // Preloads the repdefs for the column chunk. To avoid preloading,
   // would need a way too clone the input stream so that one stream
   // reads ahead for repdefs and the other tracks the data. This is
@@ -171,6 +199,10 @@ class PageReader {
   void prepareDictionary(const thrift::PageHeader& pageHeader);
   void makeDecoder();
 
+  // Decodes the BYTE_STREAM_SPLIT values of the page into
+  // 'byteStreamSplitValues_' and makes 'directDecoder_' read them.
+  void makeByteStreamSplitDecoder();
+
   // For a non-top level leaf, reads the defs and sets 'leafNulls_' and
   // 'numRowsInPage_' accordingly. This is used for non-top level leaves when
   // 'hasChunkRepDefs_' is false.
@@ -245,6 +277,9 @@ class PageReader {
       if (isDictionary()) {
         auto dictVisitor = visitor.toDictionaryColumnVisitor();
         dictionaryIdDecoder_->readWithVisitor<true>(nulls, dictVisitor);
+      } else if (deltaBpDecoder_) {
+        nullsFromFastPath = false;
+        deltaBpDecoder_->readWithVisitor<true>(nulls, visitor);
       } else {
         directDecoder_->readWithVisitor<true>(
             nulls, visitor, nullsFromFastPath);
@@ -253,6 +288,8 @@ class PageReader {
       if (isDictionary()) {
         auto dictVisitor = visitor.toDictionaryColumnVisitor();
         dictionaryIdDecoder_->readWithVisitor<false>(nullptr, dictVisitor);
+      } else if (deltaBpDecoder_) {
+        deltaBpDecoder_->readWithVisitor<false>(nulls, visitor);
       } else {
         directDecoder_->readWithVisitor<false>(
             nulls, visitor, !this->type_->type->isShortDecimal());
@@ -274,6 +311,9 @@ class PageReader {
         nullsFromFastPath = dwio::common::useFastPath<Visitor, true>(visitor);
         auto dictVisitor = visitor.toStringDictionaryColumnVisitor();
         dictionaryIdDecoder_->readWithVisitor<true>(nulls, dictVisitor);
+      } else if (deltaByteArrayDecoder_) {
+        nullsFromFastPath = false;
+        deltaByteArrayDecoder_->readWithVisitor<true>(nulls, visitor);
       } else {
         nullsFromFastPath = false;
         stringDecoder_->readWithVisitor<true>(nulls, visitor);
@@ -282,6 +322,8 @@ class PageReader {
       if (isDictionary()) {
         auto dictVisitor = visitor.toStringDictionaryColumnVisitor();
         dictionaryIdDecoder_->readWithVisitor<false>(nullptr, dictVisitor);
+      } else if (deltaByteArrayDecoder_) {
+        deltaByteArrayDecoder_->readWithVisitor<false>(nulls, visitor);
       } else {
         stringDecoder_->readWithVisitor<false>(nulls, visitor);
       }
@@ -404,6 +446,19 @@ class PageReader {
   // Offset of current page's header from start of ColumnChunk.
   uint64_t pageStart_{0};
 
+  // Offset of the first byte of 'inputStream_' from start of ColumnChunk.
+  uint64_t streamStart_{0};
+
+  // Locations of the data pages if set by setChunkRegions().
+  std::vector<thrift::PageLocation> pageLocations_;
+
+  // Ranges of the ColumnChunk to read if set by setChunkRegions(). The
+  // stream of the current region is moved to 'inputStream_'.
+  std::vector<ChunkRegion> regions_;
+
+  // Index of the region read by 'inputStream_'.
+  int32_t currentRegion_{0};
+
   // Offset of first byte after current page' header.
   uint64_t pageDataStart_{0};
 
@@ -457,7 +512,12 @@ class PageReader {
   std::unique_ptr<RleBpDataDecoder> dictionaryIdDecoder_;
   std::unique_ptr<StringDecoder> stringDecoder_;
   std::unique_ptr<BooleanDecoder> booleanDecoder_;
+  std::unique_ptr<DeltaBpDecoder> deltaBpDecoder_;
+  std::unique_ptr<DeltaByteArrayDecoder> deltaByteArrayDecoder_;
   // Add decoders for other encodings here.
+
+  // Values of a BYTE_STREAM_SPLIT page in PLAIN layout for 'directDecoder_'.
+  BufferPtr byteStreamSplitValues_;
 };
 
 template <typename Visitor>
@@ -82,6 +82,94 @@ bool ParquetData::rowGroupMatches(
   return true;
 }
 
+namespace {
+uint64_t chunkReadOffset(const thrift::ColumnMetaData& metaData) {
+  uint64_t chunkReadOffset = metaData.data_page_offset;
+  if (metaData.__isset.dictionary_page_offset &&
+      metaData.dictionary_page_offset >= 4) {
+    // this assumes the data pages follow the dict pages directly.
+    chunkReadOffset = metaData.dictionary_page_offset;
+  }
+  VELOX_CHECK_GE(chunkReadOffset, 0);
+  return chunkReadOffset;
+}
+} // namespace
+
+std::optional<RowRanges> ParquetData::filterPages(
+    uint32_t index,
+    const PageIndex& pageIndex,
+    common::Filter* filter) const {
+  auto columnIndex = pageIndex.columnIndex(type_->column);
+  auto offsetIndex = pageIndex.offsetIndex(type_->column);
+  if (!columnIndex.has_value() || !offsetIndex.has_value() ||
+      offsetIndex->page_locations.empty()) {
+    return std::nullopt;
+  }
+  return parquet::filterPages(
+      *columnIndex,
+      *offsetIndex,
+      rowGroups_[index].num_rows,
+      type_->type,
+      filter);
+}
+
+void ParquetData::setRowRanges(
+    uint32_t index,
+    const PageIndex& pageIndex,
+    const RowRanges& rowRanges) {
+  VELOX_CHECK(isTopLevel());
+  auto offsetIndex = pageIndex.offsetIndex(type_->column);
+  if (!offsetIndex.has_value() || offsetIndex->page_locations.empty()) {
+    return;
+  }
+  const auto& metaData = rowGroups_[index].columns[type_->column].meta_data;
+  const auto chunkStart = chunkReadOffset(metaData);
+  const auto numRows = rowGroups_[index].num_rows;
+  auto& pages = pagesToRead_[index];
+  pages.pageLocations = std::move(offsetIndex->page_locations);
+  pages.regions.clear();
+  auto& locations = pages.pageLocations;
+  for (auto& location : locations) {
+    VELOX_CHECK_GE(location.offset, chunkStart);
+    location.offset -= chunkStart;
+  }
+  if (rowRanges.empty()) {
+    return;
+  }
+  // Adds the range of the chunk from 'begin' to 'end', merging it with the
+  // previous range if they are adjacent.
+  auto addRegion = [&](uint64_t begin, uint64_t end) {
+    auto& regions = pages.regions;
+    if (!regions.empty() &&
+        regions.back().offset + regions.back().size == begin) {
+      regions.back().size = end - regions.back().offset;
+    } else {
+      regions.push_back({begin, end - begin, nullptr});
+    }
+  };
+  if (locations[0].offset > 0) {
+    // The dictionary page.
+    addRegion(0, locations[0].offset);
+  }
+  auto range = rowRanges.begin();
+  for (auto i = 0; i < locations.size(); ++i) {
+    const auto pageEnd =
+        i + 1 < locations.size() ? locations[i + 1].first_row_index : numRows;
+    const auto pageBegin = locations[i].first_row_index;
+    while (range != rowRanges.end() && range->end <= pageBegin) {
+      ++range;
+    }
+    if (range == rowRanges.end()) {
+      break;
+    }
+    if (range->begin < pageEnd) {
+      addRegion(
+          locations[i].offset,
+          locations[i].offset + locations[i].compressed_page_size);
+    }
+  }
+}
+
 void ParquetData::enqueueRowGroup(
     uint32_t index,
     dwio::common::BufferedInput& input) {
@@ -92,28 +180,40 @@ void ParquetData::enqueueRowGroup(
       "ColumnMetaData does not exist for schema Id ",
       type_->column);
   auto& metaData = chunk.meta_data;
+  const auto chunkStart = chunkReadOffset(metaData);
+  auto id = dwio::common::StreamIdentifier(type_->column);
 
-  uint64_t chunkReadOffset = metaData.data_page_offset;
-  if (metaData.__isset.dictionary_page_offset &&
-      metaData.dictionary_page_offset >= 4) {
-    // this assumes the data pages follow the dict pages directly.
-    chunkReadOffset = metaData.dictionary_page_offset;
+  auto pages = pagesToRead_.find(index);
+  if (pages != pagesToRead_.end()) {
+    for (auto& region : pages->second.regions) {
+      region.stream =
+          input.enqueue({chunkStart + region.offset, region.size}, &id);
+    }
+    return;
   }
-  VELOX_CHECK_GE(chunkReadOffset, 0);
 
   uint64_t readSize = (metaData.codec == thrift::CompressionCodec::UNCOMPRESSED)
       ? metaData.total_uncompressed_size
       : metaData.total_compressed_size;
 
-  auto id = dwio::common::StreamIdentifier(type_->column);
-  streams_[index] = input.enqueue({chunkReadOffset, readSize}, &id);
+  streams_[index] = input.enqueue({chunkStart, readSize}, &id);
 }
 
 dwio::common::PositionProvider ParquetData::seekToRowGroup(uint32_t index) {
   static std::vector<uint64_t> empty;
   VELOX_CHECK_LT(index, streams_.size());
-  VELOX_CHECK(streams_[index], "Stream not enqueued for column");
   auto& metadata = rowGroups_[index].columns[type_->column].meta_data;
+  auto pages = pagesToRead_.find(index);
+  if (pages != pagesToRead_.end()) {
+    reader_ = std::make_unique<PageReader>(
+        nullptr, pool_, type_, metadata.codec, metadata.total_compressed_size);
+    reader_->setChunkRegions(
+        std::move(pages->second.pageLocations),
+        std::move(pages->second.regions));
+    pagesToRead_.erase(pages);
+    return dwio::common::PositionProvider(empty);
+  }
+  VELOX_CHECK(streams_[index], "Stream not enqueued for column");
   reader_ = std::make_unique<PageReader>(
       std::move(streams_[index]),
       pool_,
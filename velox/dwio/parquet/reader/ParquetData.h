@@ -21,6 +21,7 @@
 #include "velox/dwio/common/BufferUtil.h"
 #include "velox/dwio/common/BufferedInput.h"
 #include "velox/dwio/common/ScanSpec.h"
+#include "velox/dwio/parquet/reader/PageIndex.h"
 #include "velox/dwio/parquet/reader/PageReader.h"
 #include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
 #include "velox/dwio/parquet/thrift/ThriftTransport.h"
@@ -55,6 +56,42 @@ class ParquetData : public dwio::common::FormatData {
   /// Prepares to read data for 'index'th row group.
   void enqueueRowGroup(uint32_t index, dwio::common::BufferedInput& input);
 
+  /// Returns the ranges of rows of the 'index'th row group that may pass
+  /// 'filter' according to the ColumnIndex in 'pageIndex'. Returns
+  /// std::nullopt if the column chunk has no ColumnIndex or OffsetIndex.
+  std::optional<RowRanges> filterPages(
+      uint32_t index,
+      const PageIndex& pageIndex,
+      common::Filter* FOLLY_NONNULL filter) const;
+
+  /// Restricts the data read from the 'index'th row group to the pages with
+  /// rows in 'rowRanges' according to the OffsetIndex in 'pageIndex'. Must be
+  /// called before enqueueRowGroup(). Applies to top level columns only.
+  void setRowRanges(
+      uint32_t index,
+      const PageIndex& pageIndex,
+      const RowRanges& rowRanges);
+
+  /// True if the column is not nested in a repeated or optional type.
+  bool isTopLevel() const {
+    return maxRepeat_ == 0 && maxDefine_ <= 1;
+  }
+
+  /// Returns the file offset of the Bloom filter of the column chunk in the
+  /// 'index'th row group or std::nullopt if the chunk has none.
+  std::optional<int64_t> bloomFilterOffset(uint32_t index) const {
+    const auto& chunk = rowGroups_[index].columns[type_->column];
+    if (!chunk.__isset.meta_data ||
+        !chunk.meta_data.__isset.bloom_filter_offset) {
+      return std::nullopt;
+    }
+    return chunk.meta_data.bloom_filter_offset;
+  }
+
+  const std::optional<thrift::Type::type>& parquetType() const {
+    return type_->parquetType_;
+  }
+
   /// Positions 'this' at 'index'th row group. enqueueRowGroup must be called
   /// first. The returned PositionProvider is empty and should not be used.
   /// Other formats may use it.
@@ -184,6 +221,15 @@ class ParquetData : public dwio::common::FormatData {
   // ahead of first use, not at construction.
   std::vector<std::unique_ptr<dwio::common::SeekableInputStream>> streams_;
 
+  // Data page locations and ranges of the column chunk to read for row groups
+  // restricted by setRowRanges(). The streams of the ranges are set by
+  // enqueueRowGroup().
+  struct PagesToRead {
+    std::vector<thrift::PageLocation> pageLocations;
+    std::vector<ChunkRegion> regions;
+  };
+  std::unordered_map<uint32_t, PagesToRead> pagesToRead_;
+
   const uint32_t maxDefine_;
   const uint32_t maxRepeat_;
   int64_t rowsInRowGroup_;
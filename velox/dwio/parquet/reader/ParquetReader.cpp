@@ -40,6 +40,18 @@ ReaderBase::ReaderBase(
 }
 
 void ReaderBase::loadFileMetaData() {
+  auto* metadataCache = options_.getFileMetadataCache();
+  const dwio::common::FileMetadataKey metadataKey{
+      options_.getFileId(), options_.getFileVersion(), fileLength_};
+  if (metadataCache != nullptr) {
+    auto cached = std::dynamic_pointer_cast<const ParquetFileMetadata>(
+        metadataCache->get(metadataKey));
+    if (cached != nullptr) {
+      fileMetaData_ = cached->fileMetaData;
+      return;
+    }
+  }
+
   bool preloadFile_ = fileLength_ <= filePreloadThreshold_;
   uint64_t readSize =
       preloadFile_ ? fileLength_ : std::min(fileLength_, directorySizeGuess_);
@@ -80,8 +92,14 @@ void ReaderBase::loadFileMetaData() {
   auto thriftProtocol =
       std::make_unique<apache::thrift::protocol::TCompactProtocolT<
           thrift::ThriftBufferedTransport>>(thriftTransport);
-  fileMetaData_ = std::make_unique<thrift::FileMetaData>();
-  fileMetaData_->read(thriftProtocol.get());
+  auto fileMetaData = std::make_shared<thrift::FileMetaData>();
+  fileMetaData->read(thriftProtocol.get());
+  fileMetaData_ = fileMetaData;
+  if (metadataCache != nullptr) {
+    metadataCache->put(
+        metadataKey,
+        std::make_shared<ParquetFileMetadata>(fileMetaData_, footerLength));
+  }
 }
 
 void ReaderBase::initializeSchema() {
@@ -452,19 +470,44 @@ void ReaderBase::scheduleRowGroups(
   auto input = inputs_[thisGroup].get();
   if (!input) {
     auto newInput = input_->clone();
+    filterPages(thisGroup, reader);
     reader.enqueueRowGroup(thisGroup, *newInput);
     newInput->load(dwio::common::LogType::STRIPE);
     inputs_[thisGroup] = std::move(newInput);
   }
   if (nextGroup) {
     auto newInput = input_->clone();
+    filterPages(nextGroup, reader);
     reader.enqueueRowGroup(nextGroup, *newInput);
     newInput->load(dwio::common::LogType::STRIPE);
     inputs_[nextGroup] = std::move(newInput);
   }
   if (currentGroup > 1) {
     inputs_.erase(rowGroupIds[currentGroup - 1]);
+    rowRanges_.erase(rowGroupIds[currentGroup - 1]);
+  }
+}
+
+void ReaderBase::filterPages(uint32_t index, StructColumnReader& reader) {
+  rowRanges_.erase(index);
+  if (!reader.scanSpec()->hasFilter()) {
+    return;
+  }
+  auto pageIndex = PageIndex::read(fileMetaData_->row_groups[index], *input_);
+  if (!pageIndex) {
+    return;
+  }
+  if (auto ranges = reader.filterPages(index, *pageIndex)) {
+    rowRanges_[index] = std::move(*ranges);
+  }
+}
+
+std::optional<RowRanges> ReaderBase::rowRanges(uint32_t index) const {
+  auto it = rowRanges_.find(index);
+  if (it == rowRanges_.end()) {
+    return std::nullopt;
   }
+  return it->second;
 }
 
 int64_t ReaderBase::rowGroupUncompressedSize(
@@ -557,20 +600,36 @@ void ParquetRowReader::filterRowGroups() {
       }
     }
   }
+  if (!rowGroupIds_.empty()) {
+    skippedRowGroups_ += dynamic_cast<StructColumnReader&>(*columnReader_)
+                             .filterRowGroupsByBloomFilters(
+                                 rowGroupIds_, readerBase_->bufferedInput());
+  }
 }
 
 uint64_t ParquetRowReader::next(uint64_t size, velox::VectorPtr& result) {
   VELOX_CHECK_GT(size, 0);
 
-  if (currentRowInGroup_ >= rowsInCurrentRowGroup_) {
-    // attempt to advance to next row group
-    if (!advanceToNextRowGroup()) {
-      return 0;
+  for (;;) {
+    if (currentRowInGroup_ >= rowsInCurrentRowGroup_) {
+      // attempt to advance to next row group
+      if (!advanceToNextRowGroup()) {
+        return 0;
+      }
+    }
+    skipToRowRange();
+    if (currentRowInGroup_ < rowsInCurrentRowGroup_) {
+      break;
     }
   }
 
   uint64_t rowsToRead = std::min(
       static_cast<uint64_t>(size), rowsInCurrentRowGroup_ - currentRowInGroup_);
+  if (rowRanges_.has_value()) {
+    rowsToRead = std::min<uint64_t>(
+        rowsToRead,
+        (*rowRanges_)[currentRowRange_].end - currentRowInGroup_);
+  }
 
   if (rowsToRead > 0) {
     columnReader_->next(rowsToRead, result, nullptr);
@@ -593,14 +652,40 @@ bool ParquetRowReader::advanceToNextRowGroup() {
   currentRowGroupPtr_ = &rowGroups_[rowGroupIds_[currentRowGroupIdsIdx_]];
   rowsInCurrentRowGroup_ = currentRowGroupPtr_->num_rows;
   currentRowInGroup_ = 0;
+  rowRanges_ = readerBase_->rowRanges(nextRowGroupIndex);
+  currentRowRange_ = 0;
   currentRowGroupIdsIdx_++;
   columnReader_->seekToRowGroup(nextRowGroupIndex);
   return true;
 }
 
+void ParquetRowReader::skipToRowRange() {
+  if (!rowRanges_.has_value()) {
+    return;
+  }
+  const auto& ranges = *rowRanges_;
+  while (currentRowRange_ < ranges.size() &&
+         ranges[currentRowRange_].end <= currentRowInGroup_) {
+    ++currentRowRange_;
+  }
+  const uint64_t nextRow = currentRowRange_ < ranges.size()
+      ? std::max<uint64_t>(
+            ranges[currentRowRange_].begin, currentRowInGroup_)
+      : rowsInCurrentRowGroup_;
+  if (nextRow == currentRowInGroup_) {
+    return;
+  }
+  skippedPageRows_ += nextRow - currentRowInGroup_;
+  currentRowInGroup_ = nextRow;
+  if (currentRowInGroup_ < rowsInCurrentRowGroup_) {
+    columnReader_->seekTo(currentRowInGroup_, false);
+  }
+}
+
 void ParquetRowReader::updateRuntimeStats(
     dwio::common::RuntimeStatistics& stats) const {
   stats.skippedStrides += skippedRowGroups_;
+  stats.skippedPageRows += skippedPageRows_;
 }
 
 void ParquetRowReader::resetFilterCaches() {
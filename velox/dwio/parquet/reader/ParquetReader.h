@@ -20,6 +20,7 @@
 #include "velox/dwio/common/Reader.h"
 #include "velox/dwio/common/ReaderFactory.h"
 #include "velox/dwio/common/SelectiveColumnReader.h"
+#include "velox/dwio/parquet/reader/PageIndex.h"
 #include "velox/dwio/parquet/reader/ParquetTypeWithId.h"
 #include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
 
@@ -29,6 +30,26 @@ enum class ParquetMetricsType { HEADER, FILE_METADATA, FILE, BLOCK, TEST };
 
 class StructColumnReader;
 
+/// Deserialized footer of a Parquet file. Cached in a
+/// dwio::common::FileMetadataCache and shared by all readers of the file.
+struct ParquetFileMetadata : public dwio::common::FileMetadata {
+  ParquetFileMetadata(
+      std::shared_ptr<const thrift::FileMetaData> _fileMetaData,
+      uint32_t _footerLength)
+      : fileMetaData(std::move(_fileMetaData)), footerLength(_footerLength) {}
+
+  // The deserialized structs are several times the size of the compact
+  // thrift encoding in the file.
+  uint64_t size() const override {
+    return sizeof(*this) + kExpansionRatio * footerLength;
+  }
+
+  static constexpr uint64_t kExpansionRatio = 4;
+
+  const std::shared_ptr<const thrift::FileMetaData> fileMetaData;
+  const uint32_t footerLength;
+};
+
 /// Metadata and options for reading Parquet.
 class ReaderBase {
  public:
@@ -67,12 +88,19 @@ class ReaderBase {
   }
 
   /// Ensures that streams are enqueued and loading for the row group at
-  /// 'currentGroup'. May start loading one or more subsequent groups.
+  /// 'currentGroup'. May start loading one or more subsequent groups. If the
+  /// row groups have a page index, only the pages that may have rows passing
+  /// the filters of 'reader' are loaded.
   void scheduleRowGroups(
       const std::vector<uint32_t>& groups,
       int32_t currentGroup,
       StructColumnReader& reader);
 
+  /// Returns the ranges of rows to read in the row group 'index' as
+  /// determined from the page index by scheduleRowGroups(). Returns
+  /// std::nullopt if all rows are read.
+  std::optional<RowRanges> rowRanges(uint32_t index) const;
+
   /// Returns the uncompressed size for columns in 'type' and its children in
   /// row
   /// group.
@@ -81,9 +109,14 @@ class ReaderBase {
       const dwio::common::TypeWithId& type) const;
 
  private:
-  // Reads and parses file footer.
+  // Reads and parses file footer. Takes the parsed footer from the
+  // FileMetadataCache of 'options_' if present.
   void loadFileMetaData();
 
+  // Reads the page index of row group 'index' and restricts the pages to read
+  // to the rows that may pass the filters of 'reader'.
+  void filterPages(uint32_t index, StructColumnReader& reader);
+
   void initializeSchema();
 
   std::shared_ptr<const ParquetTypeWithId> getParquetColumnInfo(
@@ -105,7 +138,7 @@ class ReaderBase {
   const dwio::common::ReaderOptions& options_;
   std::unique_ptr<velox::dwio::common::BufferedInput> input_;
   uint64_t fileLength_;
-  std::unique_ptr<thrift::FileMetaData> fileMetaData_;
+  std::shared_ptr<const thrift::FileMetaData> fileMetaData_;
   RowTypePtr schema_;
   std::shared_ptr<const dwio::common::TypeWithId> schemaWithId_;
 
@@ -114,6 +147,9 @@ class ReaderBase {
   // Map from row group index to pre-created loading BufferedInput.
   std::unordered_map<uint32_t, std::unique_ptr<dwio::common::BufferedInput>>
       inputs_;
+
+  // Map from row group index to the rows to read according to the page index.
+  std::unordered_map<uint32_t, RowRanges> rowRanges_;
 };
 
 /// Implements the RowReader interface for Parquet.
@@ -152,14 +188,19 @@ class ParquetRowReader : public dwio::common::RowReader {
   }
 
  private:
-  // Compares row group  metadata to filters in ScanSpec in options of
-  // ReaderBase and determines the set of row groups to scan.
+  // Compares row group  metadata and Bloom filters to filters in ScanSpec in
+  // options of ReaderBase and determines the set of row groups to scan.
   void filterRowGroups();
 
   // Positions the reader tre at the start of the next row group, as determined
   // by filterRowGroups().
   bool advanceToNextRowGroup();
 
+  // Skips the rows of the current row group before the first row range at or
+  // after 'currentRowInGroup_'. Skips to the end of the row group if there is
+  // no such range.
+  void skipToRowRange();
+
   memory::MemoryPool& pool_;
   const std::shared_ptr<ReaderBase> readerBase_;
   const dwio::common::RowReaderOptions& options_;
@@ -174,9 +215,20 @@ class ParquetRowReader : public dwio::common::RowReader {
   uint64_t rowsInCurrentRowGroup_;
   uint64_t currentRowInGroup_;
 
-  // Number of row groups skipped based on stats.
+  // Number of row groups skipped based on stats and Bloom filters.
   int32_t skippedRowGroups_{0};
 
+  // Ranges of rows to read in the current row group according to the page
+  // index. Not set if all rows are read.
+  std::optional<RowRanges> rowRanges_;
+
+  // Index in 'rowRanges_' of the range that contains or follows
+  // 'currentRowInGroup_'.
+  int32_t currentRowRange_{0};
+
+  // Number of rows skipped based on the page index.
+  int64_t skippedPageRows_{0};
+
   std::unique_ptr<dwio::common::SelectiveColumnReader> columnReader_;
 
   RowTypePtr requestedType_;
@@ -15,6 +15,7 @@
  */
 
 #include "velox/dwio/parquet/reader/StructColumnReader.h"
+#include "velox/dwio/parquet/reader/BloomFilter.h"
 #include "velox/dwio/parquet/reader/RepeatedColumnReader.h"
 
 namespace facebook::velox::parquet {
@@ -108,6 +109,101 @@ void StructColumnReader::enqueueRowGroup(
   }
 }
 
+std::optional<RowRanges> StructColumnReader::filterPages(
+    uint32_t index,
+    const PageIndex& pageIndex) {
+  // Rows outside of the ranges are skipped by seeking all children, which
+  // is supported for top level columns only.
+  for (auto* child : children_) {
+    if (dynamic_cast<StructColumnReader*>(child) ||
+        dynamic_cast<ListColumnReader*>(child) ||
+        dynamic_cast<MapColumnReader*>(child) ||
+        !child->formatData().as<ParquetData>().isTopLevel()) {
+      return std::nullopt;
+    }
+  }
+  std::optional<RowRanges> rowRanges;
+  for (auto* child : children_) {
+    auto* filter = child->scanSpec()->filter();
+    if (!filter) {
+      continue;
+    }
+    auto ranges = child->formatData().as<ParquetData>().filterPages(
+        index, pageIndex, filter);
+    if (!ranges.has_value()) {
+      continue;
+    }
+    rowRanges = rowRanges.has_value() ? intersectRowRanges(*rowRanges, *ranges)
+                                      : std::move(*ranges);
+  }
+  if (rowRanges.has_value()) {
+    for (auto* child : children_) {
+      child->formatData().as<ParquetData>().setRowRanges(
+          index, pageIndex, *rowRanges);
+    }
+  }
+  return rowRanges;
+}
+
+int32_t StructColumnReader::filterRowGroupsByBloomFilters(
+    std::vector<uint32_t>& rowGroupIds,
+    const dwio::common::BufferedInput& input) {
+  std::vector<dwio::common::SelectiveColumnReader*> columns;
+  for (auto* child : children_) {
+    if (!child || dynamic_cast<StructColumnReader*>(child) ||
+        dynamic_cast<ListColumnReader*>(child) ||
+        dynamic_cast<MapColumnReader*>(child)) {
+      continue;
+    }
+    auto* filter = child->scanSpec()->filter();
+    if (filter && canUseBloomFilter(*filter) &&
+        child->formatData().as<ParquetData>().parquetType()) {
+      columns.push_back(child);
+    }
+  }
+  if (columns.empty()) {
+    return 0;
+  }
+  // The row group and column of each Bloom filter to read.
+  std::vector<std::pair<int32_t, int32_t>> chunks;
+  std::vector<int64_t> offsets;
+  for (auto i = 0; i < rowGroupIds.size(); ++i) {
+    for (auto j = 0; j < columns.size(); ++j) {
+      auto& data = columns[j]->formatData().as<ParquetData>();
+      if (auto offset = data.bloomFilterOffset(rowGroupIds[i])) {
+        chunks.emplace_back(i, j);
+        offsets.push_back(*offset);
+      }
+    }
+  }
+  if (offsets.empty()) {
+    return 0;
+  }
+  auto bloomFilters = readBloomFilters(offsets, input);
+  std::vector<bool> skip(rowGroupIds.size());
+  for (auto i = 0; i < chunks.size(); ++i) {
+    auto [rowGroup, column] = chunks[i];
+    if (skip[rowGroup] || !bloomFilters[i]) {
+      continue;
+    }
+    auto* child = columns[column];
+    skip[rowGroup] = !testBloomFilter(
+        *child->scanSpec()->filter(),
+        *bloomFilters[i],
+        *child->formatData().as<ParquetData>().parquetType());
+  }
+  int32_t numSkipped = 0;
+  for (auto i = 0; i < rowGroupIds.size(); ++i) {
+    if (skip[i]) {
+      ++numSkipped;
+    } else {
+      rowGroupIds[i - numSkipped] = rowGroupIds[i];
+    }
+  }
+  rowGroupIds.resize(rowGroupIds.size() - numSkipped);
+  return numSkipped;
+}
+
 void StructColumnReader::seekToRowGroup(uint32_t index) {
   SelectiveColumnReader::seekToRowGroup(index);
   BufferPtr noBuffer;
@@ -36,6 +36,23 @@ class StructColumnReader : public dwio::common::SelectiveStructColumnReader {
   /// Creates the streams for 'rowGroup in 'input'. Does not load yet.
   void enqueueRowGroup(uint32_t index, dwio::common::BufferedInput& input);
 
+  /// Restricts reading the 'index'th row group to the pages with rows that
+  /// may pass the filters of the children according to 'pageIndex'. Returns
+  /// the ranges of these rows or std::nullopt if there is no restriction.
+  /// Applies to a root reader with top level primitive children only. Must
+  /// be called before enqueueRowGroup().
+  std::optional<RowRanges> filterPages(
+      uint32_t index,
+      const PageIndex& pageIndex);
+
+  /// Removes from 'rowGroupIds' the row groups in which the Bloom filter of
+  /// a primitive child shows that no value passes the filter of the child.
+  /// The Bloom filters are read from 'input' with coalesced IO. Returns the
+  /// number of removed row groups.
+  int32_t filterRowGroupsByBloomFilters(
+      std::vector<uint32_t>& rowGroupIds,
+      const dwio::common::BufferedInput& input);
+
   // No-op in Parquet. All readers switch row groups at the same time, there is
   // no on-demand skipping to a new row group.
   void advanceFieldReader(
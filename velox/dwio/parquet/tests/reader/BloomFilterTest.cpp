@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/BloomFilter.h"
+
+#include <folly/lang/Bits.h>
+#include <gtest/gtest.h>
+#include <thrift/protocol/TCompactProtocol.h> //@manual
+#include <thrift/transport/TBufferTransports.h> //@manual
+#include "velox/common/file/File.h"
+#include "velox/dwio/parquet/reader/ParquetReader.h"
+#include "velox/dwio/parquet/tests/ParquetReaderTestBase.h"
+#include "velox/dwio/parquet/writer/NativeWriter.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+
+namespace {
+
+// Returns a Bloom filter with the values from 'begin' to 'end' in plain
+// encoding of 'T'.
+template <typename T>
+BloomFilter makeIntegerFilter(int32_t numBytes, T begin, T end) {
+  BloomFilter bloomFilter(numBytes);
+  for (auto i = begin; i < end; ++i) {
+    bloomFilter.insert(
+        sizeof(T) == 4 ? BloomFilter::hashInt32(i)
+                       : BloomFilter::hashInt64(i));
+  }
+  return bloomFilter;
+}
+
+// Returns a BloomFilterHeader for 'bitset' followed by 'bitset'. The header
+// has no hash if 'unsupportedHash' is true.
+std::string serialize(
+    const std::vector<char>& bitset,
+    bool unsupportedHash = false) {
+  thrift::BloomFilterHeader header;
+  header.__set_numBytes(bitset.size());
+  header.algorithm.__set_BLOCK(thrift::SplitBlockAlgorithm());
+  if (!unsupportedHash) {
+    header.hash.__set_XXHASH(thrift::XxHash());
+  }
+  header.compression.__set_UNCOMPRESSED(thrift::Uncompressed());
+  auto buffer = std::make_shared<apache::thrift::transport::TMemoryBuffer>();
+  apache::thrift::protocol::TCompactProtocol protocol(buffer);
+  header.write(&protocol);
+  return buffer->getBufferAsString() +
+      std::string(bitset.data(), bitset.size());
+}
+
+class BloomFilterReaderTest : public dwio::parquet::ParquetReaderTestBase {
+ protected:
+  // Writes 'data' in row groups of 'rowsInRowGroup' rows and adds a Bloom
+  // filter of the BIGINT values of the first column to each row group. The
+  // native writer does not write Bloom filters, so they are inserted between
+  // the data and the footer.
+  std::string writeWithBloomFilters(
+      const RowVectorPtr& data,
+      int32_t rowsInRowGroup) {
+    auto sink = std::make_unique<dwio::common::MemorySink>(*pool_, 64 << 20);
+    auto* sinkPtr = sink.get();
+    NativeWriterOptions options;
+    options.rowsInRowGroup = rowsInRowGroup;
+    NativeWriter writer(
+        std::move(sink), *pool_, asRowType(data->type()), options);
+    writer.write(data);
+    writer.close();
+    std::string file(sinkPtr->getData(), sinkPtr->size());
+
+    dwio::common::ReaderOptions readerOptions{pool_.get()};
+    auto metaData = ReaderBase(makeInput(file), readerOptions).fileMetaData();
+    const auto footerLength =
+        folly::loadUnaligned<uint32_t>(file.data() + file.size() - 8);
+    file.resize(file.size() - 8 - footerLength);
+    auto* values = data->childAt(0)->as<SimpleVector<int64_t>>();
+    vector_size_t row = 0;
+    for (auto& rowGroup : metaData.row_groups) {
+      BloomFilter bloomFilter(8 << 10);
+      for (auto i = 0; i < rowGroup.num_rows; ++i, ++row) {
+        bloomFilter.insert(BloomFilter::hashInt64(values->valueAt(row)));
+      }
+      rowGroup.columns[0].meta_data.__set_bloom_filter_offset(file.size());
+      file += serialize(bloomFilter.bitset());
+    }
+    auto buffer = std::make_shared<apache::thrift::transport::TMemoryBuffer>();
+    apache::thrift::protocol::TCompactProtocol protocol(buffer);
+    metaData.write(&protocol);
+    const auto footer = buffer->getBufferAsString();
+    const uint32_t length = footer.size();
+    file += footer;
+    file.append(reinterpret_cast<const char*>(&length), sizeof(length));
+    file += "PAR1";
+    return file;
+  }
+
+  // Reads the BIGINT first column of 'file' with a filter that passes
+  // 'value'. Returns the values read and the number of skipped row groups.
+  std::pair<std::vector<int64_t>, int64_t>
+  read(const std::string& file, const RowTypePtr& rowType, int64_t value) {
+    dwio::common::ReaderOptions readerOptions{pool_.get()};
+    ParquetReader reader(makeInput(file), readerOptions);
+    auto scanSpec = makeScanSpec(rowType);
+    scanSpec->getOrCreateChild(common::Subfield(rowType->nameOf(0)))
+        ->setFilter(std::make_unique<common::BigintRange>(value, value, false));
+    auto rowReaderOptions = getReaderOpts(rowType);
+    rowReaderOptions.setScanSpec(scanSpec);
+    auto rowReader = reader.createRowReader(rowReaderOptions);
+
+    std::vector<int64_t> values;
+    VectorPtr result;
+    while (rowReader->next(1'000, result) > 0) {
+      auto* column = result->as<RowVector>()
+                         ->childAt(0)
+                         ->loadedVector()
+                         ->as<SimpleVector<int64_t>>();
+      for (auto i = 0; i < result->size(); ++i) {
+        values.push_back(column->valueAt(i));
+      }
+    }
+    dwio::common::RuntimeStatistics stats;
+    rowReader->updateRuntimeStats(stats);
+    return {values, stats.skippedStrides};
+  }
+
+  std::unique_ptr<dwio::common::BufferedInput> makeInput(
+      const std::string& file) {
+    return std::make_unique<dwio::common::BufferedInput>(
+        std::make_shared<InMemoryReadFile>(file), *pool_);
+  }
+};
+
+} // namespace
+
+TEST(BloomFilterTest, insertAndFind) {
+  constexpr int32_t kNumValues = 10'000;
+  auto bloomFilter = makeIntegerFilter<int64_t>(16 << 10, 0, kNumValues);
+  for (auto i = 0; i < kNumValues; ++i) {
+    ASSERT_TRUE(bloomFilter.mayContain(BloomFilter::hashInt64(i)));
+  }
+  // 13 bits per value give about 1% false positives.
+  int32_t numFalsePositives = 0;
+  for (auto i = kNumValues; i < 2 * kNumValues; ++i) {
+    numFalsePositives += bloomFilter.mayContain(BloomFilter::hashInt64(i));
+  }
+  EXPECT_LT(numFalsePositives, kNumValues / 50);
+}
+
+TEST(BloomFilterTest, hash) {
+  // XXH64 with seed 0 of the plain encoded values, as written by other
+  // Parquet implementations.
+  EXPECT_EQ(0xef46db3751d8e999ULL, BloomFilter::hashBytes(""));
+  int32_t int32Value = 5;
+  int64_t int64Value = 5;
+  EXPECT_EQ(
+      BloomFilter::hashBytes(std::string_view(
+          reinterpret_cast<const char*>(&int32Value), sizeof(int32Value))),
+      BloomFilter::hashInt32(5));
+  EXPECT_EQ(
+      BloomFilter::hashBytes(std::string_view(
+          reinterpret_cast<const char*>(&int64Value), sizeof(int64Value))),
+      BloomFilter::hashInt64(5));
+  EXPECT_NE(BloomFilter::hashInt32(5), BloomFilter::hashInt64(5));
+}
+
+TEST(BloomFilterTest, integerFilters) {
+  auto int64Filter = makeIntegerFilter<int64_t>(1 << 10, 1'000, 1'100);
+  auto int32Filter = makeIntegerFilter<int32_t>(1 << 10, 1'000, 1'100);
+  auto test = [&](const common::Filter& filter) {
+    auto int64Result =
+        testBloomFilter(filter, int64Filter, thrift::Type::INT64);
+    EXPECT_EQ(
+        int64Result,
+        testBloomFilter(filter, int32Filter, thrift::Type::INT32));
+    return int64Result;
+  };
+
+  EXPECT_TRUE(test(common::BigintRange(1'050, 1'050, false)));
+  EXPECT_FALSE(test(common::BigintRange(5'000, 5'000, false)));
+  // Ranges are not tested.
+  EXPECT_TRUE(test(common::BigintRange(5'000, 5'001, false)));
+  // Nulls are not in the Bloom filter.
+  EXPECT_TRUE(test(common::BigintRange(5'000, 5'000, true)));
+
+  EXPECT_TRUE(
+      test(common::BigintValuesUsingHashTable(1, 1'099, {1, 1'099}, false)));
+  EXPECT_FALSE(test(common::BigintValuesUsingHashTable(
+      1, 1'000'000, {1, 2'000, 1'000'000}, false)));
+  EXPECT_TRUE(test(common::BigintValuesUsingBitmask(
+      990, 1'010, {990, 1'000, 1'010}, false)));
+  EXPECT_FALSE(
+      test(common::BigintValuesUsingBitmask(990, 999, {990, 999}, false)));
+
+  // Values outside of the INT32 range are not in an INT32 column.
+  auto value = std::numeric_limits<int32_t>::max() + 1'050LL;
+  EXPECT_FALSE(testBloomFilter(
+      common::BigintRange(value, value, false),
+      makeIntegerFilter<int32_t>(1 << 10, 1'000, 1'100),
+      thrift::Type::INT32));
+
+  // Columns with other physical types are not tested.
+  EXPECT_TRUE(testBloomFilter(
+      common::BigintRange(5'000, 5'000, false),
+      int64Filter,
+      thrift::Type::FIXED_LEN_BYTE_ARRAY));
+}
+
+TEST(BloomFilterTest, bytesFilters) {
+  BloomFilter bloomFilter(1 << 10);
+  for (auto i = 0; i < 100; ++i) {
+    bloomFilter.insert(BloomFilter::hashBytes(fmt::format("id-{}", i)));
+  }
+  auto test = [&](const common::Filter& filter) {
+    return testBloomFilter(filter, bloomFilter, thrift::Type::BYTE_ARRAY);
+  };
+  EXPECT_TRUE(test(common::BytesValues({"id-5", "id-500"}, false)));
+  EXPECT_FALSE(test(common::BytesValues({"id-500", "id-501"}, false)));
+  auto range = [](const std::string& lower, const std::string& upper) {
+    return common::BytesRange(lower, false, false, upper, false, false, false);
+  };
+  EXPECT_TRUE(test(range("id-7", "id-7")));
+  EXPECT_FALSE(test(range("id-700", "id-700")));
+  // Ranges are not tested.
+  EXPECT_TRUE(test(range("id-700", "id-701")));
+}
+
+TEST(BloomFilterTest, read) {
+  // A small filter that is read with its header and a large one that needs
+  // a second read.
+  auto small = makeIntegerFilter<int64_t>(1 << 10, 0, 100);
+  auto large = makeIntegerFilter<int64_t>(64 << 10, 0, 10'000);
+  std::string data = "PAR1";
+  std::vector<int64_t> offsets;
+  offsets.push_back(data.size());
+  data += serialize(small.bitset());
+  offsets.push_back(data.size());
+  data += serialize(large.bitset());
+  // A filter with an unsupported hash.
+  offsets.push_back(data.size());
+  data += serialize(std::vector<char>(32), true);
+
+  auto pool = memory::getDefaultMemoryPool();
+  dwio::common::BufferedInput input(
+      std::make_shared<InMemoryReadFile>(std::move(data)), *pool);
+  auto bloomFilters = readBloomFilters(offsets, input);
+  ASSERT_EQ(3, bloomFilters.size());
+  ASSERT_NE(nullptr, bloomFilters[0]);
+  EXPECT_EQ(small.bitset(), bloomFilters[0]->bitset());
+  ASSERT_NE(nullptr, bloomFilters[1]);
+  EXPECT_EQ(large.bitset(), bloomFilters[1]->bitset());
+  EXPECT_EQ(nullptr, bloomFilters[2]);
+}
+
+TEST_F(BloomFilterReaderTest, skipRowGroups) {
+  // Even values from 0 to 19'998 in 4 row groups. An odd value is within the
+  // min and max of a row group but is not in its Bloom filter.
+  auto data = vectorMaker_->rowVector(
+      {"c0"},
+      {vectorMaker_->flatVector<int64_t>(
+          10'000, [](auto row) { return row * 2; })});
+  auto rowType = asRowType(data->type());
+  auto file = writeWithBloomFilters(data, 2'500);
+
+  // The statistics skip the row groups other than the one with 5'000 to
+  // 9'998.
+  auto [values, numSkipped] = read(file, rowType, 5'002);
+  EXPECT_EQ(std::vector<int64_t>{5'002}, values);
+  EXPECT_EQ(3, numSkipped);
+
+  // The Bloom filter skips the remaining row group.
+  std::tie(values, numSkipped) = read(file, rowType, 5'001);
+  EXPECT_TRUE(values.empty());
+  EXPECT_EQ(4, numSkipped);
+}
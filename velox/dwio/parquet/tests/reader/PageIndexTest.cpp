@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/PageIndex.h"
+
+#include <gtest/gtest.h>
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+
+namespace {
+
+std::string int64Bytes(int64_t value) {
+  return std::string(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Page index of a BIGINT column with 'numPages' pages of 100 rows each. Page
+// i has values from i * 100 to i * 100 + 99. The pages in 'nullPages' have
+// only nulls.
+std::pair<thrift::ColumnIndex, thrift::OffsetIndex> makePageIndex(
+    int32_t numPages,
+    const std::vector<int32_t>& nullPages = {}) {
+  thrift::ColumnIndex columnIndex;
+  thrift::OffsetIndex offsetIndex;
+  std::vector<bool> isNullPage(numPages);
+  std::vector<std::string> minValues(numPages);
+  std::vector<std::string> maxValues(numPages);
+  std::vector<int64_t> nullCounts(numPages);
+  std::vector<thrift::PageLocation> locations(numPages);
+  for (auto page : nullPages) {
+    isNullPage[page] = true;
+  }
+  for (auto i = 0; i < numPages; ++i) {
+    if (isNullPage[i]) {
+      nullCounts[i] = 100;
+    } else {
+      minValues[i] = int64Bytes(i * 100);
+      maxValues[i] = int64Bytes(i * 100 + 99);
+    }
+    locations[i].__set_offset(1'000 + i * 800);
+    locations[i].__set_compressed_page_size(800);
+    locations[i].__set_first_row_index(i * 100);
+  }
+  columnIndex.__set_null_pages(isNullPage);
+  columnIndex.__set_min_values(minValues);
+  columnIndex.__set_max_values(maxValues);
+  columnIndex.__set_null_counts(nullCounts);
+  columnIndex.__set_boundary_order(thrift::BoundaryOrder::ASCENDING);
+  offsetIndex.__set_page_locations(locations);
+  return {columnIndex, offsetIndex};
+}
+
+RowRanges filter(
+    const std::pair<thrift::ColumnIndex, thrift::OffsetIndex>& pageIndex,
+    common::Filter& filter) {
+  return filterPages(
+      pageIndex.first,
+      pageIndex.second,
+      pageIndex.second.page_locations.size() * 100,
+      BIGINT(),
+      &filter);
+}
+
+} // namespace
+
+TEST(PageIndexTest, filterPages) {
+  auto pageIndex = makePageIndex(10);
+
+  common::BigintRange point(250, 250, false);
+  EXPECT_EQ(RowRanges({{200, 300}}), filter(pageIndex, point));
+
+  // Adjacent pages are merged into one range.
+  common::BigintRange range(150, 420, false);
+  EXPECT_EQ(RowRanges({{100, 500}}), filter(pageIndex, range));
+
+  common::BigintRange boundary(199, 200, false);
+  EXPECT_EQ(RowRanges({{100, 300}}), filter(pageIndex, boundary));
+
+  common::BigintRange none(2'000, 3'000, false);
+  EXPECT_EQ(RowRanges{}, filter(pageIndex, none));
+}
+
+TEST(PageIndexTest, filterNullPages) {
+  auto pageIndex = makePageIndex(5, {1, 3});
+
+  common::IsNull isNull;
+  EXPECT_EQ(RowRanges({{100, 200}, {300, 400}}), filter(pageIndex, isNull));
+
+  common::IsNotNull isNotNull;
+  EXPECT_EQ(
+      RowRanges({{0, 100}, {200, 300}, {400, 500}}),
+      filter(pageIndex, isNotNull));
+
+  // Pages with only nulls pass a filter that allows nulls.
+  common::BigintRange rangeOrNull(0, 10, true);
+  EXPECT_EQ(
+      RowRanges({{0, 200}, {300, 400}}), filter(pageIndex, rangeOrNull));
+}
+
+TEST(PageIndexTest, intersectRowRanges) {
+  EXPECT_EQ(
+      RowRanges({{10, 20}, {50, 60}, {70, 80}}),
+      intersectRowRanges(
+          {{0, 20}, {50, 100}}, {{10, 30}, {40, 60}, {70, 80}, {100, 110}}));
+  EXPECT_EQ(RowRanges{}, intersectRowRanges({{0, 10}}, {{10, 20}}));
+  EXPECT_EQ(RowRanges{}, intersectRowRanges({}, {{10, 20}}));
+  EXPECT_EQ(
+      RowRanges({{5, 10}}), intersectRowRanges({{0, 100}}, {{5, 10}}));
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/ByteStreamSplitDecoder.h"
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
+#include "velox/dwio/parquet/reader/DeltaByteArrayDecoder.h"
+#include "velox/dwio/parquet/tests/reader/ParquetEncoderTestUtil.h"
+
+#include <fmt/format.h>
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+
+#include <unordered_map>
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+using namespace facebook::velox::parquet::test;
+
+namespace {
+
+constexpr int32_t kNumValues = 1'000'000;
+
+const std::string& deltaEncodedIntegers(int64_t range) {
+  static std::unordered_map<int64_t, std::string> encoded;
+  auto& data = encoded[range];
+  if (data.empty()) {
+    std::vector<int64_t> values(kNumValues);
+    for (auto i = 0; i < kNumValues; ++i) {
+      values[i] = i + folly::Random::rand64(range);
+    }
+    encodeDeltaBinaryPacked(values, data);
+  }
+  return data;
+}
+
+void decodeDeltaBinaryPacked(int64_t range) {
+  folly::BenchmarkSuspender suspender;
+  const auto& data = deltaEncodedIntegers(range);
+  suspender.dismiss();
+  DeltaBpDecoder decoder(data.data(), data.data() + data.size());
+  int64_t sum = 0;
+  for (auto i = 0; i < kNumValues; ++i) {
+    sum += decoder.readLong();
+  }
+  folly::doNotOptimizeAway(sum);
+}
+
+const std::string& deltaEncodedStrings(bool hasPrefixes) {
+  static std::string encoded[2];
+  auto& data = encoded[hasPrefixes];
+  if (data.empty()) {
+    std::vector<std::string> values(kNumValues);
+    for (auto i = 0; i < kNumValues; ++i) {
+      values[i] = fmt::format("key_{:010}", i * 7);
+    }
+    if (hasPrefixes) {
+      encodeDeltaByteArray(values, data);
+    } else {
+      encodeDeltaLengthByteArray(values, data);
+    }
+  }
+  return data;
+}
+
+void decodeDeltaByteArray(bool hasPrefixes) {
+  folly::BenchmarkSuspender suspender;
+  const auto& data = deltaEncodedStrings(hasPrefixes);
+  suspender.dismiss();
+  DeltaByteArrayDecoder decoder(
+      data.data(), data.data() + data.size(), hasPrefixes);
+  int64_t size = 0;
+  for (auto i = 0; i < kNumValues; ++i) {
+    size += decoder.readString().size();
+  }
+  folly::doNotOptimizeAway(size);
+}
+
+template <typename T>
+void decodeByteStreamSplit() {
+  folly::BenchmarkSuspender suspender;
+  static std::string data;
+  if (data.empty()) {
+    std::vector<T> values(kNumValues);
+    for (auto i = 0; i < kNumValues; ++i) {
+      values[i] = i * 1.1;
+    }
+    encodeByteStreamSplit(values, data);
+  }
+  std::vector<T> result(kNumValues);
+  suspender.dismiss();
+  decodeByteStreamSplit(
+      data.data(),
+      kNumValues,
+      sizeof(T),
+      reinterpret_cast<char*>(result.data()));
+  folly::doNotOptimizeAway(result);
+}
+
+BENCHMARK(deltaBinaryPacked8Bit) {
+  decodeDeltaBinaryPacked(1 << 8);
+}
+
+BENCHMARK(deltaBinaryPacked20Bit) {
+  decodeDeltaBinaryPacked(1 << 20);
+}
+
+BENCHMARK(deltaBinaryPacked48Bit) {
+  decodeDeltaBinaryPacked(1LL << 48);
+}
+
+BENCHMARK(deltaLengthByteArray) {
+  decodeDeltaByteArray(false);
+}
+
+BENCHMARK(deltaByteArray) {
+  decodeDeltaByteArray(true);
+}
+
+BENCHMARK(byteStreamSplitFloat) {
+  decodeByteStreamSplit<float>();
+}
+
+BENCHMARK(byteStreamSplitDouble) {
+  decodeByteStreamSplit<double>();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "velox/dwio/parquet/reader/ByteStreamSplitDecoder.h"
+#include "velox/dwio/parquet/reader/DeltaBpDecoder.h"
+#include "velox/dwio/parquet/reader/DeltaByteArrayDecoder.h"
+#include "velox/dwio/parquet/tests/reader/ParquetEncoderTestUtil.h"
+
+#include <fmt/format.h>
+#include <gtest/gtest.h>
+
+#include <limits>
+
+using namespace facebook::velox;
+using namespace facebook::velox::parquet;
+using namespace facebook::velox::parquet::test;
+
+namespace {
+
+void testDeltaBinaryPacked(
+    const std::vector<int64_t>& values,
+    int32_t blockSize = 128,
+    int32_t numMiniBlocks = 4) {
+  std::string data;
+  encodeDeltaBinaryPacked(values, data, blockSize, numMiniBlocks);
+  DeltaBpDecoder decoder(data.data(), data.data() + data.size());
+  EXPECT_EQ(values.size(), decoder.numValues());
+  for (auto i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(values[i], decoder.readLong()) << "at " << i;
+  }
+  EXPECT_EQ(data.data() + data.size(), decoder.bufferStart());
+
+  // Skips over values in steps that cross miniblocks and blocks.
+  DeltaBpDecoder skipDecoder(data.data(), data.data() + data.size());
+  for (auto i = 0; i < values.size(); i += 40) {
+    ASSERT_EQ(values[i], skipDecoder.readLong()) << "at " << i;
+    skipDecoder.skip(std::min<int64_t>(39, values.size() - i - 1));
+  }
+}
+
+std::vector<std::string> makeStrings(int32_t numValues) {
+  std::vector<std::string> values;
+  for (auto i = 0; i < numValues; ++i) {
+    // Sorted values with common prefixes of different lengths.
+    values.push_back(
+        fmt::format("prefix_{:05}_{}", i / 7, std::string(i % 11, 'x')));
+  }
+  values.push_back("");
+  values.push_back("p");
+  return values;
+}
+
+void testDeltaByteArray(
+    const std::vector<std::string>& values,
+    bool hasPrefixes) {
+  std::string data;
+  if (hasPrefixes) {
+    encodeDeltaByteArray(values, data);
+  } else {
+    encodeDeltaLengthByteArray(values, data);
+  }
+  DeltaByteArrayDecoder decoder(
+      data.data(), data.data() + data.size(), hasPrefixes);
+  for (auto i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(values[i], decoder.readString().str()) << "at " << i;
+  }
+
+  DeltaByteArrayDecoder skipDecoder(
+      data.data(), data.data() + data.size(), hasPrefixes);
+  for (auto i = 0; i < values.size(); i += 10) {
+    ASSERT_EQ(values[i], skipDecoder.readString().str()) << "at " << i;
+    skipDecoder.skip(std::min<int64_t>(9, values.size() - i - 1));
+  }
+}
+
+} // namespace
+
+TEST(ParquetDecoderTest, deltaBinaryPacked) {
+  std::vector<int64_t> values;
+  for (auto i = 0; i < 1'000; ++i) {
+    values.push_back(i * 3 - (i % 7) * 100);
+  }
+  testDeltaBinaryPacked(values);
+  testDeltaBinaryPacked(values, 256, 8);
+
+  // Constant deltas have miniblocks of bit width 0.
+  std::vector<int64_t> sequence;
+  for (auto i = 0; i < 500; ++i) {
+    sequence.push_back(1'000 + i);
+  }
+  testDeltaBinaryPacked(sequence);
+
+  // Fewer values than a miniblock, a single value and no values.
+  testDeltaBinaryPacked({5, -3, 11});
+  testDeltaBinaryPacked({-17});
+  testDeltaBinaryPacked({});
+}
+
+TEST(ParquetDecoderTest, deltaBinaryPackedWide) {
+  // Deltas that need more than 32 bits, up to the full 64 bits.
+  std::vector<int64_t> values;
+  for (auto i = 0; i < 300; ++i) {
+    switch (i % 3) {
+      case 0:
+        values.push_back(std::numeric_limits<int64_t>::min() + i);
+        break;
+      case 1:
+        values.push_back(std::numeric_limits<int64_t>::max() - i);
+        break;
+      default:
+        values.push_back((1LL << 40) * i);
+    }
+  }
+  testDeltaBinaryPacked(values);
+
+  std::vector<int64_t> medium;
+  for (auto i = 0; i < 300; ++i) {
+    medium.push_back((i % 5) * (1LL << 35) + i);
+  }
+  testDeltaBinaryPacked(medium);
+}
+
+TEST(ParquetDecoderTest, deltaLengthByteArray) {
+  testDeltaByteArray(makeStrings(1'000), false);
+  testDeltaByteArray({""}, false);
+}
+
+TEST(ParquetDecoderTest, deltaByteArray) {
+  testDeltaByteArray(makeStrings(1'000), true);
+  testDeltaByteArray({"abc", "abc", "ab", "abcd", ""}, true);
+}
+
+TEST(ParquetDecoderTest, byteStreamSplit) {
+  std::vector<double> doubles;
+  std::vector<float> floats;
+  for (auto i = 0; i < 1'001; ++i) {
+    doubles.push_back(i * 1.1 - 500);
+    floats.push_back(i / 3.0f);
+  }
+  std::string data;
+  encodeByteStreamSplit(doubles, data);
+  std::vector<double> decodedDoubles(doubles.size());
+  decodeByteStreamSplit(
+      data.data(),
+      doubles.size(),
+      sizeof(double),
+      reinterpret_cast<char*>(decodedDoubles.data()));
+  EXPECT_EQ(doubles, decodedDoubles);
+
+  data.clear();
+  encodeByteStreamSplit(floats, data);
+  std::vector<float> decodedFloats(floats.size());
+  decodeByteStreamSplit(
+      data.data(),
+      floats.size(),
+      sizeof(float),
+      reinterpret_cast<char*>(decodedFloats.data()));
+  EXPECT_EQ(floats, decodedFloats);
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <folly/Varint.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace facebook::velox::parquet::test {
+
+// Encoders for Parquet encodings that the Arrow writer does not produce. Used
+// to test and benchmark the decoders.
+
+inline void appendVarint(uint64_t value, std::string& out) {
+  uint8_t buffer[folly::kMaxVarintLength64];
+  auto size = folly::encodeVarint(value, buffer);
+  out.append(reinterpret_cast<const char*>(buffer), size);
+}
+
+// Appends 'values' bit-packed with 'bitWidth' bits each, least significant bit
+// first.
+inline void appendBitPacked(
+    const std::vector<uint64_t>& values,
+    int32_t bitWidth,
+    std::string& out) {
+  std::vector<uint8_t> bytes(values.size() * bitWidth / 8);
+  uint64_t bitOffset = 0;
+  for (auto value : values) {
+    for (auto bit = 0; bit < bitWidth; ++bit, ++bitOffset) {
+      if ((value >> bit) & 1) {
+        bytes[bitOffset / 8] |= 1 << (bitOffset % 8);
+      }
+    }
+  }
+  out.append(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+// Appends 'values' in DELTA_BINARY_PACKED encoding.
+inline void encodeDeltaBinaryPacked(
+    const std::vector<int64_t>& values,
+    std::string& out,
+    int32_t blockSize = 128,
+    int32_t numMiniBlocks = 4) {
+  const auto valuesPerMiniBlock = blockSize / numMiniBlocks;
+  appendVarint(blockSize, out);
+  appendVarint(numMiniBlocks, out);
+  appendVarint(values.size(), out);
+  appendVarint(folly::encodeZigZag(values.empty() ? 0 : values[0]), out);
+  for (size_t start = 1; start < values.size(); start += blockSize) {
+    const auto end = std::min<size_t>(start + blockSize, values.size());
+    std::vector<int64_t> deltas;
+    for (auto i = start; i < end; ++i) {
+      deltas.push_back(
+          static_cast<uint64_t>(values[i]) -
+          static_cast<uint64_t>(values[i - 1]));
+    }
+    const auto minDelta = *std::min_element(deltas.begin(), deltas.end());
+    appendVarint(folly::encodeZigZag(minDelta), out);
+    std::vector<std::vector<uint64_t>> miniBlocks;
+    std::string widths(numMiniBlocks, '\0');
+    for (size_t i = 0; i < deltas.size(); i += valuesPerMiniBlock) {
+      std::vector<uint64_t> miniBlock(valuesPerMiniBlock, 0);
+      uint64_t maxDelta = 0;
+      const auto miniBlockEnd =
+          std::min<size_t>(i + valuesPerMiniBlock, deltas.size());
+      for (auto j = i; j < miniBlockEnd; ++j) {
+        miniBlock[j - i] =
+            static_cast<uint64_t>(deltas[j]) - static_cast<uint64_t>(minDelta);
+        maxDelta = std::max(maxDelta, miniBlock[j - i]);
+      }
+      widths[miniBlocks.size()] =
+          maxDelta == 0 ? 0 : 64 - __builtin_clzll(maxDelta);
+      miniBlocks.push_back(std::move(miniBlock));
+    }
+    out.append(widths);
+    for (auto i = 0; i < miniBlocks.size(); ++i) {
+      appendBitPacked(miniBlocks[i], widths[i], out);
+    }
+  }
+}
+
+// Appends 'values' in DELTA_LENGTH_BYTE_ARRAY encoding.
+inline void encodeDeltaLengthByteArray(
+    const std::vector<std::string>& values,
+    std::string& out) {
+  std::vector<int64_t> lengths;
+  for (const auto& value : values) {
+    lengths.push_back(value.size());
+  }
+  encodeDeltaBinaryPacked(lengths, out);
+  for (const auto& value : values) {
+    out.append(value);
+  }
+}
+
+// Appends 'values' in DELTA_BYTE_ARRAY encoding.
+inline void encodeDeltaByteArray(
+    const std::vector<std::string>& values,
+    std::string& out) {
+  std::vector<int64_t> prefixLengths;
+  std::vector<std::string> suffixes;
+  std::string previous;
+  for (const auto& value : values) {
+    size_t prefix = 0;
+    while (prefix < previous.size() && prefix < value.size() &&
+           previous[prefix] == value[prefix]) {
+      ++prefix;
+    }
+    prefixLengths.push_back(prefix);
+    suffixes.push_back(value.substr(prefix));
+    previous = value;
+  }
+  encodeDeltaBinaryPacked(prefixLengths, out);
+  encodeDeltaLengthByteArray(suffixes, out);
+}
+
+// Appends 'values' in BYTE_STREAM_SPLIT encoding.
+template <typename T>
+void encodeByteStreamSplit(const std::vector<T>& values, std::string& out) {
+  const auto start = out.size();
+  out.resize(start + values.size() * sizeof(T));
+  for (size_t i = 0; i < values.size(); ++i) {
+    const auto* bytes = reinterpret_cast<const char*>(&values[i]);
+    for (size_t byte = 0; byte < sizeof(T); ++byte) {
+      out[start + byte * values.size() + i] = bytes[byte];
+    }
+  }
+}
+
+} // namespace facebook::velox::parquet::test
@@ -17,6 +17,9 @@
 #include "velox/dwio/parquet/reader/ParquetReader.h"
 #include "velox/dwio/parquet/tests/ParquetReaderTestBase.h"
 
+#include <thrift/protocol/TCompactProtocol.h> //@manual
+#include <thrift/transport/TBufferTransports.h> //@manual
+
 using namespace facebook::velox;
 using namespace facebook::velox::common;
 using namespace facebook::velox::dwio::common;
@@ -25,7 +28,110 @@ using namespace facebook::velox::parquet;
 
 namespace {
 auto defaultPool = memory::getDefaultMemoryPool();
+
+// Appends the thrift compact serialization of 'object' to 'out'. Returns the
+// size of the serialization.
+template <typename T>
+int32_t appendThrift(const T& object, std::string& out) {
+  auto buffer = std::make_shared<apache::thrift::transport::TMemoryBuffer>();
+  apache::thrift::protocol::TCompactProtocolT<
+      apache::thrift::transport::TMemoryBuffer>
+      protocol(buffer);
+  object.write(&protocol);
+  uint8_t* data;
+  uint32_t size;
+  buffer->getBuffer(&data, &size);
+  out.append(reinterpret_cast<const char*>(data), size);
+  return size;
+}
+
+std::string int64Bytes(int64_t value) {
+  return std::string(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+// Returns a Parquet file with one row group of a required BIGINT column 'a'
+// with the values 0 to 'numPages' * 'pageRows' - 1. Each page is PLAIN
+// encoded and uncompressed. The file has a ColumnIndex and an OffsetIndex.
+std::string makePageIndexFile(int32_t numPages, int32_t pageRows) {
+  std::string file = "PAR1";
+  const int64_t numRows = numPages * pageRows;
+  thrift::ColumnIndex columnIndex;
+  thrift::OffsetIndex offsetIndex;
+  for (auto page = 0; page < numPages; ++page) {
+    std::string data;
+    for (int64_t row = page * pageRows; row < (page + 1) * pageRows; ++row) {
+      data += int64Bytes(row);
+    }
+    thrift::DataPageHeader dataHeader;
+    dataHeader.__set_num_values(pageRows);
+    dataHeader.__set_encoding(thrift::Encoding::PLAIN);
+    dataHeader.__set_definition_level_encoding(thrift::Encoding::RLE);
+    dataHeader.__set_repetition_level_encoding(thrift::Encoding::RLE);
+    thrift::PageHeader header;
+    header.__set_type(thrift::PageType::DATA_PAGE);
+    header.__set_uncompressed_page_size(data.size());
+    header.__set_compressed_page_size(data.size());
+    header.__set_data_page_header(dataHeader);
+
+    thrift::PageLocation location;
+    location.__set_offset(file.size());
+    location.__set_first_row_index(page * pageRows);
+    appendThrift(header, file);
+    file += data;
+    location.__set_compressed_page_size(file.size() - location.offset);
+    offsetIndex.page_locations.push_back(location);
+    columnIndex.null_pages.push_back(false);
+    columnIndex.min_values.push_back(int64Bytes(page * pageRows));
+    columnIndex.max_values.push_back(int64Bytes((page + 1) * pageRows - 1));
+    columnIndex.null_counts.push_back(0);
+  }
+  columnIndex.__set_boundary_order(thrift::BoundaryOrder::ASCENDING);
+  columnIndex.__isset.null_counts = true;
+
+  const int64_t chunkOffset = offsetIndex.page_locations[0].offset;
+  const int64_t chunkSize = file.size() - chunkOffset;
+  thrift::ColumnMetaData metaData;
+  metaData.__set_type(thrift::Type::INT64);
+  metaData.__set_encodings({thrift::Encoding::PLAIN});
+  metaData.__set_path_in_schema({"a"});
+  metaData.__set_codec(thrift::CompressionCodec::UNCOMPRESSED);
+  metaData.__set_num_values(numRows);
+  metaData.__set_total_uncompressed_size(chunkSize);
+  metaData.__set_total_compressed_size(chunkSize);
+  metaData.__set_data_page_offset(chunkOffset);
+  thrift::ColumnChunk chunk;
+  chunk.__set_file_offset(chunkOffset);
+  chunk.__set_meta_data(metaData);
+  chunk.__set_column_index_offset(file.size());
+  chunk.__set_column_index_length(appendThrift(columnIndex, file));
+  chunk.__set_offset_index_offset(file.size());
+  chunk.__set_offset_index_length(appendThrift(offsetIndex, file));
+
+  thrift::RowGroup rowGroup;
+  rowGroup.__set_columns({chunk});
+  rowGroup.__set_total_byte_size(chunkSize);
+  rowGroup.__set_num_rows(numRows);
+
+  std::vector<thrift::SchemaElement> schema(2);
+  schema[0].__set_name("schema");
+  schema[0].__set_num_children(1);
+  schema[1].__set_name("a");
+  schema[1].__set_type(thrift::Type::INT64);
+  schema[1].__set_repetition_type(thrift::FieldRepetitionType::REQUIRED);
+  thrift::ColumnOrder columnOrder;
+  columnOrder.__set_TYPE_ORDER(thrift::TypeDefinedOrder());
+  thrift::FileMetaData fileMetaData;
+  fileMetaData.__set_version(1);
+  fileMetaData.__set_schema(schema);
+  fileMetaData.__set_num_rows(numRows);
+  fileMetaData.__set_row_groups({rowGroup});
+  fileMetaData.__set_column_orders({columnOrder});
+  const int32_t footerSize = appendThrift(fileMetaData, file);
+  file.append(reinterpret_cast<const char*>(&footerSize), sizeof(footerSize));
+  file += "PAR1";
+  return file;
 }
+} // namespace
 
 class ParquetReaderTest : public ParquetReaderTestBase {};
 
@@ -193,3 +299,80 @@ TEST_F(ParquetReaderTest, parseIntDecimal) {
     EXPECT_EQ(b[index + 1].unscaledValue(), expectValues[i]);
   }
 }
+
+TEST_F(ParquetReaderTest, fileMetadataCache) {
+  const std::string sample(getExampleFilePath("sample.parquet"));
+  FileMetadataCache cache(1 << 20);
+  ReaderOptions readerOpts{defaultPool.get()};
+  readerOpts.setFileMetadataCache(&cache, 1, 1);
+  ParquetReader first = createReader(sample, readerOpts);
+  EXPECT_EQ(cache.stats().numMisses, 1);
+  EXPECT_EQ(cache.stats().numHits, 0);
+  EXPECT_GT(cache.stats().cachedBytes, 0);
+
+  // The second reader of the same file takes the footer from the cache and
+  // reads the data with it.
+  ParquetReader second = createReader(sample, readerOpts);
+  EXPECT_EQ(cache.stats().numHits, 1);
+  EXPECT_EQ(second.numberOfRows(), 20ULL);
+  auto rowType = ROW({"a"}, {BIGINT()});
+  RowReaderOptions rowReaderOpts;
+  rowReaderOpts.setScanSpec(makeScanSpec(rowType));
+  auto rowReader = second.createRowReader(rowReaderOpts);
+  auto result = BaseVector::create(rowType, 1, pool_.get());
+  int64_t expected = 1;
+  while (rowReader->next(100, result)) {
+    auto values = result->as<RowVector>()->childAt(0)->asFlatVector<int64_t>();
+    for (auto i = 0; i < result->size(); ++i) {
+      EXPECT_EQ(values->valueAt(i), expected++);
+    }
+  }
+  EXPECT_EQ(expected, 21);
+
+  // The same file opened by a new file handle is parsed again.
+  ReaderOptions reopenedOpts{defaultPool.get()};
+  reopenedOpts.setFileMetadataCache(&cache, 1, 2);
+  ParquetReader reopened = createReader(sample, reopenedOpts);
+  EXPECT_EQ(cache.stats().numMisses, 2);
+  EXPECT_EQ(cache.stats().numHits, 1);
+}
+
+TEST_F(ParquetReaderTest, pageIndexFilter) {
+  // 10 pages of 100 rows. A filter on [250, 349] matches pages 2 and 3.
+  ReaderOptions readerOpts{defaultPool.get()};
+  ParquetReader reader(
+      std::make_unique<BufferedInput>(
+          std::make_shared<InMemoryReadFile>(makePageIndexFile(10, 100)),
+          readerOpts.getMemoryPool()),
+      readerOpts);
+  EXPECT_EQ(reader.numberOfRows(), 1'000ULL);
+
+  auto rowType = ROW({"a"}, {BIGINT()});
+  auto scanSpec = makeScanSpec(rowType);
+  scanSpec->getOrCreateChild(Subfield("a"))
+      ->setFilter(std::make_unique<BigintRange>(250, 349, false));
+  auto rowReaderOpts = getReaderOpts(rowType);
+  rowReaderOpts.setScanSpec(scanSpec);
+  auto rowReader = reader.createRowReader(rowReaderOpts);
+
+  std::vector<int64_t> values;
+  auto result = BaseVector::create(rowType, 1, pool_.get());
+  while (rowReader->next(1'000, result) > 0) {
+    auto* column = result->as<RowVector>()
+                       ->childAt(0)
+                       ->loadedVector()
+                       ->as<SimpleVector<int64_t>>();
+    for (auto i = 0; i < result->size(); ++i) {
+      values.push_back(column->valueAt(i));
+    }
+  }
+  ASSERT_EQ(values.size(), 100);
+  for (auto i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(values[i], 250 + i);
+  }
+
+  // The rows of the 8 pages that cannot match are skipped without decoding.
+  RuntimeStatistics stats;
+  rowReader->updateRuntimeStats(stats);
+  EXPECT_EQ(stats.skippedPageRows, 800);
+}
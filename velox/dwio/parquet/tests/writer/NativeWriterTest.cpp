@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/dwio/parquet/writer/NativeWriter.h"
+
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/dwio/parquet/reader/PageIndex.h"
+#include "velox/dwio/parquet/reader/ParquetReader.h"
+#include "velox/dwio/parquet/tests/ParquetReaderTestBase.h"
+
+#include <deque>
+
+using namespace facebook::velox;
+using namespace facebook::velox::dwio::common;
+using namespace facebook::velox::dwio::parquet;
+using namespace facebook::velox::parquet;
+
+using facebook::velox::test::VectorMaker;
+
+namespace {
+
+class NativeWriterTest : public ParquetReaderTestBase {
+ protected:
+  // Writes 'batches' with 'options' and returns the file.
+  std::string write(
+      const std::vector<RowVectorPtr>& batches,
+      const NativeWriterOptions& options = {}) {
+    auto sink = std::make_unique<MemorySink>(*pool_, 64 << 20);
+    auto* sinkPtr = sink.get();
+    NativeWriter writer(
+        std::move(sink), *pool_, asRowType(batches[0]->type()), options);
+    for (const auto& batch : batches) {
+      writer.write(batch);
+    }
+    writer.close();
+    return std::string(sinkPtr->getData(), sinkPtr->size());
+  }
+
+  std::unique_ptr<BufferedInput> makeInput(const std::string& file) {
+    return std::make_unique<BufferedInput>(
+        std::make_shared<InMemoryReadFile>(file), *pool_);
+  }
+
+  thrift::FileMetaData readMetaData(const std::string& file) {
+    ReaderOptions readerOptions{pool_.get()};
+    return ReaderBase(makeInput(file), readerOptions).fileMetaData();
+  }
+
+  // Reads 'file' with the native Parquet reader and checks that the result
+  // is 'expected'.
+  void assertRead(const std::string& file, const RowVectorPtr& expected) {
+    ReaderOptions readerOptions{pool_.get()};
+    ParquetReader reader(makeInput(file), readerOptions);
+    EXPECT_EQ(expected->size(), reader.numberOfRows());
+    auto rowType = asRowType(expected->type());
+    auto rowReaderOptions = getReaderOpts(rowType);
+    rowReaderOptions.setScanSpec(makeScanSpec(rowType));
+    auto rowReader = reader.createRowReader(rowReaderOptions);
+    assertReadExpected(*rowReader, expected);
+  }
+
+  static bool hasEncoding(
+      const thrift::ColumnChunk& chunk,
+      thrift::Encoding::type encoding) {
+    const auto& encodings = chunk.meta_data.encodings;
+    return std::find(encodings.begin(), encodings.end(), encoding) !=
+        encodings.end();
+  }
+
+  // Columns of all supported types except VARBINARY, which is read as
+  // VARCHAR.
+  RowVectorPtr makeData(vector_size_t size) {
+    auto nullEvery = [](int32_t n) { return VectorMaker::nullEvery(n); };
+    return vectorMaker_->rowVector(
+        {"b", "t", "s", "i", "l", "f", "d", "str", "date"},
+        {vectorMaker_->flatVector<bool>(
+             size, [](auto row) { return row % 3 == 0; }, nullEvery(7)),
+         vectorMaker_->flatVector<int8_t>(
+             size, [](auto row) { return row % 200 - 100; }, nullEvery(5)),
+         vectorMaker_->flatVector<int16_t>(
+             size, [](auto row) { return row * 3 - 5'000; }),
+         vectorMaker_->flatVector<int32_t>(
+             size, [](auto row) { return row * 7919; }, nullEvery(11)),
+         vectorMaker_->flatVector<int64_t>(
+             size, [](auto row) { return row % 50 - (1LL << 40); }),
+         vectorMaker_->flatVector<float>(
+             size, [](auto row) { return row / 3.0; }, nullEvery(13)),
+         vectorMaker_->flatVector<double>(
+             size, [](auto row) { return row % 100 * 1.5; }),
+         vectorMaker_->flatVector<StringView>(
+             size,
+             [&](auto row) {
+               strings_.push_back(
+                   std::string(row % 20, 'x') + std::to_string(row % 300));
+               return StringView(strings_.back());
+             },
+             nullEvery(17)),
+         vectorMaker_->flatVector<Date>(
+             size, [](auto row) { return Date(row - 1'000); }, nullEvery(3))});
+  }
+
+  std::deque<std::string> strings_;
+};
+
+TEST_F(NativeWriterTest, types) {
+  auto data = makeData(5'000);
+  auto file = write({data});
+  assertRead(file, data);
+
+  auto metaData = readMetaData(file);
+  EXPECT_EQ(5'000, metaData.num_rows);
+  // Readers use the statistics only for columns with a type defined order.
+  ASSERT_EQ(data->childrenSize(), metaData.column_orders.size());
+  for (const auto& columnOrder : metaData.column_orders) {
+    EXPECT_TRUE(columnOrder.__isset.TYPE_ORDER);
+  }
+  ASSERT_EQ(1, metaData.row_groups.size());
+  const auto& rowGroup = metaData.row_groups[0];
+  EXPECT_EQ(5'000, rowGroup.num_rows);
+  for (const auto& chunk : rowGroup.columns) {
+    EXPECT_TRUE(chunk.meta_data.__isset.statistics);
+    EXPECT_TRUE(chunk.__isset.column_index_offset);
+    EXPECT_TRUE(chunk.__isset.offset_index_offset);
+  }
+  // BOOLEAN is not dictionary encoded.
+  EXPECT_FALSE(
+      hasEncoding(rowGroup.columns[0], thrift::Encoding::RLE_DICTIONARY));
+  EXPECT_TRUE(
+      hasEncoding(rowGroup.columns[7], thrift::Encoding::RLE_DICTIONARY));
+}
+
+TEST_F(NativeWriterTest, rowGroupsAndPages) {
+  auto data = makeData(10'000);
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < 5; ++i) {
+    batches.push_back(std::static_pointer_cast<RowVector>(
+        data->slice(i * 2'000, 2'000)));
+  }
+  NativeWriterOptions options;
+  options.rowsInRowGroup = 3'000;
+  options.dataPageSize = 1 << 10;
+  auto file = write(batches, options);
+  assertRead(file, data);
+
+  auto metaData = readMetaData(file);
+  EXPECT_EQ(10'000, metaData.num_rows);
+  ASSERT_EQ(4, metaData.row_groups.size());
+  EXPECT_EQ(3'000, metaData.row_groups[0].num_rows);
+  EXPECT_EQ(1'000, metaData.row_groups[3].num_rows);
+  // The page index has the locations of the pages of each column chunk.
+  auto input = makeInput(file);
+  auto pageIndex = PageIndex::read(metaData.row_groups[1], *input);
+  ASSERT_TRUE(pageIndex != nullptr);
+  auto offsetIndex = pageIndex->offsetIndex(7);
+  ASSERT_TRUE(offsetIndex.has_value());
+  const auto& locations = offsetIndex->page_locations;
+  ASSERT_GT(locations.size(), 1);
+  EXPECT_EQ(0, locations[0].first_row_index);
+  for (auto i = 1; i < locations.size(); ++i) {
+    EXPECT_GT(locations[i].first_row_index, locations[i - 1].first_row_index);
+    EXPECT_EQ(
+        locations[i - 1].offset + locations[i - 1].compressed_page_size,
+        locations[i].offset);
+  }
+  ASSERT_TRUE(pageIndex->columnIndex(7).has_value());
+  EXPECT_EQ(locations.size(), pageIndex->columnIndex(7)->min_values.size());
+}
+
+TEST_F(NativeWriterTest, pageIndexFilter) {
+  // 'c0' is ascending, so each page has a narrow range of 'c0' and a
+  // range filter selects a few pages.
+  const vector_size_t size = 20'000;
+  auto data = vectorMaker_->rowVector(
+      {"c0", "c1"},
+      {vectorMaker_->flatVector<int64_t>(size, [](auto row) { return row; }),
+       vectorMaker_->flatVector<int32_t>(
+           size,
+           [](auto row) { return row % 97; },
+           VectorMaker::nullEvery(7))});
+  NativeWriterOptions options;
+  options.dataPageSize = 1 << 10;
+  auto file = write({data}, options);
+
+  ReaderOptions readerOptions{pool_.get()};
+  ParquetReader reader(makeInput(file), readerOptions);
+  auto rowType = asRowType(data->type());
+  auto scanSpec = makeScanSpec(rowType);
+  scanSpec->getOrCreateChild(velox::common::Subfield("c0"))
+      ->setFilter(
+          std::make_unique<velox::common::BigintRange>(12'345, 12'445, false));
+  auto rowReaderOptions = getReaderOpts(rowType);
+  rowReaderOptions.setScanSpec(scanSpec);
+  auto rowReader = reader.createRowReader(rowReaderOptions);
+
+  std::vector<int64_t> keys;
+  VectorPtr result;
+  while (rowReader->next(1'000, result) > 0) {
+    auto* rowVector = result->as<RowVector>();
+    auto* c0 =
+        rowVector->childAt(0)->loadedVector()->as<SimpleVector<int64_t>>();
+    auto* c1 =
+        rowVector->childAt(1)->loadedVector()->as<SimpleVector<int32_t>>();
+    for (auto i = 0; i < rowVector->size(); ++i) {
+      const auto key = c0->valueAt(i);
+      keys.push_back(key);
+      ASSERT_EQ(key % 7 == 0, c1->isNullAt(i)) << key;
+      if (!c1->isNullAt(i)) {
+        ASSERT_EQ(key % 97, c1->valueAt(i)) << key;
+      }
+    }
+  }
+  ASSERT_EQ(101, keys.size());
+  for (auto i = 0; i < keys.size(); ++i) {
+    ASSERT_EQ(12'345 + i, keys[i]);
+  }
+
+  // The rows of the pages that cannot match are skipped without decoding.
+  dwio::common::RuntimeStatistics stats;
+  rowReader->updateRuntimeStats(stats);
+  EXPECT_GT(stats.skippedPageRows, size / 2);
+  EXPECT_LT(stats.skippedPageRows, size);
+}
+
+TEST_F(NativeWriterTest, dictionaryInput) {
+  const vector_size_t size = 10'000;
+  auto base = vectorMaker_->flatVector<StringView>(
+      100,
+      [&](auto row) {
+        strings_.push_back(fmt::format("value {}", row * 17));
+        return StringView(strings_.back());
+      },
+      VectorMaker::nullEvery(10));
+  auto indices = allocateIndices(size, pool_.get());
+  auto* rawIndices = indices->asMutable<vector_size_t>();
+  for (auto i = 0; i < size; ++i) {
+    rawIndices[i] = (i * 7) % 100;
+  }
+  auto data = vectorMaker_->rowVector(
+      {"c0", "c1"},
+      {BaseVector::wrapInDictionary(nullptr, indices, size, base),
+       BaseVector::createConstant(variant(int64_t(5)), size, pool_.get())});
+  auto file = write({data});
+  assertRead(file, data);
+
+  auto metaData = readMetaData(file);
+  for (const auto& chunk : metaData.row_groups[0].columns) {
+    EXPECT_TRUE(hasEncoding(chunk, thrift::Encoding::RLE_DICTIONARY));
+    EXPECT_FALSE(hasEncoding(chunk, thrift::Encoding::PLAIN_DICTIONARY));
+  }
+}
+
+TEST_F(NativeWriterTest, dictionaryFallback) {
+  const vector_size_t size = 10'000;
+  auto data = vectorMaker_->rowVector({vectorMaker_->flatVector<int64_t>(
+      size, [](auto row) { return row * 1'000'003; })});
+  NativeWriterOptions options;
+  options.dictionaryPageSizeLimit = 8 << 10;
+  auto file = write({data}, options);
+  assertRead(file, data);
+
+  auto metaData = readMetaData(file);
+  const auto& chunk = metaData.row_groups[0].columns[0];
+  EXPECT_TRUE(hasEncoding(chunk, thrift::Encoding::RLE_DICTIONARY));
+  EXPECT_TRUE(hasEncoding(chunk, thrift::Encoding::PLAIN));
+  EXPECT_TRUE(chunk.meta_data.__isset.dictionary_page_offset);
+
+  options.enableDictionary = false;
+  file = write({data}, options);
+  assertRead(file, data);
+  EXPECT_FALSE(hasEncoding(
+      readMetaData(file).row_groups[0].columns[0],
+      thrift::Encoding::RLE_DICTIONARY));
+}
+
+TEST_F(NativeWriterTest, compression) {
+  auto data = makeData(3'000);
+  for (auto codec :
+       {thrift::CompressionCodec::SNAPPY, thrift::CompressionCodec::ZSTD}) {
+    SCOPED_TRACE(thrift::to_string(codec));
+    NativeWriterOptions options;
+    options.compression = codec;
+    options.dataPageSize = 4 << 10;
+    auto file = write({data}, options);
+    assertRead(file, data);
+    EXPECT_EQ(
+        codec, readMetaData(file).row_groups[0].columns[0].meta_data.codec);
+  }
+}
+
+TEST_F(NativeWriterTest, allNulls) {
+  const vector_size_t size = 1'000;
+  auto data = vectorMaker_->rowVector({
+      BaseVector::createNullConstant(BIGINT(), size, pool_.get()),
+      vectorMaker_->flatVector<double>(
+          size,
+          [](auto row) {
+            return row % 2 ? std::numeric_limits<double>::quiet_NaN() : row;
+          }),
+  });
+  auto file = write({data});
+  assertRead(file, data);
+
+  // A page of only NaNs has no min and max, so there is no ColumnIndex.
+  auto nanData = vectorMaker_->rowVector({vectorMaker_->flatVector<double>(
+      size, [](auto) { return std::numeric_limits<double>::quiet_NaN(); })});
+  file = write({nanData});
+  assertRead(file, nanData);
+  const auto& chunk = readMetaData(file).row_groups[0].columns[0];
+  EXPECT_FALSE(chunk.__isset.column_index_offset);
+  EXPECT_TRUE(chunk.__isset.offset_index_offset);
+}
+
+TEST_F(NativeWriterTest, unsupportedType) {
+  auto data = vectorMaker_->rowVector(
+      {vectorMaker_->arrayVector<int32_t>({{1, 2}, {3}})});
+  VELOX_ASSERT_THROW(
+      write({data}), "Type not supported by the native Parquet writer");
+}
+
+TEST_F(NativeWriterTest, factory) {
+  registerParquetWriterFactory();
+  auto data = makeData(100);
+  auto sink = std::make_unique<MemorySink>(*pool_, 1 << 20);
+  auto* sinkPtr = sink.get();
+  FileWriterOptions options;
+  options.schema = data->type();
+  options.memoryPool = pool_.get();
+  auto writer = getWriterFactory(FileFormat::PARQUET)
+                    ->createWriter(std::move(sink), options);
+  writer->write(data);
+  writer->close();
+  assertRead(std::string(sinkPtr->getData(), sinkPtr->size()), data);
+  unregisterParquetWriterFactory();
+}
+
+} // namespace
@@ -0,0 +1,583 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/dwio/parquet/writer/ColumnChunkWriter.h"
+
+#include <folly/container/F14Map.h>
+#include <snappy.h>
+#include <zstd.h>
+#include <cmath>
+#include <deque>
+
+#include "velox/dwio/parquet/writer/NativeWriter.h"
+#include "velox/dwio/parquet/writer/RleBpEncoder.h"
+
+namespace facebook::velox::parquet {
+namespace {
+
+// Parquet physical value type for a Velox value type.
+template <typename T>
+struct PhysicalType {
+  using type = T;
+};
+
+template <>
+struct PhysicalType<int8_t> {
+  using type = int32_t;
+};
+
+template <>
+struct PhysicalType<int16_t> {
+  using type = int32_t;
+};
+
+template <>
+struct PhysicalType<Date> {
+  using type = int32_t;
+};
+
+template <>
+struct PhysicalType<StringView> {
+  using type = std::string_view;
+};
+
+template <typename T>
+typename PhysicalType<T>::type toPhysical(T value) {
+  return value;
+}
+
+template <>
+int32_t toPhysical(Date value) {
+  return value.days();
+}
+
+template <>
+std::string_view toPhysical(StringView value) {
+  return std::string_view(value.data(), value.size());
+}
+
+// Returns the number of bits needed for the values in [0, 'maxValue'], at
+// least 1.
+int32_t bitWidth(uint64_t maxValue) {
+  return maxValue == 0 ? 1 : 64 - bits::countLeadingZeros(maxValue);
+}
+
+template <typename T>
+class TypedColumnChunkWriter : public ColumnChunkWriter {
+ public:
+  using P = typename PhysicalType<T>::type;
+  static constexpr bool kIsString = std::is_same_v<P, std::string_view>;
+  static constexpr bool kIsBool = std::is_same_v<P, bool>;
+  // Statistics own their strings, the values of a page do not.
+  using Stat = std::conditional_t<kIsString, std::string, P>;
+  // Floating point keys of the dictionary are compared by their bits so
+  // that NaNs and -0.0 are kept.
+  using Key = std::conditional_t<
+      std::is_same_v<P, float>,
+      uint32_t,
+      std::conditional_t<std::is_same_v<P, double>, uint64_t, P>>;
+  using PoolString = std::
+      basic_string<char, std::char_traits<char>, memory::StlAllocator<char>>;
+
+  TypedColumnChunkWriter(
+      thrift::SchemaElement schemaElement,
+      const NativeWriterOptions& options,
+      memory::MemoryPool& pool)
+      : ColumnChunkWriter(std::move(schemaElement), options, pool),
+        useDictionary_(options.enableDictionary && !kIsBool),
+        values_(pool),
+        indices_(pool),
+        dictionary_(memory::StlAllocator<P>(pool)),
+        dictionaryMap_(
+            memory::StlAllocator<std::pair<const Key, int32_t>>(pool)),
+        dictionaryStrings_(memory::StlAllocator<PoolString>(pool)),
+        baseIndices_(memory::StlAllocator<int32_t>(pool)) {}
+
+  void append(
+      const DecodedVector& decoded,
+      vector_size_t begin,
+      vector_size_t end) override {
+    // The dictionary indices of the base rows of a dictionary encoded input
+    // are cached if the base is not larger than the input.
+    const bool cacheIndices = useDictionary_ &&
+        !decoded.isIdentityMapping() &&
+        (decoded.isConstantMapping() ||
+         decoded.base()->size() <= end - begin);
+    if (cacheIndices) {
+      baseIndices_.assign(
+          decoded.isConstantMapping() ? 1 : decoded.base()->size(), -1);
+    }
+    for (auto row = begin; row < end; ++row) {
+      if (decoded.isNullAt(row)) {
+        addRow(true);
+        continue;
+      }
+      const P value = toPhysical(decoded.valueAt<T>(row));
+      if (useDictionary_) {
+        int32_t index;
+        if (cacheIndices) {
+          auto& cached = baseIndices_
+              [decoded.isConstantMapping() ? 0 : decoded.index(row)];
+          if (cached < 0) {
+            cached = dictionaryIndex(value);
+          }
+          index = cached;
+        } else {
+          index = dictionaryIndex(value);
+        }
+        indices_.append(index);
+      } else {
+        appendPlain(value);
+      }
+      updateStats(value);
+      addRow(false);
+      if (useDictionary_ &&
+          dictionaryBytes_ > options_.dictionaryPageSizeLimit) {
+        // The page so far is dictionary encoded, the rest of the column
+        // chunk is PLAIN encoded.
+        flushPage();
+        useDictionary_ = false;
+      }
+    }
+  }
+
+ protected:
+  int64_t pageValueBytes() const override {
+    if (useDictionary_) {
+      return indices_.size() * dictionaryBitWidth() / 8;
+    }
+    return kIsBool ? numBools_ / 8 : values_.size();
+  }
+
+  thrift::Encoding::type encodePageValues(
+      dwio::common::DataBuffer<char>& out) override {
+    // A page of only nulls has no values and needs no dictionary.
+    if (useDictionary_ && indices_.size() > 0) {
+      const auto width = dictionaryBitWidth();
+      out.append(static_cast<char>(width));
+      encodeRleBp(indices_.data(), indices_.size(), width, out);
+      indices_.resize(0);
+      return thrift::Encoding::RLE_DICTIONARY;
+    }
+    if constexpr (kIsBool) {
+      if (numBools_ % 8 != 0) {
+        values_.append(static_cast<char>(boolByte_));
+      }
+      numBools_ = 0;
+      boolByte_ = 0;
+    }
+    out.extendAppend(out.size(), values_.data(), values_.size());
+    values_.resize(0);
+    return thrift::Encoding::PLAIN;
+  }
+
+  bool setPageMinMax(thrift::Statistics& statistics) override {
+    if (!pageMin_.has_value()) {
+      return false;
+    }
+    setMinMax(*pageMin_, *pageMax_, statistics);
+    if (!chunkMin_.has_value() || *pageMin_ < *chunkMin_) {
+      chunkMin_ = std::move(pageMin_);
+    }
+    if (!chunkMax_.has_value() || *pageMax_ > *chunkMax_) {
+      chunkMax_ = std::move(pageMax_);
+    }
+    pageMin_.reset();
+    pageMax_.reset();
+    return true;
+  }
+
+  void setChunkMinMax(thrift::Statistics& statistics) override {
+    if (chunkMin_.has_value()) {
+      setMinMax(*chunkMin_, *chunkMax_, statistics);
+    }
+    chunkMin_.reset();
+    chunkMax_.reset();
+  }
+
+  int32_t dictionarySize() const override {
+    return dictionary_.size();
+  }
+
+  void encodeDictionary(dwio::common::DataBuffer<char>& out) override {
+    for (const auto& value : dictionary_) {
+      appendPlain(value, out);
+    }
+    dictionary_.clear();
+    dictionaryMap_.clear();
+    dictionaryStrings_.clear();
+    dictionaryBytes_ = 0;
+    useDictionary_ = options_.enableDictionary && !kIsBool;
+  }
+
+ private:
+  // Returns the bit width of the dictionary indices of a page.
+  int32_t dictionaryBitWidth() const {
+    return bitWidth(std::max<uint64_t>(dictionary_.size(), 1) - 1);
+  }
+
+  static Key toKey(P value) {
+    if constexpr (std::is_floating_point_v<P>) {
+      Key key;
+      std::memcpy(&key, &value, sizeof(key));
+      return key;
+    } else {
+      return value;
+    }
+  }
+
+  static std::string toBytes(const Stat& value) {
+    if constexpr (kIsString) {
+      return value;
+    } else {
+      return std::string(reinterpret_cast<const char*>(&value), sizeof(P));
+    }
+  }
+
+  static void
+  setMinMax(const Stat& min, const Stat& max, thrift::Statistics& statistics) {
+    statistics.__set_min_value(toBytes(min));
+    statistics.__set_max_value(toBytes(max));
+  }
+
+  // Returns the index of 'value' in the dictionary. Adds 'value' if it is
+  // not in the dictionary.
+  int32_t dictionaryIndex(P value) {
+    auto it = dictionaryMap_.find(toKey(value));
+    if (it != dictionaryMap_.end()) {
+      return it->second;
+    }
+    const int32_t index = dictionary_.size();
+    if constexpr (kIsString) {
+      // The dictionary refers to a copy of the string, not to the input.
+      value = dictionaryStrings_.emplace_back(
+          value, memory::StlAllocator<char>(pool_));
+      dictionaryBytes_ += sizeof(int32_t) + value.size();
+    } else {
+      dictionaryBytes_ += sizeof(P);
+    }
+    dictionary_.push_back(value);
+    dictionaryMap_.emplace(toKey(value), index);
+    return index;
+  }
+
+  void appendPlain(P value) {
+    if constexpr (kIsBool) {
+      boolByte_ |= static_cast<uint8_t>(value) << (numBools_ % 8);
+      if (++numBools_ % 8 == 0) {
+        values_.append(static_cast<char>(boolByte_));
+        boolByte_ = 0;
+      }
+    } else {
+      appendPlain(value, values_);
+    }
+  }
+
+  static void appendPlain(P value, dwio::common::DataBuffer<char>& out) {
+    if constexpr (kIsString) {
+      const int32_t size = value.size();
+      out.extendAppend(
+          out.size(), reinterpret_cast<const char*>(&size), sizeof(size));
+      out.extendAppend(out.size(), value.data(), size);
+    } else {
+      out.extendAppend(
+          out.size(), reinterpret_cast<const char*>(&value), sizeof(P));
+    }
+  }
+
+  void updateStats(P value) {
+    if constexpr (std::is_floating_point_v<P>) {
+      // NaNs are not ordered and are left out of the min and max.
+      if (std::isnan(value)) {
+        return;
+      }
+    }
+    if (!pageMin_.has_value() || value < *pageMin_) {
+      pageMin_ = Stat(value);
+    }
+    if (!pageMax_.has_value() || value > *pageMax_) {
+      pageMax_ = Stat(value);
+    }
+  }
+
+  bool useDictionary_;
+
+  // PLAIN encoded values of the current page.
+  dwio::common::DataBuffer<char> values_;
+
+  // Number of values of a BOOLEAN page and the bits of the last partial byte,
+  // which is not yet in 'values_'.
+  int64_t numBools_{0};
+  uint8_t boolByte_{0};
+
+  // Dictionary indices of the values of the current page.
+  dwio::common::DataBuffer<int32_t> indices_;
+
+  // The dictionary is the largest state of the writer, so it is allocated
+  // from 'pool_'.
+  std::vector<P, memory::StlAllocator<P>> dictionary_;
+  folly::F14FastMap<
+      Key,
+      int32_t,
+      folly::f14::DefaultHasher<Key>,
+      folly::f14::DefaultKeyEqual<Key>,
+      memory::StlAllocator<std::pair<const Key, int32_t>>>
+      dictionaryMap_;
+  // Strings of 'dictionary_'. A deque does not move them when it grows.
+  std::deque<PoolString, memory::StlAllocator<PoolString>> dictionaryStrings_;
+  // Size of the PLAIN encoded dictionary.
+  int64_t dictionaryBytes_{0};
+
+  // Dictionary index of each row of the base vector of the input, -1 if not
+  // looked up yet.
+  std::vector<int32_t, memory::StlAllocator<int32_t>> baseIndices_;
+
+  std::optional<Stat> pageMin_;
+  std::optional<Stat> pageMax_;
+  std::optional<Stat> chunkMin_;
+  std::optional<Stat> chunkMax_;
+};
+
+} // namespace
+
+// static
+std::unique_ptr<ColumnChunkWriter> ColumnChunkWriter::create(
+    const std::string& name,
+    const TypePtr& type,
+    const NativeWriterOptions& options,
+    memory::MemoryPool& pool) {
+  thrift::SchemaElement element;
+  element.__set_name(name);
+  element.__set_repetition_type(thrift::FieldRepetitionType::OPTIONAL);
+  auto makeWriter = [&](auto value, thrift::Type::type physicalType) {
+    element.__set_type(physicalType);
+    return std::make_unique<TypedColumnChunkWriter<decltype(value)>>(
+        std::move(element), options, pool);
+  };
+  switch (type->kind()) {
+    case TypeKind::BOOLEAN:
+      return makeWriter(bool(), thrift::Type::BOOLEAN);
+    case TypeKind::TINYINT:
+      element.__set_converted_type(thrift::ConvertedType::INT_8);
+      return makeWriter(int8_t(), thrift::Type::INT32);
+    case TypeKind::SMALLINT:
+      element.__set_converted_type(thrift::ConvertedType::INT_16);
+      return makeWriter(int16_t(), thrift::Type::INT32);
+    case TypeKind::INTEGER:
+      return makeWriter(int32_t(), thrift::Type::INT32);
+    case TypeKind::BIGINT:
+      return makeWriter(int64_t(), thrift::Type::INT64);
+    case TypeKind::REAL:
+      return makeWriter(float(), thrift::Type::FLOAT);
+    case TypeKind::DOUBLE:
+      return makeWriter(double(), thrift::Type::DOUBLE);
+    case TypeKind::VARCHAR:
+      element.__set_converted_type(thrift::ConvertedType::UTF8);
+      return makeWriter(StringView(), thrift::Type::BYTE_ARRAY);
+    case TypeKind::VARBINARY:
+      return makeWriter(StringView(), thrift::Type::BYTE_ARRAY);
+    case TypeKind::DATE:
+      element.__set_converted_type(thrift::ConvertedType::DATE);
+      return makeWriter(Date(), thrift::Type::INT32);
+    default:
+      VELOX_UNSUPPORTED(
+          "Type not supported by the native Parquet writer: {}",
+          type->toString());
+  }
+}
+
+ColumnChunkWriter::ColumnChunkWriter(
+    thrift::SchemaElement schemaElement,
+    const NativeWriterOptions& options,
+    memory::MemoryPool& pool)
+    : options_(options),
+      pool_(pool),
+      pageSizeLimit_(options.dataPageSize),
+      schemaElement_(std::move(schemaElement)),
+      defLevels_(pool),
+      pages_(pool),
+      page_(pool),
+      compressed_(pool) {}
+
+int64_t ColumnChunkWriter::bufferedBytes() const {
+  return pages_.size() + pageBytes();
+}
+
+void ColumnChunkWriter::flushPage() {
+  const int64_t numRows = defLevels_.size();
+  if (numRows == 0) {
+    return;
+  }
+  // The definition levels are preceded by their size.
+  page_.resize(sizeof(int32_t));
+  encodeRleBp(defLevels_.data(), numRows, 1, page_);
+  const int32_t levelsSize = page_.size() - sizeof(int32_t);
+  std::memcpy(page_.data(), &levelsSize, sizeof(levelsSize));
+  const auto encoding = encodePageValues(page_);
+  encodings_.insert(encoding);
+
+  thrift::Statistics statistics;
+  statistics.__set_null_count(numPageNulls_);
+  const bool hasMinMax = setPageMinMax(statistics);
+  nullPages_.push_back(numPageNulls_ == numRows);
+  minValues_.push_back(hasMinMax ? statistics.min_value : "");
+  maxValues_.push_back(hasMinMax ? statistics.max_value : "");
+  nullCounts_.push_back(numPageNulls_);
+  if (!hasMinMax && numPageNulls_ < numRows) {
+    hasColumnIndex_ = false;
+  }
+
+  thrift::DataPageHeader dataHeader;
+  dataHeader.__set_num_values(numRows);
+  dataHeader.__set_encoding(encoding);
+  dataHeader.__set_definition_level_encoding(thrift::Encoding::RLE);
+  dataHeader.__set_repetition_level_encoding(thrift::Encoding::RLE);
+  dataHeader.__set_statistics(statistics);
+  thrift::PageHeader header;
+  header.__set_type(thrift::PageType::DATA_PAGE);
+  header.__set_data_page_header(dataHeader);
+
+  thrift::PageLocation location;
+  location.__set_offset(pages_.size());
+  location.__set_first_row_index(pageFirstRow_);
+  const auto headerSize = writePage(header, page_, pages_);
+  location.__set_compressed_page_size(pages_.size() - location.offset);
+  pageLocations_.push_back(location);
+  uncompressedPagesSize_ += headerSize + page_.size();
+
+  numNulls_ += numPageNulls_;
+  pageFirstRow_ += numRows;
+  numPageNulls_ = 0;
+  defLevels_.resize(0);
+}
+
+int32_t ColumnChunkWriter::writePage(
+    thrift::PageHeader& header,
+    const dwio::common::DataBuffer<char>& data,
+    dwio::common::DataBuffer<char>& out) {
+  const dwio::common::DataBuffer<char>* compressed = &data;
+  switch (options_.compression) {
+    case thrift::CompressionCodec::UNCOMPRESSED:
+      break;
+    case thrift::CompressionCodec::SNAPPY: {
+      compressed_.resize(snappy::MaxCompressedLength(data.size()));
+      size_t size;
+      snappy::RawCompress(data.data(), data.size(), compressed_.data(), &size);
+      compressed_.resize(size);
+      compressed = &compressed_;
+      break;
+    }
+    case thrift::CompressionCodec::ZSTD: {
+      compressed_.resize(ZSTD_compressBound(data.size()));
+      const auto size = ZSTD_compress(
+          compressed_.data(),
+          compressed_.size(),
+          data.data(),
+          data.size(),
+          ZSTD_CLEVEL_DEFAULT);
+      VELOX_CHECK(
+          !ZSTD_isError(size),
+          "ZSTD compression failed: {}",
+          ZSTD_getErrorName(size));
+      compressed_.resize(size);
+      compressed = &compressed_;
+      break;
+    }
+    default:
+      VELOX_UNSUPPORTED(
+          "Compression not supported by the native Parquet writer: {}",
+          thrift::to_string(options_.compression));
+  }
+  header.__set_uncompressed_page_size(data.size());
+  header.__set_compressed_page_size(compressed->size());
+  const auto headerSize = serializeThrift(header, out);
+  out.extendAppend(out.size(), compressed->data(), compressed->size());
+  return headerSize;
+}
+
+void ColumnChunkWriter::finish(
+    int64_t fileOffset,
+    dwio::common::DataBuffer<char>& out,
+    thrift::ColumnChunk& chunk,
+    std::optional<thrift::ColumnIndex>& columnIndex,
+    thrift::OffsetIndex& offsetIndex) {
+  flushPage();
+  const int64_t chunkOffset = fileOffset + out.size();
+  thrift::ColumnMetaData metaData;
+  int64_t uncompressedSize = uncompressedPagesSize_;
+  if (const auto numValues = dictionarySize(); numValues > 0) {
+    page_.resize(0);
+    encodeDictionary(page_);
+    thrift::DictionaryPageHeader dictionaryHeader;
+    dictionaryHeader.__set_num_values(numValues);
+    dictionaryHeader.__set_encoding(thrift::Encoding::PLAIN);
+    thrift::PageHeader header;
+    header.__set_type(thrift::PageType::DICTIONARY_PAGE);
+    header.__set_dictionary_page_header(dictionaryHeader);
+    uncompressedSize += writePage(header, page_, out) + page_.size();
+    metaData.__set_dictionary_page_offset(chunkOffset);
+    encodings_.insert(thrift::Encoding::PLAIN);
+  }
+  const int64_t dataPageOffset = fileOffset + out.size();
+  out.extendAppend(out.size(), pages_.data(), pages_.size());
+
+  // The definition levels are RLE encoded.
+  encodings_.insert(thrift::Encoding::RLE);
+  metaData.__set_type(schemaElement_.type);
+  metaData.__set_encodings({encodings_.begin(), encodings_.end()});
+  metaData.__set_path_in_schema({schemaElement_.name});
+  metaData.__set_codec(options_.compression);
+  metaData.__set_num_values(pageFirstRow_);
+  metaData.__set_total_uncompressed_size(uncompressedSize);
+  metaData.__set_total_compressed_size(
+      fileOffset + out.size() - chunkOffset);
+  metaData.__set_data_page_offset(dataPageOffset);
+  thrift::Statistics statistics;
+  statistics.__set_null_count(numNulls_);
+  setChunkMinMax(statistics);
+  metaData.__set_statistics(statistics);
+  chunk = thrift::ColumnChunk();
+  chunk.__set_file_offset(chunkOffset);
+  chunk.__set_meta_data(metaData);
+
+  for (auto& location : pageLocations_) {
+    location.__set_offset(location.offset + dataPageOffset);
+  }
+  offsetIndex = thrift::OffsetIndex();
+  offsetIndex.__set_page_locations(pageLocations_);
+  columnIndex.reset();
+  if (hasColumnIndex_) {
+    columnIndex.emplace();
+    columnIndex->__set_null_pages(nullPages_);
+    columnIndex->__set_min_values(minValues_);
+    columnIndex->__set_max_values(maxValues_);
+    columnIndex->__set_boundary_order(thrift::BoundaryOrder::UNORDERED);
+    columnIndex->__set_null_counts(nullCounts_);
+  }
+
+  pages_.resize(0);
+  uncompressedPagesSize_ = 0;
+  pageFirstRow_ = 0;
+  numNulls_ = 0;
+  pageLocations_.clear();
+  nullPages_.clear();
+  minValues_.clear();
+  maxValues_.clear();
+  nullCounts_.clear();
+  hasColumnIndex_ = true;
+  encodings_.clear();
+}
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <set>
+
+#include <thrift/protocol/TCompactProtocol.h> //@manual
+#include <thrift/transport/TBufferTransports.h> //@manual
+#include "velox/dwio/common/DataBuffer.h"
+#include "velox/dwio/parquet/thrift/ParquetThriftTypes.h"
+#include "velox/vector/DecodedVector.h"
+
+namespace facebook::velox::parquet {
+
+struct NativeWriterOptions;
+
+/// Appends the thrift compact serialization of 'object' to 'out'. Returns
+/// the size of the serialization.
+template <typename T>
+int32_t serializeThrift(const T& object, dwio::common::DataBuffer<char>& out) {
+  auto buffer = std::make_shared<apache::thrift::transport::TMemoryBuffer>();
+  apache::thrift::protocol::TCompactProtocolT<
+      apache::thrift::transport::TMemoryBuffer>
+      protocol(buffer);
+  object.write(&protocol);
+  uint8_t* data;
+  uint32_t size;
+  buffer->getBuffer(&data, &size);
+  out.extendAppend(out.size(), reinterpret_cast<const char*>(data), size);
+  return size;
+}
+
+/// Encodes the values of a top level column into the pages of a column chunk.
+/// Values are dictionary encoded until the dictionary exceeds its size limit
+/// and PLAIN encoded after that. Dictionary encoded inputs are encoded by
+/// looking up each distinct value of their base vector once. The statistics of
+/// the pages are written to the page headers and the page index.
+class ColumnChunkWriter {
+ public:
+  /// Creates a writer of column 'name' of 'type'. 'options' and 'pool' must
+  /// outlive the writer.
+  static std::unique_ptr<ColumnChunkWriter> create(
+      const std::string& name,
+      const TypePtr& type,
+      const NativeWriterOptions& options,
+      memory::MemoryPool& pool);
+
+  virtual ~ColumnChunkWriter() = default;
+
+  /// Returns the SchemaElement of the column in the file schema.
+  const thrift::SchemaElement& schemaElement() const {
+    return schemaElement_;
+  }
+
+  /// Appends rows [begin, end) of 'decoded' to the column chunk.
+  virtual void append(
+      const DecodedVector& decoded,
+      vector_size_t begin,
+      vector_size_t end) = 0;
+
+  /// Returns the size of the encoded data of the column chunk so far.
+  int64_t bufferedBytes() const;
+
+  /// Ends the column chunk and appends its pages to 'out', which is written
+  /// at file offset 'fileOffset'. Sets the metadata of the chunk in 'chunk'
+  /// and the page index in 'columnIndex' and 'offsetIndex'. 'columnIndex' is
+  /// not set if a page has values but no min and max, e.g. only NaNs. The
+  /// writer is ready for the next column chunk after this.
+  void finish(
+      int64_t fileOffset,
+      dwio::common::DataBuffer<char>& out,
+      thrift::ColumnChunk& chunk,
+      std::optional<thrift::ColumnIndex>& columnIndex,
+      thrift::OffsetIndex& offsetIndex);
+
+ protected:
+  ColumnChunkWriter(
+      thrift::SchemaElement schemaElement,
+      const NativeWriterOptions& options,
+      memory::MemoryPool& pool);
+
+  // Adds a definition level for the next row. Ends the page if it is full,
+  // which is checked every 64 rows.
+  void addRow(bool isNull) {
+    defLevels_.append(isNull ? 0 : 1);
+    numPageNulls_ += isNull;
+    if ((defLevels_.size() & 63) == 0 && pageBytes() >= pageSizeLimit_) {
+      flushPage();
+    }
+  }
+
+  // Encodes the page with the rows added since the last page.
+  void flushPage();
+
+  // Returns the size of the encoded values of the current page.
+  virtual int64_t pageValueBytes() const = 0;
+
+  // Appends the encoded values of the current page to 'out' and returns
+  // their encoding. Clears the values of the page.
+  virtual thrift::Encoding::type encodePageValues(
+      dwio::common::DataBuffer<char>& out) = 0;
+
+  // Sets the min and max values of the current page in 'statistics' and
+  // clears them. Returns false if the page has no min and max.
+  virtual bool setPageMinMax(thrift::Statistics& statistics) = 0;
+
+  // Sets the min and max values of the column chunk in 'statistics' and
+  // clears them.
+  virtual void setChunkMinMax(thrift::Statistics& statistics) = 0;
+
+  // Returns the number of values in the dictionary, 0 if there is none.
+  virtual int32_t dictionarySize() const = 0;
+
+  // Appends the PLAIN encoded dictionary to 'out' and clears the
+  // dictionary.
+  virtual void encodeDictionary(dwio::common::DataBuffer<char>& out) = 0;
+
+  const NativeWriterOptions& options_;
+  memory::MemoryPool& pool_;
+
+  // Size of the encoded data of the current page at which the page ends.
+  const int64_t pageSizeLimit_;
+
+ private:
+  int64_t pageBytes() const {
+    return defLevels_.size() / 8 + pageValueBytes();
+  }
+
+  // Appends 'header' and the compressed 'data' to 'out'. Returns the size
+  // of the header.
+  int32_t writePage(
+      thrift::PageHeader& header,
+      const dwio::common::DataBuffer<char>& data,
+      dwio::common::DataBuffer<char>& out);
+
+  const thrift::SchemaElement schemaElement_;
+
+  // Definition levels of the rows of the current page.
+  dwio::common::DataBuffer<uint8_t> defLevels_;
+  int64_t numPageNulls_{0};
+
+  // Row of the column chunk at the start of the current page.
+  int64_t pageFirstRow_{0};
+
+  // Null count of the column chunk.
+  int64_t numNulls_{0};
+
+  // Headers and compressed data of the data pages of the column chunk.
+  dwio::common::DataBuffer<char> pages_;
+
+  // Sum of the sizes of the data pages in 'pages_' before compression.
+  int64_t uncompressedPagesSize_{0};
+
+  // Locations of the pages in 'pages_'. The offsets are relative to the
+  // start of 'pages_'.
+  std::vector<thrift::PageLocation> pageLocations_;
+
+  // Page statistics for the ColumnIndex.
+  std::vector<bool> nullPages_;
+  std::vector<std::string> minValues_;
+  std::vector<std::string> maxValues_;
+  std::vector<int64_t> nullCounts_;
+  bool hasColumnIndex_{true};
+
+  std::set<thrift::Encoding::type> encodings_;
+
+  // Uncompressed and compressed data of the page being written.
+  dwio::common::DataBuffer<char> page_;
+  dwio::common::DataBuffer<char> compressed_;
+};
+
+} // namespace facebook::velox::parquet
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/dwio/parquet/writer/NativeWriter.h"
+
+namespace facebook::velox::parquet {
+namespace {
+
+constexpr std::string_view kMagic{"PAR1"};
+
+} // namespace
+
+NativeWriter::NativeWriter(
+    std::unique_ptr<dwio::common::DataSink> sink,
+    memory::MemoryPool& pool,
+    RowTypePtr schema,
+    NativeWriterOptions options)
+    : sink_(std::move(sink)),
+      pool_(pool),
+      schema_(std::move(schema)),
+      options_(options),
+      decoded_(schema_->size()) {
+  VELOX_CHECK_GT(schema_->size(), 0, "Parquet writer needs columns");
+  VELOX_CHECK_GT(options_.rowsInRowGroup, 0);
+  for (auto i = 0; i < schema_->size(); ++i) {
+    columns_.push_back(ColumnChunkWriter::create(
+        schema_->nameOf(i), schema_->childAt(i), options_, pool_));
+  }
+}
+
+void NativeWriter::write(const VectorPtr& data) {
+  VELOX_CHECK(!closed_, "Parquet writer is closed");
+  auto* input = data->as<RowVector>();
+  VELOX_CHECK_NOT_NULL(input, "Parquet writer input must be a RowVector");
+  VELOX_CHECK_EQ(input->childrenSize(), columns_.size());
+  const auto numRows = input->size();
+  SelectivityVector allRows(numRows);
+  for (auto i = 0; i < columns_.size(); ++i) {
+    decoded_[i].decode(*input->childAt(i), allRows);
+  }
+  vector_size_t begin = 0;
+  while (begin < numRows) {
+    const vector_size_t end = std::min<int64_t>(
+        numRows, begin + options_.rowsInRowGroup - numRowGroupRows_);
+    int64_t bufferedBytes = 0;
+    for (auto i = 0; i < columns_.size(); ++i) {
+      columns_[i]->append(decoded_[i], begin, end);
+      bufferedBytes += columns_[i]->bufferedBytes();
+    }
+    numRowGroupRows_ += end - begin;
+    if (numRowGroupRows_ >= options_.rowsInRowGroup ||
+        bufferedBytes >= options_.rowGroupSize) {
+      flush();
+    }
+    begin = end;
+  }
+}
+
+void NativeWriter::writeMagic(dwio::common::DataBuffer<char>& out) {
+  out.extendAppend(out.size(), kMagic.data(), kMagic.size());
+}
+
+void NativeWriter::flush() {
+  VELOX_CHECK(!closed_, "Parquet writer is closed");
+  if (numRowGroupRows_ == 0) {
+    return;
+  }
+  dwio::common::DataBuffer<char> out(pool_);
+  if (fileOffset_ == 0) {
+    writeMagic(out);
+  }
+  thrift::RowGroup rowGroup;
+  rowGroup.columns.resize(columns_.size());
+  auto& columnIndexes = columnIndexes_.emplace_back(columns_.size());
+  auto& offsetIndexes = offsetIndexes_.emplace_back(columns_.size());
+  for (auto i = 0; i < columns_.size(); ++i) {
+    columns_[i]->finish(
+        fileOffset_,
+        out,
+        rowGroup.columns[i],
+        columnIndexes[i],
+        offsetIndexes[i]);
+  }
+  const int64_t rowGroupOffset = rowGroup.columns[0].file_offset;
+  int64_t totalByteSize = 0;
+  for (const auto& chunk : rowGroup.columns) {
+    totalByteSize += chunk.meta_data.total_uncompressed_size;
+  }
+  rowGroup.__set_total_byte_size(totalByteSize);
+  rowGroup.__set_num_rows(numRowGroupRows_);
+  rowGroup.__set_file_offset(rowGroupOffset);
+  rowGroup.__set_total_compressed_size(
+      fileOffset_ + out.size() - rowGroupOffset);
+  rowGroup.__set_ordinal(fileMetaData_.row_groups.size());
+  fileMetaData_.row_groups.push_back(std::move(rowGroup));
+  fileMetaData_.num_rows += numRowGroupRows_;
+  numRowGroupRows_ = 0;
+
+  fileOffset_ += out.size();
+  sink_->write(std::move(out));
+}
+
+void NativeWriter::writePageIndex(dwio::common::DataBuffer<char>& out) {
+  auto& rowGroups = fileMetaData_.row_groups;
+  for (auto i = 0; i < rowGroups.size(); ++i) {
+    for (auto j = 0; j < columns_.size(); ++j) {
+      if (auto& columnIndex = columnIndexes_[i][j]) {
+        auto& chunk = rowGroups[i].columns[j];
+        chunk.__set_column_index_offset(fileOffset_ + out.size());
+        chunk.__set_column_index_length(serializeThrift(*columnIndex, out));
+      }
+    }
+  }
+  for (auto i = 0; i < rowGroups.size(); ++i) {
+    for (auto j = 0; j < columns_.size(); ++j) {
+      auto& chunk = rowGroups[i].columns[j];
+      chunk.__set_offset_index_offset(fileOffset_ + out.size());
+      chunk.__set_offset_index_length(
+          serializeThrift(offsetIndexes_[i][j], out));
+    }
+  }
+  columnIndexes_.clear();
+  offsetIndexes_.clear();
+}
+
+void NativeWriter::close() {
+  if (closed_) {
+    return;
+  }
+  flush();
+  closed_ = true;
+  dwio::common::DataBuffer<char> out(pool_);
+  if (fileOffset_ == 0) {
+    writeMagic(out);
+  }
+  if (options_.writePageIndex) {
+    writePageIndex(out);
+  }
+
+  std::vector<thrift::SchemaElement> schema;
+  auto& root = schema.emplace_back();
+  root.__set_name("schema");
+  root.__set_num_children(columns_.size());
+  for (const auto& column : columns_) {
+    schema.push_back(column->schemaElement());
+  }
+  // Readers ignore the min and max statistics of columns without a
+  // column order. All columns are ordered by their type.
+  thrift::ColumnOrder columnOrder;
+  columnOrder.__set_TYPE_ORDER(thrift::TypeDefinedOrder());
+  fileMetaData_.__set_version(1);
+  fileMetaData_.__set_schema(std::move(schema));
+  fileMetaData_.__set_column_orders(
+      std::vector<thrift::ColumnOrder>(columns_.size(), columnOrder));
+  fileMetaData_.__set_created_by("velox");
+  const int32_t footerSize = serializeThrift(fileMetaData_, out);
+  out.extendAppend(
+      out.size(), reinterpret_cast<const char*>(&footerSize), sizeof(int32_t));
+  writeMagic(out);
+  fileOffset_ += out.size();
+  sink_->write(std::move(out));
+  sink_->close();
+}
+
+std::unique_ptr<dwio::common::FileWriter> ParquetWriterFactory::createWriter(
+    std::unique_ptr<dwio::common::DataSink> sink,
+    const dwio::common::FileWriterOptions& options) {
+  VELOX_CHECK_NOT_NULL(options.memoryPool);
+  return std::make_unique<NativeWriter>(
+      std::move(sink), *options.memoryPool, asRowType(options.schema));
+}
+
+void registerParquetWriterFactory() {
+  dwio::common::registerWriterFactory(
+      std::make_shared<ParquetWriterFactory>());
+}
+
+void unregisterParquetWriterFactory() {
+  dwio::common::unregisterWriterFactory(dwio::common::FileFormat::PARQUET);
+}
+
+} // namespace facebook::velox::parquet
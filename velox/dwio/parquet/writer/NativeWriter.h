@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "velox/dwio/common/WriterFactory.h"
+#include "velox/dwio/parquet/writer/ColumnChunkWriter.h"
+#include "velox/vector/ComplexVector.h"
+
+namespace facebook::velox::parquet {
+
+struct NativeWriterOptions {
+  /// Max number of top level rows in a row group.
+  int64_t rowsInRowGroup{1'000'000};
+
+  /// A row group ends when the encoded data of its column chunks reaches
+  /// this size.
+  int64_t rowGroupSize{128 << 20};
+
+  /// Size of the encoded data of a page before compression at which the page
+  /// ends.
+  int64_t dataPageSize{1 << 20};
+
+  /// Columns other than BOOLEAN are dictionary encoded if true.
+  bool enableDictionary{true};
+
+  /// Max size of the PLAIN encoded dictionary of a column chunk. The pages
+  /// after the dictionary reaches this size are PLAIN encoded.
+  int64_t dictionaryPageSizeLimit{1 << 20};
+
+  /// Compression of the pages. UNCOMPRESSED, SNAPPY and ZSTD are supported.
+  thrift::CompressionCodec::type compression{
+      thrift::CompressionCodec::UNCOMPRESSED};
+
+  /// Writes the ColumnIndex and OffsetIndex of the column chunks if true.
+  bool writePageIndex{true};
+};
+
+/// Writes Velox vectors into a DataSink in the Parquet format without
+/// converting them to Arrow. The data of a row group is buffered in memory
+/// from 'pool' and written to the sink when the row group ends. Supports top
+/// level columns of BOOLEAN, TINYINT, SMALLINT, INTEGER, BIGINT, REAL,
+/// DOUBLE, VARCHAR, VARBINARY and DATE types.
+class NativeWriter : public dwio::common::FileWriter {
+ public:
+  NativeWriter(
+      std::unique_ptr<dwio::common::DataSink> sink,
+      memory::MemoryPool& pool,
+      RowTypePtr schema,
+      NativeWriterOptions options = {});
+
+  /// Appends 'data', which must be a RowVector of 'schema'.
+  void write(const VectorPtr& data) override;
+
+  /// Ends the current row group and writes it to the sink.
+  void flush() override;
+
+  /// Writes the last row group, the page index and the footer and closes the
+  /// sink.
+  void close() override;
+
+ private:
+  void writeMagic(dwio::common::DataBuffer<char>& out);
+
+  // Writes the ColumnIndex and OffsetIndex of all column chunks to 'out'
+  // and sets their locations in the metadata of the chunks.
+  void writePageIndex(dwio::common::DataBuffer<char>& out);
+
+  const std::unique_ptr<dwio::common::DataSink> sink_;
+  memory::MemoryPool& pool_;
+  const RowTypePtr schema_;
+  const NativeWriterOptions options_;
+
+  std::vector<std::unique_ptr<ColumnChunkWriter>> columns_;
+  std::vector<DecodedVector> decoded_;
+
+  // Number of rows in the current row group.
+  int64_t numRowGroupRows_{0};
+
+  thrift::FileMetaData fileMetaData_;
+
+  // Page index of each column chunk of each written row group.
+  std::vector<std::vector<std::optional<thrift::ColumnIndex>>> columnIndexes_;
+  std::vector<std::vector<thrift::OffsetIndex>> offsetIndexes_;
+
+  // Number of bytes written to 'sink_'.
+  int64_t fileOffset_{0};
+
+  bool closed_{false};
+};
+
+class ParquetWriterFactory : public dwio::common::WriterFactory {
+ public:
+  ParquetWriterFactory()
+      : WriterFactory(dwio::common::FileFormat::PARQUET) {}
+
+  std::unique_ptr<dwio::common::FileWriter> createWriter(
+      std::unique_ptr<dwio::common::DataSink> sink,
+      const dwio::common::FileWriterOptions& options) override;
+};
+
+void registerParquetWriterFactory();
+
+void unregisterParquetWriterFactory();
+
+} // namespace facebook::velox::parquet
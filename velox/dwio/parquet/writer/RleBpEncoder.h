@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <folly/Varint.h>
+
+#include "velox/common/base/BitUtil.h"
+#include "velox/dwio/common/DataBuffer.h"
+
+namespace facebook::velox::parquet {
+
+/// Appends 'numValues' 'values' to 'out' in the RLE/bit-packing hybrid
+/// encoding of Parquet with 'bitWidth' bits per value. Runs of at least 8
+/// equal values are run length encoded. Other values are bit-packed in
+/// groups of 8. The last group is padded with zeros.
+template <typename T>
+void encodeRleBp(
+    const T* FOLLY_NONNULL values,
+    int64_t numValues,
+    int32_t bitWidth,
+    dwio::common::DataBuffer<char>& out) {
+  constexpr int32_t kMinRunLength = 8;
+  // Limits a bit-packed run header to one byte.
+  constexpr int32_t kMaxGroups = 63;
+  auto appendVarint = [&](uint64_t value) {
+    uint8_t buffer[folly::kMaxVarintLength64];
+    auto size = folly::encodeVarint(value, buffer);
+    out.extendAppend(
+        out.size(), reinterpret_cast<const char*>(buffer), size);
+  };
+  auto runLength = [&](int64_t begin) {
+    auto end = begin + 1;
+    while (end < numValues && values[end] == values[begin]) {
+      ++end;
+    }
+    return end - begin;
+  };
+  const int32_t byteWidth = bits::roundUp(bitWidth, 8) / 8;
+  int64_t i = 0;
+  while (i < numValues) {
+    const auto run = runLength(i);
+    if (run >= kMinRunLength) {
+      appendVarint(run << 1);
+      const uint32_t value = values[i];
+      out.extendAppend(
+          out.size(), reinterpret_cast<const char*>(&value), byteWidth);
+      i += run;
+      continue;
+    }
+    const auto begin = i;
+    int32_t numGroups = 0;
+    do {
+      i += 8;
+      ++numGroups;
+    } while (i < numValues && numGroups < kMaxGroups &&
+             runLength(i) < kMinRunLength);
+    appendVarint((numGroups << 1) | 1);
+    uint64_t buffer = 0;
+    int32_t numBits = 0;
+    for (auto j = begin; j < begin + numGroups * 8; ++j) {
+      const uint64_t value =
+          j < numValues ? static_cast<uint32_t>(values[j]) : 0;
+      buffer |= value << numBits;
+      numBits += bitWidth;
+      while (numBits >= 8) {
+        out.append(static_cast<char>(buffer & 0xff));
+        buffer >>= 8;
+        numBits -= 8;
+      }
+    }
+  }
+}
+
+} // namespace facebook::velox::parquet
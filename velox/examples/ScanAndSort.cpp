@@ -92,8 +92,8 @@ int main(int argc, char** argv) {
   connector::registerConnector(hiveConnector);
 
   // To be able to read local files, we need to register the local file
-  // filesystem. We also need to register the dwrf reader factory as well as a
-  // write protocol, in this case commit is not required:
+  // filesystem. We also need to register the dwrf reader factory. The Hive
+  // connector registers the dwrf writer factory itself:
   filesystems::registerLocalFileSystem();
   dwrf::registerDwrfReaderFactory();
 
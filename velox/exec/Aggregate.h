@@ -177,6 +177,29 @@ class Aggregate {
       const std::vector<VectorPtr>& args,
       bool mayPushdown) = 0;
 
+  // Returns true if retractSingleGroupRawInput() is supported, i.e. raw
+  // input can be removed from an accumulator exactly. Window functions use
+  // this to slide a frame without recomputing the aggregate for each row.
+  virtual bool supportsRetract() const {
+    return false;
+  }
+
+  // Removes raw input from the single accumulator. This is the inverse of
+  // addSingleGroupRawInput().
+  // @param group Pointer to the start of the group row.
+  // @param rows Rows of the 'args' to remove from the accumulator. These must
+  // have been added with addSingleGroupRawInput() before.
+  // @param args Raw input to remove from the accumulator.
+  //
+  // Removing all non-null input need not restore the null state of the
+  // group. Callers re-initialize the group if no non-null input remains.
+  virtual void retractSingleGroupRawInput(
+      char* /*group*/,
+      const SelectivityVector& /*rows*/,
+      const std::vector<VectorPtr>& /*args*/) {
+    VELOX_UNSUPPORTED("Aggregate does not support retracting input");
+  }
+
   // Extracts final results (used for final and single aggregations).
   // @param groups Pointers to the start of the group rows.
   // @param numGroups Number of groups to extract results from.
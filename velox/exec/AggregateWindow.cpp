@@ -16,6 +16,7 @@
 
 #include "velox/exec/AggregateWindow.h"
 #include "velox/common/base/Exceptions.h"
+#include "velox/common/base/RuntimeMetrics.h"
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/WindowFunction.h"
 #include "velox/expression/FunctionSignature.h"
@@ -25,10 +26,38 @@ namespace facebook::velox::exec {
 
 namespace {
 
+// Returns true if values of 'type' have a fixed size, i.e. 'type' is fixed
+// width or a ROW of such types, e.g. the row(double, bigint) intermediate
+// type of avg.
+bool isFixedSize(const TypePtr& type) {
+  if (type->isFixedWidth()) {
+    return true;
+  }
+  if (type->kind() != TypeKind::ROW) {
+    return false;
+  }
+  for (const auto& child : asRowType(type)->children()) {
+    if (!isFixedSize(child)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // A generic way to compute any aggregation used as a window function.
 // Creates an Aggregate function object for the window function invocation.
 // At each row, computes the aggregation across all rows from the frameStart
-// to frameEnd boundaries at that row using singleGroup.
+// to frameEnd boundaries at that row using singleGroup. Avoids recomputing
+// each frame from scratch where possible:
+//  - Frames with a fixed start only add the new rows to the previous frame.
+//  - Sliding frames retract the rows that left the frame and add the new
+//    rows if the aggregate supports retracting input exactly, e.g. integer
+//    sum or count.
+//  - Other aggregates with a fixed size intermediate type, e.g. min, max or
+//    avg, combine the intermediate results of a segment tree built over the
+//    rows of the block. This combines partial results in a different order than
+//    aggregating each frame, so floating point sum and avg may differ in
+//    the last bits, as they do between partial and single aggregation.
 class AggregateWindowFunction : public exec::WindowFunction {
  public:
   AggregateWindowFunction(
@@ -58,6 +87,9 @@ class AggregateWindowFunction : public exec::WindowFunction {
     aggregate_ = exec::Aggregate::create(
         name, core::AggregationNode::Step::kSingle, argTypes_, resultType);
     aggregate_->setAllocator(stringAllocator_);
+    supportsRetract_ = aggregate_->supportsRetract();
+    intermediateType_ = exec::Aggregate::intermediateType(name, argTypes_);
+    fixedSizeIntermediate_ = isFixedSize(intermediateType_);
 
     // Aggregate initialization.
     // Row layout is:
@@ -104,6 +136,7 @@ class AggregateWindowFunction : public exec::WindowFunction {
     partition_ = partition;
 
     previousFrameMetadata_.reset();
+    slidingFrame_.reset();
   }
 
   void apply(
@@ -125,6 +158,7 @@ class AggregateWindowFunction : public exec::WindowFunction {
         analyzeFrameValues(validRows, rawFrameStarts, rawFrameEnds);
 
     if (frameMetadata.incrementalAggregation) {
+      slidingFrame_.reset();
       vector_size_t startRow;
       if (frameMetadata.usePreviousAggregate) {
         // If incremental aggregation can be resumed from the previous block,
@@ -137,10 +171,7 @@ class AggregateWindowFunction : public exec::WindowFunction {
 
         // This is the start of a new incremental aggregation. So the
         // aggregate_ function object should be initialized.
-        auto singleGroup = std::vector<vector_size_t>{0};
-        aggregate_->clear();
-        aggregate_->initializeNewGroups(&rawSingleGroupRow_, singleGroup);
-        aggregateInitialized_ = true;
+        initializeSingleGroup();
       }
 
       fillArgVectors(startRow, frameMetadata.lastRow);
@@ -151,8 +182,39 @@ class AggregateWindowFunction : public exec::WindowFunction {
           rawFrameEnds,
           resultOffset,
           result);
+    } else if (supportsRetract_) {
+      slidingAggregation(
+          validRows,
+          frameMetadata.firstRow,
+          frameMetadata.lastRow,
+          rawFrameStarts,
+          rawFrameEnds,
+          resultOffset,
+          result);
+    } else if (useSegmentTree(
+                   validRows,
+                   frameMetadata.firstRow,
+                   frameMetadata.lastRow,
+                   rawFrameStarts,
+                   rawFrameEnds)) {
+      slidingFrame_.reset();
+      fillArgVectors(frameMetadata.firstRow, frameMetadata.lastRow);
+      addThreadLocalRuntimeStat(
+          "segmentTreeFrameCount", RuntimeCounter(validRows.countSelected()));
+      segmentTreeAggregation(
+          validRows,
+          frameMetadata.firstRow,
+          frameMetadata.lastRow,
+          rawFrameStarts,
+          rawFrameEnds,
+          resultOffset,
+          result);
     } else {
+      slidingFrame_.reset();
       fillArgVectors(frameMetadata.firstRow, frameMetadata.lastRow);
+      addThreadLocalRuntimeStat(
+          "simpleAggregationFrameCount",
+          RuntimeCounter(validRows.countSelected()));
       simpleAggregation(
           validRows,
           frameMetadata.firstRow,
@@ -259,21 +321,46 @@ class AggregateWindowFunction : public exec::WindowFunction {
     }
   }
 
-  void computeAggregate(
-      SelectivityVector rows,
+  void initializeSingleGroup() {
+    static const std::vector<vector_size_t> kSingleGroup{0};
+    aggregate_->clear();
+    aggregate_->initializeNewGroups(&rawSingleGroupRow_, kSingleGroup);
+    aggregateInitialized_ = true;
+  }
+
+  // Adds or, if 'retract' is true, removes the rows in [startFrame, endFrame)
+  // of 'argVectors_' to or from the single group.
+  void updateSingleGroup(
+      SelectivityVector& rows,
       vector_size_t startFrame,
-      vector_size_t endFrame) {
+      vector_size_t endFrame,
+      bool retract = false) {
     rows.clearAll();
     rows.setValidRange(startFrame, endFrame, true);
     rows.updateBounds();
 
-    BaseVector::prepareForReuse(aggregateResultVector_, 1);
+    if (retract) {
+      aggregate_->retractSingleGroupRawInput(
+          rawSingleGroupRow_, rows, argVectors_);
+    } else {
+      aggregate_->addSingleGroupRawInput(
+          rawSingleGroupRow_, rows, argVectors_, false);
+    }
+  }
 
-    aggregate_->addSingleGroupRawInput(
-        rawSingleGroupRow_, rows, argVectors_, false);
+  void extractSingleGroupValue() {
+    BaseVector::prepareForReuse(aggregateResultVector_, 1);
     aggregate_->extractValues(&rawSingleGroupRow_, 1, &aggregateResultVector_);
   }
 
+  void computeAggregate(
+      SelectivityVector& rows,
+      vector_size_t startFrame,
+      vector_size_t endFrame) {
+    updateSingleGroup(rows, startFrame, endFrame);
+    extractSingleGroupValue();
+  }
+
   void incrementalAggregation(
       const SelectivityVector& validRows,
       vector_size_t startFrame,
@@ -313,18 +400,14 @@ class AggregateWindowFunction : public exec::WindowFunction {
       const VectorPtr& result) {
     SelectivityVector rows;
     rows.resize(maxFrame + 1 - minFrame);
-    static auto kSingleGroup = std::vector<vector_size_t>{0};
 
     validRows.applyToSelected([&](auto i) {
       // This is a very naive algorithm.
       // It evaluates the entire aggregation for each row by iterating over
       // input rows from frameStart to frameEnd in the SelectivityVector.
-      // TODO : Try to re-use previous computations by advancing and retracting
-      // the aggregation based on the frame changes with each row. This would
-      // require adding new APIs to the Aggregate framework.
-      aggregate_->clear();
-      aggregate_->initializeNewGroups(&rawSingleGroupRow_, kSingleGroup);
-      aggregateInitialized_ = true;
+      // Used when frames are small or the aggregate supports neither
+      // retracting input nor a segment tree.
+      initializeSingleGroup();
 
       auto frameStartIndex = frameStartsVector[i] - minFrame;
       auto frameEndIndex = frameEndsVector[i] - minFrame + 1;
@@ -336,6 +419,226 @@ class AggregateWindowFunction : public exec::WindowFunction {
     setEmptyFramesResults(validRows, resultOffset, result);
   }
 
+  // Returns true if the first argument has a non-null value in rows
+  // [begin, end) of 'argVectors_'. The aggregates that support retracting
+  // take at most one argument and ignore null input.
+  bool hasNonNullInput(vector_size_t begin, vector_size_t end) const {
+    if (nonNullPrefix_.empty()) {
+      return true;
+    }
+    return nonNullPrefix_[end] > nonNullPrefix_[begin];
+  }
+
+  // Sets 'nonNullPrefix_' to the running count of non-null values of the
+  // first argument in 'argVectors_'. Leaves it empty if there are no nulls.
+  void computeNonNullPrefix(vector_size_t numRows) {
+    nonNullPrefix_.clear();
+    if (argVectors_.empty() || !argVectors_[0]->mayHaveNulls()) {
+      return;
+    }
+    nonNullPrefix_.resize(numRows + 1);
+    nonNullPrefix_[0] = 0;
+    for (auto i = 0; i < numRows; ++i) {
+      nonNullPrefix_[i + 1] =
+          nonNullPrefix_[i] + (argVectors_[0]->isNullAt(i) ? 0 : 1);
+    }
+  }
+
+  // Moves the frame accumulated in the single group to the frame of each
+  // row by adding the rows that entered the frame and retracting the rows
+  // that left it. Frames of consecutive rows usually overlap, e.g. for ROWS
+  // BETWEEN N PRECEDING AND CURRENT ROW, so each row costs O(1) instead of
+  // O(N). The frame carries over to the next block of the partition.
+  void slidingAggregation(
+      const SelectivityVector& validRows,
+      vector_size_t firstRow,
+      vector_size_t lastRow,
+      const vector_size_t* rawFrameStarts,
+      const vector_size_t* rawFrameEnds,
+      vector_size_t resultOffset,
+      const VectorPtr& result) {
+    // Rows that are retracted from the frame of the previous block may
+    // precede 'firstRow'.
+    const auto argsStart = slidingFrame_.has_value()
+        ? std::min(slidingFrame_->first, firstRow)
+        : firstRow;
+    fillArgVectors(argsStart, lastRow);
+    computeNonNullPrefix(lastRow + 1 - argsStart);
+
+    SelectivityVector rows;
+    rows.resize(lastRow + 1 - argsStart);
+    validRows.applyToSelected([&](auto i) {
+      const auto frameStart = rawFrameStarts[i] - argsStart;
+      const auto frameEnd = rawFrameEnds[i] + 1 - argsStart;
+      if (!slidingFrame_.has_value() ||
+          rawFrameStarts[i] < slidingFrame_->first ||
+          rawFrameEnds[i] + 1 < slidingFrame_->second ||
+          rawFrameStarts[i] >= slidingFrame_->second) {
+        // The frame moved backwards or does not overlap the previous frame.
+        initializeSingleGroup();
+        updateSingleGroup(rows, frameStart, frameEnd);
+      } else {
+        const auto previousStart = slidingFrame_->first - argsStart;
+        const auto previousEnd = slidingFrame_->second - argsStart;
+        // Retract before adding so that the accumulator never holds more
+        // than the larger of the two frames, e.g. a checked integer sum
+        // does not overflow on rows that are in neither frame's result.
+        if (frameStart > previousStart) {
+          updateSingleGroup(rows, previousStart, frameStart, true);
+        }
+        if (frameEnd > previousEnd) {
+          updateSingleGroup(rows, previousEnd, frameEnd);
+        }
+      }
+      slidingFrame_.emplace(rawFrameStarts[i], rawFrameEnds[i] + 1);
+
+      if (!hasNonNullInput(frameStart, frameEnd)) {
+        // Retracting does not restore the null state of the group.
+        initializeSingleGroup();
+      }
+      extractSingleGroupValue();
+      result->copy(aggregateResultVector_.get(), resultOffset + i, 0, 1);
+    });
+
+    // Set null values for empty (non valid) frames in the output block.
+    setEmptyFramesResults(validRows, resultOffset, result);
+  }
+
+  // Returns true if building a segment tree over the rows of the block is
+  // cheaper than aggregating each frame. Building the tree aggregates about
+  // twice the number of rows.
+  bool useSegmentTree(
+      const SelectivityVector& validRows,
+      vector_size_t firstRow,
+      vector_size_t lastRow,
+      const vector_size_t* rawFrameStarts,
+      const vector_size_t* rawFrameEnds) const {
+    if (!fixedSizeIntermediate_) {
+      return false;
+    }
+    int64_t numFrameRows = 0;
+    validRows.applyToSelected([&](auto i) {
+      numFrameRows += rawFrameEnds[i] + 1 - rawFrameStarts[i];
+    });
+    return numFrameRows > 2 * (lastRow + 1 - firstRow);
+  }
+
+  // Initializes 'numGroups' accumulators in 'treeGroups_'.
+  void initializeTreeGroups(vector_size_t numGroups) {
+    const auto rowSize = bits::roundUp(
+        singleGroupRowSize_, aggregate_->accumulatorAlignmentSize());
+    if (!treeGroupsBuffer_ ||
+        treeGroupsBuffer_->capacity() < numGroups * rowSize) {
+      treeGroupsBuffer_ =
+          AlignedBuffer::allocate<char>(numGroups * rowSize, pool_);
+    }
+    auto rawBuffer = treeGroupsBuffer_->asMutable<char>();
+    memset(rawBuffer, 0, numGroups * rowSize);
+    treeGroups_.resize(numGroups);
+    std::vector<vector_size_t> indices(numGroups);
+    for (auto i = 0; i < numGroups; ++i) {
+      treeGroups_[i] = rawBuffer + i * rowSize;
+      indices[i] = i;
+    }
+    aggregate_->clear();
+    aggregate_->initializeNewGroups(treeGroups_.data(), indices);
+  }
+
+  // Extracts the intermediate results of 'treeGroups_' into a new level of
+  // 'segmentTree_' and frees the accumulators.
+  void addTreeLevel() {
+    const auto numGroups = treeGroups_.size();
+    auto level = BaseVector::create(intermediateType_, numGroups, pool_);
+    aggregate_->extractAccumulators(treeGroups_.data(), numGroups, &level);
+    aggregate_->destroy(folly::Range(treeGroups_.data(), numGroups));
+    segmentTree_.push_back(std::move(level));
+  }
+
+  // Builds a segment tree over the rows of 'argVectors_'. Level 0 has the
+  // intermediate result of each row and entry i of level n + 1 combines
+  // entries 2 * i and 2 * i + 1 of level n.
+  void buildSegmentTree(vector_size_t numRows) {
+    segmentTree_.clear();
+    SelectivityVector rows(numRows);
+    initializeTreeGroups(numRows);
+    aggregate_->addRawInput(treeGroups_.data(), rows, argVectors_, false);
+    addTreeLevel();
+
+    std::vector<char*> rowGroups;
+    while (segmentTree_.back()->size() > 1) {
+      const auto size = segmentTree_.back()->size();
+      initializeTreeGroups((size + 1) / 2);
+      rowGroups.resize(size);
+      for (auto i = 0; i < size; ++i) {
+        rowGroups[i] = treeGroups_[i / 2];
+      }
+      rows.resizeFill(size, true);
+      aggregate_->addIntermediateResults(
+          rowGroups.data(), rows, {segmentTree_.back()}, false);
+      addTreeLevel();
+    }
+  }
+
+  // Computes each frame by combining the O(log(n)) segment tree entries that
+  // cover it.
+  void segmentTreeAggregation(
+      const SelectivityVector& validRows,
+      vector_size_t minFrame,
+      vector_size_t maxFrame,
+      const vector_size_t* frameStartsVector,
+      const vector_size_t* frameEndsVector,
+      vector_size_t resultOffset,
+      const VectorPtr& result) {
+    buildSegmentTree(maxFrame + 1 - minFrame);
+
+    std::vector<SelectivityVector> levelRows;
+    levelRows.reserve(segmentTree_.size());
+    for (const auto& level : segmentTree_) {
+      levelRows.emplace_back(level->size(), false);
+    }
+    auto addEntry = [&](int32_t level, vector_size_t index) {
+      auto& rows = levelRows[level];
+      rows.setValid(index, true);
+      rows.updateBounds();
+      aggregate_->addSingleGroupIntermediateResults(
+          rawSingleGroupRow_, rows, {segmentTree_[level]}, false);
+      rows.setValid(index, false);
+    };
+
+    // Entries that cover the start and the end of a frame. The entries are
+    // combined in row order.
+    std::vector<std::pair<int32_t, vector_size_t>> leftEntries;
+    std::vector<std::pair<int32_t, vector_size_t>> rightEntries;
+    validRows.applyToSelected([&](auto i) {
+      initializeSingleGroup();
+      leftEntries.clear();
+      rightEntries.clear();
+      auto begin = frameStartsVector[i] - minFrame;
+      auto end = frameEndsVector[i] + 1 - minFrame;
+      for (int32_t level = 0; begin < end; ++level) {
+        if (begin & 1) {
+          leftEntries.emplace_back(level, begin++);
+        }
+        if (end & 1) {
+          rightEntries.emplace_back(level, --end);
+        }
+        begin >>= 1;
+        end >>= 1;
+      }
+      for (const auto& [level, index] : leftEntries) {
+        addEntry(level, index);
+      }
+      for (auto it = rightEntries.rbegin(); it != rightEntries.rend(); ++it) {
+        addEntry(it->first, it->second);
+      }
+      extractSingleGroupValue();
+      result->copy(aggregateResultVector_.get(), resultOffset + i, 0, 1);
+    });
+
+    // Set null values for empty (non valid) frames in the output block.
+    setEmptyFramesResults(validRows, resultOffset, result);
+  }
+
   void setEmptyFramesResults(
       const SelectivityVector& validRows,
       vector_size_t resultOffset,
@@ -382,6 +685,32 @@ class AggregateWindowFunction : public exec::WindowFunction {
 
   // Used for setting null for empty frames.
   SelectivityVector invalidRows_;
+
+  // True if 'aggregate_' supports retracting input. Such aggregates use
+  // slidingAggregation() for frames that do not have a fixed start.
+  bool supportsRetract_;
+
+  // Partition rows [first, second) accumulated in the single group by
+  // slidingAggregation(). Not set if the single group holds other state.
+  std::optional<std::pair<vector_size_t, vector_size_t>> slidingFrame_;
+
+  // Number of non-null values of the first argument in the first i rows of
+  // 'argVectors_'. Empty if there are no nulls.
+  std::vector<vector_size_t> nonNullPrefix_;
+
+  // Intermediate type of 'aggregate_'.
+  TypePtr intermediateType_;
+
+  // True if 'intermediateType_' has a fixed size. Segment trees are built
+  // only for such types.
+  bool fixedSizeIntermediate_;
+
+  // Levels of the segment tree built by buildSegmentTree().
+  std::vector<VectorPtr> segmentTree_;
+
+  // Accumulators for building a level of the segment tree.
+  BufferPtr treeGroupsBuffer_;
+  std::vector<char*> treeGroups_;
 };
 
 } // namespace
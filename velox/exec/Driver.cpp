@@ -19,11 +19,17 @@
 #include <folly/executors/task_queue/UnboundedBlockingQueue.h>
 #include <folly/executors/thread_factory/InitThreadFactory.h>
 #include <gflags/gflags.h>
+#include "velox/common/process/ProcessBase.h"
 #include "velox/common/time/Timer.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/Task.h"
+#include "velox/exec/TaskExecutor.h"
 
 namespace facebook::velox::exec {
+namespace {
+// The Driver in runInternal() on this thread.
+thread_local Driver* currentDriver{nullptr};
+} // namespace
 
 DriverCtx::DriverCtx(
     std::shared_ptr<Task> _task,
@@ -149,8 +155,15 @@ void Driver::enqueue(std::shared_ptr<Driver> driver) {
   if (driver->closed_) {
     return;
   }
-  driver->task()->queryCtx()->executor()->add(
-      [driver]() { Driver::run(driver); });
+  auto* executor = driver->task()->queryCtx()->executor();
+  // A TaskExecutor schedules the Driver by the CPU time used by its Task.
+  if (auto* taskExecutor = dynamic_cast<TaskExecutor*>(executor)) {
+    taskExecutor->add(
+        [driver]() { Driver::run(driver); },
+        driver->task()->driverCpuTimeNanos());
+    return;
+  }
+  executor->add([driver]() { Driver::run(driver); });
 }
 
 Driver::Driver(
@@ -161,6 +174,7 @@ Driver::Driver(
   // Operators need access to their Driver for adaptation.
   ctx_->driver = this;
   trackOperatorCpuUsage_ = ctx_->queryConfig().operatorTrackCpuUsage();
+  sliceLimitMicros_ = ctx_->queryConfig().driverTimeSliceLimitMs() * 1'000UL;
 }
 
 namespace {
@@ -282,6 +296,12 @@ StopReason Driver::runInternal(
         RuntimeCounter(queuedTime, RuntimeCounter::Unit::kNanos));
   }
 
+  auto* const previousDriver = currentDriver;
+  currentDriver = this;
+  SCOPE_EXIT {
+    currentDriver = previousDriver;
+  };
+
   CancelGuard guard(task().get(), &state_, [&](StopReason reason) {
     // This is run on error or cancel exit.
     if (reason == StopReason::kTerminate) {
@@ -309,6 +329,11 @@ StopReason Driver::runInternal(
           guard.notThrown();
           return stop;
         }
+        if (shouldYield()) {
+          task()->addDriverYield();
+          guard.notThrown();
+          return StopReason::kYield;
+        }
 
         auto op = operators_[i].get();
         // In case we are blocked, this index will point to the operator, whose
@@ -459,11 +484,32 @@ StopReason Driver::runInternal(
   }
 }
 
+uint64_t Driver::cpuTimeNanos() const {
+  if (runStartCpuNanos_ == 0) {
+    return cpuTimeNanos_;
+  }
+  return cpuTimeNanos_ + process::threadCpuNanos() - runStartCpuNanos_;
+}
+
+bool Driver::shouldYield() const {
+  return sliceStartMicros_ != 0 &&
+      getCurrentTimeMicro() - sliceStartMicros_ >= sliceLimitMicros_;
+}
+
 // static
 void Driver::run(std::shared_ptr<Driver> self) {
   std::shared_ptr<BlockingState> blockingState;
   RowVectorPtr nullResult;
+  if (self->sliceLimitMicros_ > 0) {
+    self->sliceStartMicros_ = getCurrentTimeMicro();
+  }
+  self->runStartCpuNanos_ = process::threadCpuNanos();
   auto reason = self->runInternal(self, blockingState, nullResult);
+  self->sliceStartMicros_ = 0;
+  const auto cpuNanos = process::threadCpuNanos() - self->runStartCpuNanos_;
+  self->runStartCpuNanos_ = 0;
+  self->cpuTimeNanos_ += cpuNanos;
+  self->task()->addDriverCpuTimeNanos(cpuNanos);
 
   // When Driver runs on an executor, the last operator (sink) must not produce
   // any results.
@@ -497,6 +543,7 @@ void Driver::run(std::shared_ptr<Driver> self) {
     case StopReason::kPause:
     case StopReason::kTerminate:
     case StopReason::kAlreadyTerminated:
+    case StopReason::kAlreadyOnThread:
     case StopReason::kAtEnd:
       return;
     default:
@@ -653,6 +700,12 @@ std::string Driver::toString() {
   out << "}";
   return out.str();
 }
+
+// static
+Driver* Driver::current() {
+  return currentDriver;
+}
+
 SuspendedSection::SuspendedSection(Driver* FOLLY_NONNULL driver)
     : driver_(driver) {
   if (driver->task()->enterSuspended(driver->state()) != StopReason::kNone) {
@@ -226,6 +226,11 @@ class Driver : public std::enable_shared_from_this<Driver> {
 
   static void enqueue(std::shared_ptr<Driver> instance);
 
+  /// Returns the Driver running its operators on the calling thread or
+  /// nullptr if there is none. Lets code called from the operators, e.g. a
+  /// memory GrowCallback, enter a SuspendedSection.
+  static Driver* FOLLY_NULLABLE current();
+
   /// Run the pipeline until it produces a batch of data or gets blocked. Return
   /// the data produced or nullptr if pipeline finished processing and will not
   /// produce more data. Return nullptr and set 'blockingState' if pipeline got
@@ -294,6 +299,10 @@ class Driver : public std::enable_shared_from_this<Driver> {
     return blockingReason_;
   }
 
+  /// Returns the thread CPU time used by 'this' in run(), including the
+  /// current run. Must be called on the thread running 'this'.
+  uint64_t cpuTimeNanos() const;
+
  private:
   void enqueueInternal();
 
@@ -304,6 +313,9 @@ class Driver : public std::enable_shared_from_this<Driver> {
       std::shared_ptr<BlockingState>& blockingState,
       RowVectorPtr& result);
 
+  // Returns true if the Driver has used up its time slice on the thread.
+  bool shouldYield() const;
+
   void close();
 
   // Push down dynamic filters produced by the operator at the specified
@@ -338,6 +350,21 @@ class Driver : public std::enable_shared_from_this<Driver> {
   BlockingReason blockingReason_{BlockingReason::kNotBlocked};
 
   bool trackOperatorCpuUsage_;
+
+  // Max time in microseconds the Driver stays on a thread in run(). 0 means
+  // no limit.
+  uint64_t sliceLimitMicros_{0};
+
+  // Start of the current time slice. Set only in run(), so that the Driver
+  // does not yield when driven by next().
+  uint64_t sliceStartMicros_{0};
+
+  // Thread CPU time at the start of the current run() or 0 if 'this' is not
+  // in run().
+  uint64_t runStartCpuNanos_{0};
+
+  // Thread CPU time used by the completed runs of 'this'.
+  uint64_t cpuTimeNanos_{0};
 };
 
 using OperatorSupplier = std::function<std::unique_ptr<Operator>(
@@ -455,6 +455,67 @@ void GroupingSet::resetPartial() {
   }
 }
 
+void GroupingSet::toIntermediate(
+    const RowVectorPtr& input,
+    RowVectorPtr& result) {
+  VELOX_CHECK(isPartial_);
+  VELOX_CHECK(isRawInput_);
+  VELOX_CHECK(!isGlobal_);
+  VELOX_CHECK(table_ == nullptr || table_->numDistinct() == 0);
+  if (intermediateRows_ == nullptr) {
+    // Assigns new offsets to the accumulators of 'aggregates_'. 'table_' is
+    // not used after this.
+    intermediateRows_ = std::make_unique<RowContainer>(
+        std::vector<TypePtr>{},
+        false,
+        aggregates_,
+        std::vector<TypePtr>(),
+        false,
+        false,
+        false,
+        false,
+        &pool_,
+        ContainerRowSerde::instance());
+  }
+
+  const auto numRows = input->size();
+  activeRows_.resize(numRows);
+  activeRows_.setAll();
+  result->resize(numRows);
+  for (auto i = 0; i < keyChannels_.size(); ++i) {
+    result->childAt(i) =
+        BaseVector::loadedVectorShared(input->childAt(keyChannels_[i]));
+  }
+  if (aggregates_.empty()) {
+    return;
+  }
+
+  intermediateGroups_.resize(numRows);
+  for (auto i = 0; i < numRows; ++i) {
+    intermediateGroups_[i] = intermediateRows_->newRow();
+  }
+  intermediateIndices_.resize(numRows);
+  std::iota(intermediateIndices_.begin(), intermediateIndices_.end(), 0);
+  masks_.addInput(input, activeRows_);
+  for (auto i = 0; i < aggregates_.size(); ++i) {
+    aggregates_[i]->initializeNewGroups(
+        intermediateGroups_.data(), intermediateIndices_);
+    const auto& rows = getSelectivityVector(i);
+    // Rows not selected by the mask keep the initial accumulator.
+    if (rows.hasSelections()) {
+      populateTempVectors(i, input);
+      aggregates_[i]->addRawInput(
+          intermediateGroups_.data(), rows, tempVectors_, false);
+    }
+    aggregates_[i]->extractAccumulators(
+        intermediateGroups_.data(),
+        numRows,
+        &result->childAt(keyChannels_.size() + i));
+  }
+  tempVectors_.clear();
+  intermediateRows_->clear();
+}
+
 uint64_t GroupingSet::allocatedBytes() const {
   if (table_) {
     return table_->allocatedBytes();
@@ -548,6 +609,11 @@ void GroupingSet::ensureInputFits(const RowVectorPtr& input) {
           0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
 }
 
+bool GroupingSet::canSpill() const {
+  return spillConfig_ != nullptr && !isPartial_ && !noMoreInput_ &&
+      table_ != nullptr && table_->numDistinct() > 0;
+}
+
 void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
   if (!spiller_) {
     auto rows = table_->rows();
@@ -573,7 +639,8 @@ void GroupingSet::spill(int64_t targetRows, int64_t targetBytes) {
         spillConfig_->maxFileSize,
         spillConfig_->minSpillRunSize,
         Spiller::spillPool(),
-        spillConfig_->executor);
+        spillConfig_->executor,
+        spillConfig_->compressionKind);
   }
   spiller_->spill(targetRows, targetBytes);
 }
@@ -66,6 +66,14 @@ class GroupingSet {
 
   void resetPartial();
 
+  /// Converts raw 'input' of a partial aggregation into intermediate results
+  /// in 'result' without grouping, i.e. produces one row of keys and
+  /// accumulators per input row. Used when the partial aggregation is
+  /// abandoned because it does not reduce the input. The hash table must be
+  /// empty and must not be used after this, since the accumulators are moved
+  /// to a separate RowContainer.
+  void toIntermediate(const RowVectorPtr& input, RowVectorPtr& result);
+
   const HashLookup& hashLookup() const;
 
   /// Spills content until under 'targetRows' and under 'targetBytes'
@@ -77,6 +85,11 @@ class GroupingSet {
   /// of this will be in a paused state and off thread.
   void spill(int64_t targetRows, int64_t targetBytes);
 
+  /// Returns true if spilling is enabled, no output has been produced yet and
+  /// there are groups to spill. Checked before external memory management
+  /// calls spill().
+  bool canSpill() const;
+
   /// Returns the spiller stats including total bytes and rows spilled so far.
   Spiller::Stats spilledStats() const {
     return spiller_ != nullptr ? spiller_->stats() : Spiller::Stats{};
@@ -255,6 +268,15 @@ class GroupingSet {
   // Pool of the OperatorCtx. Used for spilling.
   memory::MemoryPool& pool_;
 
+  // Holds one row of accumulators per input row in toIntermediate().
+  std::unique_ptr<RowContainer> intermediateRows_;
+
+  // The rows of 'intermediateRows_' for the current input.
+  std::vector<char*> intermediateGroups_;
+
+  // Indices of all the rows of the current input in toIntermediate().
+  std::vector<vector_size_t> intermediateIndices_;
+
   // The RowContainer of 'table_' is moved here before freeing
   // 'table_' when starting to read spill output.
   std::unique_ptr<RowContainer> rowsWhileReadingSpill_;
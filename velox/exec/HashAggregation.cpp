@@ -42,6 +42,14 @@ HashAggregation::HashAggregation(
           driverCtx->queryConfig().partialAggregationGoodPct()),
       maxExtendedPartialAggregationMemoryUsage_(
           driverCtx->queryConfig().maxExtendedPartialAggregationMemoryUsage()),
+      abandonPartialAggregationMinRows_(
+          driverCtx->queryConfig().abandonPartialAggregationMinRows()),
+      abandonPartialAggregationMinPct_(
+          driverCtx->queryConfig().abandonPartialAggregationMinPct()),
+      canAbandonPartialAggregation_(
+          aggregationNode->step() == core::AggregationNode::Step::kPartial &&
+          !isGlobal_ && aggregationNode->preGroupedKeys().empty() &&
+          !aggregationNode->ignoreNullKeys()),
       spillConfig_(
           aggregationNode->canSpill(driverCtx->queryConfig())
               ? operatorCtx_->makeSpillConfig(Spiller::Type::kAggregate)
@@ -161,6 +169,11 @@ HashAggregation::HashAggregation(
 }
 
 void HashAggregation::addInput(RowVectorPtr input) {
+  if (abandonedPartialAggregation_) {
+    // Converted to intermediate results in getOutput().
+    input_ = input;
+    return;
+  }
   if (!pushdownChecked_) {
     mayPushdown_ = operatorCtx_->driver()->mayPushdownAggregation(this);
     pushdownChecked_ = true;
@@ -196,6 +209,14 @@ void HashAggregation::addInput(RowVectorPtr input) {
     partialFull_ = true;
   }
 
+  // Flushes the groups accumulated so far before passing the next input
+  // through.
+  if (abandonPartialAggregationEarly()) {
+    abandonedPartialAggregation_ = true;
+    partialFull_ = true;
+    addRuntimeStat("abandonedPartialAggregation", RuntimeCounter(1));
+  }
+
   if (isDistinct_) {
     newDistincts_ = !groupingSet_->hashLookup().newGroups.empty();
 
@@ -235,11 +256,34 @@ void HashAggregation::resetPartialOutputIfNeed() {
   partialFull_ = false;
   numOutputRows_ = 0;
   numInputRows_ = 0;
-  if (!finished_) {
+  if (!finished_ && !abandonedPartialAggregation_) {
     maybeIncreasePartialAggregationMemoryUsage(aggregationPct);
   }
 }
 
+bool HashAggregation::abandonPartialAggregationEarly() const {
+  if (!canAbandonPartialAggregation_ ||
+      numInputRows_ < abandonPartialAggregationMinRows_) {
+    return false;
+  }
+  return 100 * groupingSet_->numRows() >=
+      abandonPartialAggregationMinPct_ * numInputRows_;
+}
+
+RowVectorPtr HashAggregation::getAbandonedPartialOutput() {
+  if (input_ == nullptr) {
+    if (noMoreInput_) {
+      finished_ = true;
+    }
+    return nullptr;
+  }
+  auto output = std::static_pointer_cast<RowVector>(
+      BaseVector::create(outputType_, input_->size(), pool()));
+  groupingSet_->toIntermediate(input_, output);
+  input_ = nullptr;
+  return output;
+}
+
 void HashAggregation::maybeIncreasePartialAggregationMemoryUsage(
     double aggregationPct) {
   VELOX_DCHECK(isPartialOutput_);
@@ -277,6 +321,10 @@ RowVectorPtr HashAggregation::getOutput() {
     return nullptr;
   }
 
+  if (abandonedPartialAggregation_ && !partialFull_) {
+    return getAbandonedPartialOutput();
+  }
+
   // Produce results if one of the following is true:
   // - received no-more-input message;
   // - partial aggregation reached memory limit;
@@ -334,4 +382,17 @@ RowVectorPtr HashAggregation::getOutput() {
 bool HashAggregation::isFinished() {
   return finished_;
 }
+
+void HashAggregation::reclaim(uint64_t /*targetBytes*/) {
+  VELOX_CHECK(canReclaim());
+  groupingSet_->spill(0, 0);
+  pool()->getMemoryUsageTracker()->release();
+
+  const auto spillStats = groupingSet_->spilledStats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+}
 } // namespace facebook::velox::exec
@@ -32,7 +32,8 @@ class HashAggregation : public Operator {
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
-    return !noMoreInput_ && !partialFull_;
+    return !noMoreInput_ && !partialFull_ &&
+        !(abandonedPartialAggregation_ && input_ != nullptr);
   }
 
   void noMoreInput() override {
@@ -46,6 +47,14 @@ class HashAggregation : public Operator {
 
   bool isFinished() override;
 
+  bool canReclaim() const override {
+    return groupingSet_ != nullptr && groupingSet_->canSpill();
+  }
+
+  /// Spills all the groups. A partial spill would leave the memory in the
+  /// RowContainer of the hash table.
+  void reclaim(uint64_t targetBytes) override;
+
   void close() override {
     Operator::close();
     groupingSet_.reset();
@@ -64,6 +73,14 @@ class HashAggregation : public Operator {
   // measure of the effectiveness of the partial aggregation.
   void maybeIncreasePartialAggregationMemoryUsage(double aggregationPct);
 
+  // Returns true if the partial aggregation should stop grouping because the
+  // number of groups is close to the number of input rows.
+  bool abandonPartialAggregationEarly() const;
+
+  // Returns the intermediate results for 'input_' of an abandoned partial
+  // aggregation.
+  RowVectorPtr getAbandonedPartialOutput();
+
   // Maximum number of rows in the output batch.
   const uint32_t outputBatchSize_;
 
@@ -73,12 +90,20 @@ class HashAggregation : public Operator {
   const std::shared_ptr<memory::MemoryUsageTracker> memoryTracker_;
   const double partialAggregationGoodPct_;
   const int64_t maxExtendedPartialAggregationMemoryUsage_;
+  const int32_t abandonPartialAggregationMinRows_;
+  const int32_t abandonPartialAggregationMinPct_;
+  // True if this is a partial aggregation which may be abandoned.
+  const bool canAbandonPartialAggregation_;
   const std::optional<Spiller::Config> spillConfig_;
 
   int64_t maxPartialAggregationMemoryUsage_;
   std::unique_ptr<GroupingSet> groupingSet_;
 
   bool partialFull_ = false;
+  // True if the partial aggregation has been abandoned. After the groups
+  // accumulated so far are flushed, each input is converted to intermediate
+  // results without grouping.
+  bool abandonedPartialAggregation_ = false;
   bool newDistincts_ = false;
   bool finished_ = false;
   RowContainerIterator resultIterator_;
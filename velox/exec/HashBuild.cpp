@@ -203,7 +203,8 @@ void HashBuild::setupSpiller(SpillPartition* spillPartition) {
       spillConfig.maxFileSize,
       spillConfig.minSpillRunSize,
       Spiller::spillPool(),
-      spillConfig.executor);
+      spillConfig.executor,
+      spillConfig.compressionKind);
 
   const int32_t numPartitions = spiller_->hashBits().numPartitions();
   spillInputIndicesBuffers_.resize(numPartitions);
@@ -646,6 +647,27 @@ void HashBuild::addAndClearSpillTarget(uint64_t& numRows, uint64_t& numBytes) {
   numSpillBytes_ = 0;
 }
 
+bool HashBuild::canReclaim() const {
+  // A pending group spill or a finished group leaves the spill to the peers.
+  return spiller_ != nullptr && state_ == State::kRunning &&
+      spillGroup_->state() == SpillOperatorGroup::State::kRunning &&
+      !spillGroup_->needSpill() && !spiller_->state().isAllPartitionSpilled() &&
+      table_->rows()->numRows() > 0;
+}
+
+void HashBuild::reclaim(uint64_t /*targetBytes*/) {
+  VELOX_CHECK(canReclaim());
+  // Spill all the partitions with data. The rows of a partially spilled
+  // RowContainer stay allocated.
+  numSpillRows_ = std::numeric_limits<int64_t>::max();
+  numSpillBytes_ = std::numeric_limits<int64_t>::max();
+  const auto& operators = spillGroup_->operators();
+  runSpill(operators);
+  for (auto* op : operators) {
+    op->pool()->getMemoryUsageTracker()->release();
+  }
+}
+
 void HashBuild::noMoreInput() {
   checkRunning();
 
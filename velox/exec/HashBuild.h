@@ -77,6 +77,12 @@ class HashBuild final : public Operator {
 
   bool isFinished() override;
 
+  bool canReclaim() const override;
+
+  /// Spills the partitions with the most data from all the HashBuild operators
+  /// of the spill group, since the peers must spill the same partitions.
+  void reclaim(uint64_t targetBytes) override;
+
  private:
   void setState(State state);
   void checkStateTransition(State state);
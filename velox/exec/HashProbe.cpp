@@ -52,6 +52,12 @@ RowTypePtr makeTableType(
   return ROW(std::move(names), std::move(types));
 }
 
+// Returns true if 'filter' may pass values that do not occur on the build side.
+bool isBloomFilter(const common::Filter& filter) {
+  return filter.kind() == common::FilterKind::kBigintValuesUsingBloomFilter ||
+      filter.kind() == common::FilterKind::kBytesValuesUsingBloomFilter;
+}
+
 // Copy values from 'rows' of 'table' according to 'projections' in
 // 'result'. Reuses 'result' children where possible.
 void extractColumns(
@@ -263,7 +269,8 @@ void HashProbe::maybeSetupSpillInput(
       spillConfig.maxFileSize,
       spillConfig.minSpillRunSize,
       Spiller::spillPool(),
-      spillConfig.executor);
+      spillConfig.executor,
+      spillConfig.compressionKind);
   // Set the spill partitions to the corresponding ones at the build side. The
   // hash probe operator itself won't trigger any spilling.
   spiller_->setPartitionsSpilled(toPartitionNumSet(spillInputPartitionIds_));
@@ -318,22 +325,37 @@ void HashProbe::asyncWaitForHashTable() {
   } else if (
       (isInnerJoin(joinType_) || isLeftSemiFilterJoin(joinType_) ||
        isRightSemiFilterJoin(joinType_) || isRightSemiProjectJoin(joinType_)) &&
-      table_->hashMode() != BaseHashTable::HashMode::kHash && !isSpillInput() &&
-      !hasMoreSpillData()) {
+      !isSpillInput() && !hasMoreSpillData()) {
     // Find out whether there are any upstream operators that can accept
     // dynamic filters on all or a subset of the join keys. Create dynamic
-    // filters to push down.
+    // filters to push down. Keys that have no exact filter, e.g. because
+    // there are too many distinct values, get a Bloom filter if enabled.
     //
     // NOTE: this optimization is not applied in the following cases: (1) if the
     // probe input is read from spilled data and there is no upstream operators
     // involved; (2) if there is spill data to restore, then we can't filter
     // probe inputs solely based on the current table's join keys.
-    const auto& buildHashers = table_->hashers();
-    auto channels = operatorCtx_->driverCtx()->driver->canPushdownFilters(
-        this, keyChannels_);
-    for (auto i = 0; i < keyChannels_.size(); i++) {
-      if (channels.find(keyChannels_[i]) != channels.end()) {
-        if (auto filter = buildHashers[i]->getFilter(false)) {
+    const auto bloomFilterMaxSize = operatorCtx_->driverCtx()
+                                        ->queryConfig()
+                                        .hashProbeBloomFilterPushdownMaxSize();
+    const bool exactFilters =
+        table_->hashMode() != BaseHashTable::HashMode::kHash;
+    if (exactFilters || bloomFilterMaxSize > 0) {
+      const auto& buildHashers = table_->hashers();
+      auto channels = operatorCtx_->driverCtx()->driver->canPushdownFilters(
+          this, keyChannels_);
+      for (auto i = 0; i < keyChannels_.size(); i++) {
+        if (channels.find(keyChannels_[i]) == channels.end()) {
+          continue;
+        }
+        std::shared_ptr<common::Filter> filter;
+        if (exactFilters) {
+          filter = buildHashers[i]->getFilter(false);
+        }
+        if (!filter && bloomFilterMaxSize > 0) {
+          filter = table_->bloomFilterForKey(i, bloomFilterMaxSize);
+        }
+        if (filter) {
           dynamicFilters_.emplace(keyChannels_[i], std::move(filter));
         }
       }
@@ -495,9 +517,11 @@ void HashProbe::clearDynamicFilters() {
   // The join can be completely replaced with a pushed down
   // filter when the following conditions are met:
   //  * hash table has a single key with unique values,
-  //  * build side has no dependent columns.
+  //  * build side has no dependent columns,
+  //  * the pushed down filter is exact, i.e. not a Bloom filter.
   if (keyChannels_.size() == 1 && !table_->hasDuplicateKeys() &&
-      tableOutputProjections_.empty() && !filter_ && !dynamicFilters_.empty()) {
+      tableOutputProjections_.empty() && !filter_ && !dynamicFilters_.empty() &&
+      !isBloomFilter(*dynamicFilters_.begin()->second)) {
     canReplaceWithDynamicFilter_ = true;
   }
 
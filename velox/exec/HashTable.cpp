@@ -45,6 +45,106 @@ std::string BaseHashTable::modeString(HashMode mode) {
   }
 }
 
+namespace {
+// Adds the non-null values of the integer vector 'values' to 'bloomFilter' and
+// widens ['min', 'max'] to cover them.
+template <typename T>
+void addIntegers(
+    const BaseVector& values,
+    vector_size_t size,
+    BloomFilter<>& bloomFilter,
+    int64_t& min,
+    int64_t& max) {
+  auto* flat = values.asUnchecked<FlatVector<T>>();
+  for (auto i = 0; i < size; ++i) {
+    if (flat->isNullAt(i)) {
+      continue;
+    }
+    const int64_t value = flat->valueAt(i);
+    bloomFilter.insert(common::BigintValuesUsingBloomFilter::hash(value));
+    min = std::min(min, value);
+    max = std::max(max, value);
+  }
+}
+} // namespace
+
+std::shared_ptr<common::Filter> BaseHashTable::bloomFilterForKey(
+    column_index_t keyIndex,
+    uint64_t maxEntries) {
+  std::lock_guard<std::mutex> l(bloomFiltersMutex_);
+  auto it = bloomFilters_.find(keyIndex);
+  if (it != bloomFilters_.end()) {
+    return it->second;
+  }
+  auto& filter = bloomFilters_[keyIndex];
+  const auto& type = hashers_[keyIndex]->type();
+  switch (type->kind()) {
+    case TypeKind::TINYINT:
+    case TypeKind::SMALLINT:
+    case TypeKind::INTEGER:
+    case TypeKind::BIGINT:
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      break;
+    default:
+      return nullptr;
+  }
+  const auto numKeys = numDistinct();
+  if (numKeys == 0 ||
+      numKeys > std::min(maxEntries, BloomFilter<>::kMaxCapacity)) {
+    return nullptr;
+  }
+
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(numKeys);
+  int64_t min = std::numeric_limits<int64_t>::max();
+  int64_t max = std::numeric_limits<int64_t>::min();
+  constexpr int32_t kBatchSize = 1024;
+  std::vector<char*> rows(kBatchSize);
+  auto values = BaseVector::create(type, kBatchSize, rows_->pool());
+  const auto column = rows_->columnAt(keyIndex);
+  RowsIterator iter;
+  int32_t numRows;
+  while ((numRows = listAllRows(
+              &iter, kBatchSize, RowContainer::kUnlimited, rows.data())) > 0) {
+    RowContainer::extractColumn(rows.data(), numRows, column, values);
+    switch (type->kind()) {
+      case TypeKind::TINYINT:
+        addIntegers<int8_t>(*values, numRows, *bloomFilter, min, max);
+        break;
+      case TypeKind::SMALLINT:
+        addIntegers<int16_t>(*values, numRows, *bloomFilter, min, max);
+        break;
+      case TypeKind::INTEGER:
+        addIntegers<int32_t>(*values, numRows, *bloomFilter, min, max);
+        break;
+      case TypeKind::BIGINT:
+        addIntegers<int64_t>(*values, numRows, *bloomFilter, min, max);
+        break;
+      default: {
+        auto* flat = values->asUnchecked<FlatVector<StringView>>();
+        for (auto i = 0; i < numRows; ++i) {
+          if (!flat->isNullAt(i)) {
+            auto value = flat->valueAt(i);
+            bloomFilter->insert(common::BytesValuesUsingBloomFilter::hash(
+                value.data(), value.size()));
+          }
+        }
+      }
+    }
+  }
+
+  if (type->kind() == TypeKind::VARCHAR ||
+      type->kind() == TypeKind::VARBINARY) {
+    filter = std::make_shared<common::BytesValuesUsingBloomFilter>(
+        std::move(bloomFilter), false);
+  } else if (min <= max) {
+    filter = std::make_shared<common::BigintValuesUsingBloomFilter>(
+        min, max, std::move(bloomFilter), false);
+  }
+  return filter;
+}
+
 template <bool ignoreNullKeys>
 HashTable<ignoreNullKeys>::HashTable(
     std::vector<std::unique_ptr<VectorHasher>>&& hashers,
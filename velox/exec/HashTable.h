@@ -15,6 +15,8 @@
  */
 #pragma once
 
+#include <folly/container/F14Map.h>
+
 #include "velox/common/memory/MemoryAllocator.h"
 #include "velox/exec/Aggregate.h"
 #include "velox/exec/Operator.h"
@@ -224,6 +226,18 @@ class BaseHashTable {
   /// Returns a brief description for use in debugging.
   virtual std::string toString() = 0;
 
+  /// Returns a filter that passes the non-null values of the 'keyIndex'th key
+  /// of a join build side and a small fraction of other values. The filter
+  /// tests the values against a Bloom filter and is used as a dynamic filter
+  /// when the keys are too many for an exact filter. Covers the rows of
+  /// 'this' and of the tables added by prepareJoinTable(). Returns nullptr if
+  /// the key type is not supported or if there are more than 'maxEntries'
+  /// distinct keys. The filter is made on first call and shared between the
+  /// probe operators of the table. Thread-safe.
+  std::shared_ptr<common::Filter> bloomFilterForKey(
+      column_index_t keyIndex,
+      uint64_t maxEntries);
+
   static void
   storeTag(uint8_t* FOLLY_NULLABLE tags, int32_t index, uint8_t tag) {
     tags[index] = tag;
@@ -284,6 +298,13 @@ class BaseHashTable {
 
   std::vector<std::unique_ptr<VectorHasher>> hashers_;
   std::unique_ptr<RowContainer> rows_;
+
+ private:
+  std::mutex bloomFiltersMutex_;
+  // Filters made by bloomFilterForKey(), keyed on key index. nullptr if the
+  // key is not suitable for a Bloom filter.
+  folly::F14FastMap<column_index_t, std::shared_ptr<common::Filter>>
+      bloomFilters_;
 };
 
 FOLLY_ALWAYS_INLINE std::ostream& operator<<(
@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/MemoryArbitrator.h"
+
+#include <algorithm>
+
+#include "velox/exec/Task.h"
+
+namespace facebook::velox::exec {
+namespace {
+std::mutex instanceMutex;
+std::shared_ptr<MemoryArbitrator> instance;
+
+// True while the calling thread arbitrates. An allocation that exceeds a
+// query limit while reclaiming, e.g. from spilling, fails instead of
+// arbitrating recursively.
+thread_local bool arbitrating{false};
+
+const std::shared_ptr<memory::MemoryUsageTracker>& queryTracker(
+    const Task& task) {
+  const auto& tracker = task.queryCtx()->pool()->getMemoryUsageTracker();
+  VELOX_CHECK_NOT_NULL(tracker, "Query has no memory usage tracker");
+  return tracker;
+}
+} // namespace
+
+MemoryArbitrator::MemoryArbitrator(const Options& options)
+    : options_(options), freeCapacity_(options.capacity) {
+  VELOX_CHECK_GT(options_.capacity, 0);
+  VELOX_CHECK_GE(options_.initialQueryCapacity, 0);
+  VELOX_CHECK_GE(options_.minGrowBytes, 0);
+}
+
+// static
+void MemoryArbitrator::setInstance(
+    std::shared_ptr<MemoryArbitrator> arbitrator) {
+  std::lock_guard<std::mutex> l(instanceMutex);
+  instance = std::move(arbitrator);
+}
+
+// static
+std::shared_ptr<MemoryArbitrator> MemoryArbitrator::getInstance() {
+  std::lock_guard<std::mutex> l(instanceMutex);
+  return instance;
+}
+
+void MemoryArbitrator::addTask(const std::shared_ptr<Task>& task) {
+  const auto& tracker = queryTracker(*task);
+  std::lock_guard<std::mutex> l(mutex_);
+  auto& query = queries_[tracker.get()];
+  if (query.tracker == nullptr) {
+    query.tracker = tracker;
+    query.maxCapacity = tracker->maxMemory();
+    // The query may already use memory, e.g. from an earlier Task.
+    query.capacity = std::max(
+        tracker->reservedBytes(),
+        std::min(
+            {options_.initialQueryCapacity,
+             query.maxCapacity,
+             std::max<int64_t>(0, freeCapacity_)}));
+    freeCapacity_ -= query.capacity;
+    tracker->setMaxMemory(query.capacity);
+    tracker->setGrowCallback(
+        [this](int64_t /*size*/, memory::MemoryUsageTracker& rootTracker) {
+          return growCapacity(rootTracker);
+        });
+  }
+  query.tasks.emplace(task.get(), task);
+}
+
+void MemoryArbitrator::removeTask(const Task& task) {
+  const auto& tracker = queryTracker(task);
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = queries_.find(tracker.get());
+  if (it == queries_.end()) {
+    return;
+  }
+  auto& query = it->second;
+  query.tasks.erase(&task);
+  if (!query.tasks.empty()) {
+    return;
+  }
+  freeCapacity_ += query.capacity;
+  tracker->setGrowCallback(nullptr);
+  tracker->setMaxMemory(query.maxCapacity);
+  queries_.erase(it);
+}
+
+int64_t MemoryArbitrator::freeCapacity() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return freeCapacity_;
+}
+
+int64_t MemoryArbitrator::queryCapacity(
+    const memory::MemoryUsageTracker& tracker) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = queries_.find(&tracker);
+  return it == queries_.end() ? -1 : it->second.capacity;
+}
+
+MemoryArbitrator::Stats MemoryArbitrator::stats() const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return stats_;
+}
+
+bool MemoryArbitrator::growCapacity(memory::MemoryUsageTracker& tracker) {
+  if (arbitrating) {
+    return false;
+  }
+  // Leave the Task's count of threads on thread, so that pausing the Task of
+  // this thread or of the other arbitrating threads does not wait for us.
+  auto* driver = Driver::current();
+  if (driver != nullptr && driver->state().isSuspended) {
+    driver = nullptr;
+  }
+  if (driver != nullptr &&
+      driver->task()->enterSuspended(driver->state()) != StopReason::kNone) {
+    return false;
+  }
+
+  bool success;
+  arbitrating = true;
+  try {
+    success = arbitrate(tracker);
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "Memory arbitration failed: " << e.what();
+    success = false;
+  }
+  arbitrating = false;
+
+  if (driver != nullptr &&
+      driver->task()->leaveSuspended(driver->state()) != StopReason::kNone) {
+    // The Task is terminated. Any grown capacity is freed with the Task.
+    return false;
+  }
+  return success;
+}
+
+bool MemoryArbitrator::arbitrate(memory::MemoryUsageTracker& tracker) {
+  // Destroyed after releasing 'mutex_' since destroying a Task removes it
+  // from 'this'.
+  std::vector<Victim> victims;
+  int64_t bytesToFree;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    ++stats_.numRequests;
+    auto it = queries_.find(&tracker);
+    if (it == queries_.end()) {
+      ++stats_.numFailures;
+      return false;
+    }
+    auto& requestor = it->second;
+    // Another thread may have grown the capacity since the allocation.
+    if (tracker.reservedBytes() <= requestor.capacity) {
+      return true;
+    }
+    if (tracker.reservedBytes() > requestor.maxCapacity) {
+      ++stats_.numFailures;
+      return false;
+    }
+    bytesToFree =
+        targetCapacityLocked(requestor) - requestor.capacity - freeCapacity_;
+    if (bytesToFree > 0) {
+      bytesToFree -= shrinkLocked(requestor, bytesToFree);
+    }
+    if (bytesToFree > 0) {
+      victims = pickVictimsLocked();
+    }
+  }
+
+  // Pauses and reclaims without 'mutex_', so that registering and removing
+  // Tasks and the arbitration of other queries do not wait for spilling.
+  for (auto& victim : victims) {
+    if (bytesToFree <= 0) {
+      break;
+    }
+    const auto reclaimedBytes = reclaim(victim.tasks, bytesToFree);
+    std::lock_guard<std::mutex> l(mutex_);
+    stats_.reclaimedBytes += reclaimedBytes;
+    if (victim.tracker.get() == &tracker) {
+      // Freeing memory of the requestor lowers the capacity it needs.
+      bytesToFree -= reclaimedBytes;
+      continue;
+    }
+    auto it = queries_.find(victim.tracker.get());
+    if (it == queries_.end()) {
+      // The query finished and freed its capacity.
+      continue;
+    }
+    auto& query = it->second;
+    const auto shrunkBytes = std::min(
+        reclaimedBytes, query.capacity - query.tracker->reservedBytes());
+    if (shrunkBytes > 0) {
+      setCapacityLocked(query, query.capacity - shrunkBytes);
+      bytesToFree -= shrunkBytes;
+    }
+  }
+
+  std::lock_guard<std::mutex> l(mutex_);
+  auto it = queries_.find(&tracker);
+  if (it == queries_.end()) {
+    ++stats_.numFailures;
+    return false;
+  }
+  auto& requestor = it->second;
+  const auto neededBytes = tracker.reservedBytes() - requestor.capacity;
+  if (neededBytes > freeCapacity_) {
+    ++stats_.numFailures;
+    return false;
+  }
+  const auto growBytes = std::max<int64_t>(
+      {neededBytes,
+       0,
+       std::min(
+           targetCapacityLocked(requestor) - requestor.capacity,
+           freeCapacity_)});
+  setCapacityLocked(requestor, requestor.capacity + growBytes);
+  return true;
+}
+
+int64_t MemoryArbitrator::targetCapacityLocked(const QueryState& query) const {
+  return std::min(
+      query.maxCapacity,
+      std::max(
+          query.tracker->reservedBytes(),
+          query.capacity + options_.minGrowBytes));
+}
+
+int64_t MemoryArbitrator::shrinkLocked(
+    const QueryState& requestor,
+    int64_t bytes) {
+  std::vector<std::pair<int64_t, QueryState*>> candidates;
+  for (auto& [_, query] : queries_) {
+    if (&query == &requestor) {
+      continue;
+    }
+    const auto unusedBytes = query.capacity - query.tracker->reservedBytes();
+    if (unusedBytes > 0) {
+      candidates.emplace_back(unusedBytes, &query);
+    }
+  }
+  std::sort(
+      candidates.begin(),
+      candidates.end(),
+      [](const auto& left, const auto& right) {
+        return left.first > right.first;
+      });
+  int64_t shrunkBytes = 0;
+  for (auto& [unusedBytes, query] : candidates) {
+    if (shrunkBytes >= bytes) {
+      break;
+    }
+    const auto takenBytes = std::min(unusedBytes, bytes - shrunkBytes);
+    setCapacityLocked(*query, query->capacity - takenBytes);
+    shrunkBytes += takenBytes;
+  }
+  stats_.shrunkBytes += shrunkBytes;
+  return shrunkBytes;
+}
+
+std::vector<MemoryArbitrator::Victim> MemoryArbitrator::pickVictimsLocked() {
+  std::vector<Victim> victims;
+  victims.reserve(queries_.size());
+  for (auto& [_, query] : queries_) {
+    Victim victim{query.tracker, query.tracker->reservedBytes(), {}};
+    for (auto& entry : query.tasks) {
+      auto task = entry.second.lock();
+      if (task != nullptr && task->isRunning()) {
+        victim.tasks.push_back(std::move(task));
+      }
+    }
+    if (!victim.tasks.empty()) {
+      victims.push_back(std::move(victim));
+    }
+  }
+  std::sort(
+      victims.begin(),
+      victims.end(),
+      [](const Victim& left, const Victim& right) {
+        return left.reservedBytes > right.reservedBytes;
+      });
+  return victims;
+}
+
+int64_t MemoryArbitrator::reclaim(
+    const std::vector<std::shared_ptr<Task>>& tasks,
+    int64_t bytes) {
+  // A Task that is already paused, e.g. by another arbitrating thread, is
+  // skipped, so that it is not resumed here while its pauser relies on it.
+  std::vector<std::shared_ptr<Task>> pausedTasks;
+  std::vector<ContinueFuture> pauseFutures;
+  for (auto& task : tasks) {
+    if (task->pauseRequested()) {
+      continue;
+    }
+    pauseFutures.push_back(task->requestPause(true));
+    pausedTasks.push_back(task);
+  }
+  if (pausedTasks.empty()) {
+    return 0;
+  }
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    ++stats_.numReclaims;
+  }
+  for (auto& future : pauseFutures) {
+    future.wait();
+  }
+
+  int64_t reclaimedBytes = 0;
+  for (auto& task : pausedTasks) {
+    if (reclaimedBytes >= bytes) {
+      break;
+    }
+    try {
+      reclaimedBytes += task->reclaim(bytes - reclaimedBytes);
+    } catch (const std::exception&) {
+      // The operator state is unknown after a failed spill.
+      task->setError(std::current_exception());
+    }
+  }
+
+  for (auto& task : pausedTasks) {
+    try {
+      if (task->error() == nullptr) {
+        Task::resume(task);
+      }
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Failed to resume Task " << task->taskId()
+                 << " after reclaiming memory: " << e.what();
+    }
+  }
+  return reclaimedBytes;
+}
+
+void MemoryArbitrator::setCapacityLocked(QueryState& query, int64_t capacity) {
+  freeCapacity_ += query.capacity - capacity;
+  query.capacity = capacity;
+  query.tracker->setMaxMemory(capacity);
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "velox/common/memory/MemoryUsageTracker.h"
+
+namespace facebook::velox::exec {
+
+class Task;
+
+/// Shares a process wide memory capacity between the running queries instead
+/// of giving each query a fixed memory limit. A query gets
+/// 'initialQueryCapacity' when its first Task starts. When an allocation
+/// exceeds the limit of the query, the GrowCallback of the query's root
+/// MemoryUsageTracker asks the arbitrator for more capacity. The arbitrator
+/// grants it from the free capacity. If that is not enough, it first takes back
+/// the unused capacity of other queries and then pauses the Tasks of the
+/// queries with the most memory, including the requesting query, and lets
+/// their spillable operators free memory with Task::reclaim(). Only if this
+/// does not free enough memory does the allocation fail as it would without
+/// the arbitrator.
+///
+/// A query never grows beyond the max memory its root tracker had when it
+/// registered. A Driver thread asking for memory enters a SuspendedSection
+/// while arbitrating, so that its own Task can be paused. The Tasks are paused
+/// and reclaimed from without holding the lock of the arbitrator. Tasks that
+/// are already paused, e.g. by another arbitrating thread, are skipped and
+/// stay paused.
+///
+/// Queries are identified by the root MemoryUsageTracker of their QueryCtx.
+/// The limit of the tracker and the GrowCallback are restored when the last
+/// Task of the query is destroyed.
+class MemoryArbitrator {
+ public:
+  struct Options {
+    /// Memory in bytes shared by the queries.
+    int64_t capacity;
+
+    /// Memory limit in bytes of a query when its first Task starts.
+    int64_t initialQueryCapacity{128 << 20};
+
+    /// Min bytes by which the limit of a query grows. Growing by more than the
+    /// failed allocation needs keeps a growing query from arbitrating for
+    /// every allocation.
+    int64_t minGrowBytes{32 << 20};
+  };
+
+  struct Stats {
+    /// Number of allocations that exceeded the limit of their query.
+    uint64_t numRequests{0};
+
+    /// Number of the requests that could not be granted.
+    uint64_t numFailures{0};
+
+    /// Number of times the Tasks of a query were paused to reclaim memory.
+    uint64_t numReclaims{0};
+
+    /// Bytes freed by Task::reclaim().
+    uint64_t reclaimedBytes{0};
+
+    /// Unused capacity taken back from queries.
+    uint64_t shrunkBytes{0};
+  };
+
+  explicit MemoryArbitrator(const Options& options);
+
+  /// Sets the arbitrator that Tasks started from now on register with. A Task
+  /// stays with the arbitrator it registered with. nullptr, the default,
+  /// leaves the queries with the fixed limits of their trackers.
+  static void setInstance(std::shared_ptr<MemoryArbitrator> arbitrator);
+
+  static std::shared_ptr<MemoryArbitrator> getInstance();
+
+  /// Registers 'task' at start. The first Task of a query sets the limit and
+  /// the GrowCallback of the root tracker of the query.
+  void addTask(const std::shared_ptr<Task>& task);
+
+  /// Unregisters 'task' on destruction. Frees the capacity of the query of
+  /// 'task' if this was its last Task.
+  void removeTask(const Task& task);
+
+  int64_t capacity() const {
+    return options_.capacity;
+  }
+
+  /// Returns the capacity not given to any query.
+  int64_t freeCapacity() const;
+
+  /// Returns the memory limit of the query with root tracker 'tracker' or -1
+  /// if the query has no registered Task.
+  int64_t queryCapacity(const memory::MemoryUsageTracker& tracker) const;
+
+  Stats stats() const;
+
+ private:
+  struct QueryState {
+    std::shared_ptr<memory::MemoryUsageTracker> tracker;
+
+    // The max memory of 'tracker' at registration. Restored when the last Task
+    // is removed.
+    int64_t maxCapacity;
+
+    // The current memory limit of 'tracker'.
+    int64_t capacity;
+
+    std::unordered_map<const Task*, std::weak_ptr<Task>> tasks;
+  };
+
+  // A query to reclaim memory from.
+  struct Victim {
+    std::shared_ptr<memory::MemoryUsageTracker> tracker;
+
+    // The memory of the query when picked.
+    int64_t reservedBytes;
+
+    // The running Tasks of the query. Holding them keeps them from being
+    // destroyed while reclaiming.
+    std::vector<std::shared_ptr<Task>> tasks;
+  };
+
+  // The GrowCallback of the registered queries.
+  bool growCapacity(memory::MemoryUsageTracker& tracker);
+
+  // Grows the capacity of the query of 'tracker' to cover its usage. Takes
+  // 'mutex_' to pick the victims and to update the capacities, but not while
+  // reclaiming from the victims.
+  bool arbitrate(memory::MemoryUsageTracker& tracker);
+
+  // Returns the capacity 'query' grows to: at least its usage and at least
+  // 'minGrowBytes' more than its capacity, but not more than its max.
+  int64_t targetCapacityLocked(const QueryState& query) const;
+
+  // Takes back up to 'bytes' of unused capacity from the queries other than
+  // 'requestor', starting with the query with the most unused capacity.
+  // Returns the bytes taken.
+  int64_t shrinkLocked(const QueryState& requestor, int64_t bytes);
+
+  // Returns the queries with running Tasks, the query with the most memory
+  // first. Includes the requesting query.
+  std::vector<Victim> pickVictimsLocked();
+
+  // Pauses 'tasks', reclaims up to 'bytes' from them and resumes them.
+  // Returns the bytes freed. Only the Tasks that were not paused before are
+  // paused, reclaimed and resumed.
+  int64_t reclaim(
+      const std::vector<std::shared_ptr<Task>>& tasks,
+      int64_t bytes);
+
+  void setCapacityLocked(QueryState& query, int64_t capacity);
+
+  const Options options_;
+
+  mutable std::mutex mutex_;
+
+  // The capacity not given to any query. Can be negative if queries used more
+  // than their initial capacity before registering.
+  int64_t freeCapacity_;
+
+  std::unordered_map<const memory::MemoryUsageTracker*, QueryState> queries_;
+
+  Stats stats_;
+};
+
+} // namespace facebook::velox::exec
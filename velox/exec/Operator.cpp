@@ -114,7 +114,8 @@ std::optional<Spiller::Config> OperatorCtx::makeSpillConfig(
           queryConfig.spillStartPartitionBit() +
               queryConfig.spillPartitionBits()),
       queryConfig.maxSpillLevel(),
-      queryConfig.testingSpillPct());
+      queryConfig.testingSpillPct(),
+      stringToSpillCompressionKind(queryConfig.spillCompressionKind()));
 }
 
 Operator::Operator(
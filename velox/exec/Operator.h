@@ -383,6 +383,20 @@ class Operator : public BaseRuntimeStatWriter {
     return false;
   }
 
+  /// Returns true if reclaim() can free memory of 'this', e.g. by spilling its
+  /// state to disk.
+  virtual bool canReclaim() const {
+    return false;
+  }
+
+  /// Frees memory of 'this', aiming at 'targetBytes', and releases the unused
+  /// memory reservation. Called by Task::reclaim() on behalf of the
+  /// MemoryArbitrator while the Task is paused and the Drivers of the pipeline
+  /// of 'this' are off thread. Called only if canReclaim() returns true.
+  virtual void reclaim(uint64_t /*targetBytes*/) {
+    VELOX_UNSUPPORTED("This operator can't reclaim memory: {}", toString());
+  }
+
   /// Returns copy of operator stats. If 'clear' is true, the function also
   /// clears the operator stats after retrieval.
   OperatorStats stats(bool clear);
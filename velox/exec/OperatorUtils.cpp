@@ -15,6 +15,7 @@
  */
 
 #include "velox/exec/OperatorUtils.h"
+#include "velox/exec/HashTable.h"
 #include "velox/exec/VectorHasher.h"
 #include "velox/expression/EvalCtx.h"
 #include "velox/vector/ConstantVector.h"
@@ -136,6 +137,44 @@ void deselectRowsWithNulls(
   }
 }
 
+void groupProbe(
+    const RowVectorPtr& input,
+    BaseHashTable& table,
+    HashLookup& lookup,
+    SelectivityVector& rows) {
+  const auto numRows = input->size();
+  rows.resize(numRows);
+  rows.setAll();
+  auto& hashers = lookup.hashers;
+  lookup.reset(numRows);
+  for (auto& hasher : hashers) {
+    auto key = input->childAt(hasher->channel())->loadedVector();
+    hasher->decode(*key, rows);
+  }
+
+  bool rehash = false;
+  const auto mode = table.hashMode();
+  for (auto i = 0; i < hashers.size(); ++i) {
+    if (mode != BaseHashTable::HashMode::kHash) {
+      if (!hashers[i]->computeValueIds(rows, lookup.hashes)) {
+        rehash = true;
+      }
+    } else {
+      hashers[i]->hash(rows, i > 0, lookup.hashes);
+    }
+  }
+  if (rehash) {
+    if (table.hashMode() != BaseHashTable::HashMode::kHash) {
+      table.decideHashMode(numRows);
+    }
+    groupProbe(input, table, lookup, rows);
+    return;
+  }
+
+  std::iota(lookup.rows.begin(), lookup.rows.end(), 0);
+  table.groupProbe(lookup);
+}
+
 uint64_t* FilterEvalCtx::getRawSelectedBits(
     vector_size_t size,
     memory::MemoryPool* pool) {
@@ -21,6 +21,8 @@
 namespace facebook::velox::exec {
 
 class VectorHasher;
+class BaseHashTable;
+struct HashLookup;
 
 // Deselects rows from 'rows' where any of the vectors managed by the 'hashers'
 // has a null.
@@ -28,6 +30,16 @@ void deselectRowsWithNulls(
     const std::vector<std::unique_ptr<VectorHasher>>& hashers,
     SelectivityVector& rows);
 
+// Looks up the groups of all the rows of 'input' in 'table' and inserts the
+// groups not in 'table'. The keys are the columns of the hashers of 'lookup'.
+// Fills 'lookup.hits' with the group of each row and 'lookup.newGroups' with
+// the rows whose group was inserted. 'rows' is scratch space.
+void groupProbe(
+    const RowVectorPtr& input,
+    BaseHashTable& table,
+    HashLookup& lookup,
+    SelectivityVector& rows);
+
 // Reusable memory needed for processing filter results.
 struct FilterEvalCtx {
   DecodedVector decodedResult;
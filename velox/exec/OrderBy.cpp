@@ -15,6 +15,7 @@
  */
 #include "velox/exec/OrderBy.h"
 #include "velox/exec/OperatorUtils.h"
+#include "velox/exec/PrefixSort.h"
 #include "velox/exec/Task.h"
 #include "velox/vector/FlatVector.h"
 
@@ -37,9 +38,6 @@ OrderBy::OrderBy(
           orderByNode->id(),
           "OrderBy"),
       numSortKeys_(orderByNode->sortingKeys().size()),
-      spillMemoryThreshold_(operatorCtx_->driverCtx()
-                                ->queryConfig()
-                                .orderBySpillMemoryThreshold()),
       spillConfig_(
           orderByNode->canSpill(driverCtx->queryConfig())
               ? operatorCtx_->makeSpillConfig(Spiller::Type::kOrderBy)
@@ -91,6 +89,17 @@ OrderBy::OrderBy(
   }
 #endif
 
+  if (spillConfig_.has_value()) {
+    inputSpiller_ = std::make_unique<SortInputSpiller>(
+        Spiller::Type::kOrderBy,
+        data_.get(),
+        internalStoreType_,
+        keyCompareFlags_,
+        spillConfig_.value(),
+        driverCtx->queryConfig().orderBySpillMemoryThreshold(),
+        pool());
+  }
+
   outputBatchSize_ = std::max<uint32_t>(
       operatorCtx_->execCtx()
           ->queryCtx()
@@ -100,7 +109,9 @@ OrderBy::OrderBy(
 }
 
 void OrderBy::addInput(RowVectorPtr input) {
-  ensureInputFits(input);
+  if (inputSpiller_ != nullptr) {
+    inputSpiller_->ensureInputFits(input);
+  }
 
   SelectivityVector allRows(input->size());
   std::vector<char*> rows(input->size());
@@ -116,118 +127,27 @@ void OrderBy::addInput(RowVectorPtr input) {
   }
 
   numRows_ += allRows.size();
-  if (spiller_ != nullptr) {
-    const auto spillStats = spiller_->stats();
-    auto lockedStats = stats_.wlock();
-    lockedStats->spilledBytes = spillStats.spilledBytes;
-    lockedStats->spilledRows = spillStats.spilledRows;
-    lockedStats->spilledPartitions = spillStats.spilledPartitions;
-    lockedStats->spilledFiles = spillStats.spilledFiles;
-    VELOX_DCHECK_LE(lockedStats->spilledPartitions, 1);
-  }
+  updateSpillStats();
 }
 
-void OrderBy::ensureInputFits(const RowVectorPtr& input) {
-  // Check if spilling is enabled or not.
-  if (!spillConfig_.has_value()) {
-    return;
-  }
-
-  const int64_t numRows = data_->numRows();
-  if (numRows == 0) {
-    // 'data_' is empty. Nothing to spill.
-    return;
-  }
-  auto [freeRows, outOfLineFreeBytes] = data_->freeSpace();
-  const auto outOfLineBytes =
-      data_->stringAllocator().retainedSize() - outOfLineFreeBytes;
-  const int64_t outOfLineBytesPerRow = outOfLineBytes / numRows;
-  const int64_t flatInputBytes = input->estimateFlatSize();
-
-  const auto& spillConfig = spillConfig_.value();
-  // Test-only spill path.
-  if (numRows > 0 && spillConfig.testSpillPct &&
-      (folly::hasher<uint64_t>()(++spillTestCounter_)) % 100 <=
-          spillConfig.testSpillPct) {
-    const int64_t rowsToSpill = std::max<int64_t>(1, numRows / 10);
-    spill(
-        numRows - rowsToSpill,
-        outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow));
-    return;
-  }
-
-  auto tracker = pool()->getMemoryUsageTracker();
-  VELOX_CHECK_NOT_NULL(tracker);
-  const auto currentUsage = tracker->currentBytes();
-  if (spillMemoryThreshold_ != 0 && currentUsage > spillMemoryThreshold_) {
-    const int64_t bytesToSpill =
-        currentUsage * spillConfig.spillableReservationGrowthPct / 100;
-    auto rowsToSpill = std::max<int64_t>(
-        1, bytesToSpill / (data_->fixedRowSize() + outOfLineBytesPerRow));
-    spill(
-        std::max<int64_t>(0, numRows - rowsToSpill),
-        std::max<int64_t>(
-            0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
-    return;
-  }
-
-  if (freeRows > input->size() &&
-      (outOfLineBytes == 0 || outOfLineFreeBytes >= flatInputBytes)) {
-    // Enough free rows for input rows and enough variable length free
-    // space for the flat size of the whole vector. If outOfLineBytes
-    // is 0 there is no need for variable length space.
-    return;
-  }
-
-  // If there is variable length data we take the flat size of the input as a
-  // cap on the new variable length data needed.
-  const int64_t incrementBytes =
-      data_->sizeIncrement(input->size(), outOfLineBytes ? flatInputBytes : 0);
-
-  // There must be at least 2x the increment in reservation.
-  if (tracker->availableReservation() > 2 * incrementBytes) {
-    return;
-  }
-
-  // Check if can increase reservation. The increment is the larger of twice the
-  // maximum increment from this input and 'spillableReservationGrowthPct_' of
-  // the current reservation.
-  const auto targetIncrementBytes = std::max<int64_t>(
-      incrementBytes * 2,
-      currentUsage * spillConfig.spillableReservationGrowthPct / 100);
-  if (tracker->maybeReserve(targetIncrementBytes)) {
-    return;
-  }
-  const int64_t rowsToSpill = std::max<int64_t>(
-      1, targetIncrementBytes / (data_->fixedRowSize() + outOfLineBytesPerRow));
-  spill(
-      std::max<int64_t>(0, numRows - rowsToSpill),
-      std::max<int64_t>(
-          0, outOfLineBytes - (rowsToSpill * outOfLineBytesPerRow)));
+void OrderBy::reclaim(uint64_t /*targetBytes*/) {
+  VELOX_CHECK(canReclaim());
+  inputSpiller_->spill(0, 0);
+  pool()->getMemoryUsageTracker()->release();
+  updateSpillStats();
 }
 
-void OrderBy::spill(int64_t targetRows, int64_t targetBytes) {
-  VELOX_CHECK_GE(targetRows, 0);
-  VELOX_CHECK_GE(targetBytes, 0);
-
-  if (spiller_ == nullptr) {
-    VELOX_DCHECK_NOT_NULL(pool()->getMemoryUsageTracker());
-    const auto& spillConfig = spillConfig_.value();
-    spiller_ = std::make_unique<Spiller>(
-        Spiller::Type::kOrderBy,
-        data_.get(),
-        [&](folly::Range<char**> rows) { data_->eraseRows(rows); },
-        internalStoreType_,
-        data_->keyTypes().size(),
-        keyCompareFlags_,
-        spillConfig.filePath,
-        spillConfig.maxFileSize,
-        spillConfig.minSpillRunSize,
-        Spiller::spillPool(),
-        spillConfig.executor);
-    VELOX_CHECK_EQ(spiller_->state().maxPartitions(), 1);
+void OrderBy::updateSpillStats() {
+  if (spiller() == nullptr) {
+    return;
   }
-  spiller_->spill(targetRows, targetBytes);
+  const auto spillStats = spiller()->stats();
+  auto lockedStats = stats_.wlock();
+  lockedStats->spilledBytes = spillStats.spilledBytes;
+  lockedStats->spilledRows = spillStats.spilledRows;
+  lockedStats->spilledPartitions = spillStats.spilledPartitions;
+  lockedStats->spilledFiles = spillStats.spilledFiles;
+  VELOX_DCHECK_LE(lockedStats->spilledPartitions, 1);
 }
 
 void OrderBy::noMoreInput() {
@@ -239,34 +159,26 @@ void OrderBy::noMoreInput() {
     return;
   }
 
-  if (spiller_ == nullptr) {
+  if (spiller() == nullptr) {
     VELOX_CHECK_EQ(numRows_, data_->numRows());
     // Sort the pointers to the rows in RowContainer (data_) instead of sorting
     // the rows.
     returningRows_.resize(numRows_);
     RowContainerIterator iter;
     data_->listRows(&iter, numRows_, returningRows_.data());
-    std::sort(
-        returningRows_.begin(),
-        returningRows_.end(),
-        [this](const char* leftRow, const char* rightRow) {
-          for (vector_size_t index = 0; index < numSortKeys_; ++index) {
-            if (auto result = data_->compare(
-                    leftRow, rightRow, index, keyCompareFlags_[index])) {
-              return result < 0;
-            }
-          }
-          return false;
-        });
+    PrefixSort::sort(
+        data_.get(),
+        keyCompareFlags_,
+        folly::Range<char**>(returningRows_.data(), returningRows_.size()));
 
   } else {
     // Finish spill, and we shouldn't get any rows from non-spilled partition as
     // there is only one hash partition for orderBy operator.
-    Spiller::SpillRows nonSpilledRows = spiller_->finishSpill();
+    Spiller::SpillRows nonSpilledRows = spiller()->finishSpill();
     VELOX_CHECK(nonSpilledRows.empty());
     VELOX_CHECK_NULL(spillMerge_);
 
-    spillMerge_ = spiller_->startMerge(0);
+    spillMerge_ = spiller()->startMerge(0);
     spillSources_.resize(outputBatchSize_);
     spillSourceRows_.resize(outputBatchSize_);
   }
@@ -278,7 +190,7 @@ RowVectorPtr OrderBy::getOutput() {
   }
   prepareOutput();
 
-  if (spiller_ != nullptr) {
+  if (spiller() != nullptr) {
     getOutputWithSpill();
   } else {
     getOutputWithoutSpill();
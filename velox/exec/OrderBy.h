@@ -18,7 +18,7 @@
 #include "velox/exec/ContainerRowSerde.h"
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
-#include "velox/exec/Spiller.h"
+#include "velox/exec/SortInputSpiller.h"
 
 namespace facebook::velox::exec {
 
@@ -56,14 +56,16 @@ class OrderBy : public Operator {
     return finished_;
   }
 
+  bool canReclaim() const override {
+    return spillConfig_.has_value() && !noMoreInput_ && data_->numRows() > 0;
+  }
+
+  /// Spills all the rows. A partial spill would leave the memory in 'data_'.
+  void reclaim(uint64_t targetBytes) override;
+
  private:
   static const int32_t kBatchSizeInBytes{2 * 1024 * 1024};
 
-  // Checks if input will fit in the existing memory and increases
-  // reservation if not. If reservation cannot be increased, spills enough to
-  // make 'input' fit.
-  void ensureInputFits(const RowVectorPtr& input);
-
   // Prepare the reusable output buffer based on the output batch size and the
   // remaining rows to return.
   void prepareOutput();
@@ -71,18 +73,16 @@ class OrderBy : public Operator {
   void getOutputWithoutSpill();
   void getOutputWithSpill();
 
-  // Spills content until under 'targetRows' and under 'targetBytes' of out of
-  // line data are left. If 'targetRows' is 0, spills everything and physically
-  // frees the data in the 'data_'. This is called by ensureInputFits or by
-  // external memory management. In the latter case, the Driver of this will be
-  // in a paused state and off thread.
-  void spill(int64_t targetRows, int64_t targetBytes);
+  // Returns the Spiller of 'inputSpiller_', nullptr if nothing has been
+  // spilled.
+  Spiller* spiller() const {
+    return inputSpiller_ == nullptr ? nullptr : inputSpiller_->spiller();
+  }
 
-  const int32_t numSortKeys_;
+  // Copies the spill stats of 'spiller()' to the operator stats.
+  void updateSpillStats();
 
-  // The maximum memory usage that an order by can hold before spilling.
-  // If it is zero, then there is no such limit.
-  const uint64_t spillMemoryThreshold_;
+  const int32_t numSortKeys_;
 
   // Filesystem path for spill files, empty if spilling is disabled.
   // The disk spilling related configs if spilling is enabled, otherwise null.
@@ -116,11 +116,10 @@ class OrderBy : public Operator {
   // Used to collect sorted rows from 'data_' on non-spilling output path.
   std::vector<char*> returningRows_;
 
-  std::unique_ptr<Spiller> spiller_;
-
-  // Counts input batches and triggers spilling if folly hash of this % 100 <=
-  // 'testSpillPct_';.
-  uint64_t spillTestCounter_{0};
+  // Spills the rows of 'data_' if spilling is enabled, otherwise null. Input
+  // is spilled to make it fit in memory and, in a paused state and off
+  // thread, by external memory management calling reclaim().
+  std::unique_ptr<SortInputSpiller> inputSpiller_;
 
   // Set to read back spilled data if disk spilling has been triggered.
   std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
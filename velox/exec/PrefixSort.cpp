@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PrefixSort.h"
+
+#include <array>
+#include <cstring>
+
+namespace facebook::velox::exec {
+namespace {
+
+// Returns the number of value bytes of a key of 'kind' in the prefix or 0 if
+// the key cannot be encoded.
+int32_t prefixValueBytes(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+    case TypeKind::TINYINT:
+      return 1;
+    case TypeKind::SMALLINT:
+      return 2;
+    case TypeKind::INTEGER:
+    case TypeKind::DATE:
+      return 4;
+    case TypeKind::BIGINT:
+      return 8;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY:
+      return PrefixSort::kMaxStringPrefixBytes;
+    default:
+      return 0;
+  }
+}
+
+bool isStringKind(TypeKind kind) {
+  return kind == TypeKind::VARCHAR || kind == TypeKind::VARBINARY;
+}
+
+// Writes 'value' to 'out' so that memcmp of the bytes orders the values as
+// signed integers.
+template <typename T>
+void encodeSigned(T value, char* out) {
+  using U = std::make_unsigned_t<T>;
+  auto bits = static_cast<U>(value) ^ (U{1} << (sizeof(T) * 8 - 1));
+  for (int32_t i = sizeof(T) - 1; i >= 0; --i) {
+    out[i] = static_cast<char>(bits & 0xff);
+    bits >>= 8;
+  }
+}
+
+template <typename T>
+T readValue(const char* row, int32_t offset) {
+  return *reinterpret_cast<const T*>(row + offset);
+}
+
+// Encodes the value of a non-null key at 'offset' in 'row' into 'numBytes'
+// bytes at 'out', in ascending order.
+void encodeValue(
+    TypeKind kind,
+    const char* row,
+    int32_t offset,
+    int32_t numBytes,
+    char* out) {
+  switch (kind) {
+    case TypeKind::BOOLEAN:
+      out[0] = readValue<bool>(row, offset) ? 1 : 0;
+      break;
+    case TypeKind::TINYINT:
+      encodeSigned(readValue<int8_t>(row, offset), out);
+      break;
+    case TypeKind::SMALLINT:
+      encodeSigned(readValue<int16_t>(row, offset), out);
+      break;
+    case TypeKind::INTEGER:
+      encodeSigned(readValue<int32_t>(row, offset), out);
+      break;
+    case TypeKind::DATE:
+      encodeSigned(readValue<Date>(row, offset).days(), out);
+      break;
+    case TypeKind::BIGINT:
+      encodeSigned(readValue<int64_t>(row, offset), out);
+      break;
+    case TypeKind::VARCHAR:
+    case TypeKind::VARBINARY: {
+      // Strings shorter than the prefix are padded with zeros. The padded
+      // prefix orders no string after a longer one it is a prefix of, so
+      // equal prefixes are resolved by comparing the full strings.
+      std::string storage;
+      auto value = HashStringAllocator::contiguousString(
+          readValue<StringView>(row, offset), storage);
+      const auto size = std::min<int32_t>(value.size(), numBytes);
+      std::memcpy(out, value.data(), size);
+      std::memset(out + size, 0, numBytes - size);
+      break;
+    }
+    default:
+      VELOX_UNREACHABLE();
+  }
+}
+
+// Sorts prefixes of rows, each followed by the pointer to its row.
+class PrefixSorter {
+ public:
+  PrefixSorter(
+      RowContainer* container,
+      const std::vector<CompareFlags>& compareFlags,
+      int32_t prefixBytes,
+      bool exact)
+      : container_(container),
+        compareFlags_(compareFlags),
+        prefixBytes_(prefixBytes),
+        entrySize_(bits::roundUp(prefixBytes, sizeof(char*)) + sizeof(char*)),
+        exact_(exact) {}
+
+  // Returns the start of the entry for row 'index'. The prefix is at the
+  // start of the entry.
+  char* entryAt(int32_t index) {
+    return rawEntries_ + index * entrySize_;
+  }
+
+  char*& rowOf(char* entry) const {
+    return *reinterpret_cast<char**>(entry + entrySize_ - sizeof(char*));
+  }
+
+  void sort(folly::Range<char**> rows, int32_t numKeys) {
+    const auto numRows = rows.size();
+    // The entries are as large as the rows being sorted, so they are
+    // allocated from the pool of the container, e.g. while spilling.
+    auto* pool = container_->pool();
+    entries_ = AlignedBuffer::allocate<char>(numRows * entrySize_, pool);
+    rawEntries_ = entries_->asMutable<char>();
+    temp_ = AlignedBuffer::allocate<char>(numRows * entrySize_, pool);
+    rawTemp_ = temp_->asMutable<char>();
+    for (auto i = 0; i < numRows; ++i) {
+      auto* entry = entryAt(i);
+      encodePrefix(rows[i], numKeys, entry);
+      rowOf(entry) = rows[i];
+    }
+    radixSort(0, numRows, 0, rows);
+  }
+
+ private:
+  void encodePrefix(const char* row, int32_t numKeys, char* entry) {
+    const auto& keyTypes = container_->keyTypes();
+    auto* out = entry;
+    for (auto i = 0; i < numKeys; ++i) {
+      const auto kind = keyTypes[i]->kind();
+      const auto numBytes = prefixValueBytes(kind);
+      const auto flags =
+          compareFlags_.empty() ? CompareFlags() : compareFlags_[i];
+      const auto column = container_->columnAt(i);
+      // The null indicator orders nulls independently of the sort order.
+      if (RowContainer::isNullAt(row, column.nullByte(), column.nullMask())) {
+        *out = flags.nullsFirst ? 0 : 1;
+        std::memset(out + 1, 0, numBytes);
+      } else {
+        *out = flags.nullsFirst ? 1 : 0;
+        encodeValue(kind, row, column.offset(), numBytes, out + 1);
+        if (!flags.ascending) {
+          for (auto j = 1; j <= numBytes; ++j) {
+            out[j] = ~out[j];
+          }
+        }
+      }
+      out += 1 + numBytes;
+    }
+    // Zero the padding between the prefix and the row pointer.
+    std::memset(out, 0, entrySize_ - sizeof(char*) - (out - entry));
+  }
+
+  // Sorts entries [begin, end), which have equal prefix bytes before 'depth',
+  // and writes the rows in sorted order to the same positions of 'rows'.
+  void radixSort(
+      int32_t begin,
+      int32_t end,
+      int32_t depth,
+      folly::Range<char**> rows) {
+    const auto numEntries = end - begin;
+    for (;;) {
+      if (numEntries < PrefixSort::kMinRadixSortRows) {
+        comparisonSort(begin, end, depth, rows);
+        return;
+      }
+      if (depth == prefixBytes_) {
+        tieSort(begin, end, rows);
+        return;
+      }
+      std::array<int32_t, 257> offsets{};
+      for (auto i = begin; i < end; ++i) {
+        ++offsets[static_cast<uint8_t>(entryAt(i)[depth]) + 1];
+      }
+      // All entries have the same byte at 'depth', e.g. the high bytes of
+      // small integers. Continue with the next byte without moving anything.
+      if (offsets[static_cast<uint8_t>(entryAt(begin)[depth]) + 1] ==
+          numEntries) {
+        ++depth;
+        continue;
+      }
+      for (auto i = 1; i < offsets.size(); ++i) {
+        offsets[i] += offsets[i - 1];
+      }
+      auto positions = offsets;
+      for (auto i = begin; i < end; ++i) {
+        auto* entry = entryAt(i);
+        auto& position = positions[static_cast<uint8_t>(entry[depth])];
+        std::memcpy(rawTemp_ + position * entrySize_, entry, entrySize_);
+        ++position;
+      }
+      std::memcpy(entryAt(begin), rawTemp_, numEntries * entrySize_);
+      for (auto i = 0; i < 256; ++i) {
+        if (offsets[i + 1] > offsets[i]) {
+          radixSort(
+              begin + offsets[i], begin + offsets[i + 1], depth + 1, rows);
+        }
+      }
+      return;
+    }
+  }
+
+  // Sorts entries [begin, end) by the prefix bytes from 'depth' on and then
+  // by the rows if the prefix is not exact. There are fewer than
+  // kMinRadixSortRows entries.
+  void comparisonSort(
+      int32_t begin,
+      int32_t end,
+      int32_t depth,
+      folly::Range<char**> rows) {
+    VELOX_DCHECK_LT(end - begin, PrefixSort::kMinRadixSortRows);
+    std::array<char*, PrefixSort::kMinRadixSortRows> entries;
+    for (auto i = begin; i < end; ++i) {
+      entries[i - begin] = entryAt(i);
+    }
+    const auto numBytes = prefixBytes_ - depth;
+    std::sort(
+        entries.begin(),
+        entries.begin() + (end - begin),
+        [&](char* left, char* right) {
+          if (auto result =
+                  std::memcmp(left + depth, right + depth, numBytes)) {
+            return result < 0;
+          }
+          return !exact_ &&
+              container_->compareRows(
+                  rowOf(left), rowOf(right), compareFlags_) < 0;
+        });
+    for (auto i = begin; i < end; ++i) {
+      rows[i] = rowOf(entries[i - begin]);
+    }
+  }
+
+  // Sorts entries [begin, end) with equal prefixes by the rows.
+  void tieSort(int32_t begin, int32_t end, folly::Range<char**> rows) {
+    for (auto i = begin; i < end; ++i) {
+      rows[i] = rowOf(entryAt(i));
+    }
+    if (!exact_) {
+      std::sort(
+          rows.begin() + begin,
+          rows.begin() + end,
+          [&](const char* left, const char* right) {
+            return container_->compareRows(left, right, compareFlags_) < 0;
+          });
+    }
+  }
+
+  RowContainer* const container_;
+  const std::vector<CompareFlags>& compareFlags_;
+  const int32_t prefixBytes_;
+  const int32_t entrySize_;
+  // True if equal prefixes imply equal keys.
+  const bool exact_;
+  // Prefix and row pointer of each row being sorted.
+  BufferPtr entries_;
+  char* rawEntries_{nullptr};
+  // Scratch for distributing entries in radixSort().
+  BufferPtr temp_;
+  char* rawTemp_{nullptr};
+};
+
+} // namespace
+
+// static
+std::pair<int32_t, int32_t> PrefixSort::prefixKeys(
+    const RowContainer& container) {
+  int32_t numKeys = 0;
+  int32_t numBytes = 0;
+  for (const auto& type : container.keyTypes()) {
+    const auto valueBytes = prefixValueBytes(type->kind());
+    if (valueBytes == 0 || numBytes + 1 + valueBytes > kMaxPrefixBytes) {
+      break;
+    }
+    ++numKeys;
+    numBytes += 1 + valueBytes;
+    // Keys after a string prefix only order strings with equal prefixes,
+    // which are compared in full anyway.
+    if (isStringKind(type->kind())) {
+      break;
+    }
+  }
+  return {numKeys, numBytes};
+}
+
+// static
+void PrefixSort::sort(
+    RowContainer* container,
+    const std::vector<CompareFlags>& compareFlags,
+    folly::Range<char**> rows) {
+  VELOX_DCHECK(
+      compareFlags.empty() ||
+      compareFlags.size() == container->keyTypes().size());
+  const auto [numKeys, prefixBytes] = prefixKeys(*container);
+  if (numKeys == 0 || rows.size() < kMinRadixSortRows) {
+    std::sort(
+        rows.begin(), rows.end(), [&](const char* left, const char* right) {
+          return container->compareRows(left, right, compareFlags) < 0;
+        });
+    return;
+  }
+  const auto& keyTypes = container->keyTypes();
+  const bool exact = numKeys == keyTypes.size() &&
+      !isStringKind(keyTypes[numKeys - 1]->kind());
+  PrefixSorter(container, compareFlags, prefixBytes, exact)
+      .sort(rows, numKeys);
+}
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/RowContainer.h"
+
+namespace facebook::velox::exec {
+
+/// Sorts pointers to rows of a RowContainer by the key columns of the
+/// container. The leading keys of fixed width integer, boolean, date and
+/// string types are encoded into a fixed width, byte comparable prefix per
+/// row. The prefixes are sorted with an MSD radix sort. Rows with equal
+/// prefixes are ordered with RowContainer::compareRows() if the prefix does
+/// not fully encode the keys, i.e. there are keys of other types, more keys
+/// than fit in the prefix or string keys.
+///
+/// The result is the same as std::sort with RowContainer::compareRows() as
+/// the comparator, up to the order of rows with equal keys.
+class PrefixSort {
+ public:
+  /// Max bytes of a string key encoded into the prefix.
+  static constexpr int32_t kMaxStringPrefixBytes = 12;
+
+  /// Max bytes of the prefix of a row. Keys that do not fit are not encoded.
+  static constexpr int32_t kMaxPrefixBytes = 64;
+
+  /// Radix sort is used for at least this many rows. Fewer rows are sorted
+  /// with std::sort.
+  static constexpr int32_t kMinRadixSortRows = 64;
+
+  /// Sorts 'rows' of 'container' by all the key columns of 'container'.
+  /// 'compareFlags' has one entry per key column or is empty for the default
+  /// flags, as in RowContainer::compareRows().
+  static void sort(
+      RowContainer* FOLLY_NONNULL container,
+      const std::vector<CompareFlags>& compareFlags,
+      folly::Range<char**> rows);
+
+  /// Returns the number of leading key columns of 'container' that can be
+  /// encoded into the prefix and the total prefix size in bytes. Public for
+  /// testing.
+  static std::pair<int32_t, int32_t> prefixKeys(
+      const RowContainer& container);
+};
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/RowNumber.h"
+#include "velox/exec/OperatorUtils.h"
+
+namespace facebook::velox::exec {
+
+RowNumber::RowNumber(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::RowNumberNode>& rowNumberNode)
+    : Operator(
+          driverCtx,
+          rowNumberNode->outputType(),
+          operatorId,
+          rowNumberNode->id(),
+          "RowNumber"),
+      limit_(rowNumberNode->limit()),
+      generateRowNumber_(rowNumberNode->generateRowNumber()) {
+  const auto& inputType = rowNumberNode->sources()[0]->outputType();
+  const auto& keys = rowNumberNode->partitionKeys();
+  if (!keys.empty()) {
+    std::vector<std::unique_ptr<VectorHasher>> hashers;
+    hashers.reserve(keys.size());
+    for (const auto& key : keys) {
+      const auto channel = exprToChannel(key.get(), inputType);
+      VELOX_CHECK_NE(
+          channel,
+          kConstantChannel,
+          "RowNumber doesn't allow constant partition keys");
+      hashers.push_back(VectorHasher::create(key->type(), channel));
+    }
+    static const std::vector<std::unique_ptr<Aggregate>> kNoAggregates;
+    table_ = std::make_unique<HashTable<false>>(
+        std::move(hashers),
+        kNoAggregates,
+        std::vector<TypePtr>{BIGINT()},
+        false, // allowDuplicates
+        false, // isJoinBuild
+        false, // hasProbedFlag
+        pool());
+    lookup_ = std::make_unique<HashLookup>(table_->hashers());
+    numRowsOffset_ = table_->rows()->columnAt(keys.size()).offset();
+  }
+
+  for (column_index_t i = 0; i < inputType->size(); ++i) {
+    identityProjections_.emplace_back(i, i);
+  }
+  if (generateRowNumber_) {
+    resultProjections_.emplace_back(0, inputType->size());
+    results_.resize(1);
+  }
+}
+
+void RowNumber::addInput(RowVectorPtr input) {
+  const auto numInput = input->size();
+  VELOX_CHECK_NE(numInput, 0, "RowNumber::addInput received empty set of rows");
+  if (table_ != nullptr) {
+    groupProbe(input, *table_, *lookup_, activeRows_);
+    for (auto row : lookup_->newGroups) {
+      numRows(lookup_->hits[row]) = 0;
+    }
+  }
+  input_ = std::move(input);
+}
+
+RowVectorPtr RowNumber::getOutput() {
+  if (input_ == nullptr) {
+    return nullptr;
+  }
+
+  const auto numInput = input_->size();
+  int64_t* rawRowNumbers = nullptr;
+  if (generateRowNumber_) {
+    VectorPtr& result = results_[0];
+    if (result && result.unique()) {
+      BaseVector::prepareForReuse(result, numInput);
+    } else {
+      result = BaseVector::create(BIGINT(), numInput, pool());
+    }
+    rawRowNumbers =
+        result->asUnchecked<FlatVector<int64_t>>()->mutableRawValues();
+  }
+
+  BufferPtr mapping;
+  vector_size_t* rawMapping = nullptr;
+  if (limit_.has_value()) {
+    mapping = allocateIndices(numInput, pool());
+    rawMapping = mapping->asMutable<vector_size_t>();
+  }
+  vector_size_t numOutput = 0;
+  for (auto i = 0; i < numInput; ++i) {
+    const auto rowNumber = table_ != nullptr ? ++numRows(lookup_->hits[i])
+                                             : ++numTotalRows_;
+    if (rawRowNumbers != nullptr) {
+      rawRowNumbers[i] = rowNumber;
+    }
+    if (rawMapping != nullptr && rowNumber <= limit_.value()) {
+      rawMapping[numOutput++] = i;
+    }
+  }
+  if (!limit_.has_value()) {
+    numOutput = numInput;
+  }
+
+  if (numOutput == 0) {
+    input_ = nullptr;
+    return nullptr;
+  }
+  auto output = fillOutput(numOutput, mapping);
+  input_ = nullptr;
+  return output;
+}
+
+} // namespace facebook::velox::exec
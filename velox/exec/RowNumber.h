@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/HashTable.h"
+#include "velox/exec/Operator.h"
+
+namespace facebook::velox::exec {
+
+/// Numbers the input rows of each partition in the order of arrival. Keeps a
+/// counter per partition in a hash table on the partition keys and passes
+/// the input through, dropping the rows past the limit if there is one.
+class RowNumber : public Operator {
+ public:
+  RowNumber(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      const std::shared_ptr<const core::RowNumberNode>& rowNumberNode);
+
+  bool isFilter() const override {
+    return true;
+  }
+
+  bool preservesOrder() const override {
+    return true;
+  }
+
+  bool needsInput() const override {
+    return !noMoreInput_ && input_ == nullptr && !limitReached();
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  RowVectorPtr getOutput() override;
+
+  BlockingReason isBlocked(ContinueFuture* /*future*/) override {
+    return BlockingReason::kNotBlocked;
+  }
+
+  bool isFinished() override {
+    return (noMoreInput_ || limitReached()) && input_ == nullptr;
+  }
+
+ private:
+  // Returns the number of rows seen so far in 'partition'.
+  int64_t& numRows(char* partition) const {
+    return *reinterpret_cast<int64_t*>(partition + numRowsOffset_);
+  }
+
+  // True if there are no partition keys and the limit has been reached. No
+  // more rows can be produced.
+  bool limitReached() const {
+    return table_ == nullptr && limit_.has_value() &&
+        numTotalRows_ >= limit_.value();
+  }
+
+  const std::optional<int32_t> limit_;
+  const bool generateRowNumber_;
+
+  // Partitions with the number of rows seen in each. nullptr if there are no
+  // partition keys.
+  std::unique_ptr<BaseHashTable> table_;
+  std::unique_ptr<HashLookup> lookup_;
+  // Offset of the row count in the rows of 'table_'.
+  int32_t numRowsOffset_{0};
+
+  // The number of rows seen if there are no partition keys.
+  int64_t numTotalRows_{0};
+
+  SelectivityVector activeRows_;
+};
+
+} // namespace facebook::velox::exec
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/Spiller.h"
+
+namespace facebook::velox::exec {
+
+/// Spills the input of an operator that sorts all its input in a
+/// RowContainer, i.e. OrderBy and Window. Decides how many rows to spill so
+/// that the next input fits in memory and owns the Spiller that writes the
+/// rows as sorted runs. The Spiller is created on the first spill.
+class SortInputSpiller {
+ public:
+  /// 'data' holds the input with the sort keys as its keys. 'spillType' is
+  /// the row type of 'data' and 'compareFlags' are the compare flags of its
+  /// keys. 'spillMemoryThreshold' is the memory usage of 'pool' above which
+  /// input is spilled. If it is zero, there is no such limit.
+  SortInputSpiller(
+      Spiller::Type type,
+      RowContainer* data,
+      RowTypePtr spillType,
+      std::vector<CompareFlags> compareFlags,
+      const Spiller::Config& spillConfig,
+      uint64_t spillMemoryThreshold,
+      memory::MemoryPool* pool);
+
+  /// Checks if 'input' fits in the reservation of the memory pool. Tries to
+  /// increase the reservation if not. If the reservation cannot be
+  /// increased, spills enough to make 'input' fit.
+  void ensureInputFits(const RowVectorPtr& input);
+
+  /// Spills content until under 'targetRows' and under 'targetBytes' of out
+  /// of line data are left. If 'targetRows' is 0, spills everything and
+  /// physically frees the data in the RowContainer.
+  void spill(int64_t targetRows, int64_t targetBytes);
+
+  /// Returns the Spiller, nullptr if nothing has been spilled.
+  Spiller* spiller() const {
+    return spiller_.get();
+  }
+
+ private:
+  const Spiller::Type type_;
+  RowContainer* const data_;
+  const RowTypePtr spillType_;
+  const std::vector<CompareFlags> compareFlags_;
+  const Spiller::Config spillConfig_;
+  const uint64_t spillMemoryThreshold_;
+  memory::MemoryPool* const pool_;
+
+  std::unique_ptr<Spiller> spiller_;
+
+  // Counts input batches and triggers spilling if folly hash of this % 100 <=
+  // 'testSpillPct'.
+  uint64_t spillTestCounter_{0};
+};
+
+} // namespace facebook::velox::exec
@@ -15,28 +15,174 @@
  */
 
 #include "velox/exec/Spill.h"
+#include <folly/lang/Bits.h>
+#include <cstring>
 #include "velox/common/file/FileSystems.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/serializers/PrestoSerializer.h"
 
 namespace facebook::velox::exec {
 
+namespace {
 // Spilling currently uses the default PrestoSerializer which by default
 // serializes timestamp with millisecond precision to maintain compatibility
 // with presto. Since velox's native timestamp implementation supports
 // nanosecond precision, we use this serde option to ensure the serializer
 // preserves precision.
-static const serializer::presto::PrestoVectorSerde::PrestoOptions
-    kDefaultSerdeOptions(/*useLosslessTimestamp*/ true);
+serializer::presto::PrestoVectorSerde::PrestoOptions serdeOptions(
+    folly::io::CodecType compressionKind) {
+  return serializer::presto::PrestoVectorSerde::PrestoOptions(
+      /*useLosslessTimestamp*/ true, compressionKind);
+}
+
+// The header of a serialized Presto page: number of rows, codec marker,
+// uncompressed size, size in bytes and checksum.
+constexpr int32_t kPageSizeInBytesOffset = 4 + 1 + 4;
+constexpr int32_t kPageHeaderSize = kPageSizeInBytesOffset + 4 + 8;
+} // namespace
+
+folly::io::CodecType stringToSpillCompressionKind(const std::string& name) {
+  static const std::unordered_map<std::string, folly::io::CodecType> kCodecs{
+      {"none", folly::io::CodecType::NO_COMPRESSION},
+      {"zlib", folly::io::CodecType::ZLIB},
+      {"snappy", folly::io::CodecType::SNAPPY},
+      {"lz4", folly::io::CodecType::LZ4},
+      {"zstd", folly::io::CodecType::ZSTD},
+  };
+  auto it = kCodecs.find(name);
+  VELOX_USER_CHECK(
+      it != kCodecs.end(), "Unsupported spill compression codec: {}", name);
+  VELOX_USER_CHECK(
+      it->second == folly::io::CodecType::NO_COMPRESSION ||
+          folly::io::hasCodec(it->second),
+      "Spill compression codec is not available: {}",
+      name);
+  return it->second;
+}
 
 std::atomic<int32_t> SpillFile::ordinalCounter_;
 
+SpillInput::SpillInput(
+    std::unique_ptr<ReadFile>&& input,
+    BufferPtr buffer,
+    folly::Executor* executor)
+    : input_(std::move(input)),
+      buffer_(std::move(buffer)),
+      bufferSize_(buffer_->size()),
+      size_(input_->size()),
+      executor_(executor) {
+  if (executor_ != nullptr && buffer_->capacity() < size_) {
+    readAheadBuffer_ =
+        AlignedBuffer::allocate<char>(bufferSize_, buffer_->pool());
+  }
+  next(true);
+}
+
+SpillInput::~SpillInput() {
+  if (readAhead_ == nullptr) {
+    return;
+  }
+  // The read ahead writes into 'readAheadBuffer_' from 'input_'.
+  try {
+    readAhead_->move();
+  } catch (const std::exception& e) {
+    LOG(WARNING) << "Error in spill file read ahead: " << e.what();
+  }
+}
+
 void SpillInput::next(bool /*throwIfPastEnd*/) {
-  int32_t readBytes = std::min(input_->size() - offset_, buffer_->capacity());
-  VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
-  setRange({buffer_->asMutable<uint8_t>(), readBytes, 0});
-  input_->pread(offset_, readBytes, buffer_->asMutable<char>());
+  if (readAhead_ != nullptr) {
+    const int32_t readBytes = waitForReadAhead();
+    std::swap(buffer_, readAheadBuffer_);
+    setRange({buffer_->asMutable<uint8_t>(), readBytes, 0});
+    offset_ += readBytes;
+    releaseGrownBuffer(readAheadBuffer_);
+  } else {
+    releaseGrownBuffer(buffer_);
+    int32_t readBytes =
+        std::min(input_->size() - offset_, buffer_->capacity());
+    VELOX_CHECK_LT(0, readBytes, "Reading past end of spill file");
+    setRange({buffer_->asMutable<uint8_t>(), readBytes, 0});
+    input_->pread(offset_, readBytes, buffer_->asMutable<char>());
+    offset_ += readBytes;
+  }
+  startReadAhead();
+}
+
+void SpillInput::releaseGrownBuffer(BufferPtr& buffer) {
+  if (buffer->size() > bufferSize_) {
+    buffer = AlignedBuffer::allocate<char>(bufferSize_, buffer->pool());
+  }
+}
+
+void SpillInput::startReadAhead() {
+  VELOX_CHECK_NULL(readAhead_);
+  if (readAheadBuffer_ == nullptr || offset_ >= size_) {
+    return;
+  }
+  const uint64_t readBytes =
+      std::min(size_ - offset_, readAheadBuffer_->capacity());
+  readAhead_ = std::make_shared<AsyncSource<uint64_t>>(
+      [input = input_.get(),
+       buffer = readAheadBuffer_,
+       offset = offset_,
+       readBytes]() {
+        input->pread(offset, readBytes, buffer->asMutable<char>());
+        return std::make_unique<uint64_t>(readBytes);
+      });
+  executor_->add([source = readAhead_]() { source->prepare(); });
+}
+
+uint64_t SpillInput::waitForReadAhead() {
+  auto readAhead = std::move(readAhead_);
+  auto readBytes = readAhead->move();
+  VELOX_CHECK_NOT_NULL(readBytes);
+  return *readBytes;
+}
+
+void SpillInput::ensureContiguous(int32_t size) {
+  const auto& range = ranges()[0];
+  const int32_t numUnread = range.size - range.position;
+  if (numUnread >= size) {
+    return;
+  }
+  VELOX_CHECK_LE(
+      size - numUnread, size_ - offset_, "Reading past end of spill file");
+  const auto* unread = range.buffer + range.position;
+  if (buffer_->capacity() < size) {
+    auto buffer = AlignedBuffer::allocate<char>(size, buffer_->pool());
+    std::memcpy(buffer->asMutable<char>(), unread, numUnread);
+    buffer_ = std::move(buffer);
+  } else {
+    std::memmove(buffer_->asMutable<char>(), unread, numUnread);
+  }
+  int32_t numBytes = numUnread;
+  if (readAhead_ != nullptr) {
+    // Continue with the bytes read ahead. The bytes that do not fit are read
+    // again by the next read.
+    const auto readAheadBytes = std::min<uint64_t>(
+        waitForReadAhead(), buffer_->capacity() - numBytes);
+    std::memcpy(
+        buffer_->asMutable<char>() + numBytes,
+        readAheadBuffer_->as<char>(),
+        readAheadBytes);
+    numBytes += readAheadBytes;
+    offset_ += readAheadBytes;
+  }
+  const int32_t readBytes =
+      std::min<uint64_t>(size_ - offset_, buffer_->capacity() - numBytes);
+  input_->pread(offset_, readBytes, buffer_->asMutable<char>() + numBytes);
   offset_ += readBytes;
+  setRange({buffer_->asMutable<uint8_t>(), numBytes + readBytes, 0});
+  startReadAhead();
+}
+
+void SpillInput::preparePage() {
+  ensureContiguous(kPageHeaderSize);
+  const auto& range = ranges()[0];
+  const auto sizeInBytes = folly::loadUnaligned<int32_t>(
+      range.buffer + range.position + kPageSizeInBytesOffset);
+  ensureContiguous(kPageHeaderSize + sizeInBytes);
 }
 
 void SpillMergeStream::pop() {
@@ -53,24 +199,24 @@ WriteFile& SpillFile::output() {
   return *output_;
 }
 
-void SpillFile::startRead() {
-  constexpr uint64_t kMaxReadBufferSize =
-      (1 << 20) - AlignedBuffer::kPaddedSize; // 1MB - padding.
+void SpillFile::startRead(uint64_t readBufferSize, folly::Executor* executor) {
   VELOX_CHECK(!output_);
   VELOX_CHECK(!input_);
   auto fs = filesystems::getFileSystem(path_, nullptr);
   auto file = fs->openFileForRead(path_);
   auto buffer = AlignedBuffer::allocate<char>(
-      std::min<uint64_t>(fileSize_, kMaxReadBufferSize), &pool_);
-  input_ = std::make_unique<SpillInput>(std::move(file), std::move(buffer));
+      std::min<uint64_t>(fileSize_, readBufferSize), &pool_);
+  input_ = std::make_unique<SpillInput>(
+      std::move(file), std::move(buffer), executor);
 }
 
 bool SpillFile::nextBatch(RowVectorPtr& rowVector) {
   if (input_->atEnd()) {
     return false;
   }
-  VectorStreamGroup::read(
-      input_.get(), &pool_, type_, &rowVector, &kDefaultSerdeOptions);
+  input_->preparePage();
+  const auto options = serdeOptions(compressionKind_);
+  VectorStreamGroup::read(input_.get(), &pool_, type_, &rowVector, &options);
   return true;
 }
 
@@ -85,15 +231,18 @@ WriteFile& SpillFileList::currentOutput() {
         numSortingKeys_,
         sortCompareFlags_,
         fmt::format("{}-{}", path_, files_.size()),
-        pool_));
+        pool_,
+        compressionKind_));
   }
   return files_.back()->output();
 }
 
 void SpillFileList::flush() {
   if (batch_) {
+    // The listener makes the serializer checksum the pages.
+    serializer::presto::PrestoOutputStreamListener listener;
     IOBufOutputStream out(
-        pool_, nullptr, std::max<int64_t>(64 * 1024, batch_->size()));
+        pool_, &listener, std::max<int64_t>(64 * 1024, batch_->size()));
     batch_->flush(&out);
     batch_.reset();
     auto iobuf = out.getIOBuf();
@@ -109,11 +258,10 @@ void SpillFileList::write(
     const RowVectorPtr& rows,
     const folly::Range<IndexRange*>& indices) {
   if (!batch_) {
+    const auto options = serdeOptions(compressionKind_);
     batch_ = std::make_unique<VectorStreamGroup>(&pool_);
     batch_->createStreamTree(
-        std::static_pointer_cast<const RowType>(rows->type()),
-        1000,
-        &kDefaultSerdeOptions);
+        std::static_pointer_cast<const RowType>(rows->type()), 1000, &options);
   }
   batch_->append(rows, indices);
 
@@ -173,7 +321,8 @@ void SpillState::appendToPartition(
         sortCompareFlags_,
         fmt::format("{}-spill-{}", path_, partition),
         targetFileSize_,
-        pool_);
+        pool_,
+        compressionKind_);
   }
 
   IndexRange range{0, rows->size()};
@@ -182,12 +331,29 @@ void SpillState::appendToPartition(
 
 std::unique_ptr<TreeOfLosers<SpillMergeStream>> SpillState::startMerge(
     int32_t partition,
-    std::unique_ptr<SpillMergeStream>&& extra) {
+    std::unique_ptr<SpillMergeStream>&& extra,
+    folly::Executor* executor) {
   VELOX_CHECK_LT(partition, files_.size());
   std::vector<std::unique_ptr<SpillMergeStream>> result;
   if (auto list = std::move(files_[partition]); list) {
-    for (auto& file : list->files()) {
-      result.push_back(FileSpillMergeStream::create(std::move(file)));
+    auto files = list->files();
+    // Splits the memory budget between the files. Reading ahead needs two
+    // buffers per file, so it is turned off if the buffers would get too small.
+    uint64_t readBufferSize = SpillFile::kMaxReadBufferSize;
+    if (!files.empty()) {
+      if (executor != nullptr &&
+          kMaxMergeReadBufferBytes / (2 * files.size()) < kMinReadBufferSize) {
+        executor = nullptr;
+      }
+      const auto numBuffers = files.size() * (executor != nullptr ? 2 : 1);
+      readBufferSize = std::clamp<uint64_t>(
+          kMaxMergeReadBufferBytes / numBuffers,
+          kMinReadBufferSize,
+          SpillFile::kMaxReadBufferSize);
+    }
+    for (auto& file : files) {
+      result.push_back(FileSpillMergeStream::create(
+          std::move(file), readBufferSize, executor));
     }
   }
   VELOX_DCHECK_EQ(!result.empty(), isPartitionSpilled(partition));
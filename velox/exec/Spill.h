@@ -16,8 +16,10 @@
 
 #pragma once
 
+#include <folly/compression/Compression.h>
 #include <folly/container/F14Set.h>
 
+#include "velox/common/base/AsyncSource.h"
 #include "velox/common/file/File.h"
 #include "velox/exec/TreeOfLosers.h"
 #include "velox/exec/UnorderedStreamReader.h"
@@ -27,28 +29,70 @@
 
 namespace facebook::velox::exec {
 
+/// Returns the codec for the 'spill_compression_kind' query config value
+/// 'name'. Throws if 'name' is not a known codec or the codec is not
+/// available in this build.
+folly::io::CodecType stringToSpillCompressionKind(const std::string& name);
+
 // Input stream backed by spill file.
 class SpillInput : public ByteStream {
  public:
-  // Reads from 'input' using 'buffer' for buffering reads.
-  SpillInput(std::unique_ptr<ReadFile>&& input, BufferPtr buffer)
-      : input_(std::move(input)),
-        buffer_(std::move(buffer)),
-        size_(input_->size()) {
-    next(true);
-  }
+  // Reads from 'input' using 'buffer' for buffering reads. If 'executor' is
+  // set, the read of the next buffer full of data is started on 'executor'
+  // when the current buffer is being consumed. The read ahead buffer has the
+  // same size as 'buffer'.
+  SpillInput(
+      std::unique_ptr<ReadFile>&& input,
+      BufferPtr buffer,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr);
+
+  // Waits for the pending read ahead, if any, so that it does not outlive
+  // 'this'.
+  ~SpillInput() override;
 
   void next(bool throwIfPastEnd) override;
 
+  // Makes the next serialized page readable from a single buffer. The
+  // deserializer rereads a page after verifying its checksum, which requires
+  // the page not to span reads from the file.
+  void preparePage();
+
   // True if all of the file has been read into vectors.
   bool atEnd() const {
     return offset_ >= size_ && ranges()[0].position >= ranges()[0].size;
   }
 
  private:
+  // Makes the next 'size' bytes of the file readable from 'buffer_'. Moves
+  // the unread bytes to the start of 'buffer_' and reads after them if
+  // needed. Grows 'buffer_' if it is smaller than 'size'.
+  void ensureContiguous(int32_t size);
+
+  // Replaces 'buffer' with a new buffer of 'bufferSize_' bytes if
+  // ensureContiguous() grew it for a large page. This keeps the read and
+  // read ahead buffers within the read budget once the page is consumed.
+  // The contents of 'buffer' must not be needed.
+  void releaseGrownBuffer(BufferPtr& buffer);
+
+  // Starts reading the bytes from 'offset_' into 'readAheadBuffer_' on
+  // 'executor_' if there are bytes left.
+  void startReadAhead();
+
+  // Waits for the read started by startReadAhead() and returns the number of
+  // bytes read into 'readAheadBuffer_'.
+  uint64_t waitForReadAhead();
+
   std::unique_ptr<ReadFile> input_;
   BufferPtr buffer_;
+  // Size of the read buffers given by the read budget.
+  const uint64_t bufferSize_;
   const uint64_t size_;
+  folly::Executor* FOLLY_NULLABLE const executor_;
+  // Receives the read ahead. Allocated only if 'executor_' is set.
+  BufferPtr readAheadBuffer_;
+  // The read in progress into 'readAheadBuffer_'. The read starts at
+  // 'offset_'.
+  std::shared_ptr<AsyncSource<uint64_t>> readAhead_;
   // Offset of first byte not in 'buffer_'
   uint64_t offset_ = 0;
 };
@@ -63,15 +107,22 @@ class SpillInput : public ByteStream {
 /// rmdir() call.
 class SpillFile {
  public:
+  /// The max size of the read buffer of a file.
+  static constexpr uint64_t kMaxReadBufferSize =
+      (1 << 20) - AlignedBuffer::kPaddedSize; // 1MB - padding.
+
   SpillFile(
       RowTypePtr type,
       int32_t numSortingKeys,
       const std::vector<CompareFlags>& sortCompareFlags,
       const std::string& path,
-      memory::MemoryPool& pool)
+      memory::MemoryPool& pool,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION)
       : type_(std::move(type)),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
+        compressionKind_(compressionKind),
         pool_(pool),
         ordinal_(ordinalCounter_++),
         path_(fmt::format("{}-{}", path, ordinal_)) {
@@ -110,7 +161,12 @@ class SpillFile {
 
   /// Prepares 'this' for reading. Positions the read at the first row of
   /// content. The caller must call output() and finishWrite() before this.
-  void startRead();
+  /// Reads are buffered in 'readBufferSize' bytes, or less if the file is
+  /// smaller. If 'executor' is set, the next buffer is read ahead on
+  /// 'executor', which doubles the memory for buffering.
+  void startRead(
+      uint64_t readBufferSize = kMaxReadBufferSize,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr);
 
   bool nextBatch(RowVectorPtr& rowVector);
 
@@ -139,6 +195,8 @@ class SpillFile {
   const RowTypePtr type_;
   const int32_t numSortingKeys_;
   const std::vector<CompareFlags> sortCompareFlags_;
+  // The codec of the pages in the file.
+  const folly::io::CodecType compressionKind_;
   memory::MemoryPool& pool_;
 
   // Ordinal number used for making a label for debugging.
@@ -162,7 +220,9 @@ class SpillFileList {
   /// content. 'numSortingKeys' is the number of leading columns on which the
   /// data is sorted. 'path' is a file path prefix. ' 'targetFileSize' is the
   /// target byte size of a single file in the file set. 'pool' is used for
-  /// buffering and constructing the result data read from 'this'.
+  /// buffering and constructing the result data read from 'this'. The pages
+  /// written to the files are compressed with 'compressionKind' and are
+  /// checksummed.
   ///
   /// When writing sorted spill runs, the caller is responsible for buffering
   /// and sorting the data. write is called multiple times, followed by flush().
@@ -172,12 +232,15 @@ class SpillFileList {
       const std::vector<CompareFlags>& sortCompareFlags,
       const std::string& path,
       uint64_t targetFileSize,
-      memory::MemoryPool& pool)
+      memory::MemoryPool& pool,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION)
       : type_(type),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
         path_(path),
         targetFileSize_(targetFileSize),
+        compressionKind_(compressionKind),
         pool_(pool) {
     // NOTE: if the associated spilling operator has specified the sort
     // comparison flags, then it must match the number of sorting keys.
@@ -229,6 +292,7 @@ class SpillFileList {
   const std::vector<CompareFlags> sortCompareFlags_;
   const std::string path_;
   const uint64_t targetFileSize_;
+  const folly::io::CodecType compressionKind_;
   memory::MemoryPool& pool_;
   std::unique_ptr<VectorStreamGroup> batch_;
   SpillFiles files_;
@@ -363,8 +427,10 @@ class SpillMergeStream : public MergeStream {
 class FileSpillMergeStream : public SpillMergeStream {
  public:
   static std::unique_ptr<SpillMergeStream> create(
-      std::unique_ptr<SpillFile> spillFile) {
-    spillFile->startRead();
+      std::unique_ptr<SpillFile> spillFile,
+      uint64_t readBufferSize = SpillFile::kMaxReadBufferSize,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr) {
+    spillFile->startRead(readBufferSize, executor);
     auto* spillStream = new FileSpillMergeStream(std::move(spillFile));
     spillStream->nextBatch();
     return std::unique_ptr<SpillMergeStream>(spillStream);
@@ -543,25 +609,34 @@ using SpillPartitionSet =
 /// by. This has one SpillFileList per partition of spill data.
 class SpillState {
  public:
+  /// The max total size of the read buffers of the files of a merge.
+  static constexpr uint64_t kMaxMergeReadBufferBytes = 64 << 20;
+
+  /// The min size of the read buffer of a file in a merge.
+  static constexpr uint64_t kMinReadBufferSize = 64 << 10;
+
   /// Constructs a SpillState. 'type' is the content RowType. 'path' is the file
   /// system path prefix. 'bits' is the hash bit field for partitioning data
   /// between files. This also gives the maximum number of partitions.
   /// 'numSortingKeys' is the number of leading columns on which the data is
   /// sorted, 0 if only hash partitioning is used. 'targetFileSize' is the
   /// target size of a single file.  'pool' owns the memory for state and
-  /// results.
+  /// results. 'compressionKind' is the codec of the spilled pages.
   SpillState(
       const std::string& path,
       int32_t maxPartitions,
       int32_t numSortingKeys,
       const std::vector<CompareFlags>& sortCompareFlags,
       uint64_t targetFileSize,
-      memory::MemoryPool& pool)
+      memory::MemoryPool& pool,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION)
       : path_(path),
         maxPartitions_(maxPartitions),
         numSortingKeys_(numSortingKeys),
         sortCompareFlags_(sortCompareFlags),
         targetFileSize_(targetFileSize),
+        compressionKind_(compressionKind),
         pool_(pool),
         files_(maxPartitions_) {}
 
@@ -617,10 +692,14 @@ class SpillState {
 
   // Starts reading values for 'partition'. If 'extra' is non-null, it can be
   // a stream of rows from a RowContainer so as to merge unspilled data with
-  // spilled data.
+  // spilled data. If 'executor' is set, each file reads its next buffer ahead
+  // on 'executor' while the merge consumes the current one. The read buffers
+  // of all the files together stay within kMaxMergeReadBufferBytes unless
+  // there are so many files that each gets kMinReadBufferSize bytes.
   std::unique_ptr<TreeOfLosers<SpillMergeStream>> startMerge(
       int32_t partition,
-      std::unique_ptr<SpillMergeStream>&& extra);
+      std::unique_ptr<SpillMergeStream>&& extra,
+      folly::Executor* FOLLY_NULLABLE executor = nullptr);
 
   bool hasFiles(int32_t partition) const {
     return partition < files_.size() && files_[partition];
@@ -646,6 +725,7 @@ class SpillState {
   const int32_t numSortingKeys_;
   const std::vector<CompareFlags> sortCompareFlags_;
   const uint64_t targetFileSize_;
+  const folly::io::CodecType compressionKind_;
 
   memory::MemoryPool& pool_;
 
@@ -98,6 +98,12 @@ class SpillOperatorGroup {
     return needSpill_;
   }
 
+  /// Returns the operators of the group. Used to spill the group without a
+  /// spill request while the Drivers of all the operators are off thread.
+  const std::vector<Operator*>& operators() const {
+    return operators_;
+  }
+
   /// Invoked to request a new spill operation on the group. The function
   /// returns true if it needs to wait for spill to run, otherwise the spill has
   /// been inline executed and returns false.
@@ -33,8 +33,10 @@ class Spiller {
     kHashJoinProbe = 2,
     // Used for order by.
     kOrderBy = 3,
+    // Used for window.
+    kWindow = 4,
   };
-  static constexpr int kNumTypes = 4;
+  static constexpr int kNumTypes = 5;
   static std::string typeName(Type);
 
   // Specifies the config for spilling.
@@ -47,7 +49,9 @@ class Spiller {
         int32_t _spillableReservationGrowthPct,
         const HashBitRange& _hashBitRange,
         int32_t _maxSpillLevel,
-        int32_t _testSpillPct)
+        int32_t _testSpillPct,
+        folly::io::CodecType _compressionKind =
+            folly::io::CodecType::NO_COMPRESSION)
         : filePath(_filePath),
           maxFileSize(
               _maxFileSize == 0 ? std::numeric_limits<int64_t>::max()
@@ -57,7 +61,8 @@ class Spiller {
           spillableReservationGrowthPct(_spillableReservationGrowthPct),
           hashBitRange(_hashBitRange),
           maxSpillLevel(_maxSpillLevel),
-          testSpillPct(_testSpillPct) {}
+          testSpillPct(_testSpillPct),
+          compressionKind(_compressionKind) {}
 
     /// Returns the spilling level with given 'startBitOffset'.
     ///
@@ -104,12 +109,16 @@ class Spiller {
     // Percentage of input batches to be spilled for testing. 0 means no
     // spilling for test.
     int32_t testSpillPct;
+
+    // The codec used to compress spilled pages.
+    folly::io::CodecType compressionKind;
   };
 
   using SpillRows = std::vector<char*, memory::StlAllocator<char*>>;
 
   // The constructor without specifying hash bits which will only use one
-  // partition by default. It is only used by kOrderBy spiller type as for now.
+  // partition by default. It is only used by kOrderBy and kWindow spiller
+  // types as for now.
   Spiller(
       Type type,
       RowContainer* FOLLY_NONNULL container,
@@ -121,7 +130,9 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION);
 
   Spiller(
       Type type,
@@ -131,7 +142,9 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION);
 
   Spiller(
       Type type,
@@ -145,7 +158,9 @@ class Spiller {
       uint64_t targetFileSize,
       uint64_t minSpillRunSize,
       memory::MemoryPool& pool,
-      folly::Executor* FOLLY_NULLABLE executor);
+      folly::Executor* FOLLY_NULLABLE executor,
+      folly::io::CodecType compressionKind =
+          folly::io::CodecType::NO_COMPRESSION);
 
   /// Spills rows from 'this' until there are under 'targetRows' rows
   /// and 'targetBytes' of allocated variable length space in use. spill()
@@ -201,7 +216,8 @@ class Spiller {
     if (FOLLY_UNLIKELY(!needSort())) {
       VELOX_FAIL("Can't sort merge the unsorted spill data: {}", toString());
     }
-    return state_.startMerge(partition, spillMergeStreamOverRows(partition));
+    return state_.startMerge(
+        partition, spillMergeStreamOverRows(partition), executor_);
   }
 
   // Extracts up to 'maxRows' or 'maxBytes' from 'rows' into
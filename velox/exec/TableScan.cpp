@@ -52,7 +52,8 @@ RowVectorPtr TableScan::getOutput() {
           split,
           blockingFuture_,
           maxPreloadedSplits_,
-          splitPreloader_);
+          splitPreloader_,
+          driverCtx_->driver);
       if (blockingReason_ != BlockingReason::kNotBlocked) {
         return nullptr;
       }
@@ -26,6 +26,7 @@
 #include "velox/exec/Exchange.h"
 #include "velox/exec/HashBuild.h"
 #include "velox/exec/LocalPlanner.h"
+#include "velox/exec/MemoryArbitrator.h"
 #include "velox/exec/Merge.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/Task.h"
@@ -61,6 +62,34 @@ std::string errorMessageImpl(const std::exception_ptr& exception) {
   return message;
 }
 
+// Returns the id of the table scan at the start of the pipeline of 'factory'
+// if Drivers can be added to and retired from the pipeline while it runs. The
+// Drivers of the pipeline must not depend on the number of their peers, so
+// there are no joins, which synchronize the Drivers of the probe side, and the
+// pipeline produces into a partitioned output or a local exchange, which can
+// take more producers. Consumers of the Task output may count the producers
+// up front.
+std::optional<core::PlanNodeId> elasticScanNodeId(
+    const DriverFactory& factory) {
+  if (!std::dynamic_pointer_cast<const core::TableScanNode>(
+          factory.planNodes.front())) {
+    return std::nullopt;
+  }
+  if (!factory.needsPartitionedOutput() &&
+      !std::dynamic_pointer_cast<const core::LocalPartitionNode>(
+          factory.consumerNode)) {
+    return std::nullopt;
+  }
+  for (const auto& planNode : factory.planNodes) {
+    if (std::dynamic_pointer_cast<const core::HashJoinNode>(planNode) ||
+        std::dynamic_pointer_cast<const core::CrossJoinNode>(planNode) ||
+        std::dynamic_pointer_cast<const core::MergeJoinNode>(planNode)) {
+      return std::nullopt;
+    }
+  }
+  return factory.planNodes.front()->id();
+}
+
 } // namespace
 
 std::atomic<uint64_t> Task::numCreatedTasks_ = 0;
@@ -195,6 +224,10 @@ Task::~Task() {
   }
 
   removeSpillDirectoryIfExists();
+
+  if (memoryArbitrator_ != nullptr) {
+    memoryArbitrator_->removeTask(*this);
+  }
 }
 
 void Task::removeSpillDirectoryIfExists() {
@@ -381,6 +414,13 @@ void Task::start(
       1,
       "concurrentSplitGroups parameter must be greater then or equal to 1");
 
+  // Register before the Drivers allocate memory. The arbitrator takes the
+  // Task mutex when reclaiming memory.
+  if (auto arbitrator = MemoryArbitrator::getInstance()) {
+    arbitrator->addTask(self);
+    self->memoryArbitrator_ = std::move(arbitrator);
+  }
+
   uint32_t numPipelines;
   uint32_t numSplitGroups;
   {
@@ -429,6 +469,7 @@ void Task::start(
       self->taskStats_.pipelineStats.emplace_back(
           factory->inputDriver, factory->outputDriver);
     }
+    self->initElasticPipelinesLocked();
   }
 
   // Register self for possible memory recovery callback. Do this
@@ -636,6 +677,15 @@ void Task::removeDriver(std::shared_ptr<Task> self, Driver* driver) {
         ++splitGroupState.numFinishedOutputDrivers;
       }
 
+      auto elasticIt = self->elasticPipelines_.find(pipelineId);
+      if (elasticIt != self->elasticPipelines_.end()) {
+        auto& elasticState = elasticIt->second;
+        elasticState.driverSamples.erase(driver);
+        if (elasticState.retiredDrivers.erase(driver) == 0) {
+          --elasticState.numRunningDrivers;
+        }
+      }
+
       // Release the driver, note that after this 'driver' is invalid.
       driverPtr = nullptr;
       self->driverClosedLocked();
@@ -964,14 +1014,172 @@ BlockingReason Task::getSplitOrFuture(
     exec::Split& split,
     ContinueFuture& future,
     int32_t maxPreloadSplits,
-    std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload) {
+    std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload,
+    Driver* driver) {
   std::lock_guard<std::mutex> l(mutex_);
-  return getSplitOrFutureLocked(
-      splitsStates_[planNodeId].groupSplitsStores[splitGroupId],
-      split,
-      future,
-      maxPreloadSplits,
-      preload);
+  auto& splitsStore = splitsStates_[planNodeId].groupSplitsStores[splitGroupId];
+  if (driver == nullptr || elasticPipelines_.empty()) {
+    return getSplitOrFutureLocked(
+        splitsStore, split, future, maxPreloadSplits, preload);
+  }
+  auto reason = BlockingReason::kNotBlocked;
+  // A retired 'driver' finishes as if there were no more splits.
+  if (!adjustElasticPipelineLocked(driver, splitsStore)) {
+    reason = getSplitOrFutureLocked(
+        splitsStore, split, future, maxPreloadSplits, preload);
+  }
+  if (splitsStore.noMoreSplits && splitsStore.splits.empty()) {
+    stopAddingElasticDriversLocked(planNodeId);
+  }
+  return reason;
+}
+
+void Task::initElasticPipelinesLocked() {
+  const auto& config = queryCtx()->queryConfig();
+  const auto maxElasticDrivers = config.maxElasticDriversPerPipeline();
+  if (maxElasticDrivers == 0 || isGroupedExecution()) {
+    return;
+  }
+  // Drivers on an inline executor run while start() iterates over 'drivers_'
+  // outside of 'mutex_', so that no Drivers can be added.
+  if (dynamic_cast<const folly::InlineLikeExecutor*>(queryCtx()->executor())) {
+    return;
+  }
+  for (auto pipelineId = 0; pipelineId < driverFactories_.size();
+       ++pipelineId) {
+    const auto& factory = driverFactories_[pipelineId];
+    const auto maxDrivers = std::min(factory->maxDrivers, maxElasticDrivers);
+    if (maxDrivers <= factory->numDrivers) {
+      continue;
+    }
+    auto scanNodeId = elasticScanNodeId(*factory);
+    if (!scanNodeId.has_value()) {
+      continue;
+    }
+    auto& state = elasticPipelines_[pipelineId];
+    state.scanNodeId = scanNodeId.value();
+    if (!factory->needsPartitionedOutput()) {
+      state.localExchangeNodeId = factory->consumerNode->id();
+    }
+    state.minDrivers = factory->numDrivers;
+    state.maxDrivers = maxDrivers;
+    state.numRunningDrivers = factory->numDrivers;
+    state.intervalStartMicros = getCurrentTimeMicro();
+  }
+}
+
+bool Task::adjustElasticPipelineLocked(
+    Driver* driver,
+    const SplitsStore& splitsStore) {
+  auto it = elasticPipelines_.find(driver->driverCtx()->pipelineId);
+  if (it == elasticPipelines_.end() || !isRunningLocked()) {
+    return false;
+  }
+  auto& state = it->second;
+  const auto nowMicros = getCurrentTimeMicro();
+  const auto cpuNanos = driver->cpuTimeNanos();
+  auto sampleIt = state.driverSamples.find(driver);
+  if (sampleIt == state.driverSamples.end()) {
+    state.driverSamples[driver] = {cpuNanos, nowMicros};
+    return false;
+  }
+  auto& [lastCpuNanos, lastMicros] = sampleIt->second;
+  state.intervalCpuNanos += cpuNanos - lastCpuNanos;
+  state.intervalWallNanos += (nowMicros - lastMicros) * 1'000;
+  lastCpuNanos = cpuNanos;
+  lastMicros = nowMicros;
+
+  const auto& config = queryCtx()->queryConfig();
+  if (nowMicros - state.intervalStartMicros <
+          config.elasticDriverIntervalMs() * 1'000UL ||
+      state.intervalWallNanos == 0) {
+    return false;
+  }
+  const double utilization =
+      static_cast<double>(state.intervalCpuNanos) / state.intervalWallNanos;
+  state.intervalStartMicros = nowMicros;
+  state.intervalCpuNanos = 0;
+  state.intervalWallNanos = 0;
+
+  // A new Driver only helps if it finds a split.
+  if (utilization >= config.elasticDriverScaleUpUtilization() &&
+      state.canAddDrivers && state.numRunningDrivers < state.maxDrivers &&
+      splitsStore.splits.size() > state.numRunningDrivers) {
+    addElasticDriverLocked(driver->driverCtx()->pipelineId);
+    return false;
+  }
+  if (utilization < config.elasticDriverScaleDownUtilization() &&
+      state.numRunningDrivers > state.minDrivers) {
+    --state.numRunningDrivers;
+    state.driverSamples.erase(driver);
+    state.retiredDrivers.insert(driver);
+    ++taskStats_.numRetiredDrivers;
+    return true;
+  }
+  return false;
+}
+
+void Task::addElasticDriverLocked(uint32_t pipelineId) {
+  auto self = shared_from_this();
+  auto& factory = driverFactories_[pipelineId];
+  const uint32_t partitionId = factory->numDrivers;
+  auto driver = factory->createDriver(
+      std::make_unique<DriverCtx>(
+          self, partitionId, pipelineId, kUngroupedGroupId, partitionId),
+      getExchangeClientLocked(pipelineId),
+      [self](size_t i) {
+        return i < self->driverFactories_.size()
+            ? self->driverFactories_[i]->numTotalDrivers
+            : 0;
+      });
+  if (factory->needsPartitionedOutput()) {
+    // The output buffer finishes when as many Drivers as it expects finish.
+    ++numDriversInPartitionedOutput_;
+    if (auto bufferManager = bufferManager_.lock()) {
+      bufferManager->updateNumDrivers(taskId_, numDriversInPartitionedOutput_);
+    }
+  }
+  ++factory->numDrivers;
+  ++factory->numTotalDrivers;
+  ++numTotalDrivers_;
+  ++splitGroupStates_[kUngroupedGroupId].numRunningDrivers;
+  ++elasticPipelines_[pipelineId].numRunningDrivers;
+  ++taskStats_.numAddedDrivers;
+  drivers_.push_back(driver);
+  ++numRunningDrivers_;
+  Driver::enqueue(driver);
+}
+
+void Task::stopAddingElasticDriversLocked(const core::PlanNodeId& scanNodeId) {
+  for (auto& [pipelineId, state] : elasticPipelines_) {
+    if (state.scanNodeId != scanNodeId || !state.canAddDrivers) {
+      continue;
+    }
+    state.canAddDrivers = false;
+    if (!state.localExchangeNodeId.has_value() ||
+        !isElasticExchangeClosedLocked(state.localExchangeNodeId.value())) {
+      continue;
+    }
+    // The local exchange was left open for Drivers added later.
+    auto& localExchanges =
+        splitGroupStates_[kUngroupedGroupId].localExchanges;
+    auto it = localExchanges.find(state.localExchangeNodeId.value());
+    if (it != localExchanges.end()) {
+      for (auto& queue : it->second.queues) {
+        queue->noMoreProducers();
+      }
+    }
+  }
+}
+
+bool Task::isElasticExchangeClosedLocked(
+    const core::PlanNodeId& planNodeId) const {
+  for (const auto& [pipelineId, state] : elasticPipelines_) {
+    if (state.canAddDrivers && state.localExchangeNodeId == planNodeId) {
+      return false;
+    }
+  }
+  return true;
 }
 
 BlockingReason Task::getSplitOrFutureLocked(
@@ -1661,6 +1869,10 @@ void Task::noMoreLocalExchangeProducers(uint32_t splitGroupId) {
   auto& splitGroupState = splitGroupStates_[splitGroupId];
 
   for (auto& exchange : splitGroupState.localExchanges) {
+    // Elastic pipelines may still add producers.
+    if (!isElasticExchangeClosedLocked(exchange.first)) {
+      continue;
+    }
     for (auto& queue : exchange.second.queues) {
       queue->noMoreProducers();
     }
@@ -1739,6 +1951,9 @@ StopReason Task::enter(ThreadState& state) {
     return StopReason::kAlreadyTerminated;
   }
   if (state.isOnThread()) {
+    // A Driver resumed by its blocking future while reclaim() holds it. It is
+    // not blocked anymore, so resume() enqueues it again.
+    state.hasBlockingFuture = false;
     return StopReason::kAlreadyOnThread;
   }
   auto reason = shouldStopLocked();
@@ -1875,6 +2090,102 @@ ContinueFuture Task::requestPauseLocked(bool pause) {
   return makeFinishFutureLocked("Task::requestPause");
 }
 
+uint64_t Task::reclaim(uint64_t targetBytes) {
+  // The Drivers of the reclaimed operators. They are marked on thread while
+  // reclaiming outside of 'mutex_', so that terminate() does not close them
+  // and pauses wait for the reclaim to finish.
+  std::vector<std::shared_ptr<Driver>> drivers;
+  std::vector<Operator*> operators;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK(pauseRequested_, "Task must be paused to reclaim memory");
+    if (!isRunningLocked()) {
+      return 0;
+    }
+    // Operators such as HashBuild spill together with their peers, so a
+    // pipeline is skipped as a whole if any of its Drivers is on thread. An
+    // enqueued Driver is about to go on thread, so it is not taken either.
+    std::unordered_set<uint32_t> busyPipelines;
+    for (const auto& driver : drivers_) {
+      if (driver != nullptr &&
+          (driver->isOnThread() || driver->isTerminated() ||
+           driver->state().isEnqueued)) {
+        busyPipelines.insert(driver->driverCtx()->pipelineId);
+      }
+    }
+    for (const auto& driver : drivers_) {
+      if (driver == nullptr ||
+          busyPipelines.count(driver->driverCtx()->pipelineId) != 0) {
+        continue;
+      }
+      ++numThreads_;
+      driver->state().setThread();
+      drivers.push_back(driver);
+      for (auto* op : driver->operators()) {
+        if (op->canReclaim()) {
+          operators.push_back(op);
+        }
+      }
+    }
+  }
+  // Reclaim from the operators with the most memory first.
+  std::sort(
+      operators.begin(), operators.end(), [](Operator* left, Operator* right) {
+        return left->pool()->getMemoryUsageTracker()->currentBytes() >
+            right->pool()->getMemoryUsageTracker()->currentBytes();
+      });
+  TestValue::adjust("facebook::velox::exec::Task::reclaim", this);
+
+  auto* tracker = pool_->getMemoryUsageTracker().get();
+  uint64_t reclaimedBytes = 0;
+  std::exception_ptr error;
+  try {
+    for (auto* op : operators) {
+      if (reclaimedBytes >= targetBytes) {
+        break;
+      }
+      // A reclaim can also free the memory of peers of 'op'.
+      if (!op->canReclaim()) {
+        continue;
+      }
+      const auto bytesBefore = tracker->reservedBytes();
+      op->reclaim(targetBytes - reclaimedBytes);
+      reclaimedBytes +=
+          std::max<int64_t>(0, bytesBefore - tracker->reservedBytes());
+    }
+  } catch (const std::exception&) {
+    error = std::current_exception();
+  }
+
+  // Drivers terminated while reclaiming are closed here, as terminate() does
+  // for the Drivers that are not on thread.
+  std::vector<std::shared_ptr<Driver>> terminatedDrivers;
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    for (auto& driver : drivers) {
+      if (driver->isTerminated()) {
+        auto it = std::find(drivers_.begin(), drivers_.end(), driver);
+        VELOX_CHECK(it != drivers_.end());
+        it->reset();
+        driverClosedLocked();
+        terminatedDrivers.push_back(std::move(driver));
+      } else {
+        driver->state().clearThread();
+      }
+      if (--numThreads_ == 0) {
+        finishedLocked();
+      }
+    }
+  }
+  for (auto& driver : terminatedDrivers) {
+    driver->closeByTask();
+  }
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+  return reclaimedBytes;
+}
+
 Task::TaskCompletionNotifier::~TaskCompletionNotifier() {
   notify();
 }
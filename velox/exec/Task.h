@@ -27,6 +27,7 @@
 namespace facebook::velox::exec {
 
 class PartitionedOutputBufferManager;
+class MemoryArbitrator;
 
 class HashJoinBridge;
 class CrossJoinBridge;
@@ -298,7 +299,9 @@ class Task : public std::enable_shared_from_this<Task> {
   /// that will complete when split becomes available or no-more-splits
   /// signal is received. If 'maxPreloadSplits' is given, ensures that
   /// so many of splits at the head of the queue are preloading. If
-  /// they are not, calls preload on them to start preload.
+  /// they are not, calls preload on them to start preload. If 'driver' is
+  /// given and runs in a pipeline with elastic concurrency, may add a Driver
+  /// to the pipeline or retire 'driver' by returning no split.
   BlockingReason getSplitOrFuture(
       uint32_t splitGroupId,
       const core::PlanNodeId& planNodeId,
@@ -306,7 +309,8 @@ class Task : public std::enable_shared_from_this<Task> {
       ContinueFuture& future,
       int32_t maxPreloadSplits = 0,
       std::function<void(std::shared_ptr<connector::ConnectorSplit>)> preload =
-          nullptr);
+          nullptr,
+      Driver* FOLLY_NULLABLE driver = nullptr);
 
   void splitFinished();
 
@@ -478,6 +482,15 @@ class Task : public std::enable_shared_from_this<Task> {
 
   ContinueFuture requestPauseLocked(bool pause);
 
+  /// Frees memory of the operators that support reclaiming it, e.g. by
+  /// spilling, until 'targetBytes' are freed or no operator can free more.
+  /// Returns the number of bytes freed. 'this' must be paused. Operators are
+  /// reclaimed only from pipelines none of whose Drivers are on thread or
+  /// enqueued, which excludes the pipelines of Drivers in a suspended section.
+  /// The Drivers of the reclaimed operators count as on thread while
+  /// reclaiming, but 'mutex_' is not held.
+  uint64_t reclaim(uint64_t targetBytes);
+
   /// Requests activity of 'this' to stop. The returned future will be
   /// realized when the last thread stops running for 'this'. This is used to
   /// mark cancellation by the user.
@@ -496,6 +509,29 @@ class Task : public std::enable_shared_from_this<Task> {
     toYield_ = numThreads_;
   }
 
+  /// Adds 'nanos' of thread CPU time used by a Driver of 'this' on an
+  /// executor thread.
+  void addDriverCpuTimeNanos(uint64_t nanos) {
+    driverCpuTimeNanos_ += nanos;
+  }
+
+  /// Returns the thread CPU time used by the Drivers of 'this' so far. Used to
+  /// schedule the Drivers by TaskExecutor.
+  uint64_t driverCpuTimeNanos() const {
+    return driverCpuTimeNanos_;
+  }
+
+  /// Adds a yield of a Driver of 'this' at the end of its time slice.
+  void addDriverYield() {
+    ++numDriverYields_;
+  }
+
+  /// Returns the number of times the Drivers of 'this' yielded at the end of
+  /// their time slice.
+  uint64_t numDriverYields() const {
+    return numDriverYields_;
+  }
+
   /// Once 'pauseRequested_' is set, it will not be cleared until
   /// task::resume(). It is therefore OK to read it without a mutex
   /// from a thread that this flag concerns.
@@ -622,6 +658,30 @@ class Task : public std::enable_shared_from_this<Task> {
       uint32_t splitGroupId,
       std::vector<std::shared_ptr<Driver>>& out);
 
+  /// Sets up the state of the pipelines whose number of Drivers may change
+  /// while running. Called in start() before the Drivers are created.
+  void initElasticPipelinesLocked();
+
+  /// Called by 'driver' of an elastic pipeline when it asks for a split from
+  /// 'splitsStore'. Adds a Driver to the pipeline if its Drivers are CPU bound
+  /// and there are enough queued splits. Returns true if 'driver' should
+  /// finish because its Drivers are not CPU bound.
+  bool adjustElasticPipelineLocked(
+      Driver* FOLLY_NONNULL driver,
+      const SplitsStore& splitsStore);
+
+  /// Creates and starts one more Driver for 'pipelineId'.
+  void addElasticDriverLocked(uint32_t pipelineId);
+
+  /// Stops adding Drivers to the elastic pipelines reading from 'scanNodeId'
+  /// once all its splits have been handed out. Signals no more producers to
+  /// the local exchanges that no longer get new producers.
+  void stopAddingElasticDriversLocked(const core::PlanNodeId& scanNodeId);
+
+  /// Returns true if no more producers can be added to the local exchange
+  /// 'planNodeId' by elastic pipelines.
+  bool isElasticExchangeClosedLocked(const core::PlanNodeId& planNodeId) const;
+
   /// Checks if we have splits in a split group that haven't been processed yet
   /// and have capacity in terms of number of concurrent split groups being
   /// processed. If yes, creates split group state and Drivers and runs them.
@@ -811,6 +871,10 @@ class Task : public std::enable_shared_from_this<Task> {
   const int destination_;
   const std::shared_ptr<core::QueryCtx> queryCtx_;
 
+  // The arbitrator of the memory of the query that 'this' registered with at
+  // start, if any.
+  std::shared_ptr<MemoryArbitrator> memoryArbitrator_;
+
   // Root MemoryPool for this Task. All member variables that hold references
   // to pool_ must be defined after pool_, childPools_.
   std::shared_ptr<memory::MemoryPool> pool_;
@@ -863,6 +927,9 @@ class Task : public std::enable_shared_from_this<Task> {
 
   std::vector<std::unique_ptr<DriverFactory>> driverFactories_;
   std::vector<std::shared_ptr<Driver>> drivers_;
+  /// Pipelines whose number of Drivers changes while running, keyed on
+  /// pipeline id.
+  std::unordered_map<uint32_t, ElasticPipelineState> elasticPipelines_;
   /// The total number of running drivers in all pipelines.
   /// This number changes over time as drivers finish their work and maybe new
   /// get created.
@@ -932,6 +999,10 @@ class Task : public std::enable_shared_from_this<Task> {
   std::atomic<bool> terminateRequested_{false};
   std::atomic<int32_t> toYield_ = 0;
   int32_t numThreads_ = 0;
+  // Thread CPU time used by the Drivers in Driver::run().
+  std::atomic<uint64_t> driverCpuTimeNanos_{0};
+  // Number of time slice yields of the Drivers in Driver::run().
+  std::atomic<uint64_t> numDriverYields_{0};
   // Promises for the futures returned to callers of requestPause() or
   // terminate(). They are fulfilled when the last thread stops
   // running for 'this'.
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/TaskExecutor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+#include <glog/logging.h>
+
+#include "velox/common/base/Exceptions.h"
+#include "velox/common/process/ProcessBase.h"
+
+namespace facebook::velox::exec {
+
+TaskExecutor::TaskExecutor(Options options)
+    : options_(std::move(options)),
+      queues_(options_.levelThresholdNanos.size() + 1),
+      levelCpuNanos_(queues_.size(), 0) {
+  VELOX_CHECK_GT(options_.numThreads, 0);
+  VELOX_CHECK_GE(options_.levelTimeMultiplier, 1);
+  VELOX_CHECK(std::is_sorted(
+      options_.levelThresholdNanos.begin(),
+      options_.levelThresholdNanos.end()));
+  threads_.reserve(options_.numThreads);
+  for (auto i = 0; i < options_.numThreads; ++i) {
+    threads_.emplace_back([this]() { run(); });
+  }
+}
+
+TaskExecutor::~TaskExecutor() {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    stopped_ = true;
+  }
+  queueCv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void TaskExecutor::add(folly::Func func) {
+  enqueue(std::move(func), 0);
+}
+
+void TaskExecutor::add(folly::Func func, uint64_t taskCpuNanos) {
+  enqueue(std::move(func), levelOf(taskCpuNanos));
+}
+
+int32_t TaskExecutor::levelOf(uint64_t taskCpuNanos) const {
+  const auto& thresholds = options_.levelThresholdNanos;
+  return std::upper_bound(thresholds.begin(), thresholds.end(), taskCpuNanos) -
+      thresholds.begin();
+}
+
+uint64_t TaskExecutor::levelCpuNanos(int32_t level) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return levelCpuNanos_.at(level);
+}
+
+size_t TaskExecutor::numQueued(int32_t level) const {
+  std::lock_guard<std::mutex> l(mutex_);
+  return queues_.at(level).size();
+}
+
+void TaskExecutor::enqueue(folly::Func func, int32_t level) {
+  {
+    std::lock_guard<std::mutex> l(mutex_);
+    VELOX_CHECK(!stopped_, "TaskExecutor is stopped");
+    if (queues_[level].empty()) {
+      // Charge an idle level up to the least charged busy level, so that it
+      // gets its share from now on instead of catching up for the time it
+      // was idle.
+      std::optional<double> minScaledNanos;
+      for (auto i = 0; i < queues_.size(); ++i) {
+        if (i != level && !queues_[i].empty()) {
+          const auto scaledNanos = scaledCpuNanosLocked(i);
+          if (!minScaledNanos.has_value() || scaledNanos < *minScaledNanos) {
+            minScaledNanos = scaledNanos;
+          }
+        }
+      }
+      if (minScaledNanos.has_value()) {
+        const auto nanos = static_cast<uint64_t>(
+            *minScaledNanos / std::pow(options_.levelTimeMultiplier, level));
+        levelCpuNanos_[level] = std::max(levelCpuNanos_[level], nanos);
+      }
+    }
+    queues_[level].push_back(std::move(func));
+    ++numQueued_;
+  }
+  queueCv_.notify_one();
+}
+
+double TaskExecutor::scaledCpuNanosLocked(int32_t level) const {
+  return levelCpuNanos_[level] * std::pow(options_.levelTimeMultiplier, level);
+}
+
+int32_t TaskExecutor::nextLevelLocked() const {
+  VELOX_DCHECK_GT(numQueued_, 0);
+  int32_t nextLevel = -1;
+  double minScaledNanos = 0;
+  for (auto level = 0; level < queues_.size(); ++level) {
+    if (queues_[level].empty()) {
+      continue;
+    }
+    const auto scaledNanos = scaledCpuNanosLocked(level);
+    if (nextLevel == -1 || scaledNanos < minScaledNanos) {
+      nextLevel = level;
+      minScaledNanos = scaledNanos;
+    }
+  }
+  return nextLevel;
+}
+
+void TaskExecutor::run() {
+  for (;;) {
+    folly::Func func;
+    int32_t level;
+    {
+      std::unique_lock<std::mutex> l(mutex_);
+      queueCv_.wait(l, [&]() { return numQueued_ > 0 || stopped_; });
+      if (numQueued_ == 0) {
+        return;
+      }
+      level = nextLevelLocked();
+      func = std::move(queues_[level].front());
+      queues_[level].pop_front();
+      --numQueued_;
+    }
+    const auto startCpuNanos = process::threadCpuNanos();
+    try {
+      func();
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "Exception in TaskExecutor: " << e.what();
+    }
+    const auto cpuNanos = process::threadCpuNanos() - startCpuNanos;
+    std::lock_guard<std::mutex> l(mutex_);
+    levelCpuNanos_[level] += cpuNanos;
+  }
+}
+
+} // namespace facebook::velox::exec
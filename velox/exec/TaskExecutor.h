@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <folly/Executor.h>
+
+namespace facebook::velox::exec {
+
+/// Executor for the Drivers of concurrent Tasks. Runnable Drivers are kept in
+/// a multi-level feedback queue. A Driver is queued at the level of the CPU
+/// time its Task has used so far, so that short queries stay on the first
+/// levels and long running queries sink to the last levels. Each level gets a
+/// share of the CPU time of the executor that decreases with the level by
+/// 'levelTimeMultiplier'. The worker threads take the next Driver from the
+/// non-empty level that is furthest behind its share, so the last levels make
+/// progress but do not block the first levels.
+///
+/// Drivers give up their thread at the end of each time slice, see
+/// QueryConfig::kDriverTimeSliceLimitMs, and are then queued again at the
+/// level of their Task's updated CPU time.
+class TaskExecutor : public folly::Executor {
+ public:
+  struct Options {
+    /// Number of worker threads.
+    int32_t numThreads{1};
+
+    /// Upper bounds of the Task CPU time in nanoseconds of all levels but the
+    /// last, in ascending order. The number of levels is one more than the
+    /// number of thresholds.
+    std::vector<uint64_t> levelThresholdNanos{
+        1'000'000'000UL, // 1s
+        10'000'000'000UL, // 10s
+        60'000'000'000UL, // 1m
+        300'000'000'000UL}; // 5m
+
+    /// The CPU time share of a level is the share of the previous level
+    /// divided by this.
+    double levelTimeMultiplier{2};
+  };
+
+  explicit TaskExecutor(Options options);
+
+  /// Stops the worker threads after running all queued functions.
+  ~TaskExecutor() override;
+
+  /// Runs 'func' at the first level.
+  void add(folly::Func func) override;
+
+  /// Runs 'func' at the level of a Task that has used 'taskCpuNanos' of CPU
+  /// time.
+  void add(folly::Func func, uint64_t taskCpuNanos);
+
+  /// Returns the level of a Task that has used 'taskCpuNanos' of CPU time.
+  int32_t levelOf(uint64_t taskCpuNanos) const;
+
+  int32_t numLevels() const {
+    return queues_.size();
+  }
+
+  /// Returns the thread CPU time used by the functions run at 'level'.
+  uint64_t levelCpuNanos(int32_t level) const;
+
+  /// Returns the number of functions waiting at 'level'.
+  size_t numQueued(int32_t level) const;
+
+ private:
+  // Queues 'func' at 'level'.
+  void enqueue(folly::Func func, int32_t level);
+
+  // The loop of a worker thread.
+  void run();
+
+  // Returns the non-empty level that has used the least CPU time relative to
+  // its share. Must be called with 'mutex_' held and a non-empty queue.
+  int32_t nextLevelLocked() const;
+
+  // CPU time used at 'level' scaled by the inverse of the share of the level.
+  double scaledCpuNanosLocked(int32_t level) const;
+
+  const Options options_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable queueCv_;
+  std::vector<std::deque<folly::Func>> queues_;
+  // CPU time used by the functions of each level. Levels that were idle are
+  // charged up to the other levels when they get new work, so that they do
+  // not monopolize the threads to catch up.
+  std::vector<uint64_t> levelCpuNanos_;
+  // Number of queued functions at all levels.
+  size_t numQueued_{0};
+  bool stopped_{false};
+
+  std::vector<std::thread> threads_;
+};
+
+} // namespace facebook::velox::exec
@@ -83,6 +83,10 @@ struct TaskStats {
   uint64_t numTerminatedDrivers{0};
   /// The number of drivers that are currently running on driver thread.
   uint64_t numRunningDrivers{0};
+  /// The number of drivers added to and retired from pipelines with elastic
+  /// concurrency while running. See QueryConfig::kMaxElasticDriversPerPipeline.
+  uint64_t numAddedDrivers{0};
+  uint64_t numRetiredDrivers{0};
   /// Drivers blocked for various reasons. Based on enum BlockingReason.
   std::unordered_map<BlockingReason, uint64_t> numBlockedDrivers;
 };
@@ -15,6 +15,8 @@
  */
 #pragma once
 #include <limits>
+#include <optional>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -120,4 +122,46 @@ struct SplitGroupState {
   }
 };
 
+/// State of a pipeline that reads splits from a table scan and whose number of
+/// Drivers changes while the Task runs. See
+/// QueryConfig::kMaxElasticDriversPerPipeline.
+struct ElasticPipelineState {
+  /// Plan node id of the table scan at the start of the pipeline.
+  core::PlanNodeId scanNodeId;
+
+  /// Plan node id of the local exchange the pipeline produces into, if any.
+  /// No more producers is signalled to the exchange only when no more Drivers
+  /// can be added.
+  std::optional<core::PlanNodeId> localExchangeNodeId;
+
+  /// The pipeline does not retire Drivers below this many running Drivers.
+  uint32_t minDrivers{0};
+
+  /// The pipeline does not add Drivers above this many running Drivers.
+  uint32_t maxDrivers{0};
+
+  /// Number of running Drivers that have not been retired.
+  uint32_t numRunningDrivers{0};
+
+  /// False once all the splits for 'scanNodeId' have been handed out and no
+  /// more splits arrive.
+  bool canAddDrivers{true};
+
+  /// Start of the current interval over which the CPU utilization of the
+  /// Drivers is measured.
+  uint64_t intervalStartMicros{0};
+
+  /// Thread CPU and wall time of the Drivers in the current interval.
+  uint64_t intervalCpuNanos{0};
+  uint64_t intervalWallNanos{0};
+
+  /// Thread CPU time and wall time in microseconds of each Driver when it
+  /// last asked for a split.
+  std::unordered_map<const Driver*, std::pair<uint64_t, uint64_t>>
+      driverSamples;
+
+  /// Drivers that were retired but have not yet been removed from the Task.
+  std::unordered_set<const Driver*> retiredDrivers;
+};
+
 } // namespace facebook::velox::exec
@@ -18,6 +18,80 @@
 #include "velox/vector/FlatVector.h"
 
 namespace facebook::velox::exec {
+namespace {
+// Clears the bits in 'rows' for rows whose value in 'decoded' sorts after
+// 'bound'. 'bound' is std::nullopt for a null bound.
+template <typename T>
+void deselectAfterBound(
+    const DecodedVector& decoded,
+    const std::optional<T>& bound,
+    const CompareFlags& flags,
+    SelectivityVector& rows) {
+  const auto begin = rows.begin();
+  const auto end = rows.end();
+  if (!bound.has_value()) {
+    // All values sort before or equal to a null bound unless nulls come first.
+    if (flags.nullsFirst) {
+      for (auto row = begin; row < end; ++row) {
+        if (rows.isValid(row) && !decoded.isNullAt(row)) {
+          rows.setValid(row, false);
+        }
+      }
+    }
+    rows.updateBounds();
+    return;
+  }
+  const T value = bound.value();
+  if (decoded.isIdentityMapping() && !decoded.mayHaveNulls()) {
+    // Compares 64 values at a time into a mask of the rows to keep.
+    const auto* rawValues = decoded.data<T>();
+    auto* bits = rows.asMutableRange().bits();
+    for (auto word = begin / 64; word < bits::nwords(end); ++word) {
+      const auto first = word * 64;
+      const auto last = std::min(end, first + 64);
+      uint64_t keep = 0;
+      if (flags.ascending) {
+        for (auto row = first; row < last; ++row) {
+          keep |= static_cast<uint64_t>(rawValues[row] <= value)
+              << (row - first);
+        }
+      } else {
+        for (auto row = first; row < last; ++row) {
+          keep |= static_cast<uint64_t>(rawValues[row] >= value)
+              << (row - first);
+        }
+      }
+      bits[word] &= keep;
+    }
+  } else {
+    for (auto row = begin; row < end; ++row) {
+      if (!rows.isValid(row)) {
+        continue;
+      }
+      bool keep;
+      if (decoded.isNullAt(row)) {
+        keep = flags.nullsFirst;
+      } else {
+        const auto rowValue = decoded.valueAt<T>(row);
+        keep = flags.ascending ? rowValue <= value : rowValue >= value;
+      }
+      if (!keep) {
+        rows.setValid(row, false);
+      }
+    }
+  }
+  rows.updateBounds();
+}
+
+template <typename T>
+std::optional<T> valueAt(const char* row, const RowColumn& column) {
+  if (RowContainer::isNullAt(row, column.nullByte(), column.nullMask())) {
+    return std::nullopt;
+  }
+  return *reinterpret_cast<const T*>(row + column.offset());
+}
+} // namespace
+
 TopN::TopN(
     int32_t operatorId,
     DriverCtx* driverCtx,
@@ -36,7 +110,12 @@ TopN::TopN(
           topNNode->sortingOrders(),
           data_.get()),
       topRows_(comparator_),
-      decodedVectors_(outputType_->children().size()) {}
+      decodedVectors_(outputType_->children().size()),
+      isKeyChannel_(outputType_->children().size(), false) {
+  for (const auto& [channel, _] : comparator_.keyInfo()) {
+    isKeyChannel_[channel] = true;
+  }
+}
 
 TopN::Comparator::Comparator(
     const RowTypePtr& type,
@@ -56,22 +135,92 @@ TopN::Comparator::Comparator(
 }
 
 void TopN::addInput(RowVectorPtr input) {
-  SelectivityVector allRows(input->size());
+  const auto numRows = input->size();
+  inputRows_.resize(numRows);
+  inputRows_.setAll();
+  for (const auto& [channel, _] : comparator_.keyInfo()) {
+    decodedVectors_[channel].decode(*input->childAt(channel), inputRows_);
+  }
 
-  // TODO Decode keys first, then decode the rest only for passing positions
-  for (int col = 0; col < input->childrenSize(); ++col) {
-    decodedVectors_[col].decode(*input->childAt(col), allRows);
+  // The first rows are added until there are 'count_' rows.
+  const vector_size_t numFillRows =
+      std::min<int64_t>(numRows, count_ - topRows_.size());
+  if (numFillRows > 0) {
+    inputRows_.setValidRange(numFillRows, numRows, false);
+    inputRows_.updateBounds();
+    addRows(input, inputRows_);
+    if (numFillRows == numRows) {
+      return;
+    }
   }
 
-  for (int row = 0; row < input->size(); ++row) {
+  // The remaining rows are filtered against the top before decoding the
+  // other columns.
+  inputRows_.clearAll();
+  inputRows_.setValidRange(numFillRows, numRows, true);
+  inputRows_.updateBounds();
+  deselectRowsAfterTop(inputRows_);
+  if (inputRows_.hasSelections()) {
+    addRows(input, inputRows_);
+  }
+}
+
+void TopN::deselectRowsAfterTop(SelectivityVector& rows) {
+  const char* topRow = topRows_.top();
+  const auto& keyInfo = comparator_.keyInfo();
+  if (keyInfo.size() == 1) {
+    const auto channel = keyInfo[0].first;
+    const auto& sortOrder = keyInfo[0].second;
+    const CompareFlags flags{
+        sortOrder.isNullsFirst(), sortOrder.isAscending(), false};
+    const auto column = data_->columnAt(channel);
+    const auto& decoded = decodedVectors_[channel];
+    switch (outputType_->childAt(channel)->kind()) {
+      case TypeKind::TINYINT:
+        deselectAfterBound(
+            decoded, valueAt<int8_t>(topRow, column), flags, rows);
+        return;
+      case TypeKind::SMALLINT:
+        deselectAfterBound(
+            decoded, valueAt<int16_t>(topRow, column), flags, rows);
+        return;
+      case TypeKind::INTEGER:
+        deselectAfterBound(
+            decoded, valueAt<int32_t>(topRow, column), flags, rows);
+        return;
+      case TypeKind::BIGINT:
+        deselectAfterBound(
+            decoded, valueAt<int64_t>(topRow, column), flags, rows);
+        return;
+      default:
+        break;
+    }
+  }
+  for (auto row = rows.begin(); row < rows.end(); ++row) {
+    if (rows.isValid(row) && comparator_(topRow, decodedVectors_, row)) {
+      rows.setValid(row, false);
+    }
+  }
+  rows.updateBounds();
+}
+
+void TopN::addRows(const RowVectorPtr& input, const SelectivityVector& rows) {
+  for (auto col = 0; col < input->childrenSize(); ++col) {
+    if (!isKeyChannel_[col]) {
+      decodedVectors_[col].decode(*input->childAt(col), rows);
+    }
+  }
+
+  rows.applyToSelected([&](auto row) {
     char* newRow = nullptr;
     if (topRows_.size() < count_) {
       newRow = data_->newRow();
     } else {
       char* topRow = topRows_.top();
 
+      // The top may have moved down since 'rows' were selected.
       if (comparator_(topRow, decodedVectors_, row)) {
-        continue;
+        return;
       }
       topRows_.pop();
       // Reuse the topRow's memory.
@@ -83,7 +232,7 @@ void TopN::addInput(RowVectorPtr input) {
     }
 
     topRows_.push(newRow);
-  }
+  });
 }
 
 RowVectorPtr TopN::getOutput() {
@@ -45,6 +45,16 @@ class TopN : public Operator {
 
  private:
   static constexpr size_t kMaxNumRowsToReturn = 1024;
+
+  // Adds the selected 'rows' of 'input' to 'topRows_', replacing the top if
+  // there are 'count_' rows. Decodes the non-key columns of 'rows'. The key
+  // columns must be decoded.
+  void addRows(const RowVectorPtr& input, const SelectivityVector& rows);
+
+  // Deselects the 'rows' that sort after the top of 'topRows_'. These cannot
+  // be in the result since the top only moves down as rows are added. Only
+  // the key columns need to be decoded.
+  void deselectRowsAfterTop(SelectivityVector& rows);
   class Comparator {
    public:
     Comparator(
@@ -89,6 +99,11 @@ class TopN : public Operator {
       return false;
     }
 
+    const std::vector<std::pair<column_index_t, core::SortOrder>>& keyInfo()
+        const {
+      return keyInfo_;
+    }
+
    private:
     std::vector<std::pair<column_index_t, core::SortOrder>> keyInfo_;
     RowContainer* rowContainer_;
@@ -114,5 +129,11 @@ class TopN : public Operator {
   std::vector<char*> rows_;
 
   std::vector<DecodedVector> decodedVectors_;
+
+  // True for the columns that are sorting keys.
+  std::vector<bool> isKeyChannel_;
+
+  // The rows of the current input to add.
+  SelectivityVector inputRows_;
 };
 } // namespace facebook::velox::exec
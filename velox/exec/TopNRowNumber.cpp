@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/TopNRowNumber.h"
+#include "velox/exec/OperatorUtils.h"
+
+namespace facebook::velox::exec {
+
+TopNRowNumber::TopNRowNumber(
+    int32_t operatorId,
+    DriverCtx* driverCtx,
+    const std::shared_ptr<const core::TopNRowNumberNode>& node)
+    : Operator(
+          driverCtx,
+          node->outputType(),
+          operatorId,
+          node->id(),
+          "TopNRowNumber"),
+      limit_(node->limit()),
+      generateRowNumber_(node->generateRowNumber()),
+      outputBatchSize_(driverCtx->queryConfig().preferredOutputBatchSize()),
+      allocator_(pool()) {
+  const auto& inputType = node->sources()[0]->outputType();
+  const auto& sortingOrders = node->sortingOrders();
+  for (auto i = 0; i < node->sortingKeys().size(); ++i) {
+    const auto channel =
+        exprToChannel(node->sortingKeys()[i].get(), inputType);
+    VELOX_CHECK_NE(
+        channel,
+        kConstantChannel,
+        "TopNRowNumber doesn't allow constant sorting keys");
+    sortingKeys_.push_back(
+        {channel,
+         {sortingOrders[i].isNullsFirst(),
+          sortingOrders[i].isAscending(),
+          false}});
+  }
+  data_ = std::make_unique<RowContainer>(inputType->children(), pool());
+  decodedVectors_.resize(inputType->size());
+
+  const auto& keys = node->partitionKeys();
+  if (keys.empty()) {
+    partitions_.emplace_back(StlAllocator<char*>(&allocator_));
+    return;
+  }
+  std::vector<std::unique_ptr<VectorHasher>> hashers;
+  hashers.reserve(keys.size());
+  for (const auto& key : keys) {
+    const auto channel = exprToChannel(key.get(), inputType);
+    VELOX_CHECK_NE(
+        channel,
+        kConstantChannel,
+        "TopNRowNumber doesn't allow constant partition keys");
+    hashers.push_back(VectorHasher::create(key->type(), channel));
+  }
+  static const std::vector<std::unique_ptr<Aggregate>> kNoAggregates;
+  table_ = std::make_unique<HashTable<false>>(
+      std::move(hashers),
+      kNoAggregates,
+      std::vector<TypePtr>{BIGINT()},
+      false, // allowDuplicates
+      false, // isJoinBuild
+      false, // hasProbedFlag
+      pool());
+  lookup_ = std::make_unique<HashLookup>(table_->hashers());
+  partitionIndexOffset_ = table_->rows()->columnAt(keys.size()).offset();
+}
+
+bool TopNRowNumber::lessThan(const char* lhs, const char* rhs) const {
+  for (const auto& [channel, flags] : sortingKeys_) {
+    if (auto result = data_->compare(lhs, rhs, channel, flags)) {
+      return result < 0;
+    }
+  }
+  return false;
+}
+
+bool TopNRowNumber::lessThan(vector_size_t index, const char* row) const {
+  for (const auto& [channel, flags] : sortingKeys_) {
+    if (auto result = data_->compare(
+            row,
+            data_->columnAt(channel),
+            decodedVectors_[channel],
+            index,
+            flags)) {
+      return result > 0;
+    }
+  }
+  return false;
+}
+
+TopNRowNumber::TopRows& TopNRowNumber::partitionAt(vector_size_t index) {
+  if (table_ == nullptr) {
+    return partitions_[0];
+  }
+  const auto partitionIndex = *reinterpret_cast<int64_t*>(
+      lookup_->hits[index] + partitionIndexOffset_);
+  return partitions_[partitionIndex];
+}
+
+void TopNRowNumber::addInput(RowVectorPtr input) {
+  const auto numInput = input->size();
+  if (table_ != nullptr) {
+    groupProbe(input, *table_, *lookup_, activeRows_);
+    for (auto row : lookup_->newGroups) {
+      *reinterpret_cast<int64_t*>(
+          lookup_->hits[row] + partitionIndexOffset_) = partitions_.size();
+      partitions_.emplace_back(StlAllocator<char*>(&allocator_));
+    }
+  } else {
+    activeRows_.resize(numInput);
+    activeRows_.setAll();
+  }
+
+  for (auto col = 0; col < input->childrenSize(); ++col) {
+    decodedVectors_[col].decode(*input->childAt(col), activeRows_);
+  }
+
+  auto compare = [&](const char* lhs, const char* rhs) {
+    return lessThan(lhs, rhs);
+  };
+  for (auto row = 0; row < numInput; ++row) {
+    auto& topRows = partitionAt(row);
+    char* newRow = nullptr;
+    if (topRows.size() < limit_) {
+      newRow = data_->newRow();
+    } else {
+      // The worst row of the partition is on top of the heap.
+      char* topRow = topRows.front();
+      if (!lessThan(row, topRow)) {
+        continue;
+      }
+      std::pop_heap(topRows.begin(), topRows.end(), compare);
+      topRows.pop_back();
+      // Reuse the topRow's memory.
+      newRow = data_->initializeRow(topRow, true /* reuse */);
+    }
+
+    for (auto col = 0; col < input->childrenSize(); ++col) {
+      data_->store(decodedVectors_[col], row, newRow, col);
+    }
+    topRows.push_back(newRow);
+    std::push_heap(topRows.begin(), topRows.end(), compare);
+  }
+}
+
+void TopNRowNumber::noMoreInput() {
+  Operator::noMoreInput();
+
+  auto compare = [&](const char* lhs, const char* rhs) {
+    return lessThan(lhs, rhs);
+  };
+  outputRows_.reserve(data_->numRows());
+  outputRowNumbers_.reserve(data_->numRows());
+  for (auto& topRows : partitions_) {
+    std::sort_heap(topRows.begin(), topRows.end(), compare);
+    for (auto i = 0; i < topRows.size(); ++i) {
+      outputRows_.push_back(topRows[i]);
+      outputRowNumbers_.push_back(i + 1);
+    }
+    TopRows(StlAllocator<char*>(&allocator_)).swap(topRows);
+  }
+  finished_ = outputRows_.empty();
+}
+
+RowVectorPtr TopNRowNumber::getOutput() {
+  if (finished_ || !noMoreInput_) {
+    return nullptr;
+  }
+
+  const vector_size_t numOutput = std::min<vector_size_t>(
+      outputBatchSize_, outputRows_.size() - numRowsReturned_);
+  auto result = std::static_pointer_cast<RowVector>(
+      BaseVector::create(outputType_, numOutput, pool()));
+  const auto numInputColumns = data_->columnTypes().size();
+  for (auto i = 0; i < numInputColumns; ++i) {
+    data_->extractColumn(
+        outputRows_.data() + numRowsReturned_,
+        numOutput,
+        i,
+        result->childAt(i));
+  }
+  if (generateRowNumber_) {
+    auto* rawRowNumbers = result->childAt(numInputColumns)
+                              ->asFlatVector<int64_t>()
+                              ->mutableRawValues();
+    std::copy(
+        outputRowNumbers_.begin() + numRowsReturned_,
+        outputRowNumbers_.begin() + numRowsReturned_ + numOutput,
+        rawRowNumbers);
+  }
+  numRowsReturned_ += numOutput;
+  finished_ = numRowsReturned_ == outputRows_.size();
+  return result;
+}
+
+} // namespace facebook::velox::exec
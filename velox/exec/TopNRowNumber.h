@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include "velox/exec/HashTable.h"
+#include "velox/exec/Operator.h"
+
+namespace facebook::velox::exec {
+
+/// Keeps the first 'limit' rows of each partition in the order of the sorting
+/// keys and produces them with their row numbers after all input is
+/// received. The partitions are in a hash table on the partition keys. Each
+/// partition has a heap of at most 'limit' rows stored in a RowContainer with
+/// the worst row on top, so that memory is bounded by 'limit' rows per
+/// partition instead of the whole input.
+class TopNRowNumber : public Operator {
+ public:
+  TopNRowNumber(
+      int32_t operatorId,
+      DriverCtx* driverCtx,
+      const std::shared_ptr<const core::TopNRowNumberNode>& node);
+
+  bool needsInput() const override {
+    return !noMoreInput_;
+  }
+
+  void addInput(RowVectorPtr input) override;
+
+  void noMoreInput() override;
+
+  RowVectorPtr getOutput() override;
+
+  BlockingReason isBlocked(ContinueFuture* /*future*/) override {
+    return BlockingReason::kNotBlocked;
+  }
+
+  bool isFinished() override {
+    return finished_;
+  }
+
+ private:
+  using TopRows = std::vector<char*, StlAllocator<char*>>;
+
+  // Compares rows of 'data_' by the sorting keys. Returns true if 'lhs' sorts
+  // before 'rhs'.
+  bool lessThan(const char* lhs, const char* rhs) const;
+
+  // Returns true if row 'index' of the decoded input sorts before 'row' of
+  // 'data_'.
+  bool lessThan(vector_size_t index, const char* row) const;
+
+  // Returns the heap of the partition of input row 'index'.
+  TopRows& partitionAt(vector_size_t index);
+
+  const int32_t limit_;
+  const bool generateRowNumber_;
+  const vector_size_t outputBatchSize_;
+
+  // The sorting key channels with the compare flags for each.
+  std::vector<std::pair<column_index_t, CompareFlags>> sortingKeys_;
+
+  // Holds the input rows kept in any of the partitions.
+  std::unique_ptr<RowContainer> data_;
+
+  // Allocates the heaps of the partitions.
+  HashStringAllocator allocator_;
+
+  // The partitions with the index of the heap of each in 'partitions_'.
+  // nullptr if there are no partition keys.
+  std::unique_ptr<BaseHashTable> table_;
+  std::unique_ptr<HashLookup> lookup_;
+  // Offset of the index of the heap in the rows of 'table_'.
+  int32_t partitionIndexOffset_{0};
+
+  // Heaps of the rows of each partition. A single heap if there are no
+  // partition keys.
+  std::vector<TopRows> partitions_;
+
+  SelectivityVector activeRows_;
+  std::vector<DecodedVector> decodedVectors_;
+
+  // The rows to produce with their row numbers, grouped by partition and
+  // sorted within each partition. Filled in noMoreInput().
+  std::vector<char*> outputRows_;
+  std::vector<int64_t> outputRowNumbers_;
+  vector_size_t numRowsReturned_{0};
+
+  bool finished_{false};
+};
+
+} // namespace facebook::velox::exec
@@ -15,6 +15,7 @@
  */
 #include "velox/exec/Window.h"
 #include "velox/exec/OperatorUtils.h"
+#include "velox/exec/PrefixSort.h"
 #include "velox/exec/Task.h"
 
 namespace facebook::velox::exec {
@@ -55,9 +56,7 @@ Window::Window(
       outputBatchSizeInBytes_(
           driverCtx->queryConfig().preferredOutputBatchSize()),
       numInputColumns_(windowNode->sources()[0]->outputType()->size()),
-      data_(std::make_unique<RowContainer>(
-          windowNode->sources()[0]->outputType()->children(),
-          pool())),
+      inputsSorted_(windowNode->inputsSorted()),
       decodedInputVectors_(numInputColumns_),
       stringAllocator_(pool()) {
   auto inputType = windowNode->sources()[0]->outputType();
@@ -67,15 +66,76 @@ Window::Window(
       windowNode->sortingKeys(),
       windowNode->sortingOrders(),
       sortKeyInfo_);
+
+  // Store the partition and sort key columns first in 'data_' followed by
+  // the other input columns. A column which appears more than once in the
+  // keys is stored once.
+  std::vector<column_index_t> inputToData(numInputColumns_, kConstantChannel);
+  std::vector<TypePtr> keyTypes;
+  std::vector<TypePtr> dependentTypes;
+  std::vector<TypePtr> types;
+  std::vector<std::string> names;
+  for (const auto& keyInfo : {partitionKeyInfo_, sortKeyInfo_}) {
+    for (const auto& [channel, sortOrder] : keyInfo) {
+      if (inputToData[channel] != kConstantChannel) {
+        continue;
+      }
+      inputToData[channel] = keyTypes.size();
+      columnMap_.emplace_back(keyTypes.size(), channel);
+      keyTypes.push_back(inputType->childAt(channel));
+      types.push_back(keyTypes.back());
+      names.push_back(inputType->nameOf(channel));
+      keyCompareFlags_.push_back(
+          {sortOrder.isNullsFirst(), sortOrder.isAscending(), false, false});
+    }
+  }
+  for (column_index_t channel = 0; channel < numInputColumns_; ++channel) {
+    if (inputToData[channel] != kConstantChannel) {
+      continue;
+    }
+    inputToData[channel] = keyTypes.size() + dependentTypes.size();
+    columnMap_.emplace_back(inputToData[channel], channel);
+    dependentTypes.push_back(inputType->childAt(channel));
+    types.push_back(dependentTypes.back());
+    names.push_back(inputType->nameOf(channel));
+  }
+  data_ = std::make_unique<RowContainer>(keyTypes, dependentTypes, pool());
+  spillType_ = ROW(std::move(names), std::move(types));
+
+  // The key infos refer to the columns in 'data_' from here on.
+  for (auto* keyInfo : {&partitionKeyInfo_, &sortKeyInfo_}) {
+    for (auto& key : *keyInfo) {
+      key.first = inputToData[key.first];
+    }
+  }
   allKeyInfo_.reserve(partitionKeyInfo_.size() + sortKeyInfo_.size());
   allKeyInfo_.insert(
       allKeyInfo_.cend(), partitionKeyInfo_.begin(), partitionKeyInfo_.end());
   allKeyInfo_.insert(
       allKeyInfo_.cend(), sortKeyInfo_.begin(), sortKeyInfo_.end());
 
+  // Without partition keys all the input is a single partition, which has to
+  // be read back into memory as a whole. Spilling would not reduce the memory
+  // usage then.
+  if (!partitionKeyInfo_.empty() &&
+      windowNode->canSpill(driverCtx->queryConfig())) {
+    const auto spillConfig =
+        operatorCtx_->makeSpillConfig(Spiller::Type::kWindow);
+    if (spillConfig.has_value()) {
+      inputSpiller_ = std::make_unique<SortInputSpiller>(
+          Spiller::Type::kWindow,
+          data_.get(),
+          spillType_,
+          keyCompareFlags_,
+          spillConfig.value(),
+          driverCtx->queryConfig().windowSpillMemoryThreshold(),
+          pool());
+    }
+  }
+
   std::vector<exec::RowColumn> inputColumns;
   for (int i = 0; i < inputType->children().size(); i++) {
-    inputColumns.push_back(data_->columnAt(i));
+    inputColumns.push_back(data_->columnAt(inputToData[i]));
   }
   // The WindowPartition is structured over all the input columns data.
   // Individual functions access its input argument column values from it.
@@ -85,6 +145,12 @@ Window::Window(
       std::make_unique<WindowPartition>(inputColumns, inputType->children());
 
   createWindowFunctions(windowNode, inputType);
+
+  if (inputsSorted_) {
+    partitionStartRows_.push_back(0);
+    currentPartition_ = 0;
+    createPeerAndFrameBuffers();
+  }
 }
 
 Window::WindowFrame Window::createWindowFrame(
@@ -151,6 +217,10 @@ void Window::createWindowFunctions(
 }
 
 void Window::addInput(RowVectorPtr input) {
+  if (inputSpiller_ != nullptr) {
+    inputSpiller_->ensureInputFits(input);
+  }
+
   inputRows_.resize(input->size());
 
   for (auto col = 0; col < input->childrenSize(); ++col) {
@@ -158,14 +228,35 @@ void Window::addInput(RowVectorPtr input) {
   }
 
   // Add all the rows into the RowContainer.
+  const vector_size_t firstNewRow = sortedRows_.size();
   for (auto row = 0; row < input->size(); ++row) {
     char* newRow = data_->newRow();
 
-    for (auto col = 0; col < input->childrenSize(); ++col) {
-      data_->store(decodedInputVectors_[col], row, newRow, col);
+    for (const auto& columnProjection : columnMap_) {
+      data_->store(
+          decodedInputVectors_[columnProjection.outputChannel],
+          row,
+          newRow,
+          columnProjection.inputChannel);
+    }
+    if (inputsSorted_) {
+      sortedRows_.push_back(newRow);
     }
   }
   numRows_ += inputRows_.size();
+
+  if (inputsSorted_) {
+    updatePartitionStartRows(firstNewRow);
+  }
+
+  if (spiller() != nullptr) {
+    const auto spillStats = spiller()->stats();
+    auto lockedStats = stats_.wlock();
+    lockedStats->spilledBytes = spillStats.spilledBytes;
+    lockedStats->spilledRows = spillStats.spilledRows;
+    lockedStats->spilledPartitions = spillStats.spilledPartitions;
+    lockedStats->spilledFiles = spillStats.spilledFiles;
+  }
 }
 
 inline bool Window::compareRowsWithKeys(
@@ -239,21 +330,41 @@ void Window::computePartitionStartRows() {
   partitionStartRows_.push_back(sortedRows_.size());
 }
 
+void Window::updatePartitionStartRows(vector_size_t firstNewRow) {
+  VELOX_DCHECK_EQ(partitionStartRows_.back(), numProcessedRows_);
+  for (auto i = std::max(firstNewRow, 1); i < sortedRows_.size(); ++i) {
+    for (const auto& key : partitionKeyInfo_) {
+      if (data_->compare(sortedRows_[i - 1], sortedRows_[i], key.first)) {
+        partitionStartRows_.push_back(i);
+        break;
+      }
+    }
+  }
+}
+
+void Window::eraseOutputPartitions() {
+  VELOX_CHECK_EQ(numProcessedRows_, partitionStartRows_.back());
+  data_->eraseRows(folly::Range<char**>(sortedRows_.data(), numProcessedRows_));
+  sortedRows_.erase(
+      sortedRows_.begin(), sortedRows_.begin() + numProcessedRows_);
+  partitionStartRows_.clear();
+  partitionStartRows_.push_back(0);
+  numProcessedRows_ = 0;
+  currentPartition_ = 0;
+}
+
 void Window::sortPartitions() {
-  // This is a very inefficient but easy implementation to order the input rows
-  // by partition keys + sort keys.
-  // Sort the pointers to the rows in RowContainer (data_) instead of sorting
-  // the rows.
+  // Order the input rows by partition keys + sort keys, which are the keys of
+  // 'data_'. Sort the pointers to the rows in RowContainer (data_) instead of
+  // sorting the rows.
   sortedRows_.resize(numRows_);
   RowContainerIterator iter;
   data_->listRows(&iter, numRows_, sortedRows_.data());
 
-  std::sort(
-      sortedRows_.begin(),
-      sortedRows_.end(),
-      [this](const char* leftRow, const char* rightRow) {
-        return compareRowsWithKeys(leftRow, rightRow, allKeyInfo_);
-      });
+  PrefixSort::sort(
+      data_.get(),
+      keyCompareFlags_,
+      folly::Range<char**>(sortedRows_.data(), sortedRows_.size()));
 
   computePartitionStartRows();
 
@@ -268,6 +379,23 @@ void Window::noMoreInput() {
     return;
   }
 
+  if (inputsSorted_) {
+    // The last partition is complete.
+    partitionStartRows_.push_back(sortedRows_.size());
+    return;
+  }
+
+  if (spiller() != nullptr) {
+    // Spill the remaining rows and merge the sorted runs. The partitions are
+    // read back from the merge in getOutput().
+    Spiller::SpillRows nonSpilledRows = spiller()->finishSpill();
+    VELOX_CHECK(nonSpilledRows.empty());
+    VELOX_CHECK_NULL(spillMerge_);
+    spillMerge_ = spiller()->startMerge(0);
+    createPeerAndFrameBuffers();
+    return;
+  }
+
   // At this point we have seen all the input rows. We can start
   // outputting rows now.
   // However, some preparation is needed. The rows should be
@@ -277,6 +405,50 @@ void Window::noMoreInput() {
   createPeerAndFrameBuffers();
 }
 
+bool Window::isNewPartition(const char* row, SpillMergeStream& stream) {
+  const auto index = stream.currentIndex();
+  for (const auto& key : partitionKeyInfo_) {
+    const auto column = key.first;
+    if (data_->compare(
+            row, data_->columnAt(column), stream.decoded(column), index)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Window::loadSpilledPartitions() {
+  data_->clear();
+  sortedRows_.clear();
+  partitionStartRows_.clear();
+  partitionStartRows_.push_back(0);
+  numProcessedRows_ = 0;
+  currentPartition_ = 0;
+
+  const auto numColumns = spillType_->size();
+  while (auto* stream = spillMerge_->next()) {
+    if (!sortedRows_.empty() && isNewPartition(sortedRows_.back(), *stream)) {
+      if (sortedRows_.size() >= static_cast<size_t>(numRowsPerOutput_)) {
+        // Leave the next partition in the merge for the next call.
+        break;
+      }
+      partitionStartRows_.push_back(sortedRows_.size());
+    }
+
+    // The spilled rows have the same column order as 'data_'.
+    const auto index = stream->currentIndex();
+    char* newRow = data_->newRow();
+    for (auto col = 0; col < numColumns; ++col) {
+      data_->store(stream->decoded(col), index, newRow, col);
+    }
+    sortedRows_.push_back(newRow);
+    stream->pop();
+  }
+  VELOX_CHECK(!sortedRows_.empty());
+  partitionStartRows_.push_back(sortedRows_.size());
+  numSpilledRowsRead_ += sortedRows_.size();
+}
+
 void Window::callResetPartition(vector_size_t partitionNumber) {
   partitionOffset_ = 0;
   auto partitionSize = partitionStartRows_[partitionNumber + 1] -
@@ -581,22 +753,32 @@ void Window::callApplyLoop(
 }
 
 RowVectorPtr Window::getOutput() {
-  if (finished_ || !noMoreInput_) {
+  if (finished_ || (!noMoreInput_ && !inputsSorted_)) {
     return nullptr;
   }
 
-  auto numRowsLeft = numRows_ - numProcessedRows_;
+  if (spillMerge_ != nullptr && numProcessedRows_ == sortedRows_.size()) {
+    loadSpilledPartitions();
+  }
+
+  const vector_size_t numRowsLeft =
+      partitionStartRows_.back() - numProcessedRows_;
+  if (numRowsLeft == 0) {
+    // The input is sorted and no partition is complete yet.
+    VELOX_DCHECK(inputsSorted_);
+    return nullptr;
+  }
   auto numOutputRows = std::min(numRowsPerOutput_, numRowsLeft);
   auto result = std::dynamic_pointer_cast<RowVector>(
       BaseVector::create(outputType_, numOutputRows, operatorCtx_->pool()));
 
   // Set all passthrough input columns.
-  for (int i = 0; i < numInputColumns_; ++i) {
+  for (const auto& columnProjection : columnMap_) {
     data_->extractColumn(
         sortedRows_.data() + numProcessedRows_,
         numOutputRows,
-        i,
-        result->childAt(i));
+        columnProjection.inputChannel,
+        result->childAt(columnProjection.outputChannel));
   }
 
   // Construct vectors for the window function output columns.
@@ -615,7 +797,13 @@ RowVectorPtr Window::getOutput() {
     result->childAt(j) = windowOutputs[j - numInputColumns_];
   }
 
-  finished_ = (numProcessedRows_ == sortedRows_.size());
+  finished_ = (numProcessedRows_ == sortedRows_.size()) &&
+      (spillMerge_ == nullptr || numSpilledRowsRead_ == numRows_) &&
+      noMoreInput_;
+  if (inputsSorted_ && !finished_ &&
+      numProcessedRows_ == partitionStartRows_.back()) {
+    eraseOutputPartitions();
+  }
   return result;
 }
 
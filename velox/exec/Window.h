@@ -17,6 +17,7 @@
 
 #include "velox/exec/Operator.h"
 #include "velox/exec/RowContainer.h"
+#include "velox/exec/SortInputSpiller.h"
 #include "velox/exec/WindowFunction.h"
 #include "velox/exec/WindowPartition.h"
 
@@ -32,6 +33,18 @@ namespace facebook::velox::exec {
 /// It is also sorted in the order required for the WindowFunction
 /// to process it.
 ///
+/// If spilling is enabled and the input does not fit in memory, sorted runs
+/// of the input rows are spilled to disk. After all input is received the
+/// runs are merged and the partitions are read back into memory a few at a
+/// time, so that the memory usage is bounded by the largest partition rather
+/// than by the whole input.
+///
+/// If the WindowNode specifies that the input is already sorted, the input is
+/// not sorted again. The rows of a partition are buffered until the first row
+/// of the next partition arrives, then the partition is output before more
+/// input is accepted. Only the partitions being output and the partition being
+/// received are kept in memory.
+///
 /// We will revise this algorithm in the future using a HashTable based
 /// approach pending some profiling results.
 class Window : public Operator {
@@ -46,6 +59,10 @@ class Window : public Operator {
   RowVectorPtr getOutput() override;
 
   bool needsInput() const override {
+    if (inputsSorted_) {
+      // Output the complete partitions before accepting more input.
+      return !noMoreInput_ && numProcessedRows_ == partitionStartRows_.back();
+    }
     return !noMoreInput_;
   }
 
@@ -80,6 +97,30 @@ class Window : public Operator {
     const std::optional<FrameChannelArg> end;
   };
 
+  // Returns the Spiller of 'inputSpiller_', nullptr if nothing has been
+  // spilled.
+  Spiller* spiller() const {
+    return inputSpiller_ == nullptr ? nullptr : inputSpiller_->spiller();
+  }
+
+  // Clears 'data_' and reads the next partitions from 'spillMerge_' into it.
+  // Reads whole partitions until at least 'numRowsPerOutput_' rows are read
+  // or the spilled rows are exhausted. Sets up 'sortedRows_' and
+  // 'partitionStartRows_' for the partitions read.
+  void loadSpilledPartitions();
+
+  // Returns true if the current row of 'stream' is in a different partition
+  // than 'row' in 'data_'.
+  bool isNewPartition(const char* row, SpillMergeStream& stream);
+
+  // Records the start of each partition in the rows of 'sortedRows_' from
+  // 'firstNewRow' on in 'partitionStartRows_'. Used if the input is sorted.
+  void updatePartitionStartRows(vector_size_t firstNewRow);
+
+  // Erases the rows of the partitions which have been output from 'data_'.
+  // Used if the input is sorted.
+  void eraseOutputPartitions();
+
   // Helper function to create WindowFunction and frame objects
   // for this operator.
   void createWindowFunctions(
@@ -162,11 +203,28 @@ class Window : public Operator {
   const vector_size_t outputBatchSizeInBytes_;
   const vector_size_t numInputColumns_;
 
+  // True if the input is clustered by the partition keys and sorted by the
+  // sort keys. The partitions are then output as they are complete.
+  const bool inputsSorted_;
+
   // The Window operator needs to see all the input rows before starting
   // any function computation. As the Window operators gets input rows
-  // we store the rows in the RowContainer (data_).
+  // we store the rows in the RowContainer (data_). The partition and sort
+  // key columns are stored first as the keys of 'data_', followed by the
+  // other input columns as dependents. This allows to sort and spill the
+  // rows by the RowContainer keys.
   std::unique_ptr<RowContainer> data_;
 
+  // The map from the column in 'data_' (inputChannel) to the corresponding
+  // input column (outputChannel).
+  std::vector<IdentityProjection> columnMap_;
+
+  // Compare flags of the key columns in 'data_'.
+  std::vector<CompareFlags> keyCompareFlags_;
+
+  // The row type of 'data_' used for spilling.
+  RowTypePtr spillType_;
+
   // The decodedInputVectors_ are reused across addInput() calls to decode
   // the partition and sort keys for the above RowContainer.
   std::vector<DecodedVector> decodedInputVectors_;
@@ -175,10 +233,10 @@ class Window : public Operator {
   // buffers.
   HashStringAllocator stringAllocator_;
 
-  // The below 3 vectors represent the ChannelIndex of the partition keys,
-  // the order by keys and the concatenation of the 2. These keyInfo are
-  // used for sorting by those key combinations during the processing.
-  // partitionKeyInfo_ is used to separate partitions in the rows.
+  // The below 3 vectors represent the column index in 'data_' of the
+  // partition keys, the order by keys and the concatenation of the 2. These
+  // keyInfo are used for sorting by those key combinations during the
+  // processing. partitionKeyInfo_ is used to separate partitions in the rows.
   // sortKeyInfo_ is used to identify peer rows in a partition.
   // allKeyInfo_ is a combination of (partitionKeyInfo_ and sortKeyInfo_).
   // It is used to perform a full sorting of the input rows to be able to
@@ -204,7 +262,8 @@ class Window : public Operator {
   // Vector of pointers to each input row in the data_ RowContainer.
   // The rows are sorted by partitionKeys + sortKeys. This total
   // ordering can be used to split partitions (with the correct
-  // order by) for the processing.
+  // order by) for the processing. If the input was spilled, these are only
+  // the rows of the partitions read back from the spill.
   std::vector<char*> sortedRows_;
 
   // Window partition object used to provide per-partition
@@ -217,7 +276,10 @@ class Window : public Operator {
   // This is a vector that gives the index of the start row
   // (in sortedRows_) of each partition in the RowContainer data_.
   // This auxiliary structure helps demarcate partitions in
-  // getOutput calls.
+  // getOutput calls. The last element is the end of the last
+  // partition which can be output. If the input is sorted and
+  // not all received, this is the start of the partition being
+  // received.
   std::vector<vector_size_t> partitionStartRows_;
 
   // The following 4 Buffers are used to pass peer and frame start and
@@ -266,6 +328,16 @@ class Window : public Operator {
 
   // Tracks how far along the partition rows have been output.
   vector_size_t partitionOffset_ = 0;
+
+  // Spills the rows of 'data_' to make the input fit in memory if spilling
+  // is enabled, otherwise null.
+  std::unique_ptr<SortInputSpiller> inputSpiller_;
+
+  // Set to read back spilled data if disk spilling has been triggered.
+  std::unique_ptr<TreeOfLosers<SpillMergeStream>> spillMerge_;
+
+  // Number of rows read back from 'spillMerge_' so far.
+  vector_size_t numSpilledRowsRead_ = 0;
 };
 
 } // namespace facebook::velox::exec
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/Benchmark.h>
+#include <folly/hash/Hash.h>
+#include <folly/init/Init.h>
+#include "velox/exec/PrefixSort.h"
+#include "velox/vector/tests/utils/VectorMaker.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::test;
+
+namespace {
+
+// Rows of a RowContainer with all columns of a RowVector as keys.
+class SortInput {
+ public:
+  explicit SortInput(
+      std::function<std::vector<VectorPtr>(VectorMaker&)> makeKeys) {
+    auto keys = makeKeys(vectorMaker_);
+    std::vector<TypePtr> keyTypes;
+    for (const auto& key : keys) {
+      keyTypes.push_back(key->type());
+    }
+    container_ = std::make_unique<RowContainer>(
+        keyTypes, std::vector<TypePtr>{}, pool_.get());
+    const auto numRows = keys[0]->size();
+    SelectivityVector allRows(numRows);
+    rows_.resize(numRows);
+    for (auto i = 0; i < numRows; ++i) {
+      rows_[i] = container_->newRow();
+    }
+    for (auto column = 0; column < keys.size(); ++column) {
+      DecodedVector decoded(*keys[column], allRows);
+      for (auto i = 0; i < numRows; ++i) {
+        container_->store(decoded, i, rows_[i], column);
+      }
+    }
+  }
+
+  void stdSort() {
+    auto rows = rows_;
+    std::sort(
+        rows.begin(), rows.end(), [&](const char* left, const char* right) {
+          return container_->compareRows(left, right) < 0;
+        });
+    folly::doNotOptimizeAway(rows);
+  }
+
+  void prefixSort() {
+    auto rows = rows_;
+    PrefixSort::sort(
+        container_.get(), {}, folly::Range<char**>(rows.data(), rows.size()));
+    folly::doNotOptimizeAway(rows);
+  }
+
+ private:
+  std::shared_ptr<memory::MemoryPool> pool_{memory::getDefaultMemoryPool()};
+  VectorMaker vectorMaker_{pool_.get()};
+  std::unique_ptr<RowContainer> container_;
+  std::vector<char*> rows_;
+};
+
+constexpr vector_size_t kNumRows = 1'000'000;
+
+int64_t randomAt(vector_size_t row) {
+  return folly::hash::twang_mix64(row);
+}
+
+SortInput& bigintInput() {
+  static SortInput input([](VectorMaker& maker) {
+    return std::vector<VectorPtr>{
+        maker.flatVector<int64_t>(kNumRows, randomAt, maker.nullEvery(100))};
+  });
+  return input;
+}
+
+SortInput& twoIntegersInput() {
+  static SortInput input([](VectorMaker& maker) {
+    return std::vector<VectorPtr>{
+        maker.flatVector<int32_t>(
+            kNumRows, [](auto row) { return randomAt(row) % 1'000; }),
+        maker.flatVector<int32_t>(kNumRows, [](auto row) {
+          return static_cast<int32_t>(randomAt(row + kNumRows));
+        })};
+  });
+  return input;
+}
+
+SortInput& shortStringInput() {
+  static std::vector<std::string> strings = [] {
+    std::vector<std::string> result;
+    for (auto i = 0; i < 10'000; ++i) {
+      result.push_back(fmt::format("{:x}", randomAt(i) % 100'000'000'000));
+    }
+    return result;
+  }();
+  static SortInput input([](VectorMaker& maker) {
+    return std::vector<VectorPtr>{maker.flatVector<StringView>(
+        kNumRows, [](auto row) {
+          const auto& value = strings[randomAt(row) % strings.size()];
+          return StringView(value.data(), value.size());
+        })};
+  });
+  return input;
+}
+
+SortInput& doubleInput() {
+  static SortInput input([](VectorMaker& maker) {
+    return std::vector<VectorPtr>{maker.flatVector<double>(
+        kNumRows, [](auto row) { return randomAt(row) / 7.0; })};
+  });
+  return input;
+}
+
+BENCHMARK(stdSortBigint) {
+  bigintInput().stdSort();
+}
+
+BENCHMARK_RELATIVE(prefixSortBigint) {
+  bigintInput().prefixSort();
+}
+
+BENCHMARK(stdSortTwoIntegers) {
+  twoIntegersInput().stdSort();
+}
+
+BENCHMARK_RELATIVE(prefixSortTwoIntegers) {
+  twoIntegersInput().prefixSort();
+}
+
+BENCHMARK(stdSortShortString) {
+  shortStringInput().stdSort();
+}
+
+BENCHMARK_RELATIVE(prefixSortShortString) {
+  shortStringInput().prefixSort();
+}
+
+// Keys that are not encoded into a prefix fall back to std::sort.
+BENCHMARK(stdSortDouble) {
+  doubleInput().stdSort();
+}
+
+BENCHMARK_RELATIVE(prefixSortDouble) {
+  doubleInput().prefixSort();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -678,6 +678,57 @@ TEST_F(AggregationTest, partialAggregationMemoryLimit) {
           .customStats.count("flushRowCount"));
 }
 
+TEST_F(AggregationTest, abandonPartialAggregation) {
+  // Near-unique keys in c0 and a few distinct keys in c1.
+  std::vector<RowVectorPtr> vectors;
+  for (auto i = 0; i < 10; ++i) {
+    vectors.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            1'000, [&](auto row) { return i * 1'000 + row; }, nullEvery(97)),
+        makeFlatVector<int32_t>(1'000, [](auto row) { return row % 7; }),
+        makeFlatVector<int64_t>(
+            1'000, [](auto row) { return row * 3; }, nullEvery(11)),
+    }));
+  }
+  createDuckDbTable(vectors);
+
+  struct {
+    std::vector<std::string> keys;
+    std::vector<std::string> aggregates;
+    std::string duckDbSql;
+    bool expectedAbandon;
+  } testSettings[] = {
+      {{"c0"},
+       {"sum(c2)", "count(1)", "max(c1)"},
+       "SELECT c0, sum(c2), count(1), max(c1) FROM tmp GROUP BY 1",
+       true},
+      {{"c0"}, {}, "SELECT distinct c0 FROM tmp", true},
+      {{"c1"},
+       {"sum(c2)", "count(1)"},
+       "SELECT c1, sum(c2), count(1) FROM tmp GROUP BY 1",
+       false}};
+  for (const auto& testData : testSettings) {
+    SCOPED_TRACE(testData.duckDbSql);
+    core::PlanNodeId aggNodeId;
+    auto task =
+        AssertQueryBuilder(duckDbQueryRunner_)
+            .config(QueryConfig::kAbandonPartialAggregationMinRows, "2000")
+            .config(QueryConfig::kAbandonPartialAggregationMinPct, "80")
+            .plan(PlanBuilder()
+                      .values(vectors)
+                      .partialAggregation(testData.keys, testData.aggregates)
+                      .capturePlanNodeId(aggNodeId)
+                      .finalAggregation()
+                      .planNode())
+            .assertResults(testData.duckDbSql);
+    const auto runtimeStats =
+        toPlanStats(task->taskStats()).at(aggNodeId).customStats;
+    EXPECT_EQ(
+        testData.expectedAbandon,
+        runtimeStats.count("abandonedPartialAggregation") > 0);
+  }
+}
+
 TEST_F(AggregationTest, partialAggregationMemoryLimitIncrease) {
   constexpr int64_t kGB = 1 << 30;
   constexpr int64_t kB = 1 << 10;
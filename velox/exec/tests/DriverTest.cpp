@@ -18,6 +18,7 @@
 #include <velox/exec/Driver.h>
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/dwio/common/tests/utils/BatchMaker.h"
+#include "velox/exec/TaskExecutor.h"
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/Cursor.h"
 #include "velox/exec/tests/utils/OperatorTestBase.h"
@@ -504,6 +505,35 @@ TEST_F(DriverTest, yield) {
   }
 }
 
+TEST_F(DriverTest, timeSlice) {
+  int32_t hits;
+  auto plan = makeValuesFilterProject(
+      rowType_,
+      "m1 % 10 > 0",
+      "m1 % 3 + m2 % 5 + m3 % 7 + m4 % 11 + m5 % 13 + m6 % 17 + m7 % 19",
+      200,
+      2'000,
+      [](int64_t num) { return num % 10 > 0; },
+      &hits);
+  TaskExecutor::Options options;
+  options.numThreads = 2;
+  TaskExecutor executor(options);
+  auto queryCtx = std::make_shared<core::QueryCtx>(
+      &executor,
+      std::make_shared<core::MemConfig>(
+          std::unordered_map<std::string, std::string>{
+              {core::QueryConfig::kDriverTimeSliceLimitMs, "1"}}));
+  // The Drivers yield after each millisecond on thread and are queued again
+  // on 'executor'.
+  auto task = AssertQueryBuilder(plan)
+                  .queryCtx(queryCtx)
+                  .maxDrivers(4)
+                  .assertTypeAndNumRows(plan->outputType(), 4 * hits);
+  EXPECT_GT(task->numDriverYields(), 0);
+  EXPECT_GT(task->driverCpuTimeNanos(), 0);
+  EXPECT_GT(executor.levelCpuNanos(0), 0);
+}
+
 // A testing Operator that periodically does one of the following:
 //
 // 1. Blocks and registers a resume that continues the Driver after a timed
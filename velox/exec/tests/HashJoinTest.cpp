@@ -4056,6 +4056,82 @@ TEST_F(HashJoinTest, dynamicFilters) {
   }
 }
 
+TEST_F(HashJoinTest, bloomFilterDynamicFilters) {
+  const int32_t numSplits = 5;
+  const int32_t numRowsProbe = 1'000;
+  const int32_t numRowsBuild = 100;
+
+  // String keys have no exact dynamic filter, so a Bloom filter is pushed
+  // down when enabled.
+  std::vector<RowVectorPtr> probeVectors;
+  std::vector<std::shared_ptr<TempFilePath>> tempFiles;
+  std::vector<exec::Split> probeSplits;
+  for (int32_t i = 0; i < numSplits; ++i) {
+    auto rowVector = makeRowVector({
+        makeFlatVector<std::string>(
+            numRowsProbe,
+            [&](auto row) { return fmt::format("key-{}", row + i * 100); }),
+        makeFlatVector<int64_t>(numRowsProbe, [](auto row) { return row; }),
+    });
+    probeVectors.push_back(rowVector);
+    tempFiles.push_back(TempFilePath::create());
+    writeToFile(tempFiles.back()->path, rowVector);
+    probeSplits.push_back(
+        exec::Split(makeHiveConnectorSplit(tempFiles.back()->path)));
+  }
+
+  std::vector<RowVectorPtr> buildVectors = {makeRowVector({
+      makeFlatVector<std::string>(
+          numRowsBuild,
+          [](auto row) { return fmt::format("key-{}", 7 * row); }),
+      makeFlatVector<int64_t>(numRowsBuild, [](auto row) { return row; }),
+  })};
+
+  createDuckDbTable("t", probeVectors);
+  createDuckDbTable("u", buildVectors);
+
+  auto probeType = ROW({"c0", "c1"}, {VARCHAR(), BIGINT()});
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId probeScanId;
+  auto op = PlanBuilder(planNodeIdGenerator)
+                .tableScan(probeType)
+                .capturePlanNodeId(probeScanId)
+                .hashJoin(
+                    {"c0"},
+                    {"u_c0"},
+                    PlanBuilder(planNodeIdGenerator)
+                        .values(buildVectors)
+                        .project({"c0 AS u_c0", "c1 AS u_c1"})
+                        .planNode(),
+                    "",
+                    {"c0", "c1", "u_c1"},
+                    core::JoinType::kInner)
+                .planNode();
+
+  SplitInput splits;
+  splits.emplace(probeScanId, probeSplits);
+
+  HashJoinBuilder(*pool_, duckDbQueryRunner_, driverExecutor_.get())
+      .planNode(std::move(op))
+      .inputSplits(splits)
+      .config(core::QueryConfig::kHashProbeBloomFilterPushdownMaxSize, "1000")
+      .referenceQuery("SELECT t.c0, t.c1, u.c1 FROM t, u WHERE t.c0 = u.c0")
+      .verifier([&](const std::shared_ptr<Task>& task, bool hasSpill) {
+        SCOPED_TRACE(fmt::format("hasSpill:{}", hasSpill));
+        if (hasSpill) {
+          ASSERT_EQ(0, getFiltersProduced(task, 1).sum);
+          ASSERT_EQ(0, getFiltersAccepted(task, 0).sum);
+          return;
+        }
+        ASSERT_EQ(1, getFiltersProduced(task, 1).sum);
+        ASSERT_EQ(1, getFiltersAccepted(task, 0).sum);
+        // A Bloom filter may pass false positives, so the join is kept.
+        ASSERT_EQ(0, getReplacedWithFilterRows(task, 1).sum);
+        ASSERT_LT(getInputPositions(task, 1), numRowsProbe * numSplits);
+      })
+      .run();
+}
+
 // Verify the size of the join output vectors when projecting build-side
 // variable-width column.
 TEST_F(HashJoinTest, memoryUsage) {
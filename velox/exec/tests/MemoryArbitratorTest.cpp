@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/MemoryArbitrator.h"
+#include <folly/executors/ManualExecutor.h>
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/common/file/FileSystems.h"
+#include "velox/common/testutil/TestValue.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/QueryAssertions.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+
+using facebook::velox::core::QueryConfig;
+using namespace facebook::velox::common::testutil;
+
+namespace facebook::velox::exec::test {
+namespace {
+
+constexpr int64_t kMB = 1 << 20;
+
+class MemoryArbitratorTest : public OperatorTestBase {
+ protected:
+  static void SetUpTestCase() {
+    OperatorTestBase::SetUpTestCase();
+    TestValue::enable();
+  }
+
+  void SetUp() override {
+    OperatorTestBase::SetUp();
+    filesystems::registerLocalFileSystem();
+  }
+
+  void TearDown() override {
+    MemoryArbitrator::setInstance(nullptr);
+    OperatorTestBase::TearDown();
+  }
+
+  // Returns a Task that is not started, of a query with 'maxMemory'.
+  std::shared_ptr<Task> makeTask(const std::string& taskId, int64_t maxMemory) {
+    auto queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+    queryCtx->pool()->getMemoryUsageTracker()->setMaxMemory(maxMemory);
+    auto plan = PlanBuilder()
+                    .values({makeRowVector({makeFlatVector<int64_t>({1})})})
+                    .planFragment();
+    return std::make_shared<Task>(taskId, plan, 0, queryCtx);
+  }
+};
+
+TEST_F(MemoryArbitratorTest, growAndShrink) {
+  auto arbitrator = std::make_shared<MemoryArbitrator>(
+      MemoryArbitrator::Options{256 * kMB, 64 * kMB, 32 * kMB});
+  auto first = makeTask("first", 128 * kMB);
+  auto second = makeTask("second", 512 * kMB);
+  const auto& firstTracker = first->queryCtx()->pool()->getMemoryUsageTracker();
+  const auto& secondTracker =
+      second->queryCtx()->pool()->getMemoryUsageTracker();
+  arbitrator->addTask(first);
+  arbitrator->addTask(second);
+  EXPECT_EQ(64 * kMB, arbitrator->queryCapacity(*firstTracker));
+  EXPECT_EQ(64 * kMB, firstTracker->maxMemory());
+  EXPECT_EQ(128 * kMB, arbitrator->freeCapacity());
+
+  // The query grows by at least 'minGrowBytes'.
+  auto firstLeaf = firstTracker->addChild();
+  firstLeaf->update(80 * kMB);
+  EXPECT_EQ(96 * kMB, arbitrator->queryCapacity(*firstTracker));
+  EXPECT_EQ(96 * kMB, firstTracker->maxMemory());
+  EXPECT_EQ(96 * kMB, arbitrator->freeCapacity());
+
+  // The second query takes the free capacity and the unused capacity of the
+  // first query.
+  auto secondLeaf = secondTracker->addChild();
+  secondLeaf->update(176 * kMB);
+  EXPECT_EQ(176 * kMB, arbitrator->queryCapacity(*secondTracker));
+  EXPECT_EQ(80 * kMB, arbitrator->queryCapacity(*firstTracker));
+  EXPECT_EQ(0, arbitrator->freeCapacity());
+  EXPECT_EQ(16 * kMB, arbitrator->stats().shrunkBytes);
+
+  // Nothing is left to grow the first query. The allocation fails.
+  VELOX_ASSERT_THROW(firstLeaf->update(8 * kMB), "Exceeded memory cap");
+  EXPECT_EQ(80 * kMB, arbitrator->queryCapacity(*firstTracker));
+  EXPECT_EQ(1, arbitrator->stats().numFailures);
+
+  // A query can't grow beyond its max memory.
+  firstLeaf->update(-80 * kMB);
+  VELOX_ASSERT_THROW(firstLeaf->update(136 * kMB), "Exceeded memory cap");
+
+  // Removing the last Task of a query frees its capacity and restores its
+  // limit.
+  secondLeaf->update(-176 * kMB);
+  arbitrator->removeTask(*second);
+  EXPECT_EQ(-1, arbitrator->queryCapacity(*secondTracker));
+  EXPECT_EQ(512 * kMB, secondTracker->maxMemory());
+  EXPECT_EQ(176 * kMB, arbitrator->freeCapacity());
+  arbitrator->removeTask(*first);
+  EXPECT_EQ(128 * kMB, firstTracker->maxMemory());
+  EXPECT_EQ(256 * kMB, arbitrator->freeCapacity());
+}
+
+TEST_F(MemoryArbitratorTest, keepExternalPause) {
+  auto arbitrator = std::make_shared<MemoryArbitrator>(
+      MemoryArbitrator::Options{128 * kMB, 64 * kMB, 0});
+  auto first = makeTask("first", 128 * kMB);
+  auto second = makeTask("second", 128 * kMB);
+  arbitrator->addTask(first);
+  arbitrator->addTask(second);
+  auto firstLeaf =
+      first->queryCtx()->pool()->getMemoryUsageTracker()->addChild();
+  firstLeaf->update(64 * kMB);
+  first->requestPause(true).wait();
+
+  // The second query has to reclaim memory. The first Task is paused by
+  // someone else, so it is neither reclaimed from nor resumed.
+  auto secondLeaf =
+      second->queryCtx()->pool()->getMemoryUsageTracker()->addChild();
+  VELOX_ASSERT_THROW(secondLeaf->update(96 * kMB), "Exceeded memory cap");
+  EXPECT_EQ(1, arbitrator->stats().numReclaims);
+  EXPECT_TRUE(first->pauseRequested());
+  EXPECT_FALSE(second->pauseRequested());
+
+  Task::resume(first);
+  firstLeaf->update(-64 * kMB);
+  arbitrator->removeTask(*first);
+  arbitrator->removeTask(*second);
+}
+
+DEBUG_ONLY_TEST_F(MemoryArbitratorTest, reclaimWithEnqueuedDriver) {
+  // The Driver waits on 'executor' until drained.
+  folly::ManualExecutor executor;
+  auto plan = PlanBuilder()
+                  .values({makeRowVector({makeFlatVector<int64_t>({1, 2, 3})})})
+                  .orderBy({"c0"}, false)
+                  .planFragment();
+  int64_t numRows = 0;
+  auto task = std::make_shared<Task>(
+      "task",
+      plan,
+      0,
+      std::make_shared<core::QueryCtx>(&executor),
+      [&](RowVectorPtr vector, ContinueFuture* /*future*/) {
+        if (vector != nullptr) {
+          numRows += vector->size();
+        }
+        return BlockingReason::kNotBlocked;
+      });
+  Task::start(task, 1);
+  task->requestPause(true).wait();
+
+  // The enqueued Driver goes on thread while reclaiming. Its pipeline is not
+  // reclaimed from, so the Driver just sees the pause.
+  std::atomic<bool> reclaiming{false};
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::Task::reclaim",
+      std::function<void(Task*)>([&](Task* /*task*/) {
+        reclaiming = true;
+        executor.drain();
+      }));
+  EXPECT_EQ(0, task->reclaim(kMB));
+  EXPECT_TRUE(reclaiming);
+
+  Task::resume(task);
+  executor.drain();
+  EXPECT_EQ(TaskState::kFinished, task->state());
+  EXPECT_EQ(3, numRows);
+}
+
+DEBUG_ONLY_TEST_F(MemoryArbitratorTest, reclaimFromAggregation) {
+  constexpr int32_t kNumBatches = 10;
+  constexpr int32_t kBatchSize = 1'000;
+  std::vector<RowVectorPtr> batches;
+  for (int32_t i = 0; i < kNumBatches; ++i) {
+    batches.push_back(makeRowVector({
+        makeFlatVector<int64_t>(
+            kBatchSize, [i](auto row) { return i * kBatchSize + row; }),
+        makeFlatVector<int64_t>(kBatchSize, [](auto row) { return row % 7; }),
+    }));
+  }
+  createDuckDbTable(batches);
+
+  // The query gets all the capacity, so growing it has to reclaim memory
+  // from the query itself.
+  auto arbitrator = std::make_shared<MemoryArbitrator>(
+      MemoryArbitrator::Options{64 * kMB, 64 * kMB, 0});
+  MemoryArbitrator::setInstance(arbitrator);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId aggregationId;
+  CursorParameters params;
+  params.planNode =
+      PlanBuilder(planNodeIdGenerator)
+          .localPartition(
+              {}, {PlanBuilder(planNodeIdGenerator).values(batches).planNode()})
+          .singleAggregation({"c0"}, {"sum(c1)"})
+          .capturePlanNodeId(aggregationId)
+          .planNode();
+  params.queryCtx = std::make_shared<core::QueryCtx>(executor_.get());
+  params.queryCtx->setConfigOverridesUnsafe({
+      {QueryConfig::kSpillEnabled, "true"},
+      {QueryConfig::kAggregationSpillEnabled, "true"},
+  });
+  auto spillDirectory = TempDirectoryPath::create();
+  params.spillDirectory = spillDirectory->path;
+
+  std::atomic<Task*> task{nullptr};
+  std::atomic<bool> requested{false};
+  SCOPED_TESTVALUE_SET(
+      "facebook::velox::exec::Values::getOutput",
+      std::function<void(const int32_t*)>([&](const int32_t* outputIdx) {
+        if (*outputIdx != kNumBatches || requested.exchange(true)) {
+          return;
+        }
+        // Wait for the aggregation in the other pipeline to take all the
+        // input, so that it is off thread and holds the groups.
+        while (toPlanStats(task.load()->taskStats())
+                   .at(aggregationId)
+                   .inputRows < kNumBatches * kBatchSize) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(10)); // NOLINT
+        }
+        // Exceed the capacity from the Values Driver. The aggregation is
+        // spilled whether or not this frees enough memory.
+        auto tracker =
+            params.queryCtx->pool()->getMemoryUsageTracker()->addChild();
+        try {
+          tracker->update(arbitrator->capacity());
+          tracker->update(-arbitrator->capacity());
+        } catch (const VeloxException&) {
+        }
+      }));
+
+  auto result = test::assertQuery(
+      params,
+      [&](Task* newTask) { task = newTask; },
+      "SELECT c0, sum(c1) FROM tmp GROUP BY 1",
+      duckDbQueryRunner_);
+  EXPECT_TRUE(requested);
+  EXPECT_LE(1, arbitrator->stats().numReclaims);
+  EXPECT_LT(0, arbitrator->stats().reclaimedBytes);
+  EXPECT_LT(0, toPlanStats(result->taskStats()).at(aggregationId).spilledBytes);
+  OperatorTestBase::deleteTaskAndCheckSpillDirectory(result);
+}
+
+} // namespace
+} // namespace facebook::velox::exec::test
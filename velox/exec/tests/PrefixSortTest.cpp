@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/PrefixSort.h"
+#include <gtest/gtest.h>
+#include "velox/exec/tests/utils/RowContainerTestBase.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+namespace {
+
+class PrefixSortTest : public exec::test::RowContainerTestBase {
+ protected:
+  // Stores 'data' in a container with all columns as keys, sorts the rows
+  // with each of the combinations of sort orders and checks that the result
+  // is ordered by RowContainer::compareRows().
+  void testSort(const RowVectorPtr& data) {
+    std::vector<TypePtr> keyTypes;
+    for (const auto& child : data->children()) {
+      keyTypes.push_back(child->type());
+    }
+    auto container = makeRowContainer(keyTypes, {}, false);
+    const auto numRows = data->size();
+    SelectivityVector allRows(numRows);
+    std::vector<char*> rows(numRows);
+    for (auto i = 0; i < numRows; ++i) {
+      rows[i] = container->newRow();
+    }
+    for (auto column = 0; column < keyTypes.size(); ++column) {
+      DecodedVector decoded(*data->childAt(column), allRows);
+      for (auto i = 0; i < numRows; ++i) {
+        container->store(decoded, i, rows[i], column);
+      }
+    }
+
+    std::vector<std::vector<CompareFlags>> testFlags = {{}};
+    for (auto ascending : {true, false}) {
+      for (auto nullsFirst : {true, false}) {
+        std::vector<CompareFlags> flags;
+        for (auto i = 0; i < keyTypes.size(); ++i) {
+          // Alternate the order of the keys.
+          flags.push_back(
+              {i % 2 ? !nullsFirst : nullsFirst,
+               i % 2 ? !ascending : ascending});
+        }
+        testFlags.push_back(flags);
+      }
+    }
+
+    std::vector<char*> expectedRows = rows;
+    std::sort(expectedRows.begin(), expectedRows.end());
+    for (const auto& flags : testFlags) {
+      auto sortedRows = rows;
+      PrefixSort::sort(
+          container.get(),
+          flags,
+          folly::Range<char**>(sortedRows.data(), sortedRows.size()));
+      for (auto i = 1; i < numRows; ++i) {
+        ASSERT_LE(
+            container->compareRows(sortedRows[i - 1], sortedRows[i], flags),
+            0)
+            << "at row " << i;
+      }
+      std::sort(sortedRows.begin(), sortedRows.end());
+      ASSERT_EQ(expectedRows, sortedRows);
+    }
+  }
+};
+
+TEST_F(PrefixSortTest, prefixKeys) {
+  auto container = makeRowContainer({BIGINT(), INTEGER()}, {}, false);
+  EXPECT_EQ(
+      std::make_pair(2, 1 + 8 + 1 + 4), PrefixSort::prefixKeys(*container));
+
+  // Keys after a string are not encoded.
+  container = makeRowContainer({SMALLINT(), VARCHAR(), BIGINT()}, {}, false);
+  EXPECT_EQ(
+      std::make_pair(2, 1 + 2 + 1 + PrefixSort::kMaxStringPrefixBytes),
+      PrefixSort::prefixKeys(*container));
+
+  // Keys after a type that cannot be encoded are not encoded.
+  container = makeRowContainer({INTEGER(), DOUBLE(), INTEGER()}, {}, false);
+  EXPECT_EQ(std::make_pair(1, 1 + 4), PrefixSort::prefixKeys(*container));
+
+  container = makeRowContainer({DOUBLE(), INTEGER()}, {}, false);
+  EXPECT_EQ(std::make_pair(0, 0), PrefixSort::prefixKeys(*container));
+
+  // Keys that exceed the max prefix size are not encoded.
+  std::vector<TypePtr> keyTypes(10, BIGINT());
+  container = makeRowContainer(keyTypes, {}, false);
+  EXPECT_EQ(
+      std::make_pair(7, 7 * (1 + 8)), PrefixSort::prefixKeys(*container));
+}
+
+TEST_F(PrefixSortTest, integers) {
+  const vector_size_t size = 10'000;
+  testSort(makeRowVector({
+      makeFlatVector<int64_t>(
+          size,
+          [](auto row) { return (row * 7919) % 1'000 - 500; },
+          nullEvery(17)),
+      makeFlatVector<int32_t>(
+          size, [](auto row) { return row % 3 - 1; }, nullEvery(5)),
+      makeFlatVector<int16_t>(size, [](auto row) { return row % 101; }),
+      makeFlatVector<bool>(size, [](auto row) { return row % 3 == 0; }),
+  }));
+
+  // Extreme values.
+  testSort(makeRowVector({
+      makeFlatVector<int64_t>(
+          size,
+          [](auto row) {
+            switch (row % 4) {
+              case 0:
+                return std::numeric_limits<int64_t>::min();
+              case 1:
+                return std::numeric_limits<int64_t>::max();
+              default:
+                return static_cast<int64_t>(row) - 5'000;
+            }
+          }),
+      makeFlatVector<int8_t>(
+          size, [](auto row) { return static_cast<int8_t>(row); }),
+  }));
+}
+
+TEST_F(PrefixSortTest, dates) {
+  const vector_size_t size = 5'000;
+  testSort(makeRowVector({
+      makeFlatVector<Date>(
+          size,
+          [](auto row) { return Date(row % 211 - 100); },
+          nullEvery(11)),
+      makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+  }));
+}
+
+TEST_F(PrefixSortTest, strings) {
+  const vector_size_t size = 5'000;
+  // Strings of different lengths with common prefixes longer than the
+  // prefix, including a zero byte that is also used for padding.
+  std::vector<std::string> strings;
+  for (auto i = 0; i < 50; ++i) {
+    strings.push_back(std::string(i % 20, 'a' + i % 3) + std::to_string(i));
+  }
+  strings.push_back(std::string("ab\0", 3));
+  strings.push_back("ab");
+  strings.push_back("");
+  testSort(makeRowVector({
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 4; }),
+      makeFlatVector<StringView>(
+          size,
+          [&](auto row) {
+            const auto& value = strings[(row * 31) % strings.size()];
+            return StringView(value.data(), value.size());
+          },
+          nullEvery(7)),
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 13; }),
+  }));
+}
+
+TEST_F(PrefixSortTest, unsupportedKeys) {
+  const vector_size_t size = 5'000;
+  // The leading key cannot be encoded.
+  testSort(makeRowVector({
+      makeFlatVector<double>(
+          size, [](auto row) { return row % 23 / 3.0; }, nullEvery(9)),
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 7; }),
+  }));
+
+  // The second key cannot be encoded.
+  testSort(makeRowVector({
+      makeFlatVector<int32_t>(size, [](auto row) { return row % 7; }),
+      makeFlatVector<double>(
+          size, [](auto row) { return row % 23 / 3.0; }, nullEvery(9)),
+  }));
+}
+
+TEST_F(PrefixSortTest, fewRows) {
+  for (auto size : {0, 1, 2, 63, 64, 65}) {
+    SCOPED_TRACE(fmt::format("size: {}", size));
+    testSort(makeRowVector({
+        makeFlatVector<int64_t>(
+            size, [](auto row) { return row % 5; }, nullEvery(3)),
+    }));
+  }
+}
+
+} // namespace
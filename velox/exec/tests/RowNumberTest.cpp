@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec::test;
+
+namespace {
+
+class RowNumberTest : public OperatorTestBase {
+ protected:
+  // Returns batches with a unique, increasing c0, a partition key with
+  // 'numPartitions' values and nulls in c1 and a string partition key in c2.
+  std::vector<RowVectorPtr> makeBatches(
+      int32_t numBatches,
+      vector_size_t batchSize,
+      int32_t numPartitions) {
+    std::vector<RowVectorPtr> batches;
+    for (int32_t i = 0; i < numBatches; ++i) {
+      const auto offset = i * batchSize;
+      batches.push_back(makeRowVector({
+          makeFlatVector<int64_t>(
+              batchSize, [&](auto row) { return offset + row; }),
+          makeFlatVector<int32_t>(
+              batchSize,
+              [&](auto row) { return (offset + row) * 7 % numPartitions; },
+              nullEvery(17)),
+          makeFlatVector<StringView>(batchSize, [&](auto row) {
+            return StringView(fmt::format("s{}", (offset + row) % 3));
+          }),
+      }));
+    }
+    return batches;
+  }
+};
+
+TEST_F(RowNumberTest, basic) {
+  auto batches = makeBatches(5, 1'000, 100);
+  createDuckDbTable(batches);
+
+  // The rows of each partition are numbered in the order of arrival, which
+  // is the order of c0.
+  auto plan = PlanBuilder().values(batches).rowNumber({"c1"}).planNode();
+  assertQuery(
+      plan,
+      "SELECT *, row_number() over (partition by c1 order by c0) FROM tmp");
+
+  plan = PlanBuilder().values(batches).rowNumber({"c1", "c2"}).planNode();
+  assertQuery(
+      plan,
+      "SELECT *, row_number() over (partition by c1, c2 order by c0) FROM tmp");
+
+  // No partition keys.
+  plan = PlanBuilder().values(batches).rowNumber({}).planNode();
+  assertQuery(plan, "SELECT *, row_number() over (order by c0) FROM tmp");
+}
+
+TEST_F(RowNumberTest, limit) {
+  auto batches = makeBatches(5, 1'000, 100);
+  createDuckDbTable(batches);
+
+  for (auto limit : {1, 7, 100}) {
+    SCOPED_TRACE(fmt::format("limit: {}", limit));
+    auto plan =
+        PlanBuilder().values(batches).rowNumber({"c1"}, limit).planNode();
+    assertQuery(
+        plan,
+        fmt::format(
+            "SELECT * FROM (SELECT *, row_number() over "
+            "(partition by c1 order by c0) as rn FROM tmp) WHERE rn <= {}",
+            limit));
+
+    plan = PlanBuilder()
+               .values(batches)
+               .rowNumber({"c1"}, limit, false)
+               .planNode();
+    assertQuery(
+        plan,
+        fmt::format(
+            "SELECT c0, c1, c2 FROM (SELECT *, row_number() over "
+            "(partition by c1 order by c0) as rn FROM tmp) WHERE rn <= {}",
+            limit));
+
+    // No partition keys.
+    plan = PlanBuilder().values(batches).rowNumber({}, limit).planNode();
+    assertQuery(
+        plan,
+        fmt::format("SELECT *, c0 + 1 FROM tmp WHERE c0 < {}", limit));
+  }
+}
+
+TEST_F(RowNumberTest, noRowNumberOrLimit) {
+  auto batches = makeBatches(1, 10, 3);
+  VELOX_ASSERT_THROW(
+      PlanBuilder().values(batches).rowNumber({"c1"}, std::nullopt, false),
+      "RowNumber must generate a row number or have a limit");
+}
+
+} // namespace
@@ -14,10 +14,13 @@
  * limitations under the License.
  */
 #include "velox/exec/Spill.h"
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <fstream>
 #include <memory>
 #include "velox/common/base/RuntimeMetrics.h"
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/common/file/FileSystems.h"
 #include "velox/exec/OperatorUtils.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
@@ -391,6 +394,170 @@ TEST_F(SpillTest, spillStateWithSmallTargetFileSize) {
   spillStateTest(1, 2, 10, 10, {}, 10 * 2);
 }
 
+TEST_F(SpillTest, spillCompression) {
+  // Each batch is written as one page. The pages span the 1MB reads from the
+  // spill file.
+  const int32_t numBatches = 5;
+  const int32_t numRowsPerBatch = 50'000;
+  std::vector<RowVectorPtr> batches;
+  for (auto i = 0; i < numBatches; ++i) {
+    batches.push_back(makeRowVector({makeFlatVector<int64_t>(
+        numRowsPerBatch,
+        [&](auto row) { return (i * numRowsPerBatch + row) / 7; },
+        nullEvery(11))}));
+  }
+
+  std::optional<uint64_t> uncompressedBytes;
+  for (const auto& name : {"none", "zlib", "snappy", "lz4", "zstd"}) {
+    SCOPED_TRACE(name);
+    folly::io::CodecType compressionKind;
+    try {
+      compressionKind = stringToSpillCompressionKind(name);
+    } catch (const VeloxUserError&) {
+      // The codec is not available in this build.
+      continue;
+    }
+    auto tempDirectory = exec::test::TempDirectoryPath::create();
+    SpillState state(
+        tempDirectory->path + "/test",
+        1,
+        1,
+        {},
+        kGB,
+        *pool(),
+        compressionKind);
+    state.setPartitionSpilled(0);
+    for (const auto& batch : batches) {
+      state.appendToPartition(0, batch);
+    }
+    state.finishWrite(0);
+    if (!uncompressedBytes.has_value()) {
+      uncompressedBytes = state.spilledBytes();
+    } else {
+      EXPECT_LT(state.spilledBytes(), uncompressedBytes.value());
+    }
+
+    auto merge = state.startMerge(0, nullptr);
+    for (auto i = 0; i < numBatches * numRowsPerBatch; ++i) {
+      auto stream = merge->next();
+      ASSERT_NE(nullptr, stream);
+      const auto& expected = batches[i / numRowsPerBatch]->childAt(0);
+      const auto index = stream->currentIndex();
+      ASSERT_TRUE(stream->current().childAt(0)->equalValueAt(
+          expected.get(), index, i % numRowsPerBatch))
+          << i;
+      stream->pop();
+    }
+    ASSERT_EQ(nullptr, merge->next());
+  }
+  EXPECT_TRUE(uncompressedBytes.has_value());
+
+  VELOX_ASSERT_THROW(
+      stringToSpillCompressionKind("brotli"),
+      "Unsupported spill compression codec: brotli");
+}
+
+TEST_F(SpillTest, spillChecksum) {
+  auto tempDirectory = exec::test::TempDirectoryPath::create();
+  SpillState state(tempDirectory->path + "/test", 1, 1, {}, kGB, *pool());
+  state.setPartitionSpilled(0);
+  for (auto i = 0; i < 5; ++i) {
+    state.appendToPartition(
+        0, makeRowVector({makeFlatVector<int64_t>(50'000, [&](auto row) {
+          return i * 50'000 + row;
+        })}));
+  }
+  state.finishWrite(0);
+  const auto spilledFiles = state.testingSpilledFilePaths();
+  ASSERT_EQ(1, spilledFiles.size());
+
+  // Flip a byte in the middle of the file, which is in the data of a page.
+  {
+    std::fstream file(
+        spilledFiles[0], std::ios::in | std::ios::out | std::ios::binary);
+    file.seekg(0, std::ios::end);
+    const auto offset = file.tellg() / 2;
+    char byte;
+    file.seekg(offset);
+    file.read(&byte, 1);
+    byte = ~byte;
+    file.seekp(offset);
+    file.write(&byte, 1);
+  }
+
+  VELOX_ASSERT_THROW(
+      {
+        auto merge = state.startMerge(0, nullptr);
+        while (auto* stream = merge->next()) {
+          stream->pop();
+        }
+      },
+      "Received corrupted serialized page.");
+}
+
+TEST_F(SpillTest, spillReadAhead) {
+  // Each file is several times the size of the read buffer. The files have
+  // pages of different sizes so that pages span the buffers read ahead.
+  const int32_t numFiles = 4;
+  const int32_t numBatches = 6;
+  auto executor = std::make_unique<folly::CPUThreadPoolExecutor>(4);
+  for (auto* mergeExecutor :
+       std::vector<folly::Executor*>{nullptr, executor.get()}) {
+    for (const auto& compression : {"none", "zstd"}) {
+      SCOPED_TRACE(fmt::format(
+          "executor: {}, compression: {}",
+          mergeExecutor != nullptr,
+          compression));
+      folly::io::CodecType compressionKind;
+      try {
+        compressionKind = stringToSpillCompressionKind(compression);
+      } catch (const VeloxUserError&) {
+        continue;
+      }
+      auto tempDirectory = exec::test::TempDirectoryPath::create();
+      SpillState state(
+          tempDirectory->path + "/test",
+          1,
+          1,
+          {},
+          kGB,
+          *pool(),
+          compressionKind);
+      state.setPartitionSpilled(0);
+      // File 'i' has the values that are 'i' modulo 'numFiles'.
+      int64_t numValues = 0;
+      for (auto file = 0; file < numFiles; ++file) {
+        int64_t next = file;
+        for (auto batch = 0; batch < numBatches; ++batch) {
+          const auto size = 30'000 + 7'919 * batch;
+          state.appendToPartition(
+              0, makeRowVector({makeFlatVector<int64_t>(size, [&](auto row) {
+                return next + row * numFiles;
+              })}));
+          next += size * numFiles;
+          numValues += size;
+        }
+        state.finishWrite(0);
+      }
+      ASSERT_EQ(numFiles, state.spilledFiles());
+
+      auto merge = state.startMerge(0, nullptr, mergeExecutor);
+      // The files do not have the same number of values. Each value is
+      // 'numFiles' apart in its file.
+      std::vector<int64_t> values;
+      while (auto* stream = merge->next()) {
+        values.push_back(stream->decoded(0).valueAt<int64_t>(
+            stream->currentIndex()));
+        stream->pop();
+      }
+      ASSERT_EQ(numValues, values.size());
+      ASSERT_TRUE(std::is_sorted(values.begin(), values.end()));
+      ASSERT_EQ(
+          values.end(), std::adjacent_find(values.begin(), values.end()));
+    }
+  }
+}
+
 TEST_F(SpillTest, spillPartitionId) {
   SpillPartitionId partitionId1_2(1, 2);
   ASSERT_EQ(partitionId1_2.partitionBitOffset(), 1);
@@ -90,6 +90,11 @@ void setSequentialValue(
   }
 }
 
+// Returns true if 'type' spills all the rows into a single partition.
+bool isSinglePartition(Spiller::Type type) {
+  return type == Spiller::Type::kOrderBy || type == Spiller::Type::kWindow;
+}
+
 void resizeVector(RowVector& vector, vector_size_t size) {
   vector.prepareForReuse();
   vector.resize(size);
@@ -109,7 +114,7 @@ class SpillerTest : public exec::test::RowContainerTestBase {
       : param_(param),
         type_(param.type),
         executorPoolSize_(param.poolSize),
-        hashBits_(0, type_ == Spiller::Type::kOrderBy ? 0 : 2),
+        hashBits_(0, isSinglePartition(type_) ? 0 : 2),
         numPartitions_(hashBits_.numPartitions()),
         statWriter_(std::make_unique<TestRuntimeStatWriter>(stats_)) {
     setThreadLocalRunTimeStatWriter(statWriter_.get());
@@ -402,9 +407,9 @@ class SpillerTest : public exec::test::RowContainerTestBase {
           minSpillRunSize,
           *pool_,
           executor());
-    } else if (type_ == Spiller::Type::kOrderBy) {
-      // We spill 'data' in one partition in type of kOrderBy, otherwise in 4
-      // partitions.
+    } else if (isSinglePartition(type_)) {
+      // We spill 'data' in one partition in type of kOrderBy and kWindow,
+      // otherwise in 4 partitions.
       spiller_ = std::make_unique<Spiller>(
           type_,
           rowContainer_.get(),
@@ -432,7 +437,7 @@ class SpillerTest : public exec::test::RowContainerTestBase {
           *pool_,
           executor());
     }
-    if (type_ == Spiller::Type::kOrderBy) {
+    if (isSinglePartition(type_)) {
       ASSERT_EQ(spiller_->state().maxPartitions(), 1);
     } else {
       ASSERT_EQ(spiller_->state().maxPartitions(), numPartitions_);
@@ -829,7 +834,8 @@ class NoHashJoinNoOrderBy : public SpillerTest,
         .typesToExclude =
             {Spiller::Type::kHashJoinProbe,
              Spiller::Type::kHashJoinBuild,
-             Spiller::Type::kOrderBy}}
+             Spiller::Type::kOrderBy,
+             Spiller::Type::kWindow}}
         .getTestParams();
   }
 };
@@ -879,8 +885,8 @@ TEST_P(NoHashJoin, error) {
 }
 
 TEST_P(NoHashJoinNoOrderBy, spillWithEmptyPartitions) {
-  // kOrderBy type which has only one partition which is not relevant for this
-  // test.
+  // kOrderBy and kWindow types which have only one partition are not relevant
+  // for this test.
   rowType_ = ROW({{"long_val", BIGINT()}, {"string_val", VARCHAR()}});
   struct {
     std::vector<int> rowsPerPartition;
@@ -950,7 +956,8 @@ TEST_P(NoHashJoinNoOrderBy, spillWithEmptyPartitions) {
 }
 
 TEST_P(NoHashJoinNoOrderBy, spillWithNonSpillingPartitions) {
-  // kOrderBy type which has only one partition, is irrelevant for this test.
+  // kOrderBy and kWindow types which have only one partition, are irrelevant
+  // for this test.
   rowType_ = ROW({{"long_val", BIGINT()}, {"string_val", VARCHAR()}});
   struct {
     std::vector<int> rowsPerPartition;
@@ -1013,7 +1020,7 @@ TEST_P(NoHashJoinNoOrderBy, spillWithNonSpillingPartitions) {
 }
 
 TEST_P(AllTypes, nonSortedSpillFunctions) {
-  if (type_ == Spiller::Type::kOrderBy || type_ == Spiller::Type::kAggregate) {
+  if (isSinglePartition(type_) || type_ == Spiller::Type::kAggregate) {
     setupSpillData(rowType_, numKeys_, 1'000, 1, nullptr, {});
     sortSpillData();
     setupSpiller(100'000, 0, false);
@@ -21,6 +21,7 @@
 #include "velox/dwio/common/tests/utils/DataFiles.h"
 #include "velox/exec/PartitionedOutputBufferManager.h"
 #include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/Cursor.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
@@ -532,6 +533,53 @@ TEST_F(TableScanTest, waitForSplit) {
       duckDbQueryRunner_);
 }
 
+TEST_F(TableScanTest, elasticDrivers) {
+  auto filePaths = makeFilePaths(20);
+  auto vectors = makeVectors(20, 1'000);
+  for (int32_t i = 0; i < vectors.size(); i++) {
+    writeToFile(filePaths[i]->path, vectors[i]);
+  }
+  createDuckDbTable(vectors);
+
+  auto planNodeIdGenerator = std::make_shared<core::PlanNodeIdGenerator>();
+  core::PlanNodeId scanNodeId;
+  auto plan = PlanBuilder(planNodeIdGenerator)
+                  .localPartition(
+                      {},
+                      {PlanBuilder(planNodeIdGenerator)
+                           .tableScan(rowType_)
+                           .capturePlanNodeId(scanNodeId)
+                           .partialAggregation({}, {"count(1)", "sum(c0)"})
+                           .planNode()})
+                  .finalAggregation()
+                  .planNode();
+
+  // The scan pipeline starts with one Driver, adds Drivers while more splits
+  // than Drivers are queued and retires them afterwards.
+  auto task =
+      AssertQueryBuilder(plan, duckDbQueryRunner_)
+          .splits(scanNodeId, makeHiveConnectorSplits(filePaths))
+          .maxDrivers(1)
+          .config(core::QueryConfig::kMaxElasticDriversPerPipeline, "4")
+          .config(core::QueryConfig::kElasticDriverIntervalMs, "0")
+          .config(core::QueryConfig::kElasticDriverScaleUpUtilization, "0")
+          .config(core::QueryConfig::kElasticDriverScaleDownUtilization, "2")
+          .assertResults("SELECT count(*), sum(c0) FROM tmp");
+  const auto stats = task->taskStats();
+  EXPECT_GT(stats.numAddedDrivers, 0);
+  EXPECT_GT(stats.numRetiredDrivers, 0);
+  EXPECT_LE(stats.numAddedDrivers, 3);
+  EXPECT_EQ(stats.numTotalDrivers, 2 + stats.numAddedDrivers);
+
+  // Without the config the number of Drivers is fixed.
+  task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+             .splits(scanNodeId, makeHiveConnectorSplits(filePaths))
+             .maxDrivers(1)
+             .assertResults("SELECT count(*), sum(c0) FROM tmp");
+  EXPECT_EQ(task->taskStats().numAddedDrivers, 0);
+  EXPECT_EQ(task->taskStats().numRetiredDrivers, 0);
+}
+
 TEST_F(TableScanTest, splitOffsetAndLength) {
   auto vectors = makeVectors(10, 1'000);
   auto filePath = TempFilePath::create();
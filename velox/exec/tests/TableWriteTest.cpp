@@ -16,13 +16,20 @@
 #include "velox/common/base/Fs.h"
 #include "velox/common/base/tests/GTestUtils.h"
 #include "velox/connectors/hive/HiveConfig.h"
+#include "velox/connectors/hive/HivePartitionFunction.h"
 #include "velox/connectors/hive/HivePartitionUtil.h"
 #include "velox/dwio/common/DataSink.h"
+#ifdef VELOX_ENABLE_PARQUET
+#include "velox/dwio/parquet/RegisterParquetReader.h"
+#endif
 #include "velox/exec/tests/utils/AssertQueryBuilder.h"
 #include "velox/exec/tests/utils/HiveConnectorTestBase.h"
 #include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/exec/tests/utils/TempDirectoryPath.h"
 
+#include <folly/ScopeGuard.h>
+
+#include <numeric>
 #include <regex>
 
 using namespace facebook::velox;
@@ -144,6 +151,82 @@ class TableWriteTest : public HiveConnectorTestBase {
     return folly::join(" AND ", conjuncts);
   }
 
+  // Writes 'vectors' of 'rowType' to a table bucketed by 'c0' into
+  // 'numBuckets' buckets and sorted by 'c1'. Verifies that each file holds the
+  // rows of the bucket in its name sorted by 'c1' and that all rows are
+  // written.
+  void testBucketedWrite(
+      const RowTypePtr& rowType,
+      const std::vector<RowVectorPtr>& vectors,
+      int32_t numBuckets,
+      const std::unordered_map<std::string, std::string>& connectorConfig =
+          {}) {
+    createDuckDbTable(vectors);
+    auto bucketProperty = std::make_shared<HiveBucketProperty>(
+        numBuckets,
+        std::vector<std::string>{"c0"},
+        std::vector<std::shared_ptr<const HiveSortingColumn>>{
+            std::make_shared<HiveSortingColumn>(
+                "c1", core::SortOrder(true, true))});
+
+    auto outputDirectory = TempDirectoryPath::create();
+    auto plan = PlanBuilder()
+                    .values(vectors)
+                    .tableWrite(
+                        rowType->names(),
+                        std::make_shared<core::InsertTableHandle>(
+                            kHiveConnectorId,
+                            makeHiveInsertTableHandle(
+                                rowType->names(),
+                                rowType->children(),
+                                {},
+                                makeLocationHandle(outputDirectory->path),
+                                dwio::common::FileFormat::DWRF,
+                                bucketProperty)),
+                        CommitStrategy::kNoCommit,
+                        "rows")
+                    .project({"rows"})
+                    .planNode();
+    AssertQueryBuilder builder(plan, duckDbQueryRunner_);
+    for (const auto& [key, value] : connectorConfig) {
+      builder.connectorConfig(kHiveConnectorId, key, value);
+    }
+    builder.assertResults("SELECT count(*) FROM tmp");
+
+    HivePartitionFunction bucketFunction(
+        numBuckets, makeIdentityBuckets(numBuckets), {0});
+    const auto files = getRecursiveFiles(outputDirectory->path);
+    ASSERT_EQ(files.size(), numBuckets);
+    for (const auto& file : files) {
+      const auto fileName = fs::path(file).filename().string();
+      const auto bucket = folly::to<uint32_t>(fileName.substr(0, 6));
+      auto data =
+          AssertQueryBuilder(PlanBuilder().tableScan(rowType).planNode())
+              .split(makeHiveConnectorSplit(file))
+              .copyResults(pool());
+      std::vector<uint32_t> buckets;
+      bucketFunction.partition(*data, buckets);
+      auto sortKeys = data->childAt(1)->asFlatVector<int64_t>();
+      for (auto row = 0; row < data->size(); ++row) {
+        ASSERT_EQ(buckets[row], bucket) << fileName;
+        if (row > 0) {
+          ASSERT_LE(sortKeys->valueAt(row - 1), sortKeys->valueAt(row))
+              << fileName;
+        }
+      }
+    }
+    assertQuery(
+        PlanBuilder().tableScan(rowType).planNode(),
+        makeHiveConnectorSplits(outputDirectory),
+        "SELECT * FROM tmp");
+  }
+
+  static std::vector<int> makeIdentityBuckets(int32_t numBuckets) {
+    std::vector<int> buckets(numBuckets);
+    std::iota(buckets.begin(), buckets.end(), 0);
+    return buckets;
+  }
+
   RowTypePtr rowType_{
       ROW({"c0", "c1", "c2", "c3", "c4", "c5"},
           {BIGINT(), INTEGER(), SMALLINT(), REAL(), DOUBLE(), VARCHAR()})};
@@ -279,6 +362,50 @@ TEST_F(TableWriteTest, directReadWrite) {
       "SELECT * FROM tmp");
 }
 
+#ifdef VELOX_ENABLE_PARQUET
+// Writes Parquet files and reads them back. The Hive connector registers the
+// Parquet writer factory.
+TEST_F(TableWriteTest, parquetReadWrite) {
+  parquet::registerParquetReaderFactory(parquet::ParquetReaderType::NATIVE);
+  SCOPE_EXIT {
+    parquet::unregisterParquetReaderFactory();
+  };
+  auto vectors = makeVectors(rowType_, 5, 1000);
+  createDuckDbTable(vectors);
+
+  auto outputDirectory = TempDirectoryPath::create();
+  auto plan = PlanBuilder()
+                  .values(vectors)
+                  .tableWrite(
+                      rowType_->names(),
+                      std::make_shared<core::InsertTableHandle>(
+                          kHiveConnectorId,
+                          makeHiveInsertTableHandle(
+                              rowType_->names(),
+                              rowType_->children(),
+                              {},
+                              makeLocationHandle(outputDirectory->path),
+                              dwio::common::FileFormat::PARQUET)),
+                      CommitStrategy::kNoCommit,
+                      "rows")
+                  .project({"rows"})
+                  .planNode();
+  assertQuery(plan, "SELECT count(*) FROM tmp");
+
+  std::vector<std::shared_ptr<connector::ConnectorSplit>> splits;
+  for (const auto& file : getRecursiveFiles(outputDirectory->path)) {
+    splits.push_back(HiveConnectorSplitBuilder(file)
+                         .fileFormat(dwio::common::FileFormat::PARQUET)
+                         .build());
+  }
+  ASSERT_FALSE(splits.empty());
+  assertQuery(
+      PlanBuilder().tableScan(rowType_).planNode(),
+      splits,
+      "SELECT * FROM tmp");
+}
+#endif
+
 // Tests writing constant vectors.
 TEST_F(TableWriteTest, constantVectors) {
   vector_size_t size = 1'000;
@@ -576,6 +703,69 @@ TEST_F(TableWriteTest, maxPartitions) {
       fmt::format("Exceeded limit of {} distinct partitions.", maxPartitions));
 }
 
+TEST_F(TableWriteTest, bucketedSortedWrite) {
+  auto rowType = ROW({"c0", "c1", "c2"}, {INTEGER(), BIGINT(), VARCHAR()});
+  auto vectors = makeBatches(5, [&](auto batch) {
+    return makeRowVector(
+        rowType->names(),
+        {makeFlatVector<int32_t>(
+             1'000, [&](auto row) { return (row + batch) % 97; }),
+         makeFlatVector<int64_t>(
+             1'000, [&](auto row) { return (row * 7919 + batch) % 1'009; }),
+         makeFlatVector<StringView>(1'000, [&](auto row) {
+           return StringView(fmt::format("str_{}_{}", batch, row));
+         })});
+  });
+  testBucketedWrite(rowType, vectors, 4);
+}
+
+TEST_F(TableWriteTest, bucketedSortedWriteWithSpill) {
+  auto rowType = ROW({"c0", "c1", "c2"}, {INTEGER(), BIGINT(), VARCHAR()});
+  auto vectors = makeBatches(10, [&](auto batch) {
+    return makeRowVector(
+        rowType->names(),
+        {makeFlatVector<int32_t>(
+             1'000, [&](auto row) { return (row + batch) % 31; }),
+         makeFlatVector<int64_t>(
+             1'000, [&](auto row) { return (row * 7919 + batch) % 1'009; }),
+         makeFlatVector<StringView>(1'000, [&](auto row) {
+           return StringView(fmt::format("str_{}_{}", batch, row));
+         })});
+  });
+  // The buffers of all writers exceed the budget before each write, so they
+  // are spilled.
+  auto spillDirectory = TempDirectoryPath::create();
+  testBucketedWrite(
+      rowType,
+      vectors,
+      3,
+      {{HiveConfig::kSortedWriteSpillDirectory, spillDirectory->path},
+       {HiveConfig::kSortedWriteMaxBufferBytes, "1"}});
+  // The spill files are removed after the merge.
+  ASSERT_TRUE(fs::is_empty(spillDirectory->path));
+
+  // Without a spill directory the write fails once the buffers exceed the
+  // budget.
+  VELOX_ASSERT_THROW(
+      testBucketedWrite(
+          rowType, vectors, 3, {{HiveConfig::kSortedWriteMaxBufferBytes, "1"}}),
+      "Sorted write buffers of");
+}
+
+TEST_F(TableWriteTest, maxOpenWriters) {
+  auto rowType = ROW({"c0", "c1"}, {INTEGER(), BIGINT()});
+  auto vectors = makeBatches(2, [&](auto batch) {
+    return makeRowVector(
+        rowType->names(),
+        {makeFlatVector<int32_t>(100, [&](auto row) { return row; }),
+         makeFlatVector<int64_t>(100, [&](auto row) { return row + batch; })});
+  });
+  VELOX_ASSERT_THROW(
+      testBucketedWrite(
+          rowType, vectors, 4, {{HiveConfig::kMaxOpenWriters, "3"}}),
+      "Exceeded limit of 3 open writers.");
+}
+
 // Test TableWriter does not create a file if input is empty.
 TEST_F(TableWriteTest, writeNoFile) {
   auto outputDirectory = TempDirectoryPath::create();
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/exec/TaskExecutor.h"
+
+#include <folly/synchronization/Baton.h>
+#include <gtest/gtest.h>
+
+#include "velox/common/process/ProcessBase.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+
+namespace {
+
+// Keeps the thread busy for 'nanos' of thread CPU time.
+void burnCpu(uint64_t nanos) {
+  const auto start = process::threadCpuNanos();
+  while (process::threadCpuNanos() - start < nanos) {
+  }
+}
+
+class TaskExecutorTest : public testing::Test {
+ protected:
+  static TaskExecutor::Options singleThreadOptions() {
+    TaskExecutor::Options options;
+    options.numThreads = 1;
+    options.levelThresholdNanos = {1'000, 1'000'000};
+    options.levelTimeMultiplier = 2;
+    return options;
+  }
+
+  // Occupies the only thread of 'executor' until 'baton' is posted, so that
+  // the functions added meanwhile are all queued.
+  static void blockThread(TaskExecutor& executor, folly::Baton<>& baton) {
+    folly::Baton<> started;
+    executor.add([&]() {
+      started.post();
+      baton.wait();
+    });
+    started.wait();
+  }
+};
+
+TEST_F(TaskExecutorTest, levelOf) {
+  TaskExecutor executor(singleThreadOptions());
+  ASSERT_EQ(executor.numLevels(), 3);
+  EXPECT_EQ(executor.levelOf(0), 0);
+  EXPECT_EQ(executor.levelOf(999), 0);
+  EXPECT_EQ(executor.levelOf(1'000), 1);
+  EXPECT_EQ(executor.levelOf(999'999), 1);
+  EXPECT_EQ(executor.levelOf(1'000'000), 2);
+  EXPECT_EQ(executor.levelOf(std::numeric_limits<uint64_t>::max()), 2);
+}
+
+TEST_F(TaskExecutorTest, levelShares) {
+  constexpr int32_t kNumPerLevel = 20;
+  constexpr uint64_t kBurnNanos = 1'000'000;
+  std::mutex mutex;
+  std::vector<int32_t> levels;
+  folly::Baton<> baton;
+  TaskExecutor executor(singleThreadOptions());
+  blockThread(executor, baton);
+
+  for (auto level = 0; level < 2; ++level) {
+    for (auto i = 0; i < kNumPerLevel; ++i) {
+      executor.add(
+          [&, level]() {
+            burnCpu(kBurnNanos);
+            std::lock_guard<std::mutex> l(mutex);
+            levels.push_back(level);
+          },
+          level == 0 ? 0 : 1'000);
+    }
+  }
+  EXPECT_EQ(executor.numQueued(0), kNumPerLevel);
+  EXPECT_EQ(executor.numQueued(1), kNumPerLevel);
+  baton.post();
+  while (executor.numQueued(0) + executor.numQueued(1) > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1)); // NOLINT
+  }
+
+  // The first level gets about twice the CPU time of the second level while
+  // both have work.
+  std::lock_guard<std::mutex> l(mutex);
+  const auto numFirstLevel =
+      std::count(levels.begin(), levels.begin() + 15, 0);
+  EXPECT_GE(numFirstLevel, 8);
+  EXPECT_LE(numFirstLevel, 12);
+}
+
+TEST_F(TaskExecutorTest, idleLevelCharge) {
+  folly::Baton<> baton;
+  TaskExecutor executor(singleThreadOptions());
+  for (auto i = 0; i < 10; ++i) {
+    executor.add([]() { burnCpu(100'000); });
+  }
+  blockThread(executor, baton);
+  ASSERT_GE(executor.levelCpuNanos(0), 1'000'000);
+  EXPECT_EQ(executor.levelCpuNanos(2), 0);
+
+  // A level that gets work after being idle does not get the time it was idle
+  // for, so it cannot monopolize the thread.
+  executor.add([]() {});
+  const auto levelCpuNanos = executor.levelCpuNanos(0);
+  executor.add([]() {}, 1'000'000);
+  EXPECT_EQ(executor.levelCpuNanos(2), levelCpuNanos / 4);
+  baton.post();
+}
+
+} // namespace
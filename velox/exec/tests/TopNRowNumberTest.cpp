@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <folly/String.h>
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec::test;
+
+namespace {
+
+class TopNRowNumberTest : public OperatorTestBase {
+ protected:
+  // Returns batches with a unique sort key in c0, a partition key with
+  // 'numPartitions' values and nulls in c1 and a unique string in c2. c0 is
+  // null in at most one row per partition so that the row numbers do not
+  // depend on the order of ties.
+  std::vector<RowVectorPtr> makeBatches(
+      int32_t numBatches,
+      vector_size_t batchSize,
+      int32_t numPartitions) {
+    std::vector<RowVectorPtr> batches;
+    for (int32_t i = 0; i < numBatches; ++i) {
+      const auto offset = i * batchSize;
+      batches.push_back(makeRowVector({
+          makeFlatVector<int64_t>(
+              batchSize,
+              [&](auto row) { return (offset + row) * 7'919 % 10'007; },
+              [&](auto row) {
+                return offset + row < numPartitions / 2 && row % 17 != 0;
+              }),
+          makeFlatVector<int32_t>(
+              batchSize,
+              [&](auto row) { return (offset + row) % numPartitions; },
+              nullEvery(17)),
+          makeFlatVector<StringView>(batchSize, [&](auto row) {
+            return StringView(fmt::format("s{}", offset + row));
+          }),
+      }));
+    }
+    return batches;
+  }
+
+  void testTopNRowNumber(
+      const std::vector<RowVectorPtr>& batches,
+      const std::vector<std::string>& partitionKeys,
+      const std::string& sortingKey,
+      int32_t limit) {
+    SCOPED_TRACE(fmt::format("{} limit {}", sortingKey, limit));
+    const auto partitionBy = partitionKeys.empty()
+        ? std::string()
+        : fmt::format("partition by {}", folly::join(", ", partitionKeys));
+    const auto sql = fmt::format(
+        "SELECT * FROM (SELECT *, row_number() over ({} order by {}) as rn "
+        "FROM tmp) WHERE rn <= {}",
+        partitionBy,
+        sortingKey,
+        limit);
+
+    auto plan = PlanBuilder()
+                    .values(batches)
+                    .topNRowNumber(partitionKeys, {sortingKey}, limit, true)
+                    .planNode();
+    assertQuery(plan, sql);
+
+    plan = PlanBuilder()
+               .values(batches)
+               .topNRowNumber(partitionKeys, {sortingKey}, limit, false)
+               .planNode();
+    assertQuery(plan, fmt::format("SELECT c0, c1, c2 FROM ({})", sql));
+  }
+};
+
+TEST_F(TopNRowNumberTest, basic) {
+  auto batches = makeBatches(5, 1'000, 50);
+  createDuckDbTable(batches);
+
+  for (auto limit : {1, 5, 200}) {
+    testTopNRowNumber(batches, {"c1"}, "c0", limit);
+    testTopNRowNumber(batches, {"c1"}, "c0 DESC", limit);
+  }
+  testTopNRowNumber(batches, {"c1"}, "c0 NULLS FIRST", 200);
+  testTopNRowNumber(batches, {"c1"}, "c2 DESC", 3);
+}
+
+TEST_F(TopNRowNumberTest, multipleKeys) {
+  auto batches = makeBatches(3, 1'000, 30);
+  createDuckDbTable(batches);
+
+  testTopNRowNumber(batches, {"c1", "c2"}, "c0", 1);
+  testTopNRowNumber(batches, {"c2"}, "c0", 2);
+}
+
+TEST_F(TopNRowNumberTest, noPartitionKeys) {
+  auto batches = makeBatches(3, 1'000, 30);
+  createDuckDbTable(batches);
+
+  testTopNRowNumber(batches, {}, "c0", 10);
+  testTopNRowNumber(batches, {}, "c0 DESC", 2'500);
+}
+
+TEST_F(TopNRowNumberTest, manyPartitions) {
+  // More rows in the output than in an output batch.
+  auto batches = makeBatches(10, 1'000, 5'000);
+  createDuckDbTable(batches);
+
+  testTopNRowNumber(batches, {"c1"}, "c0", 1);
+  testTopNRowNumber(batches, {"c1"}, "c0", 3);
+}
+
+} // namespace
@@ -228,6 +228,37 @@ TEST_F(TopNTest, multiBatch) {
   testSingleKey(vectors, "c2", 2'500);
 }
 
+TEST_F(TopNTest, integerKeyBound) {
+  // Batches are filtered against the top row before the other columns are
+  // decoded. Covers flat keys with and without nulls, dictionary encoded keys
+  // and a limit that fills in the middle of a batch. Non-null keys are unique
+  // and the limits exceed the number of nulls to make the results
+  // deterministic.
+  vector_size_t batchSize = 1'000;
+  std::vector<RowVectorPtr> vectors;
+  for (int32_t i = 0; i < 5; ++i) {
+    auto value = [&](vector_size_t row) {
+      return (batchSize * i + row) * 7'919 % 5'003 - 2'500;
+    };
+    auto c0 = makeFlatVector<int32_t>(batchSize, value);
+    auto c1 = makeFlatVector<int16_t>(batchSize, value, nullEvery(7));
+    auto c2 = wrapInDictionary(
+        makeIndicesInReverse(batchSize),
+        batchSize,
+        makeFlatVector<int64_t>(batchSize, value, nullEvery(13)));
+    auto c3 = makeFlatVector<StringView>(batchSize, [](vector_size_t row) {
+      return StringView(std::to_string(row));
+    });
+    vectors.push_back(makeRowVector({c0, c1, c2, c3}));
+  }
+  createDuckDbTable(vectors);
+
+  testSingleKey(vectors, "c0", 10);
+  testSingleKey(vectors, "c0", 1'500);
+  testSingleKey(vectors, "c1", 800);
+  testSingleKey(vectors, "c2", 500);
+}
+
 TEST_F(TopNTest, empty) {
   vector_size_t batchSize = 1'000;
   std::vector<RowVectorPtr> vectors;
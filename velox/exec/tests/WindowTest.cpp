@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "velox/core/QueryConfig.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/OperatorTestBase.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
+#include "velox/exec/tests/utils/TempDirectoryPath.h"
+#include "velox/functions/prestosql/aggregates/RegisterAggregateFunctions.h"
+#include "velox/functions/prestosql/window/WindowFunctionsRegistration.h"
+
+using namespace facebook::velox;
+using namespace facebook::velox::exec;
+using namespace facebook::velox::exec::test;
+
+namespace {
+
+class WindowTest : public OperatorTestBase {
+ protected:
+  void SetUp() override {
+    OperatorTestBase::SetUp();
+    aggregate::prestosql::registerAllAggregateFunctions();
+    window::prestosql::registerAllWindowFunctions();
+  }
+
+  // Returns 'numBatches' batches of 'batchSize' rows with a partition key
+  // of 'numPartitions' values in c1 and a unique sort key in c0.
+  std::vector<RowVectorPtr> makeBatches(
+      int32_t numBatches,
+      vector_size_t batchSize,
+      int32_t numPartitions) {
+    std::vector<RowVectorPtr> batches;
+    for (int32_t i = 0; i < numBatches; ++i) {
+      const auto offset = i * batchSize;
+      batches.push_back(makeRowVector({
+          makeFlatVector<int64_t>(
+              batchSize, [&](auto row) { return offset + row; }),
+          makeFlatVector<int32_t>(
+              batchSize,
+              [&](auto row) { return (offset + row) % numPartitions; }),
+          makeFlatVector<StringView>(
+              batchSize,
+              [&](auto row) {
+                return StringView(fmt::format("s{}", row % 17));
+              },
+              nullEvery(13)),
+      }));
+    }
+    return batches;
+  }
+};
+
+TEST_F(WindowTest, spill) {
+  auto batches = makeBatches(10, 1'000, 7);
+  createDuckDbTable(batches);
+
+  core::PlanNodeId windowId;
+  auto plan = PlanBuilder()
+                  .values(batches)
+                  .window(
+                      {"row_number() over (partition by c1 order by c0 desc)",
+                       "count(c2) over (partition by c1 order by c0 desc "
+                       "rows between 5 preceding and current row)"})
+                  .capturePlanNodeId(windowId)
+                  .planNode();
+  const std::string sql =
+      "SELECT *, row_number() over (partition by c1 order by c0 desc), "
+      "count(c2) over (partition by c1 order by c0 desc "
+      "rows between 5 preceding and current row) FROM tmp";
+
+  {
+    SCOPED_TRACE("run without spilling");
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_).assertResults(sql);
+    EXPECT_EQ(0, toPlanStats(task->taskStats()).at(windowId).spilledBytes);
+  }
+  {
+    SCOPED_TRACE("run with spilling");
+    auto spillDirectory = TempDirectoryPath::create();
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .config(core::QueryConfig::kTestingSpillPct, "100")
+                    .config(core::QueryConfig::kSpillEnabled, "true")
+                    .config(core::QueryConfig::kWindowSpillEnabled, "true")
+                    .spillDirectory(spillDirectory->path)
+                    .assertResults(sql);
+    const auto stats = toPlanStats(task->taskStats()).at(windowId);
+    EXPECT_LT(0, stats.spilledBytes);
+    EXPECT_LT(0, stats.spilledRows);
+    EXPECT_EQ(1, stats.spilledPartitions);
+    EXPECT_LT(0, stats.spilledFiles);
+    OperatorTestBase::deleteTaskAndCheckSpillDirectory(task);
+  }
+  {
+    SCOPED_TRACE("window spilling disabled");
+    auto spillDirectory = TempDirectoryPath::create();
+    auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                    .config(core::QueryConfig::kTestingSpillPct, "100")
+                    .config(core::QueryConfig::kSpillEnabled, "true")
+                    .config(core::QueryConfig::kWindowSpillEnabled, "false")
+                    .spillDirectory(spillDirectory->path)
+                    .assertResults(sql);
+    EXPECT_EQ(0, toPlanStats(task->taskStats()).at(windowId).spilledBytes);
+  }
+}
+
+TEST_F(WindowTest, spillWithoutPartitionKeys) {
+  // A single partition is not spilled as it has to be read back as a whole.
+  auto batches = makeBatches(5, 1'000, 1);
+  createDuckDbTable(batches);
+
+  core::PlanNodeId windowId;
+  auto plan = PlanBuilder()
+                  .values(batches)
+                  .window({"row_number() over (order by c0)"})
+                  .capturePlanNodeId(windowId)
+                  .planNode();
+  auto spillDirectory = TempDirectoryPath::create();
+  auto task = AssertQueryBuilder(plan, duckDbQueryRunner_)
+                  .config(core::QueryConfig::kTestingSpillPct, "100")
+                  .config(core::QueryConfig::kSpillEnabled, "true")
+                  .spillDirectory(spillDirectory->path)
+                  .assertResults(
+                      "SELECT *, row_number() over (order by c0) FROM tmp");
+  EXPECT_EQ(0, toPlanStats(task->taskStats()).at(windowId).spilledBytes);
+}
+
+TEST_F(WindowTest, streaming) {
+  // Partitions span several input batches and batches hold several
+  // partitions.
+  auto batches = makeBatches(10, 1'000, 7);
+  createDuckDbTable(batches);
+
+  const std::vector<std::pair<std::string, std::vector<std::string>>>
+      testSettings = {
+          {"partition by c1 order by c0 desc", {"c1", "c0 desc"}},
+          {"order by c0 desc", {"c0 desc"}},
+      };
+  for (const auto& [overClause, sortingKeys] : testSettings) {
+    SCOPED_TRACE(overClause);
+    const auto windowFunctions = std::vector<std::string>{
+        fmt::format("row_number() over ({})", overClause),
+        fmt::format(
+            "count(c2) over ({} rows between 5 preceding and current row)",
+            overClause)};
+    auto plan = PlanBuilder()
+                    .values(batches)
+                    .orderBy(sortingKeys, false)
+                    .streamingWindow(windowFunctions)
+                    .planNode();
+    AssertQueryBuilder(plan, duckDbQueryRunner_)
+        .assertResults(fmt::format(
+            "SELECT *, {} FROM tmp", folly::join(", ", windowFunctions)));
+  }
+
+  // Each row is a partition.
+  auto plan = PlanBuilder()
+                  .values(batches)
+                  .orderBy({"c0"}, false)
+                  .streamingWindow({"row_number() over (partition by c0)"})
+                  .planNode();
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .assertResults(
+          "SELECT *, row_number() over (partition by c0) FROM tmp");
+}
+
+TEST_F(WindowTest, streamingEmptyInput) {
+  auto batches = makeBatches(1, 0, 1);
+  createDuckDbTable(batches);
+
+  auto plan =
+      PlanBuilder()
+          .values(batches)
+          .streamingWindow({"row_number() over (partition by c1 order by c0)"})
+          .planNode();
+  AssertQueryBuilder(plan, duckDbQueryRunner_)
+      .assertResults(
+          "SELECT *, row_number() over (partition by c1 order by c0) FROM tmp");
+}
+
+} // namespace
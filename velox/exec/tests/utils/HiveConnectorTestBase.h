@@ -105,12 +105,18 @@ class HiveConnectorTestBase : public OperatorTestBase {
   /// name of tableColumnTypes[i] is tableColumnNames[i].
   /// @param partitionedBy A list of partition columns of the target table.
   /// @param locationHandle Location handle for the table write.
+  /// @param storageFormat File format of the written files.
+  /// @param bucketProperty Bucketing and sorting of the target table or
+  /// nullptr if the table is not bucketed.
   static std::shared_ptr<connector::hive::HiveInsertTableHandle>
   makeHiveInsertTableHandle(
       const std::vector<std::string>& tableColumnNames,
       const std::vector<TypePtr>& tableColumnTypes,
       const std::vector<std::string>& partitionedBy,
-      std::shared_ptr<connector::hive::LocationHandle> locationHandle);
+      std::shared_ptr<connector::hive::LocationHandle> locationHandle,
+      dwio::common::FileFormat storageFormat = dwio::common::FileFormat::DWRF,
+      std::shared_ptr<const connector::hive::HiveBucketProperty>
+          bucketProperty = nullptr);
 
   static std::shared_ptr<connector::hive::HiveColumnHandle> regularColumn(
       const std::string& name,
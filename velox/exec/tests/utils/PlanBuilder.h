@@ -662,6 +662,37 @@ class PlanBuilder {
   ///  rows between a + 10 preceding and 10 following)"
   PlanBuilder& window(const std::vector<std::string>& windowFunctions);
 
+  /// Same as window(), but the input is expected to be clustered by the
+  /// partition keys and sorted by the sorting keys within each partition, e.g.
+  /// the output of an orderBy() on the partition and sorting keys. The window
+  /// functions are evaluated one partition at a time as the input streams in.
+  PlanBuilder& streamingWindow(const std::vector<std::string>& windowFunctions);
+
+  /// Add a RowNumberNode to compute row_number() over 'partitionKeys' in the
+  /// order of the input.
+  ///
+  /// @param limit If set, drops the rows with a row number greater than
+  /// 'limit'.
+  /// @param generateRowNumber If true, adds a BIGINT 'row_number' column to
+  /// the output.
+  PlanBuilder& rowNumber(
+      const std::vector<std::string>& partitionKeys,
+      std::optional<int32_t> limit = std::nullopt,
+      bool generateRowNumber = true);
+
+  /// Add a TopNRowNumberNode to keep the first 'limit' rows of each
+  /// partition in the order of 'sortingKeys', e.g.
+  ///
+  ///     .topNRowNumber({"a"}, {"b DESC"}, 10, true)
+  ///
+  /// @param generateRowNumber If true, adds a BIGINT 'row_number' column to
+  /// the output.
+  PlanBuilder& topNRowNumber(
+      const std::vector<std::string>& partitionKeys,
+      const std::vector<std::string>& sortingKeys,
+      int32_t limit,
+      bool generateRowNumber);
+
   /// Stores the latest plan node ID into the specified variable. Useful for
   /// capturing IDs of the leaf plan nodes (table scans, exchanges, etc.) to use
   /// when adding splits at runtime.
@@ -716,6 +747,10 @@ class PlanBuilder {
       const std::shared_ptr<const core::IExpr>& untypedExpr);
 
  private:
+  PlanBuilder& window(
+      const std::vector<std::string>& windowFunctions,
+      bool inputsSorted);
+
   std::shared_ptr<const core::FieldAccessTypedExpr> field(column_index_t index);
 
   std::vector<std::shared_ptr<const core::FieldAccessTypedExpr>> fields(
@@ -113,6 +113,31 @@ class SumAggregate
         TAccumulator(0));
   }
 
+  bool supportsRetract() const override {
+    // Removing values from a floating point sum is not exact.
+    return std::is_integral_v<TAccumulator>;
+  }
+
+  void retractSingleGroupRawInput(
+      char* group,
+      const SelectivityVector& rows,
+      const std::vector<VectorPtr>& args) override {
+    if constexpr (std::is_integral_v<TAccumulator>) {
+      DecodedVector decoded(*args[0], rows);
+      TAccumulator sum = 0;
+      rows.applyToSelected([&](vector_size_t i) {
+        if (!decoded.isNullAt(i)) {
+          sum = functions::checkedPlus<TAccumulator>(
+              sum, decoded.valueAt<TInput>(i));
+        }
+      });
+      auto* accumulator = exec::Aggregate::value<TAccumulator>(group);
+      *accumulator = functions::checkedMinus<TAccumulator>(*accumulator, sum);
+    } else {
+      BaseAggregate::retractSingleGroupRawInput(group, rows, args);
+    }
+  }
+
  protected:
   // TData is used to store the updated sum state. It can be either
   // TAccumulator or TResult, which in most cases are the same, but for
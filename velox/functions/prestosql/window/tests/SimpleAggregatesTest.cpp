@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 #include "velox/common/base/tests/GTestUtils.h"
+#include "velox/exec/PlanNodeStats.h"
+#include "velox/exec/tests/utils/AssertQueryBuilder.h"
+#include "velox/exec/tests/utils/PlanBuilder.h"
 #include "velox/functions/prestosql/window/tests/WindowTestBase.h"
 
 using namespace facebook::velox::exec::test;
@@ -144,5 +147,96 @@ TEST_F(StringAggregatesTest, nonFixedWidthAggregate) {
   testWindowFunction(vectors, "max(c2)", kSortOrderBasedOverClauses);
 }
 
+class SlidingFrameAggregatesTest : public WindowTestBase {};
+
+TEST_F(SlidingFrameAggregatesTest, nulls) {
+  // A partition larger than an output batch. The frames slide across batches
+  // and some frames have only null values of c3.
+  const vector_size_t size = 3'000;
+  auto input = makeRowVector({
+      makeFlatVector<int32_t>(size, [](auto /* row */) { return 1; }),
+      makeFlatVector<int64_t>(size, [](auto row) { return row % 20 + 1; }),
+      makeFlatVector<int64_t>(size, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(
+          size,
+          [](auto row) { return row % 17 - 8; },
+          [](auto row) { return row % 500 < 50 || row % 3 == 0; }),
+  });
+  createDuckDbTable({input});
+
+  const std::vector<std::string> frameClauses = {
+      "rows between 5 preceding and current row",
+      "rows between 100 preceding and 10 following",
+      "rows between c1 preceding and c1 following",
+      "rows between 10 following and 20 following",
+  };
+  for (const auto& function :
+       {"sum(c3)", "count(c3)", "avg(c3)", "min(c3)", "max(c3)", "count(1)"}) {
+    for (const auto& frameClause : frameClauses) {
+      testWindowFunction(
+          {input}, function, {"partition by c0 order by c2"}, frameClause);
+    }
+  }
+}
+
+TEST_F(SlidingFrameAggregatesTest, retractBeforeAdd) {
+  // Each frame sums to less than the maximum bigint, but the union of two
+  // consecutive frames does not. The frame must slide without overflowing.
+  const int64_t kValue = 4'000'000'000'000'000'000;
+  auto input = makeRowVector({
+      makeFlatVector<int64_t>(10, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(10, [&](auto /* row */) { return kValue; }),
+  });
+  auto plan = PlanBuilder()
+                  .values({input})
+                  .window({"sum(c1) over (order by c0 "
+                           "rows between 1 preceding and current row)"})
+                  .planNode();
+  auto expected = makeRowVector({
+      input->childAt(0),
+      input->childAt(1),
+      makeFlatVector<int64_t>(
+          10, [&](auto row) { return row == 0 ? kValue : 2 * kValue; }),
+  });
+  AssertQueryBuilder(plan).assertResults(expected);
+}
+
+TEST_F(SlidingFrameAggregatesTest, avgUsesSegmentTree) {
+  // avg has a row(double, bigint) intermediate type and does not retract
+  // input. Wide sliding frames combine the entries of a segment tree instead
+  // of aggregating each frame.
+  const vector_size_t kSize = 1'000;
+  auto input = makeRowVector({
+      makeFlatVector<int64_t>(kSize, [](auto row) { return row; }),
+      makeFlatVector<int64_t>(kSize, [](auto row) { return row % 7; }),
+  });
+  core::PlanNodeId windowId;
+  auto plan = PlanBuilder()
+                  .values({input})
+                  .window({"avg(c1) over (order by c0 "
+                           "rows between 5 preceding and 5 following)"})
+                  .capturePlanNodeId(windowId)
+                  .planNode();
+  auto expected = makeRowVector({
+      input->childAt(0),
+      input->childAt(1),
+      makeFlatVector<double>(
+          kSize,
+          [&](auto row) {
+            const auto start = std::max<vector_size_t>(0, row - 5);
+            const auto end = std::min<vector_size_t>(kSize, row + 6);
+            int64_t sum = 0;
+            for (auto i = start; i < end; ++i) {
+              sum += i % 7;
+            }
+            return static_cast<double>(sum) / (end - start);
+          }),
+  });
+  auto task = AssertQueryBuilder(plan).assertResults(expected);
+  const auto stats = toPlanStats(task->taskStats()).at(windowId).customStats;
+  EXPECT_EQ(kSize, stats.at("segmentTreeFrameCount").sum);
+  EXPECT_EQ(0, stats.count("simpleAggregationFrameCount"));
+}
+
 }; // namespace
 }; // namespace facebook::velox::window::test
@@ -14,6 +14,9 @@
  * limitations under the License.
  */
 #include "velox/serializers/PrestoSerializer.h"
+
+#include <folly/Random.h>
+
 #include "velox/common/base/Crc.h"
 #include "velox/common/memory/ByteStream.h"
 #include "velox/functions/prestosql/types/TimestampWithTimeZoneType.h"
@@ -30,6 +33,7 @@ constexpr int8_t kCompressedBitMask = 1;
 constexpr int8_t kEncryptedBitMask = 2;
 constexpr int8_t kCheckSumBitMask = 4;
 constexpr folly::StringPiece kRLE{"RLE"};
+constexpr folly::StringPiece kDictionary{"DICTIONARY"};
 
 int64_t computeChecksum(
     PrestoOutputStreamListener* listener,
@@ -47,11 +51,12 @@ int64_t computeChecksum(
     ByteStream* source,
     int codecMarker,
     int numRows,
-    int uncompressedSize) {
+    int uncompressedSize,
+    int sizeInBytes) {
   auto offset = source->tellp();
   bits::Crc32 crc32;
 
-  auto remainingBytes = uncompressedSize;
+  auto remainingBytes = sizeInBytes;
   while (remainingBytes > 0) {
     auto data = source->nextView(remainingBytes);
     crc32.process_bytes(data.data(), data.size());
@@ -86,6 +91,15 @@ bool isChecksumBitSet(int8_t codec) {
   return (codec & kCheckSumBitMask) == kCheckSumBitMask;
 }
 
+// Returns the codec for 'kind' or nullptr if 'kind' is NO_COMPRESSION.
+std::unique_ptr<folly::io::Codec> getCompressionCodec(
+    folly::io::CodecType kind) {
+  if (kind == folly::io::CodecType::NO_COMPRESSION) {
+    return nullptr;
+  }
+  return folly::io::getCodec(kind);
+}
+
 std::string typeToEncodingName(const TypePtr& type) {
   switch (type->kind()) {
     case TypeKind::BOOLEAN:
@@ -464,6 +478,24 @@ void readConstantVector(
   *result = BaseVector::wrapInConstant(size, 0, children[0]);
 }
 
+void readDictionaryVector(
+    ByteStream* source,
+    const TypePtr& type,
+    velox::memory::MemoryPool* pool,
+    VectorPtr* result,
+    bool useLosslessTimestamp) {
+  auto size = source->read<int32_t>();
+  std::vector<TypePtr> childTypes = {type};
+  std::vector<VectorPtr> children(1);
+  readColumns(source, pool, childTypes, &children, useLosslessTimestamp);
+
+  BufferPtr indices = allocateIndices(size, pool);
+  source->readBytes(indices->asMutable<uint8_t>(), size * sizeof(int32_t));
+  // Skip the dictionary id.
+  source->skip(3 * sizeof(int64_t));
+  *result = BaseVector::wrapInDictionary(nullptr, indices, size, children[0]);
+}
+
 void readArrayVector(
     ByteStream* source,
     std::shared_ptr<const Type> type,
@@ -754,6 +786,9 @@ void readColumns(
     if (encoding == kRLE) {
       readConstantVector(
           source, types[i], pool, &(*result)[i], useLosslessTimestamp);
+    } else if (encoding == kDictionary) {
+      readDictionaryVector(
+          source, types[i], pool, &(*result)[i], useLosslessTimestamp);
     } else {
       checkTypeEncoding(encoding, types[i]);
       auto it = readers.find(types[i]->kind());
@@ -788,9 +823,11 @@ class VectorStream {
       bool useLosslessTimestamp)
       : type_(type),
         useLosslessTimestamp_(useLosslessTimestamp),
+        streamArena_(streamArena),
         nulls_(streamArena, true, true),
         lengths_(streamArena),
-        values_(streamArena) {
+        values_(streamArena),
+        indices_(streamArena) {
     streamArena->newTinyRange(50, &header_);
     auto name = typeToEncodingName(type);
     header_.size = name.size() + sizeof(int32_t);
@@ -877,8 +914,22 @@ class VectorStream {
     return children_[index].get();
   }
 
+  // Appends the rows of 'vector' in 'ranges' to a top level column. If the
+  // first batch is constant or dictionary encoded and the dictionary is
+  // small enough, the column is written as an RLE or DICTIONARY block. Later
+  // batches of any encoding are added to that block: an RLE block turns into
+  // a dictionary when a different value arrives and rows that are not
+  // dictionary encoded become dictionary entries of their own.
+  void appendEncoded(
+      const VectorPtr& vector,
+      const folly::Range<const IndexRange*>& ranges);
+
   // Writes out the accumulated contents. Does not change the state.
   void flush(OutputStream* out) {
+    if (encoding_ != Encoding::kFlat) {
+      flushEncoded(out);
+      return;
+    }
     out->write(reinterpret_cast<char*>(header_.buffer), header_.size);
     switch (type_->kind()) {
       case TypeKind::ROW:
@@ -957,11 +1008,34 @@ class VectorStream {
   }
 
  private:
+  enum class Encoding { kFlat, kRle, kDictionary };
+
+  // Returns true if the rows of dictionary encoded 'vector' in 'ranges'
+  // refer to at most half as many distinct base rows.
+  static bool dictionaryPaysOff(
+      const BaseVector& vector,
+      const folly::Range<const IndexRange*>& ranges,
+      int32_t numRows);
+
+  void startRle(const VectorPtr& vector, int32_t numRows);
+
+  // Starts a DICTIONARY block before appending 'numRows' rows. An RLE block
+  // becomes a dictionary with the RLE value as its only entry.
+  void startDictionary(int32_t numRows);
+
+  void appendDictionary(
+      const VectorPtr& vector,
+      const folly::Range<const IndexRange*>& ranges,
+      int32_t numRows);
+
+  void flushEncoded(OutputStream* out);
+
   const TypePtr type_;
   /// Indicates whether to serialize timestamps with nanosecond precision.
   /// If false, they are serialized with millisecond precision which is
   /// compatible with presto.
   const bool useLosslessTimestamp_;
+  StreamArena* const streamArena_;
   int32_t nonNullCount_{0};
   int32_t nullCount_{0};
   int32_t totalLength_{0};
@@ -971,6 +1045,26 @@ class VectorStream {
   ByteStream lengths_;
   ByteStream values_;
   std::vector<std::unique_ptr<VectorStream>> children_;
+
+  // State of a top level column written as an RLE or DICTIONARY block by
+  // appendEncoded().
+  Encoding encoding_{Encoding::kFlat};
+  // Number of rows in the RLE or DICTIONARY block.
+  int32_t numEncodedRows_{0};
+  // The value of an RLE block or the entries of a DICTIONARY block.
+  std::unique_ptr<VectorStream> dictionary_;
+  int32_t dictionarySize_{0};
+  // Index of the null entry in 'dictionary_' or -1 if there is none.
+  int32_t nullIndex_{-1};
+  // Dictionary indices, one int32_t per row.
+  ByteStream indices_;
+  // Constant vector of an RLE block.
+  VectorPtr rleValue_;
+  // Base vector of the last dictionary encoded batch and the index in
+  // 'dictionary_' of each of its rows, -1 if not added yet. Consecutive
+  // batches often share the base, e.g. the output of a filter.
+  VectorPtr lastBase_;
+  std::vector<int32_t> baseToDictionary_;
 };
 
 template <>
@@ -1360,6 +1454,170 @@ void serializeColumn(
   }
 }
 
+// static
+bool VectorStream::dictionaryPaysOff(
+    const BaseVector& vector,
+    const folly::Range<const IndexRange*>& ranges,
+    int32_t numRows) {
+  auto rawIndices = vector.wrapInfo()->as<vector_size_t>();
+  std::vector<uint64_t> referenced(bits::nwords(vector.valueVector()->size()));
+  int32_t numReferenced = 0;
+  for (const auto& range : ranges) {
+    for (auto row = range.begin; row < range.begin + range.size; ++row) {
+      if (vector.isNullAt(row)) {
+        continue;
+      }
+      if (!bits::isBitSet(referenced.data(), rawIndices[row])) {
+        bits::setBit(referenced.data(), rawIndices[row]);
+        ++numReferenced;
+      }
+    }
+  }
+  return numReferenced * 2 <= numRows;
+}
+
+void VectorStream::startRle(const VectorPtr& vector, int32_t numRows) {
+  encoding_ = Encoding::kRle;
+  rleValue_ = vector;
+  numEncodedRows_ = numRows;
+  dictionary_ = std::make_unique<VectorStream>(
+      type_, streamArena_, 1, useLosslessTimestamp_);
+  IndexRange first{0, 1};
+  serializeColumn(
+      vector.get(), folly::Range(&first, 1), dictionary_.get());
+  dictionarySize_ = 1;
+}
+
+void VectorStream::startDictionary(int32_t numRows) {
+  indices_.startWrite((numEncodedRows_ + numRows) * sizeof(int32_t));
+  if (encoding_ == Encoding::kRle) {
+    // All rows so far have the RLE value.
+    if (rleValue_->isNullAt(0)) {
+      nullIndex_ = 0;
+    }
+    rleValue_ = nullptr;
+    for (auto i = 0; i < numEncodedRows_; ++i) {
+      indices_.appendOne<int32_t>(0);
+    }
+  } else {
+    dictionary_ = std::make_unique<VectorStream>(
+        type_, streamArena_, numRows, useLosslessTimestamp_);
+  }
+  encoding_ = Encoding::kDictionary;
+}
+
+void VectorStream::appendDictionary(
+    const VectorPtr& vector,
+    const folly::Range<const IndexRange*>& ranges,
+    int32_t numRows) {
+  numEncodedRows_ += numRows;
+  if (vector->encoding() != VectorEncoding::Simple::DICTIONARY) {
+    // The rows become new dictionary entries.
+    serializeColumn(vector.get(), ranges, dictionary_.get());
+    for (auto i = 0; i < numRows; ++i) {
+      indices_.appendOne<int32_t>(dictionarySize_++);
+    }
+    return;
+  }
+
+  auto base = vector->valueVector();
+  if (base != lastBase_) {
+    lastBase_ = base;
+    baseToDictionary_.assign(base->size(), -1);
+  }
+  auto rawIndices = vector->wrapInfo()->as<vector_size_t>();
+  // Base rows that are added to 'dictionary_', in order of their indices.
+  std::vector<IndexRange> newEntries;
+  auto addNewEntries = [&]() {
+    if (!newEntries.empty()) {
+      serializeColumn(base.get(), newEntries, dictionary_.get());
+      newEntries.clear();
+    }
+  };
+  for (const auto& range : ranges) {
+    for (auto row = range.begin; row < range.begin + range.size; ++row) {
+      if (vector->isNullAt(row)) {
+        if (nullIndex_ == -1) {
+          addNewEntries();
+          dictionary_->appendNull();
+          nullIndex_ = dictionarySize_++;
+        }
+        indices_.appendOne<int32_t>(nullIndex_);
+        continue;
+      }
+      auto& index = baseToDictionary_[rawIndices[row]];
+      if (index == -1) {
+        index = dictionarySize_++;
+        newEntries.push_back(IndexRange{rawIndices[row], 1});
+      }
+      indices_.appendOne<int32_t>(index);
+    }
+  }
+  addNewEntries();
+}
+
+void VectorStream::appendEncoded(
+    const VectorPtr& vector,
+    const folly::Range<const IndexRange*>& ranges) {
+  const auto numRows = rangesTotalSize(ranges);
+  if (numRows == 0) {
+    return;
+  }
+  if (encoding_ == Encoding::kFlat && nullCount_ + nonNullCount_ == 0) {
+    // The first batch decides the encoding.
+    if (vector->encoding() == VectorEncoding::Simple::CONSTANT) {
+      startRle(vector, numRows);
+      return;
+    }
+    if (vector->encoding() == VectorEncoding::Simple::DICTIONARY &&
+        dictionaryPaysOff(*vector, ranges, numRows)) {
+      startDictionary(numRows);
+    }
+  }
+
+  switch (encoding_) {
+    case Encoding::kFlat:
+      serializeColumn(vector.get(), ranges, this);
+      return;
+    case Encoding::kRle:
+      if (vector->encoding() == VectorEncoding::Simple::CONSTANT &&
+          vector->equalValueAt(rleValue_.get(), 0, 0)) {
+        numEncodedRows_ += numRows;
+        return;
+      }
+      startDictionary(numRows);
+      FOLLY_FALLTHROUGH;
+    case Encoding::kDictionary:
+      appendDictionary(vector, ranges, numRows);
+      return;
+  }
+}
+
+void VectorStream::flushEncoded(OutputStream* out) {
+  if (encoding_ == Encoding::kRle) {
+    writeInt32(out, kRLE.size());
+    out->write(kRLE.data(), kRLE.size());
+    writeInt32(out, numEncodedRows_);
+    dictionary_->flush(out);
+    return;
+  }
+
+  // Presto identifies dictionaries by a UUID and a sequence number. Each
+  // DICTIONARY block gets a distinct id so that no two blocks are taken to
+  // share a dictionary.
+  static const int64_t kDictionaryIdHigh = folly::Random::rand64();
+  static std::atomic<int64_t> dictionaryIdLow{0};
+
+  writeInt32(out, kDictionary.size());
+  out->write(kDictionary.data(), kDictionary.size());
+  writeInt32(out, numEncodedRows_);
+  dictionary_->flush(out);
+  indices_.flush(out);
+  writeInt64(out, kDictionaryIdHigh);
+  writeInt64(out, dictionaryIdLow++);
+  writeInt64(out, 0); // sequence id
+}
+
 void expandRepeatedRanges(
     const BaseVector* vector,
     const vector_size_t* rawOffsets,
@@ -1627,13 +1885,17 @@ class PrestoVectorSerializer : public VectorSerializer {
       std::shared_ptr<const RowType> rowType,
       int32_t numRows,
       StreamArena* streamArena,
-      bool useLosslessTimestamp) {
+      const PrestoVectorSerde::PrestoOptions& options)
+      : pool_(streamArena->pool()),
+        codec_(getCompressionCodec(options.compressionKind)),
+        minCompressionRatio_(options.minCompressionRatio),
+        preserveEncodings_(options.preserveEncodings) {
     auto types = rowType->children();
     auto numTypes = types.size();
     streams_.resize(numTypes);
     for (int i = 0; i < numTypes; i++) {
       streams_[i] = std::make_unique<VectorStream>(
-          types[i], streamArena, numRows, useLosslessTimestamp);
+          types[i], streamArena, numRows, options.useLosslessTimestamp);
     }
   }
 
@@ -1644,7 +1906,11 @@ class PrestoVectorSerializer : public VectorSerializer {
     if (newRows > 0) {
       numRows_ += newRows;
       for (int32_t i = 0; i < vector->childrenSize(); ++i) {
-        serializeColumn(vector->childAt(i).get(), ranges, streams_[i].get());
+        if (preserveEncodings_) {
+          streams_[i]->appendEncoded(vector->childAt(i), ranges);
+        } else {
+          serializeColumn(vector->childAt(i).get(), ranges, streams_[i].get());
+        }
       }
     }
   }
@@ -1659,8 +1925,12 @@ class PrestoVectorSerializer : public VectorSerializer {
       VELOX_CHECK(child->isConstantEncoding());
     }
 
+    // The whole page is RLE encoded, so the columns are not encoded again.
     std::vector<IndexRange> ranges{{0, 1}};
-    append(vector, folly::Range(ranges.data(), ranges.size()));
+    numRows_ += 1;
+    for (int32_t i = 0; i < vector->childrenSize(); ++i) {
+      serializeColumn(vector->childAt(i).get(), ranges, streams_[i].get());
+    }
 
     flushInternal(vector->size(), true /*rle*/, out);
   }
@@ -1697,18 +1967,26 @@ class PrestoVectorSerializer : public VectorSerializer {
     if (listener) {
       listener->resume();
     }
-    writeInt32(out, streams_.size());
 
-    if (rle) {
-      // Write RLE encoding marker.
-      writeInt32(out, kRLE.size());
-      out->write(kRLE.data(), kRLE.size());
-      // Write number of RLE values.
-      writeInt32(out, numRows);
-    }
-
-    for (auto& stream : streams_) {
-      stream->flush(out);
+    int32_t uncompressedSize;
+    if (!codec_) {
+      writeColumns(numRows, rle, out);
+      uncompressedSize = (int32_t)out->tellp() - offset - kHeaderSize;
+    } else {
+      // The columns are serialized into a separate buffer and are copied to
+      // 'out' either compressed or, if compression does not pay off, as is.
+      IOBufOutputStream uncompressedOut(*pool_);
+      writeColumns(numRows, rle, &uncompressedOut);
+      auto uncompressed = uncompressedOut.getIOBuf();
+      uncompressedSize = uncompressed->computeChainDataLength();
+      auto compressed = codec_->compress(uncompressed.get());
+      if (compressed->computeChainDataLength() <=
+          uncompressedSize * minCompressionRatio_) {
+        codec |= kCompressedBitMask;
+        writeIOBuf(*compressed, out);
+      } else {
+        writeIOBuf(*uncompressed, out);
+      }
     }
 
     // Pause CRC computation
@@ -1716,25 +1994,55 @@ class PrestoVectorSerializer : public VectorSerializer {
       listener->pause();
     }
 
-    // Fill in uncompressedSizeInBytes & sizeInBytes
+    // Fill in codec, uncompressedSizeInBytes & sizeInBytes
     int32_t size = (int32_t)out->tellp() - offset;
-    int32_t uncompressedSize = size - kHeaderSize;
+    int32_t sizeInBytes = size - kHeaderSize;
     int64_t crc = 0;
     if (listener) {
       crc = computeChecksum(listener, codec, numRows, uncompressedSize);
     }
 
-    out->seekp(offset + kSizeInBytesOffset);
-    writeInt32(out, uncompressedSize);
+    out->seekp(offset + kCodecOffset);
+    out->write(&codec, 1);
     writeInt32(out, uncompressedSize);
+    writeInt32(out, sizeInBytes);
     writeInt64(out, crc);
     out->seekp(offset + size);
   }
 
  private:
-  static const int32_t kSizeInBytesOffset{4 + 1};
+  static const int32_t kCodecOffset{4};
+  static const int32_t kSizeInBytesOffset{kCodecOffset + 1};
   static const int32_t kHeaderSize{kSizeInBytesOffset + 4 + 4 + 8};
 
+  // Writes the number of columns, the RLE marker if 'rle' and the columns.
+  void writeColumns(int32_t numRows, bool rle, OutputStream* out) {
+    writeInt32(out, streams_.size());
+
+    if (rle) {
+      // Write RLE encoding marker.
+      writeInt32(out, kRLE.size());
+      out->write(kRLE.data(), kRLE.size());
+      // Write number of RLE values.
+      writeInt32(out, numRows);
+    }
+
+    for (auto& stream : streams_) {
+      stream->flush(out);
+    }
+  }
+
+  static void writeIOBuf(const folly::IOBuf& iobuf, OutputStream* out) {
+    for (auto range : iobuf) {
+      out->write(reinterpret_cast<const char*>(range.data()), range.size());
+    }
+  }
+
+  memory::MemoryPool* const pool_;
+  const std::unique_ptr<folly::io::Codec> codec_;
+  const float minCompressionRatio_;
+  const bool preserveEncodings_;
+
   int32_t numRows_{0};
   std::vector<std::unique_ptr<VectorStream>> streams_;
 };
@@ -1752,11 +2060,13 @@ std::unique_ptr<VectorSerializer> PrestoVectorSerde::createSerializer(
     int32_t numRows,
     StreamArena* streamArena,
     const Options* options) {
-  bool useLosslessTimestamp = options != nullptr
-      ? static_cast<const PrestoOptions*>(options)->useLosslessTimestamp
-      : false;
+  static const PrestoOptions kDefaultOptions{};
   return std::make_unique<PrestoVectorSerializer>(
-      type, numRows, streamArena, useLosslessTimestamp);
+      type,
+      numRows,
+      streamArena,
+      options != nullptr ? *static_cast<const PrestoOptions*>(options)
+                         : kDefaultOptions);
 }
 
 void PrestoVectorSerde::serializeConstants(
@@ -1789,25 +2099,47 @@ void PrestoVectorSerde::deserialize(
 
   auto pageCodecMarker = source->read<int8_t>();
   auto uncompressedSize = source->read<int32_t>();
-  // skip size in bytes
-  source->skip(4);
+  auto sizeInBytes = source->read<int32_t>();
   auto checksum = source->read<int64_t>();
 
   int64_t actualCheckSum = 0;
   if (isChecksumBitSet(pageCodecMarker)) {
-    actualCheckSum =
-        computeChecksum(source, pageCodecMarker, numRows, uncompressedSize);
+    actualCheckSum = computeChecksum(
+        source, pageCodecMarker, numRows, uncompressedSize, sizeInBytes);
   }
 
   VELOX_CHECK_EQ(
       checksum, actualCheckSum, "Received corrupted serialized page.");
 
-  // skip number of columns
-  source->skip(4);
-
   auto children = &(*result)->children();
   auto childTypes = type->as<TypeKind::ROW>().children();
-  readColumns(source, pool, childTypes, children, useLosslessTimestamp);
+
+  if (!isCompressedBitSet(pageCodecMarker)) {
+    // skip number of columns
+    source->skip(4);
+    readColumns(source, pool, childTypes, children, useLosslessTimestamp);
+    return;
+  }
+
+  const auto compressionKind = options != nullptr
+      ? static_cast<const PrestoOptions*>(options)->compressionKind
+      : folly::io::CodecType::NO_COMPRESSION;
+  auto codec = getCompressionCodec(compressionKind);
+  VELOX_CHECK_NOT_NULL(
+      codec, "Received compressed page but no compression codec is set.");
+  auto compressed = folly::IOBuf::create(sizeInBytes);
+  source->readBytes(compressed->writableData(), sizeInBytes);
+  compressed->append(sizeInBytes);
+  auto uncompressed = codec->uncompress(compressed.get(), uncompressedSize);
+  uncompressed->coalesce();
+
+  ByteStream uncompressedSource;
+  uncompressedSource.resetInput({ByteRange{
+      uncompressed->writableData(), (int32_t)uncompressed->length(), 0}});
+  // skip number of columns
+  uncompressedSource.skip(4);
+  readColumns(
+      &uncompressedSource, pool, childTypes, children, useLosslessTimestamp);
 }
 
 // static
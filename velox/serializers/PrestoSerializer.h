@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 #pragma once
+#include <folly/compression/Compression.h>
+
 #include "velox/common/base/Crc.h"
 #include "velox/vector/VectorStream.h"
 
@@ -22,13 +24,35 @@ class PrestoVectorSerde : public VectorSerde {
  public:
   // Input options that the serializer recognizes.
   struct PrestoOptions : VectorSerde::Options {
-    explicit PrestoOptions(bool useLosslessTimestamp)
-        : useLosslessTimestamp(useLosslessTimestamp) {}
+    PrestoOptions() = default;
+
+    explicit PrestoOptions(
+        bool useLosslessTimestamp,
+        folly::io::CodecType compressionKind =
+            folly::io::CodecType::NO_COMPRESSION)
+        : useLosslessTimestamp(useLosslessTimestamp),
+          compressionKind(compressionKind) {}
+
     // Currently presto only supports millisecond precision and the serializer
     // converts velox native timestamp to that resulting in loss of precision.
     // This option allows it to serialize with nanosecond precision and is
     // currently used for spilling. Is false by default.
     bool useLosslessTimestamp{false};
+
+    // Codec used to compress serialized pages, e.g. LZ4 or ZSTD. The page
+    // header does not record the codec, so the reader must be given the same
+    // option to decompress. Pages are written uncompressed if NO_COMPRESSION.
+    folly::io::CodecType compressionKind{folly::io::CodecType::NO_COMPRESSION};
+
+    // A page is sent compressed only if the compressed size is at most this
+    // fraction of the uncompressed size. Presto uses the same threshold.
+    float minCompressionRatio{0.8};
+
+    // If true, top level columns that arrive constant or dictionary encoded
+    // are serialized as RLE or DICTIONARY blocks instead of being flattened,
+    // provided that this makes the page smaller. The deserializer returns
+    // these columns as constant and dictionary vectors.
+    bool preserveEncodings{false};
   };
 
   void estimateSerializedSize(
@@ -290,6 +290,151 @@ TEST_F(PrestoSerializerTest, multiPage) {
   ASSERT_TRUE(byteStream->atEnd());
 }
 
+TEST_F(PrestoSerializerTest, compression) {
+  // Offset of the codec marker in the page header.
+  constexpr int32_t kCodecOffset = 4;
+  constexpr int8_t kCompressedBitMask = 1;
+
+  for (auto kind : {folly::io::CodecType::LZ4, folly::io::CodecType::ZSTD}) {
+    if (!folly::io::hasCodec(kind)) {
+      continue;
+    }
+    SCOPED_TRACE(fmt::format("codec: {}", static_cast<int>(kind)));
+    const serializer::presto::PrestoVectorSerde::PrestoOptions options(
+        false, kind);
+
+    auto compressible = vectorMaker_->rowVector({
+        vectorMaker_->flatVector<int64_t>(
+            10'000, [](auto row) { return row % 7; }),
+        vectorMaker_->flatVector<StringView>(
+            10'000, [](auto row) { return row % 2 ? "apple" : "banana"; }),
+    });
+    std::ostringstream compressedOut;
+    serialize(compressible, &compressedOut, &options);
+    auto compressed = compressedOut.str();
+    ASSERT_TRUE(compressed[kCodecOffset] & kCompressedBitMask);
+
+    std::ostringstream plainOut;
+    serialize(compressible, &plainOut, nullptr);
+    ASSERT_LT(compressed.size(), plainOut.str().size());
+
+    auto rowType = asRowType(compressible->type());
+    assertEqualVectors(
+        deserialize(rowType, compressed, &options), compressible);
+    VELOX_ASSERT_THROW(
+        deserialize(rowType, compressed, nullptr),
+        "Received compressed page but no compression codec is set.");
+
+    // Random data does not compress and is sent as is.
+    auto incompressible =
+        vectorMaker_->rowVector({vectorMaker_->flatVector<int64_t>(
+            1'000, [](auto /*row*/) { return folly::Random::rand64(); })});
+    std::ostringstream out;
+    serialize(incompressible, &out, &options);
+    ASSERT_FALSE(out.str()[kCodecOffset] & kCompressedBitMask);
+    assertEqualVectors(
+        deserialize(asRowType(incompressible->type()), out.str(), &options),
+        incompressible);
+  }
+}
+
+TEST_F(PrestoSerializerTest, preserveEncodings) {
+  serializer::presto::PrestoVectorSerde::PrestoOptions options;
+  options.preserveEncodings = true;
+
+  auto base = vectorMaker_->flatVector<StringView>(10, [](auto row) {
+    return row % 2 ? "a string that is not inlined" : "short";
+  });
+  auto indices = makeIndices(
+      1'000, [](auto row) { return (row * 7) % 10; }, pool_.get());
+  auto dictionary = BaseVector::wrapInDictionary(
+      BufferPtr(nullptr), indices, 1'000, base);
+  auto constant = BaseVector::wrapInConstant(1'000, 3, base);
+
+  auto rowVector = vectorMaker_->rowVector({dictionary, constant});
+  auto rowType = asRowType(rowVector->type());
+  std::ostringstream out;
+  serialize(rowVector, &out, &options);
+  auto deserialized = deserialize(rowType, out.str(), &options);
+  assertEqualVectors(rowVector, deserialized);
+  ASSERT_EQ(
+      VectorEncoding::Simple::DICTIONARY,
+      deserialized->childAt(0)->encoding());
+  ASSERT_EQ(
+      VectorEncoding::Simple::CONSTANT, deserialized->childAt(1)->encoding());
+
+  std::ostringstream flatOut;
+  serialize(rowVector, &flatOut, nullptr);
+  ASSERT_LT(out.str().size(), flatOut.str().size() / 2);
+
+  // A dictionary that references most of its base is flattened.
+  auto wideDictionary = BaseVector::wrapInDictionary(
+      BufferPtr(nullptr), makeIndicesInReverse(10, pool_.get()), 10, base);
+  rowVector = vectorMaker_->rowVector({wideDictionary, base});
+  std::ostringstream wideOut;
+  serialize(rowVector, &wideOut, &options);
+  deserialized = deserialize(rowType, wideOut.str(), &options);
+  assertEqualVectors(rowVector, deserialized);
+  ASSERT_EQ(
+      VectorEncoding::Simple::FLAT, deserialized->childAt(0)->encoding());
+}
+
+TEST_F(PrestoSerializerTest, preserveEncodingsMultipleBatches) {
+  serializer::presto::PrestoVectorSerde::PrestoOptions options;
+  options.preserveEncodings = true;
+
+  auto base = vectorMaker_->flatVector<int64_t>(
+      100, [](auto row) { return row; }, VectorMaker::nullEvery(13));
+  auto indices =
+      makeIndices(500, [](auto row) { return row % 20; }, pool_.get());
+  BufferPtr nulls = AlignedBuffer::allocate<bool>(500, pool_.get());
+  auto rawNulls = nulls->asMutable<uint64_t>();
+  for (auto i = 0; i < 500; ++i) {
+    bits::setNull(rawNulls, i, i % 11 == 0);
+  }
+
+  // The first batches are RLE. The third one turns the column into a
+  // dictionary, to which the next batches add their rows.
+  std::vector<VectorPtr> batches = {
+      BaseVector::wrapInConstant(50, 1, base),
+      BaseVector::wrapInConstant(30, 1, base),
+      BaseVector::createNullConstant(BIGINT(), 20, pool_.get()),
+      BaseVector::wrapInDictionary(nulls, indices, 500, base),
+      vectorMaker_->flatVector<int64_t>(40, [](auto row) { return -row; }),
+      BaseVector::wrapInDictionary(nullptr, indices, 500, base),
+  };
+
+  auto rowType = ROW({"c0"}, {BIGINT()});
+  vector_size_t totalSize = 0;
+  for (const auto& batch : batches) {
+    totalSize += batch->size();
+  }
+  auto expected = BaseVector::create(BIGINT(), totalSize, pool_.get());
+
+  auto arena = std::make_unique<StreamArena>(pool_.get());
+  auto serializer =
+      serde_->createSerializer(rowType, totalSize, arena.get(), &options);
+  vector_size_t offset = 0;
+  for (const auto& batch : batches) {
+    std::vector<IndexRange> ranges{{0, batch->size()}};
+    serializer->append(
+        vectorMaker_->rowVector({batch}),
+        folly::Range(ranges.data(), ranges.size()));
+    expected->copy(batch.get(), offset, 0, batch->size());
+    offset += batch->size();
+  }
+  facebook::velox::serializer::presto::PrestoOutputStreamListener listener;
+  std::ostringstream out;
+  OStreamOutputStream output(&out, &listener);
+  serializer->flush(&output);
+
+  auto deserialized = deserialize(rowType, out.str(), &options);
+  ASSERT_EQ(
+      VectorEncoding::Simple::DICTIONARY,
+      deserialized->childAt(0)->encoding());
+  assertEqualVectors(expected, deserialized->childAt(0));
+}
+
 TEST_F(PrestoSerializerTest, timestampWithNanosecondPrecision) {
   // Verify that nanosecond precision is preserved when the right options are
   // passed to the serde.
@@ -24,7 +24,9 @@
 
 #include <folly/Range.h>
 #include <folly/container/F14Set.h>
+#include <folly/hash/Hash.h>
 
+#include "velox/common/base/BloomFilter.h"
 #include "velox/common/base/Exceptions.h"
 #include "velox/common/base/SimdUtil.h"
 #include "velox/type/StringView.h"
@@ -52,6 +54,8 @@ enum class FilterKind {
   kNegatedBytesValues,
   kBigintMultiRange,
   kMultiRange,
+  kBigintValuesUsingBloomFilter,
+  kBytesValuesUsingBloomFilter,
 };
 
 /**
@@ -962,6 +966,89 @@ class NegatedBigintValuesUsingBitmask final : public Filter {
   std::unique_ptr<BigintValuesUsingBitmask> nonNegated_;
 };
 
+/// IN-list filter for integral data types implemented as a Bloom filter over
+/// the hashes of the values. May pass values that are not in the list. Used
+/// for filters pushed down from a hash join build side when the build keys are
+/// too many to list. The Bloom filter is shared between copies of the filter.
+/// When merged with another filter, the other filter is kept as 'conjunct' and
+/// both must pass.
+class BigintValuesUsingBloomFilter final : public Filter {
+ public:
+  /// @param min Minimum value.
+  /// @param max Maximum value.
+  /// @param bloomFilter Bloom filter with hash(value) inserted for all values
+  /// that pass the filter.
+  /// @param nullAllowed Null values are passing the filter if true.
+  /// @param conjunct Optional filter that must also pass.
+  BigintValuesUsingBloomFilter(
+      int64_t min,
+      int64_t max,
+      std::shared_ptr<const BloomFilter<>> bloomFilter,
+      bool nullAllowed,
+      std::shared_ptr<const Filter> conjunct = nullptr)
+      : Filter(true, nullAllowed, FilterKind::kBigintValuesUsingBloomFilter),
+        min_(min),
+        max_(max),
+        bloomFilter_(std::move(bloomFilter)),
+        conjunct_(std::move(conjunct)) {
+    VELOX_CHECK_LE(min_, max_);
+    VELOX_CHECK_NOT_NULL(bloomFilter_);
+  }
+
+  BigintValuesUsingBloomFilter(
+      const BigintValuesUsingBloomFilter& other,
+      bool nullAllowed)
+      : Filter(true, nullAllowed, other.kind()),
+        min_(other.min_),
+        max_(other.max_),
+        bloomFilter_(other.bloomFilter_),
+        conjunct_(other.conjunct_) {}
+
+  std::unique_ptr<Filter> clone(
+      std::optional<bool> nullAllowed = std::nullopt) const final {
+    return std::make_unique<BigintValuesUsingBloomFilter>(
+        *this, nullAllowed.value_or(nullAllowed_));
+  }
+
+  /// Returns the hash number to insert into the Bloom filter for 'value'.
+  static uint64_t hash(int64_t value) {
+    return folly::hash::twang_mix64(value);
+  }
+
+  bool testInt64(int64_t value) const final {
+    return value >= min_ && value <= max_ &&
+        bloomFilter_->mayContain(hash(value)) &&
+        (!conjunct_ || conjunct_->testInt64(value));
+  }
+
+  bool testInt64Range(int64_t min, int64_t max, bool hasNull) const final;
+
+  std::unique_ptr<Filter> mergeWith(const Filter* other) const final;
+
+  int64_t min() const {
+    return min_;
+  }
+
+  int64_t max() const {
+    return max_;
+  }
+
+  std::string toString() const final {
+    return fmt::format(
+        "BigintValuesUsingBloomFilter: [{}, {}] {}{}",
+        min_,
+        max_,
+        nullAllowed_ ? "with nulls" : "no nulls",
+        conjunct_ ? " and " + conjunct_->toString() : "");
+  }
+
+ private:
+  const int64_t min_;
+  const int64_t max_;
+  const std::shared_ptr<const BloomFilter<>> bloomFilter_;
+  const std::shared_ptr<const Filter> conjunct_;
+};
+
 /// Base class for range filters on floating point and string data types.
 class AbstractRange : public Filter {
  public:
@@ -1619,6 +1706,67 @@ class NegatedBytesValues final : public Filter {
   std::unique_ptr<BytesValues> nonNegated_;
 };
 
+/// IN-list filter for string data type implemented as a Bloom filter over the
+/// hashes of the values. May pass values that are not in the list. See
+/// BigintValuesUsingBloomFilter.
+class BytesValuesUsingBloomFilter final : public Filter {
+ public:
+  /// @param bloomFilter Bloom filter with hash(value) inserted for all values
+  /// that pass the filter.
+  /// @param nullAllowed Null values are passing the filter if true.
+  /// @param conjunct Optional filter that must also pass.
+  BytesValuesUsingBloomFilter(
+      std::shared_ptr<const BloomFilter<>> bloomFilter,
+      bool nullAllowed,
+      std::shared_ptr<const Filter> conjunct = nullptr)
+      : Filter(true, nullAllowed, FilterKind::kBytesValuesUsingBloomFilter),
+        bloomFilter_(std::move(bloomFilter)),
+        conjunct_(std::move(conjunct)) {
+    VELOX_CHECK_NOT_NULL(bloomFilter_);
+  }
+
+  BytesValuesUsingBloomFilter(
+      const BytesValuesUsingBloomFilter& other,
+      bool nullAllowed)
+      : Filter(true, nullAllowed, other.kind()),
+        bloomFilter_(other.bloomFilter_),
+        conjunct_(other.conjunct_) {}
+
+  std::unique_ptr<Filter> clone(
+      std::optional<bool> nullAllowed = std::nullopt) const final {
+    return std::make_unique<BytesValuesUsingBloomFilter>(
+        *this, nullAllowed.value_or(nullAllowed_));
+  }
+
+  /// Returns the hash number to insert into the Bloom filter for 'value'.
+  static uint64_t hash(const char* value, int32_t length) {
+    return folly::hash::SpookyHashV2::Hash64(value, length, 0);
+  }
+
+  bool testBytes(const char* value, int32_t length) const final {
+    return bloomFilter_->mayContain(hash(value, length)) &&
+        (!conjunct_ || conjunct_->testBytes(value, length));
+  }
+
+  bool testBytesRange(
+      std::optional<std::string_view> min,
+      std::optional<std::string_view> max,
+      bool hasNull) const final;
+
+  std::unique_ptr<Filter> mergeWith(const Filter* other) const final;
+
+  std::string toString() const final {
+    return fmt::format(
+        "BytesValuesUsingBloomFilter: {}{}",
+        nullAllowed_ ? "with nulls" : "no nulls",
+        conjunct_ ? " and " + conjunct_->toString() : "");
+  }
+
+ private:
+  const std::shared_ptr<const BloomFilter<>> bloomFilter_;
+  const std::shared_ptr<const Filter> conjunct_;
+};
+
 /// Represents a combination of two of more filters with
 /// OR semantics. The filter passes if at least one of the contained filters
 /// passes.
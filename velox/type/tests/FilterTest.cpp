@@ -1729,3 +1729,77 @@ TEST(FilterTest, mergeWithBytesMultiRange) {
     }
   }
 }
+
+TEST(FilterTest, bigintValuesUsingBloomFilter) {
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(1000);
+  for (auto i = 0; i < 1000; ++i) {
+    bloomFilter->insert(BigintValuesUsingBloomFilter::hash(i * 1000));
+  }
+  BigintValuesUsingBloomFilter filter(0, 999'000, bloomFilter, false);
+  int32_t numFalsePositives = 0;
+  for (auto i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(filter.testInt64(i * 1000));
+    numFalsePositives += filter.testInt64(i * 1000 + 1);
+  }
+  EXPECT_LT(numFalsePositives, 100);
+  EXPECT_FALSE(filter.testNull());
+  EXPECT_FALSE(filter.testInt64(-1000));
+  EXPECT_FALSE(filter.testInt64(1'000'000));
+
+  EXPECT_TRUE(filter.testInt64Range(-10, 10, false));
+  EXPECT_TRUE(filter.testInt64Range(5000, 5000, false));
+  EXPECT_FALSE(filter.testInt64Range(-10, -1, false));
+  EXPECT_FALSE(filter.testInt64Range(1'000'000, 2'000'000, false));
+
+  // Merging with a range narrows the range of the filter.
+  BigintRange range(2000, 2'000'000, false);
+  auto merged = filter.mergeWith(&range);
+  ASSERT_EQ(merged->kind(), FilterKind::kBigintValuesUsingBloomFilter);
+  EXPECT_FALSE(merged->testInt64(1000));
+  EXPECT_TRUE(merged->testInt64(2000));
+  EXPECT_TRUE(range.mergeWith(&filter)->testInt64(2000));
+  EXPECT_FALSE(range.mergeWith(&filter)->testInt64(1000));
+
+  // Merging with an IN-list keeps both filters.
+  auto values = createBigintValues({1000, 3000, 12345}, false);
+  merged = values->mergeWith(&filter);
+  ASSERT_EQ(merged->kind(), FilterKind::kBigintValuesUsingBloomFilter);
+  EXPECT_TRUE(merged->testInt64(1000));
+  EXPECT_FALSE(merged->testInt64(2000));
+  EXPECT_FALSE(merged->testInt64Range(1001, 2999, false));
+
+  auto clone = filter.clone(true);
+  EXPECT_TRUE(clone->testNull());
+  EXPECT_TRUE(clone->testInt64(5000));
+}
+
+TEST(FilterTest, bytesValuesUsingBloomFilter) {
+  std::vector<std::string> values({"Igne", "natura", "renovitur", "integra."});
+  auto bloomFilter = std::make_shared<BloomFilter<>>();
+  bloomFilter->reset(values.size());
+  for (const auto& value : values) {
+    bloomFilter->insert(
+        BytesValuesUsingBloomFilter::hash(value.data(), value.size()));
+  }
+  BytesValuesUsingBloomFilter filter(bloomFilter, false);
+  for (const auto& value : values) {
+    EXPECT_TRUE(filter.testBytes(value.data(), value.size()));
+    EXPECT_TRUE(filter.testBytesRange(value, value, false));
+  }
+  EXPECT_FALSE(filter.testNull());
+  EXPECT_TRUE(filter.testBytesRange("a", "z", false));
+
+  BytesRange range("A", false, false, "j", false, false, false);
+  auto merged = range.mergeWith(&filter);
+  ASSERT_EQ(merged->kind(), FilterKind::kBytesValuesUsingBloomFilter);
+  EXPECT_TRUE(merged->testBytes("Igne", 4));
+  EXPECT_TRUE(merged->testBytes("integra.", 8));
+  EXPECT_FALSE(merged->testBytes("natura", 6));
+  EXPECT_FALSE(merged->testBytesRange("k", "m", false));
+
+  IsNotNull isNotNull;
+  EXPECT_FALSE(filter.clone(true)->mergeWith(&isNotNull)->testNull());
+  IsNull isNull;
+  EXPECT_EQ(filter.mergeWith(&isNull)->kind(), FilterKind::kAlwaysFalse);
+}
@@ -29,17 +29,40 @@ namespace facebook::velox {
 namespace {
 
 // The supported conversions use one buffer for nulls (0), one for values (1),
-// and one for offsets (2).
+// and one for offsets (2). String views use one buffer for nulls (0), one for
+// the views (1), one per data buffer and a last one for the data buffer sizes.
 static constexpr size_t kMaxBuffers{3};
 
+// A string in Arrow's Utf8View and BinaryView layouts. Strings of up to 12
+// bytes are inlined as in StringView. Longer strings have a 4 byte prefix
+// followed by the index of the data buffer and the offset in it instead of a
+// pointer.
+struct ArrowStringView {
+  int32_t size;
+  union {
+    char inlined[StringView::kInlineSize];
+    struct {
+      char prefix[StringView::kPrefixSize];
+      int32_t bufferIndex;
+      int32_t offset;
+    } ref;
+  };
+};
+
+static_assert(sizeof(ArrowStringView) == sizeof(StringView));
+
 // Structure that will hold the buffers needed by ArrowArray. This is opaquely
 // carried by ArrowArray.private_data
 class VeloxToArrowBridgeHolder {
  public:
-  VeloxToArrowBridgeHolder() {
-    for (size_t i = 0; i < kMaxBuffers; ++i) {
-      buffers_[i] = nullptr;
-    }
+  VeloxToArrowBridgeHolder()
+      : buffers_(kMaxBuffers, nullptr), bufferPtrs_(kMaxBuffers) {}
+
+  // Sets the number of buffers for layouts that need more than kMaxBuffers.
+  // Invalidates the result of getArrowBuffers().
+  void resizeBuffers(size_t numBuffers) {
+    buffers_.resize(numBuffers, nullptr);
+    bufferPtrs_.resize(numBuffers);
   }
 
   // Acquires a buffer at index `idx`.
@@ -56,7 +79,7 @@ class VeloxToArrowBridgeHolder {
   }
 
   const void** getArrowBuffers() {
-    return buffers_;
+    return buffers_.data();
   }
 
   // Allocates space for `numChildren` ArrowArray pointers.
@@ -87,11 +110,11 @@ class VeloxToArrowBridgeHolder {
 
  private:
   // Holds the pointers to the arrow buffers.
-  const void* buffers_[kMaxBuffers];
+  std::vector<const void*> buffers_;
 
   // Holds ownership over the Buffers being referenced by the buffers vector
   // above.
-  BufferPtr bufferPtrs_[kMaxBuffers];
+  std::vector<BufferPtr> bufferPtrs_;
 
   // Auxiliary buffers to hold ownership over ArrowArray children structures.
   std::vector<std::unique_ptr<ArrowArray>> childrenPtrs_;
@@ -209,6 +232,7 @@ static void releaseArrowSchema(ArrowSchema* arrowSchema) {
 // Returns the Arrow C data interface format type for a given Velox type.
 const char* exportArrowFormatStr(
     const TypePtr& type,
+    const ArrowOptions& options,
     std::string& formatBuffer) {
   switch (type->kind()) {
     // Scalar types.
@@ -233,12 +257,12 @@ const char* exportArrowFormatStr(
       formatBuffer = fmt::format("d:{},{}", precision, scale);
       return formatBuffer.c_str();
     }
-    // We always map VARCHAR and VARBINARY to the "small" version (lower case
-    // format string), which uses 32 bit offsets.
+    // We map VARCHAR and VARBINARY to the "small" version (lower case format
+    // string), which uses 32 bit offsets, unless string views are requested.
     case TypeKind::VARCHAR:
-      return "u"; // utf-8 string
+      return options.exportToStringView ? "vu" : "u"; // utf-8 string (view)
     case TypeKind::VARBINARY:
-      return "z"; // binary
+      return options.exportToStringView ? "vz" : "z"; // binary (view)
 
     case TypeKind::TIMESTAMP:
       // TODO: need to figure out how we'll map this since in Velox we currently
@@ -412,11 +436,111 @@ void exportStrings(
   VELOX_DCHECK_EQ(bufSize, *rawOffsets);
 }
 
+// Exports strings as Utf8View or BinaryView. The string buffers of 'vec' are
+// exported as the data buffers without copying. Only the StringViews are
+// rewritten to refer to a data buffer by index and offset. Strings that are
+// not in a string buffer of 'vec', e.g. strings of a buffer view, are copied
+// to an extra data buffer.
+void exportStringViews(
+    const FlatVector<StringView>& vec,
+    const Selection& rows,
+    ArrowArray& out,
+    memory::MemoryPool* pool,
+    VeloxToArrowBridgeHolder& holder) {
+  const auto& stringBuffers = vec.stringBuffers();
+  // Start addresses of the string buffers with their indices, sorted by
+  // address.
+  std::vector<std::pair<const char*, int32_t>> bufferStarts;
+  bufferStarts.reserve(stringBuffers.size());
+  for (int32_t i = 0; i < stringBuffers.size(); ++i) {
+    bufferStarts.emplace_back(stringBuffers[i]->as<char>(), i);
+  }
+  std::sort(bufferStarts.begin(), bufferStarts.end());
+
+  auto contains = [&](int32_t index, const StringView& value) {
+    const auto* start = stringBuffers[index]->as<char>();
+    return value.data() >= start &&
+        value.data() + value.size() <= start + stringBuffers[index]->size() &&
+        value.data() - start <= std::numeric_limits<int32_t>::max();
+  };
+
+  // Returns the index of the string buffer containing 'value' or -1. Strings
+  // of consecutive rows are mostly in the same buffer.
+  int32_t lastIndex = -1;
+  auto findBuffer = [&](const StringView& value) {
+    if (lastIndex >= 0 && contains(lastIndex, value)) {
+      return lastIndex;
+    }
+    auto it = std::upper_bound(
+        bufferStarts.begin(),
+        bufferStarts.end(),
+        value.data(),
+        [](const char* data, const auto& bufferStart) {
+          return data < bufferStart.first;
+        });
+    if (it != bufferStarts.begin() && contains(std::prev(it)->second, value)) {
+      lastIndex = std::prev(it)->second;
+      return lastIndex;
+    }
+    return -1;
+  };
+
+  auto views = AlignedBuffer::allocate<StringView>(out.length, pool);
+  auto* rawViews = views->asMutable<ArrowStringView>();
+  std::string extraData;
+  vector_size_t j = 0;
+  rows.apply([&](vector_size_t i) {
+    auto& view = rawViews[j++];
+    std::memset(&view, 0, sizeof(view));
+    if (vec.isNullAt(i)) {
+      return;
+    }
+    const auto& value = vec.valueAtFast(i);
+    view.size = value.size();
+    if (value.isInline()) {
+      std::memcpy(view.inlined, value.data(), value.size());
+      return;
+    }
+    std::memcpy(view.ref.prefix, value.data(), StringView::kPrefixSize);
+    auto index = findBuffer(value);
+    if (index >= 0) {
+      view.ref.bufferIndex = index;
+      view.ref.offset = value.data() - stringBuffers[index]->as<char>();
+    } else {
+      VELOX_CHECK_LE(
+          extraData.size() + value.size(),
+          std::numeric_limits<int32_t>::max());
+      view.ref.bufferIndex = stringBuffers.size();
+      view.ref.offset = extraData.size();
+      extraData.append(value.data(), value.size());
+    }
+  });
+
+  const auto numDataBuffers = stringBuffers.size() + !extraData.empty();
+  holder.resizeBuffers(3 + numDataBuffers);
+  holder.setBuffer(1, views);
+  auto sizes = AlignedBuffer::allocate<int64_t>(numDataBuffers, pool);
+  auto* rawSizes = sizes->asMutable<int64_t>();
+  for (auto i = 0; i < stringBuffers.size(); ++i) {
+    holder.setBuffer(2 + i, stringBuffers[i]);
+    rawSizes[i] = stringBuffers[i]->size();
+  }
+  if (!extraData.empty()) {
+    auto extra = AlignedBuffer::allocate<char>(extraData.size(), pool);
+    std::memcpy(extra->asMutable<char>(), extraData.data(), extraData.size());
+    holder.setBuffer(2 + stringBuffers.size(), extra);
+    rawSizes[stringBuffers.size()] = extraData.size();
+  }
+  holder.setBuffer(2 + numDataBuffers, sizes);
+  out.n_buffers = 3 + numDataBuffers;
+}
+
 void exportFlat(
     const BaseVector& vec,
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
+    const ArrowOptions& options,
     VeloxToArrowBridgeHolder& holder) {
   out.n_children = 0;
   out.children = nullptr;
@@ -435,8 +559,21 @@ void exportFlat(
       break;
     case TypeKind::VARCHAR:
     case TypeKind::VARBINARY:
-      exportStrings(
-          *vec.asUnchecked<FlatVector<StringView>>(), rows, out, pool, holder);
+      if (options.exportToStringView) {
+        exportStringViews(
+            *vec.asUnchecked<FlatVector<StringView>>(),
+            rows,
+            out,
+            pool,
+            holder);
+      } else {
+        exportStrings(
+            *vec.asUnchecked<FlatVector<StringView>>(),
+            rows,
+            out,
+            pool,
+            holder);
+      }
       break;
     default:
       VELOX_NYI(
@@ -449,13 +586,15 @@ void exportBase(
     const BaseVector&,
     const Selection&,
     ArrowArray&,
-    memory::MemoryPool*);
+    memory::MemoryPool*,
+    const ArrowOptions&);
 
 void exportRows(
     const RowVector& vec,
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
+    const ArrowOptions& options,
     VeloxToArrowBridgeHolder& holder) {
   out.n_buffers = 1;
   holder.resizeChildren(vec.childrenSize());
@@ -467,7 +606,8 @@ void exportRows(
           *vec.childAt(i)->loadedVector(),
           rows,
           *holder.allocateChild(i),
-          pool);
+          pool,
+          options);
     } catch (const VeloxException&) {
       for (column_index_t j = 0; j < i; ++j) {
         // When exception is thrown, i th child is guaranteed unset.
@@ -528,6 +668,7 @@ void exportArrays(
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
+    const ArrowOptions& options,
     VeloxToArrowBridgeHolder& holder) {
   Selection childRows(vec.elements()->size());
   exportOffsets(vec, rows, out, pool, holder, childRows);
@@ -536,7 +677,8 @@ void exportArrays(
       *vec.elements()->loadedVector(),
       childRows,
       *holder.allocateChild(0),
-      pool);
+      pool,
+      options);
   out.n_children = 1;
   out.children = holder.getChildrenArrays();
 }
@@ -546,6 +688,7 @@ void exportMaps(
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
+    const ArrowOptions& options,
     VeloxToArrowBridgeHolder& holder) {
   RowVector child(
       pool,
@@ -556,7 +699,7 @@ void exportMaps(
   Selection childRows(child.size());
   exportOffsets(vec, rows, out, pool, holder, childRows);
   holder.resizeChildren(1);
-  exportBase(child, childRows, *holder.allocateChild(0), pool);
+  exportBase(child, childRows, *holder.allocateChild(0), pool, options);
   out.n_children = 1;
   out.children = holder.getChildrenArrays();
 }
@@ -566,6 +709,7 @@ void exportDictionary(
     const Selection& rows,
     ArrowArray& out,
     memory::MemoryPool* pool,
+    const ArrowOptions& options,
     VeloxToArrowBridgeHolder& holder) {
   out.n_buffers = 2;
   out.n_children = 0;
@@ -578,39 +722,45 @@ void exportDictionary(
   }
   auto& values = *vec.valueVector()->loadedVector();
   out.dictionary = holder.allocateDictionary();
-  exportBase(values, Selection(values.size()), *out.dictionary, pool);
+  exportBase(
+      values, Selection(values.size()), *out.dictionary, pool, options);
 }
 
 void exportBase(
     const BaseVector& vec,
     const Selection& rows,
     ArrowArray& out,
-    memory::MemoryPool* pool) {
+    memory::MemoryPool* pool,
+    const ArrowOptions& options) {
   auto holder = std::make_unique<VeloxToArrowBridgeHolder>();
-  out.buffers = holder->getArrowBuffers();
   out.length = rows.count();
   out.offset = 0;
   out.dictionary = nullptr;
   exportNulls(vec, rows, out, pool, *holder);
   switch (vec.encoding()) {
     case VectorEncoding::Simple::FLAT:
-      exportFlat(vec, rows, out, pool, *holder);
+      exportFlat(vec, rows, out, pool, options, *holder);
       break;
     case VectorEncoding::Simple::ROW:
-      exportRows(*vec.asUnchecked<RowVector>(), rows, out, pool, *holder);
+      exportRows(
+          *vec.asUnchecked<RowVector>(), rows, out, pool, options, *holder);
       break;
     case VectorEncoding::Simple::ARRAY:
-      exportArrays(*vec.asUnchecked<ArrayVector>(), rows, out, pool, *holder);
+      exportArrays(
+          *vec.asUnchecked<ArrayVector>(), rows, out, pool, options, *holder);
       break;
     case VectorEncoding::Simple::MAP:
-      exportMaps(*vec.asUnchecked<MapVector>(), rows, out, pool, *holder);
+      exportMaps(
+          *vec.asUnchecked<MapVector>(), rows, out, pool, options, *holder);
       break;
     case VectorEncoding::Simple::DICTIONARY:
-      exportDictionary(vec, rows, out, pool, *holder);
+      exportDictionary(vec, rows, out, pool, options, *holder);
       break;
     default:
       VELOX_NYI("{} cannot be exported to Arrow yet.", vec.encoding());
   }
+  // Set after the export since string views may resize the buffers.
+  out.buffers = holder->getArrowBuffers();
   out.private_data = holder.release();
   out.release = releaseArrowArray;
 }
@@ -620,11 +770,15 @@ void exportBase(
 void exportToArrow(
     const VectorPtr& vector,
     ArrowArray& arrowArray,
-    memory::MemoryPool* pool) {
-  exportBase(*vector, Selection(vector->size()), arrowArray, pool);
+    memory::MemoryPool* pool,
+    const ArrowOptions& options) {
+  exportBase(*vector, Selection(vector->size()), arrowArray, pool, options);
 }
 
-void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
+void exportToArrow(
+    const VectorPtr& vec,
+    ArrowSchema& arrowSchema,
+    const ArrowOptions& options) {
   auto& type = vec->type();
 
   arrowSchema.name = nullptr;
@@ -644,10 +798,11 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
     arrowSchema.format = "i";
     bridgeHolder->dictionary = std::make_unique<ArrowSchema>();
     arrowSchema.dictionary = bridgeHolder->dictionary.get();
-    exportToArrow(vec->valueVector(), *arrowSchema.dictionary);
+    exportToArrow(vec->valueVector(), *arrowSchema.dictionary, options);
 
   } else {
-    arrowSchema.format = exportArrowFormatStr(type, bridgeHolder->formatBuffer);
+    arrowSchema.format =
+        exportArrowFormatStr(type, options, bridgeHolder->formatBuffer);
     arrowSchema.dictionary = nullptr;
 
     if (type->kind() == TypeKind::MAP) {
@@ -662,14 +817,14 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
           0,
           std::vector<VectorPtr>{maps.mapKeys(), maps.mapValues()},
           maps.getNullCount());
-      exportToArrow(rows, *child);
+      exportToArrow(rows, *child, options);
       child->name = "entries";
       setUniqueChild(std::move(child), *bridgeHolder, arrowSchema);
 
     } else if (type->kind() == TypeKind::ARRAY) {
       auto child = std::make_unique<ArrowSchema>();
       auto& arrays = *vec->asUnchecked<ArrayVector>();
-      exportToArrow(arrays.elements(), *child);
+      exportToArrow(arrays.elements(), *child, options);
       // Name is required, and "item" is the default name used in arrow itself.
       child->name = "item";
       setUniqueChild(std::move(child), *bridgeHolder, arrowSchema);
@@ -702,7 +857,7 @@ void exportToArrow(const VectorPtr& vec, ArrowSchema& arrowSchema) {
         try {
           auto& currentSchema = bridgeHolder->childrenOwned[i];
           currentSchema = std::make_unique<ArrowSchema>();
-          exportToArrow(rows.childAt(i), *currentSchema);
+          exportToArrow(rows.childAt(i), *currentSchema, options);
           currentSchema->name = bridgeHolder->rowType->nameOf(i).data();
           arrowSchema.children[i] = currentSchema.get();
         } catch (const VeloxException& e) {
@@ -757,6 +912,16 @@ TypePtr importFromArrow(const ArrowSchema& arrowSchema) {
     case 'Z':
       return VARBINARY();
 
+    // String and binary views.
+    case 'v':
+      if (format[1] == 'u') {
+        return VARCHAR();
+      }
+      if (format[1] == 'z') {
+        return VARBINARY();
+      }
+      break;
+
     case 't': // temporal types.
       // Mapping it to ttn for now.
       if (format[1] == 't' && format[2] == 'n') {
@@ -948,6 +1113,80 @@ VectorPtr createStringFlatVector(
       optionalNullCount(nullCount));
 }
 
+// Imports Utf8View or BinaryView. Only the views are converted to
+// StringViews, the data buffers are wrapped without copying.
+VectorPtr createStringViewFlatVector(
+    memory::MemoryPool* pool,
+    const TypePtr& type,
+    BufferPtr nulls,
+    const ArrowArray& arrowArray,
+    WrapInBufferViewFunc wrapInBufferView) {
+  VELOX_USER_CHECK_GE(
+      arrowArray.n_buffers,
+      3,
+      "Expecting at least three buffers as input for string view types.");
+  const auto length = arrowArray.length;
+  const auto numDataBuffers = arrowArray.n_buffers - 3;
+  const auto* dataBufferSizes = static_cast<const int64_t*>(
+      arrowArray.buffers[arrowArray.n_buffers - 1]);
+  const auto* views =
+      static_cast<const ArrowStringView*>(arrowArray.buffers[1]);
+  const auto* rawNulls = nulls ? nulls->as<uint64_t>() : nullptr;
+
+  BufferPtr stringViews = AlignedBuffer::allocate<StringView>(length, pool);
+  auto* rawStringViews = stringViews->asMutable<StringView>();
+  std::vector<bool> usedBuffers(numDataBuffers);
+  for (int64_t i = 0; i < length; ++i) {
+    // The views of null rows may be uninitialized.
+    if (rawNulls && bits::isBitNull(rawNulls, i)) {
+      rawStringViews[i] = StringView();
+      continue;
+    }
+    const auto& view = views[i];
+    VELOX_USER_CHECK_GE(view.size, 0, "Invalid size in string view");
+    if (view.size <= StringView::kInlineSize) {
+      rawStringViews[i] = StringView(view.inlined, view.size);
+      continue;
+    }
+    VELOX_USER_CHECK(
+        view.ref.bufferIndex >= 0 && view.ref.bufferIndex < numDataBuffers,
+        "Invalid data buffer index in string view: {}",
+        view.ref.bufferIndex);
+    VELOX_USER_CHECK(
+        view.ref.offset >= 0 &&
+            view.ref.offset + static_cast<int64_t>(view.size) <=
+                dataBufferSizes[view.ref.bufferIndex],
+        "String view [{}, {}) is out of bounds of data buffer {} of {} bytes",
+        view.ref.offset,
+        view.ref.offset + static_cast<int64_t>(view.size),
+        view.ref.bufferIndex,
+        dataBufferSizes[view.ref.bufferIndex]);
+    const auto* data =
+        static_cast<const char*>(arrowArray.buffers[2 + view.ref.bufferIndex]);
+    rawStringViews[i] = StringView(data + view.ref.offset, view.size);
+    usedBuffers[view.ref.bufferIndex] = true;
+  }
+
+  std::vector<BufferPtr> stringViewBuffers;
+  for (auto i = 0; i < numDataBuffers; ++i) {
+    if (usedBuffers[i]) {
+      stringViewBuffers.emplace_back(
+          wrapInBufferView(arrowArray.buffers[2 + i], dataBufferSizes[i]));
+    }
+  }
+
+  return std::make_shared<FlatVector<StringView>>(
+      pool,
+      type,
+      nulls,
+      length,
+      stringViews,
+      std::move(stringViewBuffers),
+      SimpleVectorStats<StringView>{},
+      std::nullopt,
+      optionalNullCount(arrowArray.null_count));
+}
+
 VectorPtr importFromArrowImpl(
     ArrowSchema& arrowSchema,
     ArrowArray& arrowArray,
@@ -1122,6 +1361,10 @@ VectorPtr importFromArrowImpl(
 
   // String data types (VARCHAR and VARBINARY).
   if (type->isVarchar() || type->isVarbinary()) {
+    if (arrowSchema.format[0] == 'v') {
+      return createStringViewFlatVector(
+          pool, type, nulls, arrowArray, wrapInBufferView);
+    }
     VELOX_USER_CHECK_EQ(
         arrowArray.n_buffers,
         3,
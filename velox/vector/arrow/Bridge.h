@@ -27,6 +27,15 @@ struct ArrowSchema;
 
 namespace facebook::velox {
 
+/// Options for exporting Velox vectors and types to Arrow.
+struct ArrowOptions {
+  /// Exports VARCHAR and VARBINARY as Arrow's Utf8View and BinaryView instead
+  /// of Utf8 and Binary. The view layout matches StringView, so the string
+  /// buffers are shared with the vector instead of being copied into a
+  /// contiguous buffer. The consumer must support the view types.
+  bool exportToStringView{false};
+};
+
 /// Export a generic Velox Vector to an ArrowArray, as defined by Arrow's C data
 /// interface:
 ///
@@ -41,8 +50,9 @@ namespace facebook::velox {
 /// input Vector shared_ptr.
 ///
 /// The function takes a memory pool where allocations will be made (in cases
-/// where the conversion is not zero-copy, e.g. for strings) and throws in case
-/// the conversion is not implemented yet.
+/// where the conversion is not zero-copy, e.g. for strings unless
+/// 'options.exportToStringView' is set) and throws in case the conversion is
+/// not implemented yet.
 ///
 /// Example usage:
 ///
@@ -58,7 +68,8 @@ void exportToArrow(
     const VectorPtr& vector,
     ArrowArray& arrowArray,
     memory::MemoryPool* pool =
-        &velox::memory::getProcessDefaultMemoryManager().getRoot());
+        &velox::memory::getProcessDefaultMemoryManager().getRoot(),
+    const ArrowOptions& options = {});
 
 /// Export the type of a Velox vector to an ArrowSchema.
 ///
@@ -78,8 +89,12 @@ void exportToArrow(
 ///   arrowSchema.release(&arrowSchema);
 ///
 /// NOTE: Since Arrow couples type and encoding, we need both Velox type and
-/// actual data (containing encoding) to create an ArrowSchema.
-void exportToArrow(const VectorPtr&, ArrowSchema&);
+/// actual data (containing encoding) to create an ArrowSchema. The same
+/// 'options' must be used for the ArrowArray and the ArrowSchema.
+void exportToArrow(
+    const VectorPtr&,
+    ArrowSchema&,
+    const ArrowOptions& options = {});
 
 /// Import an ArrowSchema into a Velox Type object.
 ///
@@ -108,7 +123,8 @@ TypePtr importFromArrow(const ArrowSchema& arrowSchema);
 /// carry a pointer to it, but not really used in most cases - unless the
 /// conversion itself requires a new allocation. In most cases no new
 /// allocations are required, unless for arrays of varchars (or varbinaries) and
-/// complex types written out of order.
+/// complex types written out of order. Arrays of Utf8View and BinaryView
+/// only need a new buffer for the StringViews, the string buffers are shared.
 ///
 /// The new Velox vector returned contains only references to the underlying
 /// buffers, so it's the client's responsibility to ensure the buffer's
@@ -21,6 +21,7 @@
 #include <gtest/gtest.h>
 
 #include "velox/common/base/Nulls.h"
+#include "velox/common/base/tests/GTestUtils.h"
 #include "velox/core/QueryCtx.h"
 #include "velox/vector/arrow/Bridge.h"
 #include "velox/vector/tests/utils/VectorMaker.h"
@@ -336,6 +337,67 @@ TEST_F(ArrowBridgeArrayExportTest, flatString) {
   testFlatVector<std::string>({});
 }
 
+TEST_F(ArrowBridgeArrayExportTest, flatStringView) {
+  std::vector<std::optional<std::string>> inputData = {
+      "my string",
+      "another slightly longer string",
+      std::nullopt,
+      "",
+      "exactly12...",
+      "thirteen.....",
+      std::nullopt,
+      "another even longer string to ensure it's for sure not stored inline!!!",
+  };
+  auto vector = vectorMaker_.flatVectorNullable(inputData);
+  const auto& stringBuffers =
+      vector->asFlatVector<StringView>()->stringBuffers();
+  ASSERT_FALSE(stringBuffers.empty());
+
+  ArrowOptions options;
+  options.exportToStringView = true;
+  ArrowArray arrowArray;
+  exportToArrow(vector, arrowArray, pool_.get(), options);
+  EXPECT_EQ(inputData.size(), arrowArray.length);
+  EXPECT_EQ(2, arrowArray.null_count);
+
+  // Nulls, views, the string buffers of the vector and their sizes.
+  ASSERT_EQ(3 + stringBuffers.size(), arrowArray.n_buffers);
+  for (auto i = 0; i < stringBuffers.size(); ++i) {
+    // The string buffers are not copied.
+    EXPECT_EQ(stringBuffers[i]->as<void>(), arrowArray.buffers[2 + i]);
+    EXPECT_EQ(
+        stringBuffers[i]->size(),
+        static_cast<const int64_t*>(
+            arrowArray.buffers[arrowArray.n_buffers - 1])[i]);
+  }
+
+  const auto* nulls = static_cast<const uint64_t*>(arrowArray.buffers[0]);
+  const auto* views = static_cast<const char*>(arrowArray.buffers[1]);
+  for (auto i = 0; i < inputData.size(); ++i) {
+    if (inputData[i] == std::nullopt) {
+      EXPECT_TRUE(bits::isBitNull(nulls, i));
+      continue;
+    }
+    // A view is the size followed by the inlined string or by a 4 byte
+    // prefix, the data buffer index and the offset.
+    const auto* view = views + i * 16;
+    const auto size = *reinterpret_cast<const int32_t*>(view);
+    ASSERT_EQ(inputData[i]->size(), size);
+    const char* data = view + 4;
+    if (size > 12) {
+      EXPECT_EQ(0, std::memcmp(inputData[i]->data(), data, 4));
+      const auto bufferIndex = *reinterpret_cast<const int32_t*>(view + 8);
+      const auto offset = *reinterpret_cast<const int32_t*>(view + 12);
+      data = static_cast<const char*>(arrowArray.buffers[2 + bufferIndex]) +
+          offset;
+    }
+    EXPECT_EQ(*inputData[i], std::string(data, size));
+  }
+
+  arrowArray.release(&arrowArray);
+  EXPECT_EQ(nullptr, arrowArray.release);
+}
+
 TEST_F(ArrowBridgeArrayExportTest, rowVector) {
   std::vector<std::optional<int64_t>> col1 = {1, 2, 3, 4};
   std::vector<std::optional<double>> col2 = {99.9, 88.8, 77.7, std::nullopt};
@@ -1075,6 +1137,114 @@ class ArrowBridgeArrayImportTest : public ArrowBridgeArrayExportTest {
     });
   }
 
+  void testImportStringView() {
+    std::vector<std::optional<std::string>> inputValues = {
+        "hello world",
+        "larger string which should not be inlined...",
+        std::nullopt,
+        "",
+        "another string which is not inlined",
+        std::nullopt,
+    };
+    auto vector = vectorMaker_.flatVectorNullable(inputValues);
+    ArrowOptions options;
+    options.exportToStringView = true;
+    ArrowSchema arrowSchema;
+    ArrowArray arrowArray;
+    exportToArrow(vector, arrowSchema, options);
+    exportToArrow(vector, arrowArray, pool_.get(), options);
+    EXPECT_EQ(std::string("vu"), arrowSchema.format);
+
+    auto output = importFromArrow(arrowSchema, arrowArray, pool_.get());
+    assertVectorContent(inputValues, output, 2);
+
+    // The strings that are not inlined are not copied.
+    auto* flat = output->asFlatVector<StringView>();
+    EXPECT_EQ(
+        vector->asFlatVector<StringView>()->valueAt(1).data(),
+        flat->valueAt(1).data());
+    EXPECT_EQ(
+        vector->asFlatVector<StringView>()->stringBuffers().size(),
+        flat->stringBuffers().size());
+
+    if (isViewer()) {
+      arrowArray.release(&arrowArray);
+      arrowSchema.release(&arrowSchema);
+    } else {
+      EXPECT_EQ(arrowArray.release, nullptr);
+      EXPECT_EQ(arrowSchema.release, nullptr);
+    }
+
+    // Binary views with the views of null rows left uninitialized.
+    std::vector<std::optional<std::string>> binaryValues = {
+        std::nullopt, "binary", "binary value that is not inlined"};
+    ArrowContextHolder holder;
+    holder.nulls = AlignedBuffer::allocate<uint64_t>(1, pool_.get());
+    bits::setNull(holder.nulls->asMutable<uint64_t>(), 0);
+    bits::clearNull(holder.nulls->asMutable<uint64_t>(), 1);
+    bits::clearNull(holder.nulls->asMutable<uint64_t>(), 2);
+    holder.values = AlignedBuffer::allocate<char>(3 * 16, pool_.get(), '\xff');
+    auto* views = holder.values->asMutable<char>();
+    const auto& inlined = *binaryValues[1];
+    const auto& notInlined = *binaryValues[2];
+    *reinterpret_cast<int32_t*>(views + 16) = inlined.size();
+    std::memset(views + 20, 0, 12);
+    std::memcpy(views + 20, inlined.data(), inlined.size());
+    *reinterpret_cast<int32_t*>(views + 32) = notInlined.size();
+    std::memcpy(views + 36, notInlined.data(), 4);
+    *reinterpret_cast<int32_t*>(views + 40) = 0;
+    *reinterpret_cast<int32_t*>(views + 44) = 0;
+    const int64_t dataSize = notInlined.size();
+    const void* buffers[] = {
+        holder.nulls->as<void>(), views, notInlined.data(), &dataSize};
+    auto binarySchema = makeArrowSchema("vz");
+    auto binaryArray = makeArrowArray(buffers, 4, 3, 1);
+    output = importFromArrow(binarySchema, binaryArray, pool_.get());
+    ASSERT_EQ(*VARBINARY(), *output->type());
+    EXPECT_TRUE(output->isNullAt(0));
+    EXPECT_EQ(inlined, output->asFlatVector<StringView>()->valueAt(1).str());
+    EXPECT_EQ(
+        notInlined.data(),
+        output->asFlatVector<StringView>()->valueAt(2).data());
+
+    // Data buffer index out of range.
+    *reinterpret_cast<int32_t*>(views + 40) = 1;
+    binarySchema = makeArrowSchema("vz");
+    binaryArray = makeArrowArray(buffers, 4, 3, 1);
+    VELOX_ASSERT_THROW(
+        importFromArrow(binarySchema, binaryArray, pool_.get()),
+        "Invalid data buffer index in string view: 1");
+
+    // String past the end of the data buffer.
+    *reinterpret_cast<int32_t*>(views + 40) = 0;
+    *reinterpret_cast<int32_t*>(views + 44) = 1;
+    binarySchema = makeArrowSchema("vz");
+    binaryArray = makeArrowArray(buffers, 4, 3, 1);
+    VELOX_ASSERT_THROW(
+        importFromArrow(binarySchema, binaryArray, pool_.get()),
+        fmt::format(
+            "String view [1, {}) is out of bounds of data buffer 0 of {} bytes",
+            dataSize + 1,
+            dataSize));
+
+    // Negative offset.
+    *reinterpret_cast<int32_t*>(views + 44) = -1;
+    binarySchema = makeArrowSchema("vz");
+    binaryArray = makeArrowArray(buffers, 4, 3, 1);
+    VELOX_ASSERT_THROW(
+        importFromArrow(binarySchema, binaryArray, pool_.get()),
+        "is out of bounds of data buffer 0");
+
+    // Negative size.
+    *reinterpret_cast<int32_t*>(views + 44) = 0;
+    *reinterpret_cast<int32_t*>(views + 32) = -20;
+    binarySchema = makeArrowSchema("vz");
+    binaryArray = makeArrowArray(buffers, 4, 3, 1);
+    VELOX_ASSERT_THROW(
+        importFromArrow(binarySchema, binaryArray, pool_.get()),
+        "Invalid size in string view");
+  }
+
   void testImportFailures() {
     ArrowSchema arrowSchema;
     ArrowArray arrowArray;
@@ -1162,6 +1332,10 @@ TEST_F(ArrowBridgeArrayImportAsViewerTest, string) {
   testImportString();
 }
 
+TEST_F(ArrowBridgeArrayImportAsViewerTest, stringView) {
+  testImportStringView();
+}
+
 TEST_F(ArrowBridgeArrayImportAsViewerTest, row) {
   testImportRow();
 }
@@ -1209,6 +1383,10 @@ TEST_F(ArrowBridgeArrayImportAsOwnerTest, string) {
   testImportString();
 }
 
+TEST_F(ArrowBridgeArrayImportAsOwnerTest, stringView) {
+  testImportStringView();
+}
+
 TEST_F(ArrowBridgeArrayImportAsOwnerTest, row) {
   testImportRow();
 }
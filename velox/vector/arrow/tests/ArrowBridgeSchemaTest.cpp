@@ -27,17 +27,23 @@ namespace {
 using namespace facebook::velox;
 static void mockRelease(ArrowSchema*) {}
 
-void exportToArrow(const TypePtr& type, ArrowSchema& out) {
+void exportToArrow(
+    const TypePtr& type,
+    ArrowSchema& out,
+    const ArrowOptions& options = {}) {
   auto pool =
       &facebook::velox::memory::getProcessDefaultMemoryManager().getRoot();
-  exportToArrow(BaseVector::create(type, 0, pool), out);
+  exportToArrow(BaseVector::create(type, 0, pool), out, options);
 }
 
 class ArrowBridgeSchemaExportTest : public testing::Test {
  protected:
-  void testScalarType(const TypePtr& type, const char* arrowFormat) {
+  void testScalarType(
+      const TypePtr& type,
+      const char* arrowFormat,
+      const ArrowOptions& options = {}) {
     ArrowSchema arrowSchema;
-    exportToArrow(type, arrowSchema);
+    exportToArrow(type, arrowSchema, options);
 
     EXPECT_EQ(std::string{arrowFormat}, std::string{arrowSchema.format});
     EXPECT_EQ(nullptr, arrowSchema.name);
@@ -126,6 +132,12 @@ TEST_F(ArrowBridgeSchemaExportTest, scalar) {
 
   testScalarType(DECIMAL(10, 4), "d:10,4");
   testScalarType(DECIMAL(20, 15), "d:20,15");
+
+  ArrowOptions options;
+  options.exportToStringView = true;
+  testScalarType(VARCHAR(), "vu", options);
+  testScalarType(VARBINARY(), "vz", options);
+  testScalarType(BIGINT(), "l", options);
 }
 
 TEST_F(ArrowBridgeSchemaExportTest, nested) {
@@ -234,6 +246,8 @@ TEST_F(ArrowBridgeSchemaImportTest, scalar) {
   EXPECT_EQ(*VARCHAR(), *testSchemaImport("U"));
   EXPECT_EQ(*VARBINARY(), *testSchemaImport("z"));
   EXPECT_EQ(*VARBINARY(), *testSchemaImport("Z"));
+  EXPECT_EQ(*VARCHAR(), *testSchemaImport("vu"));
+  EXPECT_EQ(*VARBINARY(), *testSchemaImport("vz"));
 
   // Temporal.
   EXPECT_EQ(*TIMESTAMP(), *testSchemaImport("ttn"));